@@ -30,6 +30,8 @@
  * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
  *
  * @details Only works if the number of measurements per time step stays constant. 
+ * The data is written as text or in the binary column format of ResultFormattingTools,
+ * see setOutputFormat(). Binary files get the extension ".bin" appended to the filename.
  */
 template < class IngredientsType , class T > class AnalyzerAbstractDump : public AbstractAnalyzer
 {
@@ -71,6 +73,8 @@ private:
 	bool isFirstFileDump;
 	/*control bool for the last writing*/
 	bool isCleanup;
+	/*text or binary output*/
+	ResultFormattingTools::OutputFormat outputFormat;
 protected:
 	//!dump data and cleans buffer 
 	void dumpTimeSeries();
@@ -102,6 +106,10 @@ public:
 	bool getIsFirstFileDump() const { return isFirstFileDump; }  
 	//! reset the variable isFirstFileDump to false (could be used if the filename changes in between data dumpings)
 	void resetIsFirstFileDump() {isFirstFileDump=true;}
+	//! set the output format (initially ResultFormattingTools::getDefaultOutputFormat())
+	void setOutputFormat(ResultFormattingTools::OutputFormat outputFormat_){outputFormat=outputFormat_;}
+	//! get the output format
+	ResultFormattingTools::OutputFormat getOutputFormat() const {return outputFormat;}
 };
 
 /*************************************************************************
@@ -121,7 +129,8 @@ bufferSize(100),
 NColumns(0),
 Data(NColumns,std::vector<T>(0)),
 isFirstFileDump(true),
-isCleanup(false)
+isCleanup(false),
+outputFormat(ResultFormattingTools::getDefaultOutputFormat())
 {
   std::stringstream comment; 
   comment<<"Created by AnalyzerAbstractDump\n";
@@ -169,15 +178,15 @@ void AnalyzerAbstractDump<IngredientsType, T >::dumpTimeSeries()
     if (Data[0].size() > bufferSize || isCleanup ){
 	if ( NColumns != Data.size() || NColumns == 0 )
 	    throw std::runtime_error("[AnalyzerAbstractDump]::dumpTimeSeries() Did not set up NColumns!");
-	//fist make a single vector<vector<T> > for writing the results
-	std::vector<std::vector<T> > resultsTimeseries(Data);
-	resultsTimeseries.insert(resultsTimeseries.begin(),MCSTimes);
 	//if it is written for the first time, include comment in the output file
+	//the mcs times are passed as first column, so Data does not have to be copied
 	if(isFirstFileDump){
-		ResultFormattingTools::writeResultFile(
+		ResultFormattingTools::writeOutputFile(
+			outputFormat,
 			outputFilename,
 			ingredients,
-			resultsTimeseries,
+			MCSTimes,
+			Data,
 			commentTimeSeries
 		);
 
@@ -185,8 +194,10 @@ void AnalyzerAbstractDump<IngredientsType, T >::dumpTimeSeries()
 	}
 	//otherwise just append the new data
 	else{
-		ResultFormattingTools::appendToResultFile(outputFilename,
-							  resultsTimeseries);
+		ResultFormattingTools::appendToOutputFile(outputFormat,
+							  outputFilename,
+							  MCSTimes,
+							  Data);
 	}
 	//set all time series vectors back to zero size
 	MCSTimes.resize(0);
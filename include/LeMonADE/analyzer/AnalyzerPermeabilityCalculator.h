@@ -3,6 +3,7 @@
 
 #include <LeMonADE/utility/ResultFormattingTools.h>
 #include <LeMonADE/utility/MonomerGroup.h>
+#include <algorithm>
 
 /**
  * @file
@@ -33,6 +34,11 @@
  * (iii) It is reccomended to simulate the system for 100 MCS(simInterval_=100)(or track permeable objects after 100 MCS)
  * before executing this analyzer to get proper results.<br>
  * 
+ * The state of every particle (objects first, then solvent monomers) is kept in flat int8 arrays:
+ * 0 for outside, +1/-1 for inside the boundaries (entered from above/below). In execute() the
+ * new states are calculated in parallel (if compiled with OpenMP) and a translocation is detected
+ * by comparing the old and new state arrays element by element in permeabilityUpdate().<br>
+ * 
  * @tparam IngredientsType
  *
  * @param ingredients_ the system holding the simulation box with bilayer, solvent and objects.
@@ -75,17 +81,33 @@ protected:
     std::vector<VectorDouble3> groupsCOM;
     int32_t boxXm_1,boxYm_1,boxZm_1,binBoxX,binBoxY,boxZ;
 
-    //!Maps for storing indices of particle which are inside the boundaries(close to the bilayer).
-    std::map<int, int> particlesInsideBoundaries;
-    std::map<int, int> particlesInsideBoundariesOld;
+    //!Dense two dimensional grid of bin values, stored row by row in a single vector.
+    template<class T>
+    class BinGrid{
+    public:
+        BinGrid():ny(0){}
+        void resize(int32_t nx, int32_t ny_, T value){ny=ny_; data.assign(size_t(nx)*ny,value);}
+        void fill(T value){std::fill(data.begin(),data.end(),value);}
+        T* operator[](int32_t x){return &data[size_t(x)*ny];}
+        const T* operator[](int32_t x) const {return &data[size_t(x)*ny];}
+    private:
+        int32_t ny;
+        std::vector<T> data;
+    };
+
+    //!State of every particle(objects first, then solvent): 0 outside, +1/-1 inside the boundaries(close to the bilayer)
+    //!entered from above/below. particlesInsideBoundaries holds the states of the current call to execute(), where particles
+    //!outside the boundaries are marked with +2/-2 according to their side of the midplane.
+    std::vector<int8_t> particlesInsideBoundaries;
+    std::vector<int8_t> particlesInsideBoundariesOld;
     
     //!Vector for storing the indices of monomers which are solvent.
     std::vector < int32_t > solventIndices;
 
     //!Vectors and variables used by midplaneUpdater() function.
-    std::vector<std::vector < float > >  midplane;
-    std::vector<std::vector < float > >  counterMidplane;
-    std::vector<std::vector < float > >  poreFlag;
+    BinGrid< float >  midplane;
+    BinGrid< float >  counterMidplane;
+    BinGrid< float >  poreFlag;
     std::vector<VectorInt3> neigbours;
     int32_t counterSolvent,counterObjects,counterExecute;
     float sigma;
@@ -120,6 +142,9 @@ public:
     //!Function to find the center of mass of subgroup of monomers(generally objects).    
     VectorDouble3 centerOfMass(const group_type_ind&  m);
     
+    //!Function to find the state of a particle(see particlesInsideBoundaries) at the given position.
+    int8_t particleState(const VectorDouble3& position, int32_t f2s);
+    
     //!Function for dumping the permeability values in the file.        
     void dumpPermeabilityPerMcs();
 
@@ -181,9 +206,9 @@ AnalyzerPermeabilityCalculator<IngredientsType>::AnalyzerPermeabilityCalculator(
     //Initiate arrays of the size as number of bins in x and 
     //y direction.
     
-    midplane.resize(binBoxX, std::vector<float>(binBoxY, boxZ/2.0));
-    counterMidplane.resize(binBoxX, std::vector<float>(binBoxY, 0));
-    poreFlag.resize(binBoxX, std::vector<float>(binBoxY, 0));
+    midplane.resize(binBoxX, binBoxY, boxZ/2.0);
+    counterMidplane.resize(binBoxX, binBoxY, 0);
+    poreFlag.resize(binBoxX, binBoxY, 0);
     sigma=5.0;
     isFirstFileDump=1;
     
@@ -195,10 +220,10 @@ AnalyzerPermeabilityCalculator<IngredientsType>::AnalyzerPermeabilityCalculator(
         if(ingredients.getMolecules()[i].getAttributeTag()==SOLVENTAG)
             solventIndices.push_back(i);
         
-   //groupsCOM vector stores the center of mass of objects(groups.size())
-   //and solvent monomers.  
+   //groupsCOM vector stores the center of mass of objects(groups.size()).
+   //The solvent positions are read directly from the molecules.
     
-    groupsCOM.resize(groups.size()+solventIndices.size());
+    groupsCOM.resize(groups.size());
     
     //To start maps to store particles according to inside/outside 
     //of the boundaries.
@@ -221,42 +246,25 @@ void AnalyzerPermeabilityCalculator<IngredientsType>::execute(){
     //Increase the counter. 
     counterExecute++;
 
-    int32_t x,y,z,distance,f2s,sign;
+    const int32_t nGroups=groups.size();
+    const int32_t nSolvent=solventIndices.size();
     
-    //Loop to go over all the particles(objects and solvent)
-    //to see if they are in the boundaries.
-        
-    for(size_t i=0;i<groups.size()+solventIndices.size();i++){
-        
-         //The objects boundaries can be set wider than
-         //solvent boundaries.
+     //Find the state of all the particles(objects and solvent).
+     //The objects boundaries can be set wider than
+     //solvent boundaries.
     
-        if(i<groups.size()){
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(dynamic,16)
+        for(int32_t i=0;i<nGroups;i++){
             groupsCOM[i]=centerOfMass(groups[i]);
-            f2s=factorSigma;
-        }
-        
-        else{
-            groupsCOM[i]=ingredients.getMolecules()[solventIndices[i-groups.size()]];
-            f2s=3;
+            particlesInsideBoundaries[i]=particleState(groupsCOM[i],factorSigma);
         }
         
-         //Folding back coordinates for midplane array.
-         //then, find the distance between midplane and particle 
-         //using minimum image convention.
-            
-        x=(int32_t(groupsCOM[i].getX())&boxXm_1)/binSize;
-        y=(int32_t(groupsCOM[i].getY())&boxYm_1)/binSize;
-        
-        distance=int32_t(groupsCOM[i].getZ()) - midplane[x][y];
-        distance=reduceDistanceInPeriodicSpace(distance,boxZ);
-        
-        if(abs(distance)<=f2s*sigma){
-             //check if particle is in upper side or
-             //lower side.
-            
-            sign = (distance<0)?-1:1;
-            particlesInsideBoundaries[i]=sign;
+        #pragma omp for schedule(static)
+        for(int32_t i=0;i<nSolvent;i++){
+            VectorDouble3 position(molecules.getVertexUnchecked(solventIndices[i]));
+            particlesInsideBoundaries[nGroups+i]=particleState(position,3);
         }
     }
     
@@ -272,19 +280,15 @@ void AnalyzerPermeabilityCalculator<IngredientsType>::execute(){
     if(counterExecute%midplaneUpdaterInterval==0)
         midplaneUpdater();
     
-    //Reset map values.    
-    for(int32_t i=0;i<particlesInsideBoundariesOld.size();i++){
-        particlesInsideBoundariesOld[i]=particlesInsideBoundaries[i];
-        particlesInsideBoundaries[i]=0;
-    }
-    
 }
 
 /**
-* @details Updates the permeability values by comparing maps 
+* @details Updates the permeability values by comparing the state arrays 
 * particlesInsideBoundariesOld and particlesInsideBoundaries. If a particle
 * was inside before(Old) and exit boundary from a direction opposite to it entered in, 
-* then it counts as one translocation event. 
+* then it counts as one translocation event, i.e. if the product of the old and new
+* state is -2. Afterwards particlesInsideBoundariesOld holds the direction 
+* particles inside the boundaries came in from and zero for all other particles.
 * 
 * @tparam IngredientsType Features used in the system. See Ingredients.
 */
@@ -292,37 +296,31 @@ void AnalyzerPermeabilityCalculator<IngredientsType>::execute(){
 template<class IngredientsType>
 void AnalyzerPermeabilityCalculator<IngredientsType>::permeabilityUpdate(){
      
-    int32_t x,y,upDownIndicator;
+    const int32_t nGroups=groups.size();
+    const int32_t nParticles=particlesInsideBoundaries.size();
+    int32_t crossedObjects=0,crossedSolvent=0;
     
      //Loop to go over all the particles(objects and solvent)
-     //which were present in last execution and check if they 
-     //still present, if not then, check if they went from 
-     //opposite direction they came in and count a translocation 
-     //event. If a particle is still present, then store the
-     //direction it came inside from.
-    
-    for(int32_t i=0;i<particlesInsideBoundariesOld.size();i++){
+     //and count a translocation event if a particle left the 
+     //boundaries on the opposite side it came in. If a particle 
+     //is still inside, store(or remember) the direction it came
+     //inside from.
+    
+    #pragma omp parallel for schedule(static) reduction(+:crossedObjects,crossedSolvent)
+    for(int32_t i=0;i<nParticles;i++){
+        const int8_t oldState=particlesInsideBoundariesOld[i];
+        const int8_t newState=particlesInsideBoundaries[i];
+        const int32_t crossed=(oldState*newState==-2);
         
-        if(abs(particlesInsideBoundariesOld[i])==1&&particlesInsideBoundaries[i]==0){
-                        
-            x=(int32_t(groupsCOM[i].getX())&boxXm_1)/binSize;
-            y=(int32_t(groupsCOM[i].getY())&boxYm_1)/binSize;
-            
-            upDownIndicator=int32_t(groupsCOM[i].getZ())-midplane[x][y];
-            upDownIndicator=reduceDistanceInPeriodicSpace(upDownIndicator,boxZ);
-            
-            if(particlesInsideBoundariesOld[i]*upDownIndicator<0){
-
-                if(i<groups.size())
-                    counterObjects++;
-                else
-                    counterSolvent++;
-            }
-        }
-        //Store(or remember) the direction of the particles from where it entered in the boundary.
-        else if(abs(particlesInsideBoundariesOld[i])==1&&abs(particlesInsideBoundaries[i])==1)
-            particlesInsideBoundaries[i]=particlesInsideBoundariesOld[i];
+        if(i<nGroups) crossedObjects+=crossed;
+        else crossedSolvent+=crossed;
+        
+        const bool inside=(newState*newState==1);
+        particlesInsideBoundariesOld[i]=(inside ? (oldState!=0 ? oldState : newState) : 0);
     }
+    
+    counterObjects+=crossedObjects;
+    counterSolvent+=crossedSolvent;
 };
 
 /**
@@ -338,12 +336,9 @@ void AnalyzerPermeabilityCalculator<IngredientsType>::midplaneUpdater(){
 
      //Reset all values to zero
      
-     for(int32_t x1=0;x1<binBoxX;x1++)
-         for(int32_t y1=0;y1<binBoxY;y1++){
-             midplane[x1][y1]=0;
-             counterMidplane[x1][y1]=0;
-             poreFlag[x1][y1]=0;
-         }
+     midplane.fill(0);
+     counterMidplane.fill(0);
+     poreFlag.fill(0);
              
      int32_t x,y,z;
      int32_t referenceI=0;
@@ -472,38 +467,67 @@ void AnalyzerPermeabilityCalculator<IngredientsType>::findNearestMidplaneValue(i
 template<class IngredientsType>
 void AnalyzerPermeabilityCalculator<IngredientsType>::initParticleArrays(){
     
-    int32_t x,y,distance,sign,f2s;
+    const int32_t nGroups=groups.size();
+    const int32_t nSolvent=solventIndices.size();
+    
+    particlesInsideBoundaries.assign(nGroups+nSolvent,0);
+    particlesInsideBoundariesOld.assign(nGroups+nSolvent,0);
     
-    for(size_t i=0;i<groups.size()+solventIndices.size();i++){
+    for(int32_t i=0;i<nGroups+nSolvent;i++){
+        
+        int32_t f2s;
+        VectorDouble3 position;
         
-        if(i<groups.size()){
+        if(i<nGroups){
             groupsCOM[i]=centerOfMass(groups[i]);
+            position=groupsCOM[i];
             f2s=factorSigma;
         }
         
         else{
-            groupsCOM[i]=ingredients.getMolecules()[solventIndices[i-groups.size()]];
+            position=ingredients.getMolecules()[solventIndices[i-nGroups]];
             f2s=3;
         }
-    
-        x=(int32_t(groupsCOM[i].getX())&boxXm_1)/binSize;
-        y=(int32_t(groupsCOM[i].getY())&boxYm_1)/binSize;
-        
-        distance=(int32_t(groupsCOM[i].getZ())&boxZm_1) - midplane[x][y];
-        distance=reduceDistanceInPeriodicSpace(distance,boxZ);
         
-        if(abs(distance)<=f2s*sigma){
-            sign = (distance<0)?-1:1;
-            particlesInsideBoundariesOld.insert(make_pair(i ,sign));
-        }
-        else
-            particlesInsideBoundariesOld.insert(make_pair(i,0));
+        position.setZ(int32_t(position.getZ())&boxZm_1);
         
-        particlesInsideBoundaries.insert(make_pair(i,0));
+        int8_t state=particleState(position,f2s);
+        particlesInsideBoundariesOld[i]=(state*state==1 ? state : 0);
  }
  
 };
 
+/**
+* @details Folding back coordinates for midplane array, then, find the distance
+* between midplane and particle using minimum image convention.
+* 
+* @tparam IngredientsType Features used in the system. See Ingredients.
+*
+* @param position position of the particle
+* @param f2s factor of sigma defining the boundaries
+* @return +1/-1 if the particle is inside the boundaries above/below the midplane,
+* +2/-2 if it is outside the boundaries above/below the midplane
+*/
+
+template<class IngredientsType>
+int8_t AnalyzerPermeabilityCalculator<IngredientsType>::particleState(const VectorDouble3& position, int32_t f2s){
+    
+    int32_t x=(int32_t(position.getX())&boxXm_1)/binSize;
+    int32_t y=(int32_t(position.getY())&boxYm_1)/binSize;
+    
+    int32_t distance=int32_t(position.getZ()) - midplane[x][y];
+    distance=reduceDistanceInPeriodicSpace(distance,boxZ);
+    
+    //check if particle is in upper side or
+    //lower side.
+    int8_t sign = (distance<0)?-1:1;
+    
+    if(abs(distance)<=f2s*sigma)
+        return sign;
+    else
+        return 2*sign;
+}
+
 /**
 * @details Prints the permeability per mcs into files.
 * 
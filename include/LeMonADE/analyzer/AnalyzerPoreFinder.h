@@ -3,6 +3,7 @@
 
 #include <LeMonADE/utility/ResultFormattingTools.h>
 #include <LeMonADE/utility/MonomerGroup.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -81,6 +82,10 @@ private:
  * x-y plane which are free of tail monomers all along z axis as pore points. The cluster analysis then, 
  * finds out all the cluster of points which are connected with the cluster size more than
  * CLUSTER_SIZE_THRESHOLD. This threshold can be changed with the macro below.
+ * The projection of the tail monomers onto the x-y plane is stored in a flat bitmap. The clusters
+ * are labelled with a union-find (Hoshen-Kopelman like) pass with periodic boundaries: bands of
+ * CLUSTER_ROWS_PER_BAND rows are labelled independently (in parallel if compiled with OpenMP) and
+ * the bands are joined afterwards. The box size in x and y has to be a power of two.
  * Furthermore, in considering the copolymers it is essential to count only the polymer whose COM distance from the 
  * bilayer midplane is below a threshold which can set by POLYMER_DIST_THRESHOLD.<br>
  * 
@@ -104,6 +109,7 @@ private:
 #define POLYMER_DIST_THRESHOLD 10
 #define SOLVENTAG 5
 #define TAILTAG 2
+#define CLUSTER_ROWS_PER_BAND 16
 
 template<class IngredientsType>
 class AnalyzerPoreFinder: public AbstractAnalyzer
@@ -124,12 +130,15 @@ protected:
     //!vectors storing VectorInt2 objects
     std::vector<VectorInt2> coordinatesOfPore;
     std::vector<VectorInt2> centriod;
-    std::vector<VectorInt2> neigbours;
-    std::vector<VectorInt2> clusterList;
 
     //!vectors various arrays used by functions below.
     
-    std::vector<std::vector< bool > > tailOccupied;
+    //!projection of tail monomers onto x-y plane, index x*boxY+y
+    std::vector< uint8_t > tailOccupied;
+    //!union-find parent of each tail free site, -1 for occupied sites
+    std::vector< int32_t > clusterParent;
+    //!number of sites (later offset in coordinatesOfPore) of each cluster root
+    std::vector< int32_t > clusterCount;
     std::vector<std::vector< int > > coordinatesOfPoreStore;
     std::vector<std::vector< int > > coordinatesOfPolymers;
     std::vector<int> sizeOfCluster;
@@ -146,21 +155,12 @@ public:
     AnalyzerPoreFinder(IngredientsType& i, const group_type& g,std::string fileSuffix_="");
     virtual ~AnalyzerPoreFinder(){}
     
-    //!Function to fill lattice with tail monomer types.
-    void LatticeFiller();
-    
     //!Function to store lattice points which are occupied by tail monomers.
     void tailOccupiedFinder();
     
     //!Function for cluster analysis of points free of any tail monomers.
     void clusterAnalysis();
     
-    //!Function used by clusterAnalysis() to find a lipid site which is free of lipids and not been checked already.    
-    VectorInt2 lookForLipidFreeSites();
-    
-    //!Function used by clusterAnalysis() addNeigbours of an last unchecked values in the cluster list.
-    void addNeigbours(int32_t lastUnChecked);
-    
     //!Function used by clusterAnalysis() to store various values to the memory for later dump.
     void storeValues();
     
@@ -178,6 +178,23 @@ public:
     void cleanup();
     void initialize(){};
 
+private:
+    //!Function used by clusterAnalysis() to find the root of a site with path halving.
+    int32_t findClusterRoot(int32_t site){
+        while(clusterParent[site]!=site){
+            clusterParent[site]=clusterParent[clusterParent[site]];
+            site=clusterParent[site];
+        }
+        return site;
+    }
+
+    //!Function used by clusterAnalysis() to join the clusters of two sites. The smaller index becomes the root.
+    void uniteClusters(int32_t site1, int32_t site2){
+        int32_t root1=findClusterRoot(site1);
+        int32_t root2=findClusterRoot(site2);
+        if(root1<root2) clusterParent[root2]=root1;
+        else if(root2<root1) clusterParent[root1]=root2;
+    }
 };
 
 /**
@@ -216,23 +233,15 @@ AnalyzerPoreFinder<IngredientsType>::AnalyzerPoreFinder(IngredientsType& i, cons
         if(type<SOLVENTAG) {referenceI=i; break;}}
 
    //Initate various array with box size in x-y direction.
-    tailOccupied.resize(boxX,std::vector<bool>(boxY));
+    tailOccupied.resize(boxX*boxY,0);
+    clusterParent.resize(boxX*boxY,-1);
+    clusterCount.resize(boxX*boxY,0);
     coordinatesOfPoreStore.resize(boxX,std::vector<int32_t>(boxY,0));
     coordinatesOfPolymers.resize(boxX,std::vector<int32_t>(boxY,0));
 
    //Initate pore size array with three rows.
    //for MCS, poresize, and third one radius of gyration. 
     poreSizeStore.resize(3);
-    
-   //Initate nearest neigbours on 2d surface on simple cubic lattice.
-    VectorInt2 V(1,0);
-    neigbours.push_back(V);
-    V.setAllCoordinates(-1,0);
-    neigbours.push_back(V);
-    V.setAllCoordinates(0,1);
-    neigbours.push_back(V);
-    V.setAllCoordinates(0,-1);
-    neigbours.push_back(V);
 }
 
 /**
@@ -245,9 +254,7 @@ AnalyzerPoreFinder<IngredientsType>::AnalyzerPoreFinder(IngredientsType& i, cons
 template<class IngredientsType>
 bool AnalyzerPoreFinder<IngredientsType>::execute(){
 
-    //Fill the lattice 
-    //and find all the sites filled with tail monomers in x-y plane.
-    LatticeFiller();
+    //find all the sites filled with tail monomers in x-y plane.
     tailOccupiedFinder();
     
     //Perform cluster analysis.     
@@ -266,43 +273,8 @@ bool AnalyzerPoreFinder<IngredientsType>::execute(){
 }
 
 /**
-* @details Fill lattice if there is a tail monomer with its type or zero otherwise 
-* 
-* @tparam IngredientsType Features used in the system. See Ingredients.
-*/
-
-template<class IngredientsType>
-void AnalyzerPoreFinder<IngredientsType>::LatticeFiller(){
-  
-    for(int32_t x=0;x<boxX;x++)
-      for(int32_t y=0;y<boxY;y++)
-          for(int32_t z=0;z<boxZ;z++)
-                ingredients.setLatticeEntry(x,y,z,0);
- 
-for(int32_t i=0;i<ingredients.getMolecules().size();i++){
-  VectorInt3 pos=ingredients.getMolecules()[i];
-  int32_t type=ingredients.getMolecules()[i].getAttributeTag();
-  
-  if(type!=TAILTAG) continue;
-  
-  VectorInt3 dx(1,0,0);
-  VectorInt3 dy(0,1,0);
-  VectorInt3 dz(0,0,1);
-  
-  ingredients.setLatticeEntry(pos,type);
-  ingredients.setLatticeEntry(pos+dx,type);
-  ingredients.setLatticeEntry(pos+dy,type);
-  ingredients.setLatticeEntry(pos+dx+dy,type);
-  ingredients.setLatticeEntry(pos+dz,type);
-  ingredients.setLatticeEntry(pos+dz+dx,type);
-  ingredients.setLatticeEntry(pos+dz+dy,type);
-  ingredients.setLatticeEntry(pos+dz+dx+dy,type);
- }
- 
-} 
-
-/**
-* @details Find the lattice sites in x-y plane which are occupied with tail monomers.
+* @details Find the lattice sites in x-y plane which are occupied with tail monomers,
+* i.e. project the cubes of all tail monomers onto the x-y plane.
 * 
 * @tparam IngredientsType Features used in the system. See Ingredients.
 */
@@ -310,19 +282,32 @@ for(int32_t i=0;i<ingredients.getMolecules().size();i++){
 template<class IngredientsType>
 void AnalyzerPoreFinder<IngredientsType>::tailOccupiedFinder(){
     
-   for(int32_t x=0;x<boxX;x++)
-       for(int32_t y=0;y<boxY;y++)
-           for(int32_t z=0;z<boxY;z++)
-               if(ingredients.getLatticeEntry(x,y,z)==TAILTAG){
-                   tailOccupied[x][y]=true;
-                   break;
-                 }
-               else
-                   tailOccupied[x][y]=false;
+    std::fill(tailOccupied.begin(),tailOccupied.end(),0);
+
+    for(int32_t i=0;i<ingredients.getMolecules().size();i++){
+        if(ingredients.getMolecules()[i].getAttributeTag()!=TAILTAG) continue;
+
+        int32_t x=ingredients.getMolecules()[i].getX()&boxXm_1;
+        int32_t y=ingredients.getMolecules()[i].getY()&boxYm_1;
+        int32_t xp1=(x+1)&boxXm_1;
+        int32_t yp1=(y+1)&boxYm_1;
+
+        tailOccupied[x*boxY+y]=1;
+        tailOccupied[xp1*boxY+y]=1;
+        tailOccupied[x*boxY+yp1]=1;
+        tailOccupied[xp1*boxY+yp1]=1;
+    }
 }
 
 /**
 * @details Analyse the cluster of points to find pore points on lattice.
+* The tail free sites are labelled with union-find. First, bands of
+* CLUSTER_ROWS_PER_BAND rows in x are labelled independently, then the clusters
+* across the band borders (including the periodic border in x) are joined.
+* As the smaller site index always becomes the root, the root of a cluster
+* is its first site in the order x*boxY+y. Clusters are stored in this order
+* and with their sites sorted, such that the first site of each cluster in
+* coordinatesOfPore is the reference point used in storeValues().
 * 
 * @tparam IngredientsType Features used in the system. See Ingredients.
 */
@@ -335,114 +320,74 @@ void AnalyzerPoreFinder<IngredientsType>::clusterAnalysis(){
     sizeOfCluster.resize(0);
     sizeOfCluster.push_back(0);
 
-    
-     // Outside do-while loop looks for points on lattice in x-y plane 
-     // which are free of lipids, once one such point is found, the inside 
-     // loop finds the cluster associated with this point. At the end, all 
-     // the clusters with the size bigger than CLUSTER_SIZE_THRESHOLD are saved 
-     // in coordinatesofPore for further processing.   
-     
-    do{
-        //Restart the clusterList
-        clusterList.resize(0);
-        //initial coordinate of point which is tail free 
-        VectorInt2 iniCoordinate=lookForLipidFreeSites();
-        
-        //If lookForLipidFreeSites returns an impossible coordinate
-        //this means all the lattice points have been looked upon.
-        // thus break the loop. 
-          
-        if(iniCoordinate.getX()==(boxX+1)) break;
-        
-        //Otherwise add this clusterList
-        clusterList.push_back(iniCoordinate);
-        int32_t lastUnChecked=0;
-         
-        do{
-             //check the for neigbours of the 
-             //lastUnChecked cluster points which are tail free
-            addNeigbours(lastUnChecked);
-            //increase the counter of unchecked lattice sites.
-            lastUnChecked++;
-           //If the lastUnChecked has yet gone through 
-            // all the clusterList, keep do-ing
-        }while(lastUnChecked!=clusterList.size());
-
-        //if clusterlist size is larger than threshold then save.
-        if(clusterList.size()>CLUSTER_SIZE_THRESHOLD){
-            sizeOfCluster.push_back(clusterList.size()+coordinatesOfPore.size());
-            coordinatesOfPore.insert(coordinatesOfPore.end(), clusterList.begin(), clusterList.end());
-        }
-        
-   }while(true);
-   
-   //Once the cluster is found, 
-    // store the values.
-   storeValues();
-}
+    const int32_t nSites=boxX*boxY;
+    const int32_t nBands=(boxX+CLUSTER_ROWS_PER_BAND-1)/CLUSTER_ROWS_PER_BAND;
 
-/**
-* @details Adds neigbours of a lattice point which are free of tails.
-* This function also sets tail occupied tag to true as an indicator 
-* that the lattice site has been checked before.  
-* 
-* @tparam IngredientsType Features used in the system. See Ingredients.
-*/
+    //label the bands independently. All sites touched here belong to the band.
+    #pragma omp parallel for schedule(static)
+    for(int32_t band=0;band<nBands;band++){
+        const int32_t xStart=band*CLUSTER_ROWS_PER_BAND;
+        const int32_t xEnd=std::min(boxX,xStart+CLUSTER_ROWS_PER_BAND);
 
-template<class IngredientsType>
-void AnalyzerPoreFinder<IngredientsType>::addNeigbours(int32_t lastUnChecked){
-    
-    VectorInt2 neigbourToPoint;
-    int32_t x,y;
-    VectorInt2 pointTobeChecked=clusterList[lastUnChecked];
-    
-    for(int32_t i=0;i<neigbours.size();i++){
-        
-        neigbourToPoint=pointTobeChecked+neigbours[i];
-        
-        //fold back in the case of boundary cases
-        x=(neigbourToPoint[0])&boxXm_1;
-        y=(neigbourToPoint[1])&boxYm_1;
-        
-        neigbourToPoint.setAllCoordinates(x,y);
-        
-         //If point was not checked before 
-         //add to list and set the checked 
-         //tag to true
-         
-        if(tailOccupied[x][y]==false){            
-            clusterList.push_back(neigbourToPoint);
-            tailOccupied[x][y]=true;
-        }
+        for(int32_t site=xStart*boxY;site<xEnd*boxY;site++)
+            clusterParent[site]=(tailOccupied[site] ? -1 : site);
+
+        for(int32_t x=xStart;x<xEnd;x++)
+            for(int32_t y=0;y<boxY;y++){
+                const int32_t site=x*boxY+y;
+                if(tailOccupied[site]) continue;
+
+                //neighbour in y with periodic boundary
+                const int32_t siteY=x*boxY+((y+1)&boxYm_1);
+                if(!tailOccupied[siteY]) uniteClusters(site,siteY);
+
+                //neighbour in x inside the band
+                if(x+1<xEnd && !tailOccupied[site+boxY]) uniteClusters(site,site+boxY);
+            }
     }
-    
-    tailOccupied[pointTobeChecked.getX()][pointTobeChecked.getY()]=true;
- }
- 
-/**
-* @details Find the and return lattice sites which are tail free and have not been checked before, 
-* If no point is found then send coordinates specific boxlength+1 to indicate to clusterAnalysis()
-* that search is over.
-*   
-* 
-* @tparam IngredientsType Features used in the system. See Ingredients.
-*/
 
-template<class IngredientsType>
-VectorInt2 AnalyzerPoreFinder<IngredientsType>::lookForLipidFreeSites(){
-    
-    for(int32_t x=0;x<boxX;x++)
+    //join the bands, the last band is joined with the first one (periodic boundary)
+    for(int32_t band=0;band<nBands;band++){
+        const int32_t xLast=std::min(boxX,(band+1)*CLUSTER_ROWS_PER_BAND)-1;
+        const int32_t xNext=(xLast+1)&boxXm_1;
         for(int32_t y=0;y<boxY;y++){
-            if(tailOccupied[x][y]==false){
-                tailOccupied[x][y]=true;
-                VectorInt2 vec(x,y);
-                return vec;
-            }
-            tailOccupied[x][y]=true;
+            const int32_t site=xLast*boxY+y;
+            const int32_t siteX=xNext*boxY+y;
+            if(!tailOccupied[site] && !tailOccupied[siteX]) uniteClusters(site,siteX);
         }
-    
-    VectorInt2 vec(boxX+1,boxY+1);
-    return vec;
+    }
+
+    //count the sites of every cluster
+    std::fill(clusterCount.begin(),clusterCount.end(),0);
+    for(int32_t site=0;site<nSites;site++)
+        if(!tailOccupied[site]) clusterCount[findClusterRoot(site)]++;
+
+    //if cluster size is larger than threshold then save. clusterCount
+    //is reused as the offset of the cluster in coordinatesOfPore
+    int32_t nPoreSites=0;
+    for(int32_t site=0;site<nSites;site++){
+        if(tailOccupied[site] || clusterParent[site]!=site) continue;
+        if(clusterCount[site]>CLUSTER_SIZE_THRESHOLD){
+            int32_t offset=nPoreSites;
+            nPoreSites+=clusterCount[site];
+            clusterCount[site]=offset;
+            sizeOfCluster.push_back(nPoreSites);
+        }
+        else
+            clusterCount[site]=-1;
+    }
+
+    coordinatesOfPore.resize(nPoreSites);
+    for(int32_t site=0;site<nSites;site++){
+        if(tailOccupied[site]) continue;
+        const int32_t root=findClusterRoot(site);
+        if(clusterCount[root]<0) continue;
+        coordinatesOfPore[clusterCount[root]++].setAllCoordinates(site/boxY,site%boxY);
+    }
+   
+   //Once the cluster is found, 
+    // store the values.
+   storeValues();
 }
 
 /**
@@ -34,6 +34,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/analyzer/AbstractAnalyzer.h>
 #include <LeMonADE/utility/ResultFormattingTools.h>
 #include <LeMonADE/utility/MonomerGroup.h>
+#include <LeMonADE/utility/GyrationTensor.h>
 
 /*************************************************************************
  * definition of AnalyzerRadiusOfGyration class
@@ -60,6 +61,11 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * If a more sophisticated grouping of monomers into groups is required, one can
  * also write a new analyzer, inheriting from AnalyzerRadiusOfGyration, and
  * overwriting the initialize function.
+ * For every group the full gyration tensor is calculated (see GyrationTensor),
+ * from the coordinates gathered into contiguous buffers. The groups are
+ * distributed over threads if LeMonADE is compiled with OpenMP. The tensors
+ * of the last call to execute() are available through getGyrationTensors(),
+ * e.g. for evaluating eigenvalues or asphericities in derived analyzers.
  */
 template < class IngredientsType > class AnalyzerRadiusOfGyration : public AbstractAnalyzer
 {
@@ -71,6 +77,8 @@ private:
 	const IngredientsType& ingredients;
 	//! Rg2 is calculated for the groups in this vector
 	std::vector<MonomerGroup<molecules_type> > groups;
+	//! gyration tensors of the groups, calculated in the last call to execute()
+	std::vector<GyrationTensor> gyrationTensors;
 	//! timeseries of the Rg^2. Components: [0]-> Rg^2_x, [1]->Rg^2_y, [2]->Rg^2_z, [3]:Rg^2_tot
 	std::vector< std::vector<double> > Rg2TimeSeries;
 	//! vector of mcs times for writing the time series
@@ -81,10 +89,10 @@ private:
 	std::string outputFile;
 	//! flag used in dumping time series output
 	bool isFirstFileDump;
+	//! text or binary output of the time series
+	ResultFormattingTools::OutputFormat outputFormat;
 	//! save the current values in Rg2TimeSeriesX, etc., to disk
 	void dumpTimeSeries();
-	//! calculate the Rg squared of the monomer group
-	VectorDouble3 calculateRg2Components(const MonomerGroup<molecules_type>& group) const;
 protected:
 	//! Set the groups to be analyzed. This function is meant to be used in initialize() of derived classes.
 	void setMonomerGroups(std::vector<MonomerGroup<molecules_type> > groupVector){groups=groupVector;}
@@ -106,6 +114,12 @@ public:
 	void setBufferSize(uint32_t size){bufferSize=size;}
 	//! Change the output file name
 	void setOutputFile(std::string filename){outputFile=filename;isFirstFileDump=true;}
+	//! Set the output format (initially ResultFormattingTools::getDefaultOutputFormat())
+	void setOutputFormat(ResultFormattingTools::OutputFormat format){outputFormat=format;isFirstFileDump=true;}
+	//! Get the output format
+	ResultFormattingTools::OutputFormat getOutputFormat() const {return outputFormat;}
+	//! Get the gyration tensors of all groups calculated in the last call to execute()
+	const std::vector<GyrationTensor>& getGyrationTensors() const {return gyrationTensors;}
 
 };
 
@@ -126,6 +140,7 @@ AnalyzerRadiusOfGyration<IngredientsType>::AnalyzerRadiusOfGyration(
 ,bufferSize(100)
 ,outputFile(filename)
 ,isFirstFileDump(true)
+,outputFormat(ResultFormattingTools::getDefaultOutputFormat())
 {
 }
 
@@ -150,18 +165,38 @@ void AnalyzerRadiusOfGyration<IngredientsType>::initialize()
 }
 
 /**
- * @details Calculates the current Rg2, saves it in the
- * time series, and saves the time series to disk in regular intervals.
+ * @details Calculates the gyration tensors of all groups and from these the
+ * current Rg2, saves it in the time series, and saves the time series to disk
+ * in regular intervals. The tensors of the groups are calculated in parallel,
+ * each thread using its own buffers for the coordinates. The average is taken
+ * afterwards in the order of the groups, such that the result does not
+ * depend on the number of threads.
  * */
 template< class IngredientsType >
 bool AnalyzerRadiusOfGyration<IngredientsType>::execute()
 {
+	const long nGroups=long(groups.size());
+	gyrationTensors.resize(nGroups);
+
+	#pragma omp parallel
+	{
+		std::vector<double> x,y,z;
+
+		#pragma omp for schedule(dynamic,16)
+		for(long n=0;n<nGroups;n++)
+		{
+			groups[n].gatherCoordinates(x,y,z);
+			if(x.empty()) gyrationTensors[n]=GyrationTensor();
+			else gyrationTensors[n].calculate(&x[0],&y[0],&z[0],x.size());
+		}
+	}
+
 	VectorDouble3 Rg2Components(0.0,0.0,0.0);
 
-	for(size_t n=0;n<groups.size();n++)
+	for(size_t n=0;n<gyrationTensors.size();n++)
 	{
 		//this vector will contain (Rg^2_x, Rg^2_y, Rg^2_z), i.e. the squared components!
-		Rg2Components+=calculateRg2Components(groups[n])/double(groups.size());
+		Rg2Components+=gyrationTensors[n].getRg2Components()/double(groups.size());
 	}
 
 	Rg2TimeSeries[0].push_back(Rg2Components.getX());
@@ -194,10 +229,7 @@ void AnalyzerRadiusOfGyration<IngredientsType>::cleanup()
 template<class IngredientsType>
 void AnalyzerRadiusOfGyration<IngredientsType>::dumpTimeSeries()
 {
-	//fist make a single vector<vector<double> > for writing the results
-	std::vector<std::vector<double> > resultsTimeseries=Rg2TimeSeries;
-	resultsTimeseries.insert(resultsTimeseries.begin(),MCSTimes);
-
+	//the mcs times are written as first column, Rg2TimeSeries is not copied
 	//if it is written for the first time, include comment in the output file
 	if(isFirstFileDump){
 		std::stringstream commentTimeSeries;
@@ -205,10 +237,12 @@ void AnalyzerRadiusOfGyration<IngredientsType>::dumpTimeSeries()
 		commentTimeSeries<<"file contains time series of average Rg_squared (Rg2) over all analyzed groups\n";
 		commentTimeSeries<<"format: mcs\t Rg2X\t Rg2Y\t Rg2Z\t Rg2Total\n";
 
-		ResultFormattingTools::writeResultFile(
+		ResultFormattingTools::writeOutputFile(
+			outputFormat,
 			outputFile,
 			ingredients,
-			resultsTimeseries,
+			MCSTimes,
+			Rg2TimeSeries,
 			commentTimeSeries.str()
 		);
 
@@ -216,8 +250,10 @@ void AnalyzerRadiusOfGyration<IngredientsType>::dumpTimeSeries()
 	}
 	//otherwise just append the new data
 	else{
-		ResultFormattingTools::appendToResultFile(outputFile,
-							  resultsTimeseries);
+		ResultFormattingTools::appendToOutputFile(outputFormat,
+							  outputFile,
+							  MCSTimes,
+							  Rg2TimeSeries);
 	}
 	//set all time series vectors back to zero size
 	MCSTimes.resize(0);
@@ -225,48 +261,6 @@ void AnalyzerRadiusOfGyration<IngredientsType>::dumpTimeSeries()
 	Rg2TimeSeries.resize(4,std::vector<double>(0));
 }
 
-/**
- * @details calculates the three components Rg^2_x, Rg^2_y,Rg^2_z and returns
- * them in a vector.
- * @return VectorDouble3 containing the components Rg^2_x, Rg^2_y,Rg^2_z, or (0.0,0.0,0.0) if group is empty)
- * @param group the monomer group of which the Rg2 is calculated
- * */
-template<class IngredientsType>
-VectorDouble3 AnalyzerRadiusOfGyration<IngredientsType>::calculateRg2Components(
-	const MonomerGroup<molecules_type>& group) const
-{
-	//if group is empty, return zero vector
-	if(group.size()==0){
-		return VectorDouble3(0.0,0.0,0.0);
-	}
-
-
-	VectorDouble3 sum_sqr; VectorDouble3 CoM_sum;
-	//first calculate the center of mass
-	for ( size_t n = 0; n < group.size(); ++n)
-	{
-		CoM_sum.setX( CoM_sum.getX() + group[n].getX() );
-		CoM_sum.setY( CoM_sum.getY() + group[n].getY() );
-		CoM_sum.setZ( CoM_sum.getZ() + group[n].getZ() );
-	}
-	double inv_N = 1.0 / double ( group.size() );
-
-	VectorDouble3 CoM (double ( CoM_sum.getX() ) * inv_N,
-			   double ( CoM_sum.getY() ) * inv_N,
-			   double ( CoM_sum.getZ() ) * inv_N);
-
-	//now calculate the Rg2 using the center of mass
-	for ( uint32_t n = 0; n < group.size(); ++n)
-	{
-		double diffX,diffY,diffZ;
-		diffX = double(group[n].getX()) - CoM.getX();
-		diffY = double(group[n].getY()) - CoM.getY();
-		diffZ = double(group[n].getZ()) - CoM.getZ();
-		sum_sqr +=VectorDouble3(diffX*diffX,diffY*diffY,diffZ*diffZ);
-	}
-	return sum_sqr / double ( group.size() );
-
-}
 #endif
 
 
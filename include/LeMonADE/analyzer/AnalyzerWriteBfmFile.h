@@ -39,6 +39,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/Version.h>
 #include <LeMonADE/analyzer/AbstractAnalyzer.h>
 #include <LeMonADE/io/AbstractWrite.h>
+#include <LeMonADE/io/CommandTable.h>
 #include <LeMonADE/utility/ResultFormattingTools.h>
 
 /***********************************************************************/
@@ -162,8 +163,11 @@ private:
   int myCommandWriteType;
 
   //bfm Write strings with associated write objects
-  //! Vector of pairs of Write-strings (e.g. !box_x) associated Write objects
-  std::vector < std::pair<std::string, SuperAbstractWrite*> > WriteObjects;
+  //! Table of Write-strings (e.g. !box_x) and associated Write objects, ids in order of registration
+  CommandTable<SuperAbstractWrite*> WriteObjects;
+
+  //! Id of the !mcs Write in WriteObjects, which is written last in every step
+  int32_t mcsWriteId;
 
   //init-flag to see if the initialize() routine was called. this
   //is necessary, because it opens the file and writes the header
@@ -187,7 +191,8 @@ private:
  */
 template <class IngredientsType>
 AnalyzerWriteBfmFile<IngredientsType>::AnalyzerWriteBfmFile(const std::string& filename, const IngredientsType& ing, int writeType)
-    :_filename(filename),ingredients(ing),myWriteType(writeType),isInitialized(false){}
+    :_filename(filename),ingredients(ing),myWriteType(writeType),
+    mcsWriteId(CommandTable<SuperAbstractWrite*>::notFound),isInitialized(false){}
 
 /***********************************************************************/
 //destructor
@@ -199,12 +204,10 @@ AnalyzerWriteBfmFile<IngredientsType>::AnalyzerWriteBfmFile(const std::string& f
 template<class IngredientsType>
 AnalyzerWriteBfmFile<IngredientsType>::~AnalyzerWriteBfmFile()
 {
-	std::vector< std::pair <std::string,SuperAbstractWrite*> >::iterator it;
-
-	for(it=WriteObjects.begin();it!=WriteObjects.end();++it)
+	for(size_t id=0;id<WriteObjects.size();id++)
 	{
-		delete it->second;
-		it->second=0;
+		delete WriteObjects[id];
+		WriteObjects[id]=0;
 	}
 	WriteObjects.clear();
 
@@ -224,22 +227,17 @@ template <class IngredientsType>
 void AnalyzerWriteBfmFile<IngredientsType>::registerWrite(std::string WriteString,SuperAbstractWrite* WriteObject){
 
 
-	std::vector< std::pair <std::string,SuperAbstractWrite*> >::iterator it;
-	//first check if the command string (WriteString) is already used for
-	//a different write
-	for(it=WriteObjects.begin();it!=WriteObjects.end();++it)
+	//register the write object, if the command string (WriteString) is not
+	//already used for a different write
+	std::pair<int32_t,bool> inserted=WriteObjects.insert(WriteString,WriteObject);
+	if(inserted.second==false)
 	{
-		if(it->first==WriteString)
-		{
-
-			std::stringstream errormessage;
-			errormessage<<"WriteBfmFile::registerWrite "
-					<<"Write string "<<WriteString<<" already used";
-			throw std::runtime_error(errormessage.str());
-		}
+		std::stringstream errormessage;
+		errormessage<<"WriteBfmFile::registerWrite "
+				<<"Write string "<<WriteString<<" already used";
+		throw std::runtime_error(errormessage.str());
 	}
-	//if we are still here, we can register the write object
-	WriteObjects.push_back(std::make_pair(WriteString,WriteObject));
+	if(WriteString=="!mcs") mcsWriteId=inserted.first;
 	std::cout <<  WriteString << " registered for writing\n";
 }
 
@@ -255,27 +253,21 @@ void AnalyzerWriteBfmFile<IngredientsType>::registerWrite(std::string WriteStrin
 template <class IngredientsType>
 void AnalyzerWriteBfmFile<IngredientsType>::replaceWrite(std::string WriteString,SuperAbstractWrite* NewWriteObject)
 {
-	bool stringReplaced=false;
-
-	std::vector< std::pair <std::string,SuperAbstractWrite*> >::iterator it;
 	//first check if the command string (WriteString) is already used for
 	//a different write
-	for(it=WriteObjects.begin();it!=WriteObjects.end();++it)
+	int32_t id=WriteObjects.find(WriteString);
+	if(id!=WriteObjects.notFound)
 	{
-		if(it->first==WriteString)
-		{
-			//get the pointer to the old write object and free the memory
-			SuperAbstractWrite* tmp= it->second;
-			it->second=0;
-			delete tmp;
-			//insert the new object instead
-			it->second=NewWriteObject;
-			std::cout<<"WARNING: REPLACED WRITE "<<WriteString<<std::endl;
-			stringReplaced=true;
-		}
+		//get the pointer to the old write object and free the memory
+		SuperAbstractWrite* tmp=WriteObjects[id];
+		WriteObjects[id]=0;
+		delete tmp;
+		//insert the new object instead
+		WriteObjects[id]=NewWriteObject;
+		std::cout<<"WARNING: REPLACED WRITE "<<WriteString<<std::endl;
 	}
 	//if the write object was not replaced, throw an exception
-	if(stringReplaced==false)
+	else
 	{
 		std::stringstream errormessage;
 		errormessage<<"WriteBfmFile::replaceWrite "
@@ -394,21 +386,17 @@ bool AnalyzerWriteBfmFile<IngredientsType>::execute(){
 
   if(myWriteType==OVERWRITE) startOverwriteNewFile(_filename);
 
-  std::vector< std::pair<std::string,SuperAbstractWrite*> >::iterator it;
-  SuperAbstractWrite* mcsCommand=0;
   //write all Writes that do not have the writeHeaderOnly flag set
-  for(it=WriteObjects.begin(); it!=WriteObjects.end(); ++it)
+  for(size_t id=0; id<WriteObjects.size(); id++)
   {
-	if(it->first=="!mcs") mcsCommand=it->second;
-	else if( (it->second)->writeHeaderOnly()==false)
+	if(int32_t(id)!=mcsWriteId && WriteObjects[id]->writeHeaderOnly()==false)
 	{
-		(it->second)->writeStream(file);
+		WriteObjects[id]->writeStream(file);
 	}
   }
   //if an !mcs was part of the write objects, write it now
   //the !mcs must always be written last in each step
-  if(mcsCommand!=0) mcsCommand->writeStream(file);
-  mcsCommand=0;
+  if(mcsWriteId!=WriteObjects.notFound) WriteObjects[mcsWriteId]->writeStream(file);
   return true;
 
 }
@@ -507,13 +495,12 @@ void AnalyzerWriteBfmFile<IngredientsType>::writeHeader()
 	file<<metadata.str();
 	file<<"########################################################\n\n";
 
-	std::vector<std::pair<std::string,SuperAbstractWrite*> >::iterator it;
 	//write all Writes, that have the writeHeaderOnly flag set
-	for(it=WriteObjects.begin(); it!=WriteObjects.end(); ++it)
+	for(size_t id=0; id<WriteObjects.size(); id++)
 	{
-		if( (it->second)->writeHeaderOnly())
+		if( WriteObjects[id]->writeHeaderOnly())
 		{
-			(it->second)->writeStream(file);
+			WriteObjects[id]->writeStream(file);
 
 		}
 	}
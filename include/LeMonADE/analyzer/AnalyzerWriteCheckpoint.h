@@ -0,0 +1,91 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_ANALYZER_ANALYZERWRITECHECKPOINT_H
+#define LEMONADE_ANALYZER_ANALYZERWRITECHECKPOINT_H
+
+#include <string>
+
+#include <LeMonADE/analyzer/AbstractAnalyzer.h>
+#include <LeMonADE/io/Checkpoint.h>
+
+/**
+ * @file
+ *
+ * @class AnalyzerWriteCheckpoint
+ *
+ * @brief Saves a checkpoint of the system in every execute()
+ *
+ * @details Every execute() replaces the checkpoint file by the current state
+ * (see saveCheckpoint()), such that the file always holds the last completed
+ * cycle. A simulation is restarted by calling loadCheckpoint() with the same
+ * feature set instead of reading a bfm-file.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information
+ */
+template<class IngredientsType>
+class AnalyzerWriteCheckpoint : public AbstractAnalyzer
+{
+public:
+	/**
+	 * @param filename name of the checkpoint file
+	 * @param ing the system to save
+	 * @param includeLattice if false, the lattice is not saved, but rebuilt on loading
+	 */
+	AnalyzerWriteCheckpoint(const std::string& filename, const IngredientsType& ing, bool includeLattice=true)
+	:ingredients(ing),checkpointFilename(filename),withLattice(includeLattice)
+	{}
+
+	virtual ~AnalyzerWriteCheckpoint(){}
+
+	virtual void initialize(){}
+
+	//! writes the checkpoint
+	virtual bool execute()
+	{
+		saveCheckpoint(checkpointFilename,ingredients,withLattice);
+		return true;
+	}
+
+	virtual void cleanup(){}
+
+	//! name of the checkpoint file
+	const std::string& getFilename() const {return checkpointFilename;}
+
+private:
+	//! the system to save
+	const IngredientsType& ingredients;
+
+	//! name of the checkpoint file
+	std::string checkpointFilename;
+
+	//! true if the lattice occupation is part of the checkpoint
+	bool withLattice;
+};
+
+#endif /* LEMONADE_ANALYZER_ANALYZERWRITECHECKPOINT_H */
@@ -97,12 +97,44 @@ public:
 	//! Returns the index of the i-th connection (bond partner) of the vertex.
 	uint32_t getNeighborIdx(uint32_t i) const;
 
+	//! Returns the index of the i-th connection without checking i against the number of links.
+	uint32_t getNeighborIdxUnchecked(uint32_t i) const {
+		return links[i];
+	}
+
 	//! Connect this Vertex (monomer) to another Vertex with index \a b.
 	void connect(int32_t b);
 
 	//! Disconnect this Vertex (monomer) from another Vertex with index \a b.
 	void disconnect(uint32_t b);
 
+	/**
+	 * @brief Returns the index of the bond vector to the i-th neighbor stored by setBondIndexUnchecked().
+	 *
+	 * @details The value is a cache owned by the user (see FeatureBondset). A new
+	 * link starts with getUnknownBondIndex(), and disconnect() keeps the stored
+	 * values aligned with the remaining links.
+	 */
+	uint16_t getBondIndexUnchecked(uint32_t i) const {
+		return bondIndices[i];
+	}
+
+	//! Stores the index of the bond vector to the i-th neighbor without checking i against the number of links.
+	void setBondIndexUnchecked(uint32_t i, uint16_t bondIndex) {
+		bondIndices[i] = bondIndex;
+	}
+
+	//! Returns the value marking a bond index which was not set since the link was made.
+	static uint16_t getUnknownBondIndex() {
+		return 0xFFFF;
+	}
+
+	//! Replaces every neighbor index i by newIndex[i], keeping the order of the links
+	void relabelLinks(const std::vector<uint32_t>& newIndex) {
+		for (uint32_t i = 0; i < counter; ++i)
+			links[i] = newIndex[links[i]];
+	}
+
 	/**********************************************************************/
 	//operators
 	/**********************************************************************/
@@ -118,6 +150,9 @@ private:
 	//! Array contains the indices of connected vertices
 	uint32_t links[max_connectivity];
 
+	//! Array contains the cached bond vector indices of the links (see getBondIndexUnchecked())
+	uint16_t bondIndices[max_connectivity];
+
 	//! Current number of connections
 	uint32_t counter;
 
@@ -148,6 +183,7 @@ Connected<Vertex,max_connectivity>::Connected(const Connected<V, MC>& src)
 	else {
 		for (uint i = 0; i < src.getNumLinks(); ++i) {
 			links[i] = src.getNeighborIdx(i);
+			bondIndices[i] = getUnknownBondIndex();
 		}
 		counter = src.getNumLinks();
 	}
@@ -171,6 +207,7 @@ void Connected<Vertex,max_connectivity>::operator=(const Connected<V, MC> &val){
 	else {
 		for (uint i = 0; i < val.getNumLinks(); ++i) {
 			links[i] = val.getNeighborIdx(i);
+			bondIndices[i] = getUnknownBondIndex();
 		}
 		counter = val.getNumLinks();
 	}
@@ -227,6 +264,7 @@ void Connected<Vertex,max_connectivity>::connect(int32_t b) {
 	checkMaxConnectivity();
 
 	links[counter] = uint32_t (b);
+	bondIndices[counter] = getUnknownBondIndex();
 	counter++;
 }
 
@@ -254,6 +292,7 @@ void Connected<Vertex,max_connectivity>::disconnect(uint32_t b) {
 	else {
 		for (; i < counter - 1; ++i) {
 			links[i] = links[i + 1];
+			bondIndices[i] = bondIndices[i + 1];
 		}
 		--counter;
 	}
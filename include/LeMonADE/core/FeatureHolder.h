@@ -30,6 +30,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <cxxabi.h>
+#include <typeinfo>
 
 #include "extern/loki/Typelist.h"
 #include "extern/loki/TypelistMacros.h"
@@ -157,6 +158,60 @@ public:
 	Feature::synchronize(ingredients); Base::synchronize(ingredients);
   }
 
+  /**
+   * @brief Writes the state of all Features into a checkpoint.
+   *
+   * @details Every Feature gets its own section, named after its type, such that
+   * reading a checkpoint with a different set of Features fails with an error.
+   *
+   * @param ingredients A reference to the IngredientsType - mainly the system.
+   * @param checkpoint The checkpoint to write to (e.g. CheckpointWriter).
+   */
+  template < class IngredientsType, class CheckpointOut >
+  void writeCheckpoint(const IngredientsType& ingredients, CheckpointOut& checkpoint) const
+  {
+	checkpoint.beginSection(typeid(Feature).name());
+	Feature::writeCheckpoint(ingredients,checkpoint);
+	checkpoint.endSection();
+	Base   ::writeCheckpoint(ingredients,checkpoint);
+  }
+
+  /**
+   * @brief Restores the state of all Features from a checkpoint.
+   *
+   * @details Features which can not restore their state from the checkpoint
+   * (Feature::readCheckpoint() returns false) are synchronized instead. This
+   * happens in the same order as in synchronize().
+   *
+   * @param ingredients A reference to the IngredientsType - mainly the system.
+   * @param checkpoint The checkpoint to read from (e.g. CheckpointReader).
+   * @return always true
+   */
+  template < class IngredientsType, class CheckpointIn >
+  bool readCheckpoint(IngredientsType& ingredients, CheckpointIn& checkpoint)
+  {
+	checkpoint.beginSection(typeid(Feature).name());
+	if(!Feature::readCheckpoint(ingredients,checkpoint))
+		Feature::synchronize(ingredients);
+	checkpoint.endSection();
+	Base   ::readCheckpoint(ingredients,checkpoint);
+	return true;
+  }
+
+  /**
+   * @brief Collects the energies of all Features.
+   *
+   * @details It delegates the report to all Features and Base, such that
+   * the energies are added in the order of the features.
+   *
+   * @param report The report collecting the energies (e.g. EnergyReport).
+   */
+  template < class EnergyReportType > void reportEnergy(EnergyReportType& report) const
+  {
+	Feature::reportEnergy(report);
+	Base   ::reportEnergy(report);
+  }
+
 };
 
 #endif /* LEMONADE_CORE_FEATUREHOLDER_H_ */
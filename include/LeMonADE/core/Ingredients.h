@@ -234,6 +234,34 @@ public:
 		context_type::synchronize(ing);
 	}
 
+	/**
+	 * @brief Writes the state of all Features into a checkpoint.
+	 *
+	 * @details Calls context_type::writeCheckpoint(Ingredients&,CheckpointOut&).
+	 * The molecules are not part of this, see saveCheckpoint() in io/Checkpoint.h.
+	 *
+	 * @param checkpoint The checkpoint to write to.
+	 */
+	template<class CheckpointOut>
+	void writeCheckpoint(CheckpointOut& checkpoint) const
+	{
+		context_type::writeCheckpoint(*this,checkpoint);
+	}
+
+	/**
+	 * @brief Restores the state of all Features from a checkpoint.
+	 *
+	 * @details Calls context_type::readCheckpoint(Ingredients&,CheckpointIn&).
+	 * Features without checkpoint support are synchronized individually.
+	 *
+	 * @param checkpoint The checkpoint to read from.
+	 */
+	template<class CheckpointIn>
+	void readCheckpoint(CheckpointIn& checkpoint)
+	{
+		context_type::readCheckpoint(*this,checkpoint);
+	}
+
 	/**
 	 * @brief Export the relevant functionality of all meta-information and molecules
 	 * for reading bfm-files.
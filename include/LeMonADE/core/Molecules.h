@@ -31,8 +31,11 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <sstream>
 #include <stdint.h>
 #include <stdexcept>
+#include <type_traits>
 
 #include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
 #include <LeMonADE/core/ConnectedDecorator.h>
@@ -245,6 +248,29 @@ template < class Vertex, uint max_connectivity = 7, class Edge = int > class Mol
    */
   Vertex& operator[](uint32_t idx)	{return vertices.at(idx);}
 
+  /**
+   * @brief Provides access to the vertex (monomer) with index \a idx without boundary check.
+   *
+   * @details Meant for tight loops (e.g. gathering coordinates of a monomer group),
+   * where the index is known to be valid. Use operator[] otherwise.
+   *
+   * @param idx The index of vertex (monomer) in the graph.
+   * @return The vertex (monomer) in the graph with index \a idx.
+   */
+  const Vertex& getVertexUnchecked(uint32_t idx) const {return vertices[idx];}
+
+  //! Same as getNumLinks(), but without boundary check
+  uint32_t getNumLinksUnchecked(uint32_t idx) const {return vertices[idx].getNumLinks();}
+
+  //! Same as getNeighborIdx(), but without boundary checks
+  uint32_t getNeighborIdxUnchecked(uint32_t idx, uint32_t j) const {return vertices[idx].getNeighborIdxUnchecked(j);}
+
+  //! Returns the bond vector index cached on the j-th link of vertex idx, without boundary checks (see Connected::getBondIndexUnchecked())
+  uint16_t getBondIndexUnchecked(uint32_t idx, uint32_t j) const {return vertices[idx].getBondIndexUnchecked(j);}
+
+  //! Caches a bond vector index on the j-th link of vertex idx, without boundary checks
+  void setBondIndexUnchecked(uint32_t idx, uint32_t j, uint16_t bondIndex) {vertices[idx].setBondIndexUnchecked(j,bondIndex);}
+
   //! Returns the information \a Edge stored on the connection (bond) between vertices with indices a and b
   const Edge& getLinkInfo(uint32_t a, uint32_t b) const;
 
@@ -269,6 +295,15 @@ template < class Vertex, uint max_connectivity = 7, class Edge = int > class Mol
   //! returns the edges of the graph 
   std::map < std::pair < uint32_t, uint32_t > , Edge > getEdges() const {return edges;}
 
+  //! Writes age, vertices (incl. links) and edges as raw data into a checkpoint
+  template < class CheckpointOut > void writeCheckpoint(CheckpointOut& checkpoint) const;
+
+  //! Restores age, vertices and edges from a checkpoint written by writeCheckpoint()
+  template < class CheckpointIn > void readCheckpoint(CheckpointIn& checkpoint);
+
+  //! Reorders the vertices such that the new vertex i is the old vertex order[i]. Links and edges are renumbered accordingly
+  void permute(const std::vector<uint32_t>& order);
+
 private:
 
   /**
@@ -518,6 +553,107 @@ uint32_t Molecules <Vertex,max_connectivity,Edge>::getNeighborIdx(uint32_t idx,
 }
 
 
+/**
+ * @details The vertices are written as raw memory including their neighbor
+ * lists. The vertex type and thus all monomer extensions therefore have to be
+ * trivially copyable, which is checked at compile time.
+ * @param checkpoint the checkpoint to write to (e.g. CheckpointWriter)
+ */
+template < class Vertex, uint max_connectivity, class Edge>
+template < class CheckpointOut >
+void Molecules <Vertex,max_connectivity,Edge>::writeCheckpoint(CheckpointOut& checkpoint) const
+{
+	static_assert(std::is_trivially_copyable<internal_vertex_type>::value,"Molecules::writeCheckpoint: vertex type must be trivially copyable");
+	checkpoint.write(myAge);
+	checkpoint.writeVector(vertices);
+
+	uint64_t nEdges=edges.size();
+	checkpoint.write(nEdges);
+	for(typename std::map < IndexPair, Edge >::const_iterator it=edges.begin();it!=edges.end();++it)
+	{
+		checkpoint.write(it->first.first);
+		checkpoint.write(it->first.second);
+		checkpoint.write(it->second);
+	}
+}
+
+/**
+ * @details The current content of the graph is replaced. The edges are
+ * inserted in the (sorted) order they were written in, which takes constant
+ * time per edge.
+ * @param checkpoint the checkpoint to read from (e.g. CheckpointReader)
+ */
+template < class Vertex, uint max_connectivity, class Edge>
+template < class CheckpointIn >
+void Molecules <Vertex,max_connectivity,Edge>::readCheckpoint(CheckpointIn& checkpoint)
+{
+	checkpoint.read(myAge);
+	checkpoint.readVector(vertices);
+
+	edges.clear();
+	uint64_t nEdges;
+	checkpoint.read(nEdges);
+	for(uint64_t n=0;n<nEdges;n++)
+	{
+		std::pair<IndexPair,Edge> edge;
+		checkpoint.read(edge.first.first);
+		checkpoint.read(edge.first.second);
+		checkpoint.read(edge.second);
+		edges.insert(edges.end(),edge);
+	}
+}
+
+/**
+ * @details The vertices keep their content and their connectivity, only
+ * their indices change: the vertex at index order[i] is moved to index i, and
+ * all neighbor lists and the keys of the edges map are renumbered. The order
+ * of the links of each vertex is kept. Features holding per-index information
+ * outside of the vertices have to be synchronized afterwards.
+ *
+ * @throw <std::runtime_error> if order is not a permutation of 0...size()-1
+ * @param order order[i] is the old index of the vertex moved to index i
+ */
+template < class Vertex, uint max_connectivity, class Edge>
+void Molecules <Vertex,max_connectivity,Edge>::permute(const std::vector<uint32_t>& order)
+{
+	const uint32_t nVertices=vertices.size();
+	if(order.size()!=nVertices){
+		std::stringstream errormessage;
+		errormessage<<"Molecules::permute(): permutation has size "<<order.size()<<", but graph has "<<nVertices<<" vertices";
+		throw std::runtime_error(errormessage.str());
+	}
+
+	//invert the permutation, detecting duplicate and out of range entries
+	std::vector<uint32_t> newIndex(nVertices,nVertices);
+	for(uint32_t i=0;i<nVertices;i++)
+	{
+		if(order[i]>=nVertices || newIndex[order[i]]!=nVertices){
+			std::stringstream errormessage;
+			errormessage<<"Molecules::permute(): entry "<<i<<" ("<<order[i]<<") is out of range or appears twice";
+			throw std::runtime_error(errormessage.str());
+		}
+		newIndex[order[i]]=i;
+	}
+
+	std::vector < internal_vertex_type > permutedVertices;
+	permutedVertices.reserve(nVertices);
+	for(uint32_t i=0;i<nVertices;i++)
+	{
+		permutedVertices.push_back(vertices[order[i]]);
+		permutedVertices.back().relabelLinks(newIndex);
+	}
+	vertices.swap(permutedVertices);
+
+	std::map < IndexPair, Edge > permutedEdges;
+	for(typename std::map < IndexPair, Edge >::const_iterator it=edges.begin();it!=edges.end();++it)
+	{
+		uint32_t a=newIndex[it->first.first];
+		uint32_t b=newIndex[it->first.second];
+		permutedEdges.insert(std::make_pair(IndexPair(std::min(a,b),std::max(a,b)),it->second));
+	}
+	edges.swap(permutedEdges);
+}
+
 /**
  * @param a The index \a a of vertex (monomer) in the graph.
  * @param b The index \a b of vertex (monomer) in the graph.
@@ -561,4 +561,106 @@ template<class IngredientsType> void ReadMcs<IngredientsType>::processSolventCon
 
 
 
+/***********************************************************************/
+/**
+ * @class ReadMcsDelta
+ * @brief Handles BFM-File-Reads \b !mcs_delta.
+ *
+ * @details A \b !mcs_delta frame sets the age and the positions of the
+ * monomers that moved since the previous frame in the file, given as lines
+ * "index x y z" with the index starting at 1. All other monomers keep their
+ * positions, i.e. the frame is only meaningful on top of the preceeding frames
+ * back to the last \b !mcs. FileImport::gotoMcs() takes care of this.
+ * The command line \b !mcs_delta=mcs base=mcs monomers=n names the mcs of
+ * the frame the delta applies to and the number of monomers, both are
+ * compared to the current state of the destination.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information.
+ **/
+template < class IngredientsType >
+class ReadMcsDelta: public ReadToDestination < IngredientsType >
+{
+public:
+  ReadMcsDelta(IngredientsType& destination):ReadToDestination< IngredientsType > (destination){}
+  void execute();
+};
+
+/***********************************************************************/
+/**
+ * @brief Executes the reading routine to extract \b !mcs_delta.
+ *
+ * @throw <std::runtime_error> if the Monte-Carlo-Step or a line could not be parsed, if a monomer index is out of range,
+ * or if the base frame or the number of monomers does not match the destination.
+ **/
+template < class IngredientsType > void ReadMcsDelta< IngredientsType >::execute()
+{
+  typename IngredientsType::molecules_type& molecules = this->getDestination().modifyMolecules();
+
+  unsigned long mcs;
+  std::string line;
+  std::streampos previous;
+
+  this->getInputStream()>>mcs;
+  if(this->getInputStream().fail()){
+    std::stringstream errormessage;
+    errormessage<<"ReadMcsDelta<IngredientsType>::execute()\n"
+		<<"Could not read mcs number. Previous mcs number was "<<molecules.getAge();
+    throw std::runtime_error(errormessage.str());
+  }
+
+  //the rest of the command line holds the base frame and the number of monomers
+  getline(this->getInputStream(),line);
+  std::stringstream header(line);
+  std::string token;
+  unsigned long base=0, nMonomers=0;
+  bool hasBase=false, hasMonomers=false;
+  while(header>>token){
+    std::stringstream value(token.substr(token.find('=')+1));
+    if(token.compare(0,5,"base=")==0) hasBase=bool(value>>base);
+    else if(token.compare(0,9,"monomers=")==0) hasMonomers=bool(value>>nMonomers);
+  }
+  if(!hasBase || !hasMonomers){
+    std::stringstream errormessage;
+    errormessage<<"ReadMcsDelta<IngredientsType>::execute()\n"
+		<<"Could not read base frame and number of monomers of mcs "<<mcs;
+    throw std::runtime_error(errormessage.str());
+  }
+  if(base!=molecules.getAge() || nMonomers!=molecules.size()){
+    std::stringstream errormessage;
+    errormessage<<"ReadMcsDelta<IngredientsType>::execute()\n"
+		<<"Delta frame mcs "<<mcs<<" is based on mcs "<<base<<" with "<<nMonomers<<" monomers, "
+		<<"but the current frame is mcs "<<molecules.getAge()<<" with "<<molecules.size()<<" monomers";
+    throw std::runtime_error(errormessage.str());
+  }
+  molecules.setAge(mcs);
+
+  previous=this->getInputStream().tellg();
+  getline(this->getInputStream(),line);
+
+  while(!line.empty() && !this->getInputStream().fail()){
+
+	  //if the line contains a bfm Read, stop the procedure and set the get pointer back
+	  if(this->detectRead(line)){
+		  this->getInputStream().seekg(previous);
+		  return;
+	  }
+
+	  std::stringstream stream(line);
+	  uint32_t index;
+	  int32_t x,y,z;
+	  stream>>index>>x>>y>>z;
+
+	  if(stream.fail() || index<1 || index>molecules.size()){
+		  std::stringstream errormessage;
+		  errormessage<<"ReadMcsDelta<IngredientsType>::execute()\n"
+				  <<"Could not read monomer position \""<<line<<"\" in mcs "<<mcs;
+		  throw std::runtime_error(errormessage.str());
+	  }
+	  molecules[index-1].setAllCoordinates(x,y,z);
+
+	  previous=this->getInputStream().tellg();
+	  getline(this->getInputStream(),line);
+  }
+}
+
 #endif /* LEMONADE_CORE_MOLECULESREAD_H */
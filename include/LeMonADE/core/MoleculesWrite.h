@@ -42,7 +42,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 /**
  * @file
  * @brief Writing routines for bfm-Reads !number_of_monomers !bonds, !mcs,
- * !add_bonds and !remove_bonds
+ * !add_bonds and !remove_bonds. !mcs may be written as !mcs_delta, see WriteMcs.
  **/
 /***********************************************************************/
 
@@ -71,29 +71,117 @@ public:
  * @class WriteMcs
  * @brief Handles BFM-File-Write \b !mcs.
  *
+ * @details If the source has a keyframe interval larger than one
+ * (getMcsKeyframeInterval()), only every n-th frame is written as complete
+ * conformation \b !mcs. The frames in between are written as \b !mcs_delta,
+ * which lists only the monomers that moved since the previously written frame,
+ * one line "index x y z" per monomer (index starting with 1). The command line
+ * \b !mcs_delta=mcs base=mcs monomers=n also names the mcs of the frame the
+ * delta is based on and the number of monomers, so that a reader can detect
+ * a delta applied to the wrong frame. The moved
+ * monomers are found by comparing to a copy of the positions written last.
+ * A keyframe is always written for the first frame, if the number of monomers
+ * changed, and if the file is overwritten in every step.
+ *
  * @tparam IngredientsType Ingredients class storing all system information.
  **/
 template <class IngredientsType>
 class WriteMcs: public AbstractWrite<IngredientsType>
 {
+	enum BFM_WRITE_TYPE_EXPANDED{
+	  C_APPEND=3,	//!< The configuration (excl. header) is append to the file
+	  C_OVERWRITE=4,  //!< The configuration (incl. header) overwrites the existing file
+	  C_NEWFILE=5,	//!< The configuration (incl. header) is written to a new file
+	  C_APPNOFILE=6,	//!< The file doenst exist
+	};
+
 public:
-	//! Writes \b !mcs in every output of the bfm-file.
-	WriteMcs(const IngredientsType& src):AbstractWrite<IngredientsType>(src){};
+	//! Writes \b !mcs (or \b !mcs_delta) in every output of the bfm-file.
+	WriteMcs(const IngredientsType& src, int writeType=C_APPEND)
+	:AbstractWrite<IngredientsType>(src),myWriteType(writeType),framesSinceKeyframe(0),lastWrittenMcs(0){};
 	void writeStream(std::ostream& strm);
 
 private:
+	void writeKeyframe(std::ostream&) const;
+	void writeDeltaFrame(std::ostream&);
 	std::string writeSolventBlock(std::pair<size_t,size_t>) const;
 	std::string compressNumber(int32_t) const;
 	int32_t foldBack(int32_t,uint32_t) const;
 	//!maximum length of a line in compressed solvent format
 	static const int32_t maxLineLength=200;
+
+	//! ENUM-type BFM_WRITE_TYPE specify the write-out
+	int myWriteType;
+	//! number of delta frames written since the last keyframe
+	uint32_t framesSinceKeyframe;
+	//! mcs of the frame written last (only used for delta frames)
+	uint64_t lastWrittenMcs;
+	//! positions of all monomers in the frame written last (only used for delta frames)
+	std::vector<VectorInt3> lastWrittenPositions;
 };
 
 /*******************Implementation of members  ******************************/
 
-//! Executes the routine to write \b !mcs.
+//! Executes the routine to write \b !mcs or \b !mcs_delta.
 template <class IngredientsType>
 void WriteMcs<IngredientsType>::writeStream(std::ostream& strm)
+{
+	const typename IngredientsType::molecules_type& molecules(this->getSource().getMolecules());
+	const uint32_t keyframeInterval=this->getSource().getMcsKeyframeInterval();
+
+	//first the frame is written into this stringstream
+	std::stringstream contents;
+
+	if(keyframeInterval<=1)
+	{
+		writeKeyframe(contents);
+		lastWrittenPositions.clear();
+	}
+	else if(myWriteType==C_OVERWRITE
+		|| lastWrittenPositions.size()!=molecules.size()
+		|| framesSinceKeyframe+1>=keyframeInterval)
+	{
+		writeKeyframe(contents);
+		framesSinceKeyframe=0;
+		lastWrittenPositions.resize(molecules.size());
+		for(size_t n=0;n<molecules.size();n++)
+			lastWrittenPositions[n]=molecules[n].getVector3D();
+		lastWrittenMcs=molecules.getAge();
+	}
+	else
+	{
+		writeDeltaFrame(contents);
+		framesSinceKeyframe++;
+	}
+
+	strm << contents.str();
+	strm.flush();
+}
+
+//! Writes the monomers moved since the last frame as \b !mcs_delta and updates the stored positions.
+template <class IngredientsType>
+void WriteMcs<IngredientsType>::writeDeltaFrame(std::ostream& contents)
+{
+	const typename IngredientsType::molecules_type& molecules(this->getSource().getMolecules());
+
+	contents<<"\n!mcs_delta="<< molecules.getAge()
+		<<" base="<<lastWrittenMcs<<" monomers="<<molecules.size();
+	for(size_t n=0;n<molecules.size();n++)
+	{
+		const VectorInt3& position=molecules[n].getVector3D();
+		if(!(position==lastWrittenPositions[n]))
+		{
+			contents<<"\n"<<n+1<<" "<<position;
+			lastWrittenPositions[n]=position;
+		}
+	}
+	lastWrittenMcs=molecules.getAge();
+	contents<<"\n\n";
+}
+
+//! Writes the complete conformation as \b !mcs.
+template <class IngredientsType>
+void WriteMcs<IngredientsType>::writeKeyframe(std::ostream& contents) const
 {
 	//get references to molecules
 	const typename IngredientsType::molecules_type& molecules(this->getSource().getMolecules());
@@ -106,9 +194,6 @@ void WriteMcs<IngredientsType>::writeStream(std::ostream& strm)
 	if(compressedIndices.size()!=0) itCompressedIndices=compressedIndices.begin();
 	else itCompressedIndices=compressedIndices.end();
 
-	//first the mcs is written into this stringstream
-	std::stringstream contents;
-
 	//write command and age
 	contents<<"\n!mcs="<< molecules.getAge();
     VectorInt3  dummyPosition;
@@ -168,9 +253,6 @@ void WriteMcs<IngredientsType>::writeStream(std::ostream& strm)
     }
 
 	contents<<"\n\n";
-	contents.flush();
-	strm << contents.str();
-	strm.flush();
 }
 
 /**
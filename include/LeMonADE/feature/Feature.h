@@ -127,6 +127,46 @@ public:
    */
   template < class IngredientsType > void synchronize(IngredientsType& ingredients) {};
 
+  /**
+   * @brief Writes the state of the Feature into a checkpoint. Does Nothing.
+   *
+   * @details Features holding state which can not be reconstructed from the
+   * molecules (e.g. box size, bondset) or which is expensive to reconstruct
+   * (e.g. lattice occupation) override this function together with readCheckpoint().
+   * See CheckpointWriter for the available write functions.
+   *
+   * @param ingredients A reference to the IngredientsType - mainly the system.
+   * @param checkpoint The checkpoint to write to.
+   */
+  template < class IngredientsType, class CheckpointOut >
+  void writeCheckpoint(const IngredientsType&, CheckpointOut&) const {}
+
+  /**
+   * @brief Restores the state of the Feature from a checkpoint.
+   *
+   * @details Reads back what was written by writeCheckpoint(). The default
+   * implementation reads nothing and returns false, such that the Feature is
+   * synchronized instead (see FeatureHolder::readCheckpoint()).
+   *
+   * @param ingredients A reference to the IngredientsType - mainly the system.
+   * @param checkpoint The checkpoint to read from.
+   * @return true if the Feature is consistent with the system without synchronization
+   */
+  template < class IngredientsType, class CheckpointIn >
+  bool readCheckpoint(IngredientsType&, CheckpointIn&) {return false;}
+
+  /**
+   * @brief Adds the energy of the Feature to a report. Does Nothing.
+   *
+   * @details Features contributing to the energy of the system keep its
+   * current value and override this function to add it to the report
+   * (see EnergyReport::addEnergy()).
+   *
+   * @param report The report collecting the energies of all Features.
+   */
+  template < class EnergyReportType >
+  void reportEnergy(EnergyReportType&) const {}
+
   /**
    * @brief Overloaded function to stream all metadata to an output stream.
    *
@@ -36,12 +36,15 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @brief Definition and implementation of class template FeatureBendingPotential
 **/
 
+#include <cmath>
+
 #include <LeMonADE/feature/Feature.h>
 #include <LeMonADE/updater/moves/MoveBase.h>
 #include <LeMonADE/updater/moves/MoveLocalSc.h>
 #include <LeMonADE/feature/FeatureBoltzmann.h>
 #include <LeMonADE/feature/FeatureAttributes.h>
 #include <LeMonADE/feature/FeatureBendingPotentialReadWrite.h>
+#include <LeMonADE/utility/LastCheckedMove.h>
 
 
 
@@ -89,7 +92,10 @@ namespace BendingPotentials
  * This reduces memory requirements. This feature throws runtime_error if opposite is done.<br>
  * (ii)The type can be any integer between 1 and 10.<br>
  * The feature adds the bfm-file command !bending_potential A energy
- * for monomers of type A with bending potential of E in kT
+ * for monomers of type A with bending potential of E in kT.
+ * The feature keeps the total bending energy of the system, which is
+ * recalculated by setChainEnds() and synchronize() and updated with the
+ * energy difference of every applied MoveLocalSc.
  **/
 
 class FeatureBendingPotential:public Feature
@@ -109,6 +115,12 @@ private:
     //! Lookup to tag chains ends and their neigbours.
     std::vector <int32_t> chainsEnds;
 
+    //! Total bending energy of the system
+    double bendingEnergy;
+
+    //! Factor of the last checked move, also stored as 1 for monomers without bending strength
+    mutable LastCheckedMove lastChecked;
+
     //! Returns this feature's factor for the acceptance probability for the given Monte Carlo move and type.
     template<class IngredientsType> 
     double calculateAcceptanceProbability(const IngredientsType& ingredients,
@@ -143,6 +155,18 @@ public:
     //! check for standard sc-BFM local move
     template<class IngredientsType>
     bool checkMove(const IngredientsType& ingredients,MoveLocalSc& move) const;
+
+    //! apply function for all Monte Carlo moves without special apply functions (does nothing)
+    template<class IngredientsType>
+    void applyMove(const IngredientsType&, const MoveBase&){}
+
+    //! apply function for sc-BFM local move, updates the bending energy
+    template<class IngredientsType>
+    void applyMove(const IngredientsType& ing, const MoveLocalSc& move);
+
+    //! recalculates the bending energy, if the chain ends are set up
+    template<class IngredientsType>
+    void synchronize(IngredientsType& ingredients);
     
     //! This is simple function to convert bond vector to integer ID in one to one mapping. 
     uint32_t bondVectorToIndex(const VectorInt3& bondVector) const;                                     
@@ -158,6 +182,18 @@ public:
     //!returns the bending potential strength for type.
     double getBendingPotential(int32_t type) const;
 
+    //!returns the total bending energy of the system in kT
+    double getBendingEnergy() const {return bendingEnergy;}
+
+    //!calculates the total bending energy of the system from the positions
+    template<class IngredientsType>
+    double calculateBendingEnergy(const IngredientsType& ingredients) const;
+
+    //!adds the bending energy to report (see EnergyReport)
+    template<class EnergyReportType>
+    void reportEnergy(EnergyReportType& report) const
+    {report.addEnergy("FeatureBendingPotential",bendingEnergy);}
+
     //!export bfm-file read command !bending_potential
     template<class IngredientsType>
     void exportRead(FileImport <IngredientsType>& fileReader);
@@ -166,6 +202,27 @@ public:
     template<class IngredientsType>
     void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& fileWriter) const;
 
+    //!writes the potential strengths, their probability lookup and the chain end tags into a checkpoint
+    template<class IngredientsType, class CheckpointOut>
+    void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+    {
+        checkpoint.write(numNonSolvent);
+        checkpoint.writeArray(bpStrengthTable,11);
+        checkpoint.writeArray(&probabilityLookup[0][0][0],11*180*180);
+        checkpoint.writeVector(chainsEnds);
+    }
+
+    //!restores the state written by writeCheckpoint(). The bending energy is recalculated in synchronize()
+    template<class IngredientsType, class CheckpointIn>
+    bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+    {
+        checkpoint.read(numNonSolvent);
+        checkpoint.readArray(bpStrengthTable,11);
+        checkpoint.readArray(&probabilityLookup[0][0][0],11*180*180);
+        checkpoint.readVector(chainsEnds);
+        return false;
+    }
+
 };
 
 
@@ -176,6 +233,7 @@ public:
  **/
 
 FeatureBendingPotential::FeatureBendingPotential()
+:numNonSolvent(0),bendingEnergy(0.0)
 {
   //initialize the bpStrengthTable and probability lookups with default values
   for(size_t n=0;n<11;n++)
@@ -206,13 +264,93 @@ bool FeatureBendingPotential::checkMove(const IngredientsType& ingredients,
   //if monoType has zero strength then returns true without making any change in 
   //probability
   int32_t monoType=ingredients.getMolecules()[move.getIndex()].getAttributeTag();
-  if(!bpStrengthTable[monoType]) return true;
+  if(!bpStrengthTable[monoType])
+  {
+    lastChecked.set(move.getIndex(),move.getDir(),1.0);
+    return true;
+  }
   
   double prob=calculateAcceptanceProbability(ingredients,move,monoType);
   move.multiplyProbability(prob);
+  lastChecked.set(move.getIndex(),move.getDir(),prob);
   return true;
 }
 
+/**
+ * @details Updates the bending energy. If the move is the one checked last,
+ * the energy difference is obtained from its probability factor exp(-dE),
+ * otherwise the factor is calculated again from the bond angles at the chain
+ * ends known from setChainEnds().
+ *
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] move Monte Carlo move of type MoveLocalSc
+ **/
+template<class IngredientsType>
+void FeatureBendingPotential::applyMove(const IngredientsType& ingredients,
+                                        const MoveLocalSc& move)
+{
+  if(lastChecked.matches(move.getIndex(),move.getDir()))
+  {
+    bendingEnergy+=lastChecked.getEnergyDifference();
+    return;
+  }
+
+  int32_t monoType=ingredients.getMolecules()[move.getIndex()].getAttributeTag();
+  if(!bpStrengthTable[monoType] || move.getIndex()>=chainsEnds.size()) return;
+
+  //no change of the angles is the most frequent case and needs no logarithm
+  double prob=calculateAcceptanceProbability(ingredients,move,monoType);
+  if(prob!=1.0)
+    bendingEnergy-=std::log(prob);
+}
+
+/**
+ * @details The energy can only be calculated once the chain ends are known,
+ * i.e. after setChainEnds() has been called. Otherwise it remains zero.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ **/
+template<class IngredientsType>
+void FeatureBendingPotential::synchronize(IngredientsType& ingredients)
+{
+  //recalculate the bending energy, removing any drift of the running sum
+  if(!chainsEnds.empty())
+    bendingEnergy=calculateBendingEnergy(ingredients);
+}
+
+/**
+ * @details Sums the energies of the angles at all monomers which are not chain
+ * ends, using the bending potential strength of the monomer at the vertex.
+ * The energies are taken from the probability lookup, such that they agree
+ * with the energy differences of the moves.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @return total bending energy of the system (in kT)
+ **/
+template<class IngredientsType>
+double FeatureBendingPotential::calculateBendingEnergy(const IngredientsType& ingredients) const
+{
+  const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+  double energy=0.0;
+
+  for(size_t n=0;n<chainsEnds.size() && n<molecules.size();n++)
+  {
+    int32_t monoType=molecules[n].getAttributeTag();
+    if(monoType<1 || monoType>10 || !bpStrengthTable[monoType]) continue;
+
+    //chain ends have distance 0 from the start or the end of the chain
+    if(!(3&chainsEnds[n]) || !((3<<2)&chainsEnds[n])) continue;
+
+    VectorInt3 bondvector1=molecules[n+1]-molecules[n];
+    VectorInt3 bondvector2=molecules[n]-molecules[n-1];
+    energy-=std::log(probabilityLookup[monoType][bondVectorToIndex(bondvector1)][bondVectorToIndex(bondvector2)]);
+  }
+
+  return energy;
+}
+
 
 /**
  * @details The function is called by the Ingredients class when an object of type Ingredients
@@ -405,6 +543,8 @@ void FeatureBendingPotential::setChainEnds(IngredientsType& ingredients){
               tagNiegbsandEnds(i,sameAttNeigbIndex);
       }
   }
+
+  bendingEnergy=calculateBendingEnergy(ingredients);
   
 }  
 /**
@@ -466,6 +606,9 @@ void FeatureBendingPotential::setBendingPotential(IngredientsType& ingredients,
             
         std::cout<<"set bending potential for types ";
         std::cout<<type<<" to "<<energy<<"kT\n";
+
+        if(!chainsEnds.empty())
+            bendingEnergy=calculateBendingEnergy(ingredients);
       }
     else
       {
@@ -84,13 +84,21 @@ public:
 /**
  * @brief Feature adding a set of bond-vectors (Bondset or SlowBondset) to the system.
  *
+ * @details Optionally, the look-up index of every bond-vector is cached on the
+ * links of the molecules (see setUseBondIndexCache()). The check of a local
+ * move then shifts the cached indices by the move direction instead of reading
+ * the positions of the bond partners. The cache is filled in synchronize() and
+ * kept up to date by applyMove(). Positions changed in any other way require a
+ * call to synchronize() before the next move, as for the lattice features.
+ * Links made after the last synchronize() are checked by the bond-vector.
+ * The cache needs the 9 bit look-up index of FastBondset.
  **/
 template< class BondSetType=FastBondset>
 class FeatureBondset : public Feature
 {
  public:
-	//! Standard constructor (empty)
-  FeatureBondset(){}
+	//! Standard constructor, the bond index cache is switched off
+  FeatureBondset():useBondIndexCache(false),bondIndexCacheActive(false){}
 
   //! Standard destructor (empty)
   virtual ~FeatureBondset(){}
@@ -106,6 +114,14 @@ class FeatureBondset : public Feature
 // 	SlowBondset& modifyBondset()     {return bondset;};
 //  const SlowBondset&    getBondset()const{return bondset;};
 
+  //! Switches the cache of bond-vector indices on the links on or off. Takes effect with the next synchronize()
+  void setUseBondIndexCache(bool use){useBondIndexCache=use; bondIndexCacheActive=false;}
+
+  //! Returns true if the cache of bond-vector indices was switched on
+  bool getUseBondIndexCache() const {return useBondIndexCache;}
+
+  //! Returns true if the cache of bond-vector indices is filled and used by the moves
+  bool isBondIndexCacheActive() const {return bondIndexCacheActive;}
 
 
  /**
@@ -145,6 +161,40 @@ class FeatureBondset : public Feature
     fileWriter.registerWrite("!set_of_bondvectors", new WriteBondset<FeatureBondset>(*this));
   }
 
+  //! Writes the bond vectors, their identifiers and the state of the bond index cache into a checkpoint
+  template <class IngredientsType, class CheckpointOut>
+  void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+  {
+    uint8_t cacheActive=bondIndexCacheActive;
+    checkpoint.write(cacheActive);
+    uint64_t nBonds=bondset.size();
+    checkpoint.write(nBonds);
+    for(typename BondSetType::iterator it=bondset.begin();it!=bondset.end();++it){
+      checkpoint.write(it->first);
+      checkpoint.write(it->second.getX()); checkpoint.write(it->second.getY()); checkpoint.write(it->second.getZ());
+    }
+  }
+
+  //! Restores the bond vectors from a checkpoint and rebuilds the look-up table. The cached bond indices are part of the molecules
+  template <class IngredientsType, class CheckpointIn>
+  bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+  {
+    uint8_t cacheActive;
+    checkpoint.read(cacheActive);
+    useBondIndexCache=bondIndexCacheActive=(cacheActive!=0);
+    uint64_t nBonds;
+    checkpoint.read(nBonds);
+    bondset.clear();
+    for(uint64_t n=0;n<nBonds;n++){
+      int32_t identifier,x,y,z;
+      checkpoint.read(identifier);
+      checkpoint.read(x); checkpoint.read(y); checkpoint.read(z);
+      bondset.addBond(x,y,z,identifier);
+    }
+    bondset.updateLookupTable();
+    return true;
+  }
+
   /**
    * @brief Check move for all unknown moves: this does nothing
    *
@@ -179,8 +229,25 @@ class FeatureBondset : public Feature
           uint32_t monoIndex=move.getIndex();
           const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
 
-          for (size_t j=0; j< molecules.getNumLinks(monoIndex); ++j){
-              if (!bondset.isValidStrongCheck(molecules[molecules.getNeighborIdx(monoIndex,j)].getVector3D()-(molecules[monoIndex].getVector3D()+move.getDir()))) return false;
+          //the index was checked by the move already
+          const VectorInt3 newPos=molecules.getVertexUnchecked(monoIndex).getVector3D()+move.getDir();
+          const uint32_t nLinks=molecules.getNumLinksUnchecked(monoIndex);
+
+          if(bondIndexCacheActive){
+              //the new bond-vectors are the cached ones minus the move direction
+              const VectorInt3 shift(-move.getDir().getX(),-move.getDir().getY(),-move.getDir().getZ());
+              for (uint32_t j=0; j< nLinks; ++j){
+                  const uint32_t bondIndex=molecules.getBondIndexUnchecked(monoIndex,j);
+                  if (BondSetType::isBondIndex(bondIndex)){
+                      if (!bondset.isValidIndexStrongCheck(BondSetType::shiftBondIndex(bondIndex,shift))) return false;
+                  }
+                  else if (!bondset.isValidStrongCheck(molecules.getVertexUnchecked(molecules.getNeighborIdxUnchecked(monoIndex,j)).getVector3D()-newPos)) return false;
+              }
+              return true;
+          }
+
+          for (uint32_t j=0; j< nLinks; ++j){
+              if (!bondset.isValidStrongCheck(molecules.getVertexUnchecked(molecules.getNeighborIdxUnchecked(monoIndex,j)).getVector3D()-newPos)) return false;
           }
 
           return true;
@@ -235,10 +302,72 @@ class FeatureBondset : public Feature
       return true;
   }
   
+  /**
+   * @brief Apply move for all unknown moves: this does nothing
+   *
+   * @param [in] ingredients A reference to the IngredientsType - mainly the system
+   * @param [in] move General move other than MoveLocalBase (MoveLocalSc or MoveLocalBcc).
+   */
+  template<class IngredientsType>
+  void applyMove(IngredientsType&, const MoveBase&){}
+
+  /**
+   * @brief Overloaded for MoveLocalBase. See MoveLocalSc and MoveLocalBcc
+   *
+   * @details Updates the cached bond-vector indices, if the cache is used.
+   *
+   * @param [in] ingredients A reference to the IngredientsType - mainly the system.
+   * @param [in] move A reference to LocalMoveType.
+   */
+  template<class IngredientsType,class LocalMoveType>
+  void applyMove(IngredientsType& ingredients, const MoveLocalBase<LocalMoveType>& move)
+  {
+    if(bondIndexCacheActive)
+      updateBondIndexCache(ingredients.modifyMolecules(),move.getIndex(),move.getDir());
+  }
+
+  /**
+   * @brief Updates the cached bond-vector indices for a displacement of a monomer
+   *
+   * @details Has to be called before the position of the monomer is changed.
+   * Both directions of every bond of the monomer are updated, i.e. the entries
+   * of the monomer and the ones of its bond partners.
+   *
+   * @param molecules The molecules storing the cache on their links.
+   * @param monoIndex Index of the displaced monomer.
+   * @param dir Displacement of the monomer.
+   */
+  template<class MoleculesType>
+  void updateBondIndexCache(MoleculesType& molecules, uint32_t monoIndex, const VectorInt3& dir) const
+  {
+    const VectorInt3 shift(-dir.getX(),-dir.getY(),-dir.getZ());
+    const uint32_t nLinks=molecules.getNumLinksUnchecked(monoIndex);
+
+    for (uint32_t j=0; j< nLinks; ++j){
+      const uint32_t neighborIdx=molecules.getNeighborIdxUnchecked(monoIndex,j);
+      uint32_t bondIndex=molecules.getBondIndexUnchecked(monoIndex,j);
+      if (BondSetType::isBondIndex(bondIndex))
+        bondIndex=BondSetType::shiftBondIndex(bondIndex,shift);
+      else
+        bondIndex=bondset.bondVectorToIndex(molecules.getVertexUnchecked(neighborIdx).getVector3D()-molecules.getVertexUnchecked(monoIndex).getVector3D()+shift);
+      molecules.setBondIndexUnchecked(monoIndex,j,bondIndex);
+
+      //the bond partner stores the reversed bond-vector
+      const uint32_t nNeighborLinks=molecules.getNumLinksUnchecked(neighborIdx);
+      for (uint32_t k=0; k< nNeighborLinks; ++k){
+        if (molecules.getNeighborIdxUnchecked(neighborIdx,k)==monoIndex){
+          molecules.setBondIndexUnchecked(neighborIdx,k,BondSetType::reverseBondIndex(bondIndex));
+          break;
+        }
+      }
+    }
+  }
+
   /**
    * @brief Updates the bond-set lookup table if necessary
    *
    * @details Synchronizes the bond-set look-up table with the rest of the system, and checks for invalid bonds.
+   * If the bond index cache is used, the indices of all bonds are stored on the links.
    *
    * @param ingredients A reference to the IngredientsType - mainly the system.
    */
@@ -246,21 +375,28 @@ class FeatureBondset : public Feature
   {
     //this function only does something if the bondset has change since the last update
     bondset.updateLookupTable();
+    bondIndexCacheActive=false;
 
-    const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+    typename IngredientsType::molecules_type& molecules=ingredients.modifyMolecules();
 
     for (size_t i=0; i< molecules.size(); ++i)
     {
      for (size_t j=0; j< molecules.getNumLinks(i); ++j){
 
 	 uint n = molecules.getNeighborIdx(i,j);
-	 if (!bondset.isValidStrongCheck(molecules[n].getVector3D()-molecules[i].getVector3D()))
+	 const VectorInt3 bondVector=molecules[n].getVector3D()-molecules[i].getVector3D();
+	 const uint32_t bondIndex=bondset.bondVectorToIndex(bondVector);
+	 if (!bondset.isValidStrongCheck(bondVector) || (useBondIndexCache && !bondset.isValidIndexStrongCheck(bondIndex)))
 	{
 	  std::ostringstream errorMessage;
 	  errorMessage << "FeatureBondset::synchronize(): Invalid bond vector between monomer " << i << " at " << molecules[i].getVector3D() << " and " << n << " at " <<  molecules[n].getVector3D() <<  ".\n";throw std::runtime_error(errorMessage.str());
 	}
+	 if (useBondIndexCache)
+	   molecules.setBondIndexUnchecked(i,j,bondIndex);
     }
     }
+
+    bondIndexCacheActive=useBondIndexCache;
   }
 
 protected:
@@ -268,6 +404,12 @@ protected:
   //! Stores the set of allowed bond-vectors.
   BondSetType bondset;
 
+  //! True if the bond-vector indices are to be cached on the links of the molecules
+  bool useBondIndexCache;
+
+  //! True if the cache was filled by synchronize() and is kept up to date by the moves
+  bool bondIndexCacheActive;
+
 
   /* if you want to use the SlowBondset, comment the line above and uncomment
    * the line below.*/
@@ -246,6 +246,27 @@ public:
 	fileWriter.registerWrite("!periodic_z",new WritePeriodicZ<FeatureBox>(*this));
 	}
 
+	//! Writes box size and periodicity into a checkpoint
+	template <class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{
+		checkpoint.write(boxX); checkpoint.write(boxY); checkpoint.write(boxZ);
+		checkpoint.write(periodicX); checkpoint.write(periodicY); checkpoint.write(periodicZ);
+	}
+
+	//! Restores box size and periodicity from a checkpoint
+	template <class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{
+		int32_t x,y,z;
+		bool pX,pY,pZ;
+		checkpoint.read(x); checkpoint.read(y); checkpoint.read(z);
+		checkpoint.read(pX); checkpoint.read(pY); checkpoint.read(pZ);
+		setBoxX(x); setBoxY(y); setBoxZ(z);
+		setPeriodicX(pX); setPeriodicY(pY); setPeriodicZ(pZ);
+		return true;
+	}
+
 	/**
 	 * @brief For all unknown moves: this does nothing
 	 *
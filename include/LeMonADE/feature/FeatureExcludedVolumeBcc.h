@@ -112,6 +112,24 @@ public:
 		this->latticeFilledUp = latticeFilledUp;
 	}
 
+	//! Stores whether the lattice occupation is part of the checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const {
+		uint8_t latticeSaved=(checkpoint.includesLattice() && latticeFilledUp);
+		checkpoint.write(latticeSaved);
+	}
+
+	//! The lattice occupation is restored by the lattice feature. Otherwise it is filled by synchronize()
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType& ingredients, CheckpointIn& checkpoint) {
+		uint8_t latticeSaved;
+		checkpoint.read(latticeSaved);
+		latticeFilledUp=(latticeSaved!=0);
+		//a restored but unfilled lattice is refilled from scratch
+		if(!latticeFilledUp && checkpoint.includesLattice()) ingredients.clearLattice();
+		return latticeFilledUp;
+	}
+
 	//! check move for basic move - always true
 	template<class IngredientsType>
 	bool checkMove(const IngredientsType& ingredients, const MoveBase& move) const;
@@ -28,6 +28,10 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef LEMONADE_FEATURE_FEATUREEXCLUDEDVOLUMESC_H
 #define LEMONADE_FEATURE_FEATUREEXCLUDEDVOLUMESC_H
 
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
 #include <LeMonADE/feature/Feature.h>
 #include <LeMonADE/feature/FeatureLattice.h>
 #include <LeMonADE/feature/FeatureLatticePowerOfTwo.h>
@@ -38,6 +42,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
 #include <LeMonADE/updater/moves/MoveLocalBcc.h>
 #include <LeMonADE/updater/moves/MoveAddMonomerBcc.h>
+#include <LeMonADE/utility/LatticeFillScheduler.h>
 
 /*****************************************************************************/
 /**
@@ -110,6 +115,24 @@ public:
 		this->latticeFilledUp = latticeFilledUp;
 	}
 
+	//! Stores whether the lattice occupation is part of the checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const {
+		uint8_t latticeSaved=(checkpoint.includesLattice() && latticeFilledUp);
+		checkpoint.write(latticeSaved);
+	}
+
+	//! The lattice occupation is restored by the lattice feature. Otherwise it is filled by synchronize()
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType& ingredients, CheckpointIn& checkpoint) {
+		uint8_t latticeSaved;
+		checkpoint.read(latticeSaved);
+		latticeFilledUp=(latticeSaved!=0);
+		//a restored but unfilled lattice is refilled from scratch
+		if(!latticeFilledUp && checkpoint.includesLattice()) ingredients.clearLattice();
+		return latticeFilledUp;
+	}
+
 	//! check move for basic move - always true
 	template<class IngredientsType>
 	bool checkMove(const IngredientsType& ingredients, const MoveBase& move) const;
@@ -159,9 +182,23 @@ protected:
 	template<class IngredientsType> void fillLattice(
 			IngredientsType& ingredients);
 
+	//! Populates the lattice with value(molecules,n) for every monomer n, completely or incrementally.
+	template<class IngredientsType, class ValueFunction> void fillLattice(
+			IngredientsType& ingredients, const ValueFunction& value);
+
+	//! Value written on the sites of every monomer by fillLattice(IngredientsType&)
+	struct OccupiedValue
+	{
+		template<class MoleculesType>
+		LatticeValueType operator()(const MoleculesType&, uint32_t) const {return LatticeValueType(1);}
+	};
+
 	//! Tag for indication if the lattice is populated.
 	bool latticeFilledUp;
 
+	//! Parallel fill and snapshot for the incremental synchronization.
+	LatticeFillScheduler<LatticeValueType> fillScheduler;
+
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -304,8 +341,11 @@ bool FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::checkMove( c
  * @fn bool FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::checkMove( const IngredientsType& ingredients, const MoveLocalScDiag& move )const
  * @brief checks excluded volume for moves of type MoveLocalScDiag
  *
+ * @details Only the 4 (axes) or 6 (diagonals) sites entered by the move are
+ * checked, see MoveLocalScDiag::getEnteredSites().
+ *
  * @param [in] ingredients A reference to the IngredientsType - mainly the system.
- * @param [in] move A reference to MoveLocalSc.
+ * @param [in] move A reference to MoveLocalScDiag.
  * @return if move is allowed (\a true) or rejected (\a false).
  * */
 /******************************************************************************/
@@ -315,88 +355,19 @@ bool FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::checkMove( c
 {
 	if(!latticeFilledUp)
 	    throw std::runtime_error("*****FeatureExcludedVolumeSc::checkMove....lattice is not populated. Run synchronize!\n");
-	if ( move.getDir()==VectorInt3(1,0,0)||move.getDir()==VectorInt3(-1,0,0)||
-	     move.getDir()==VectorInt3(0,1,0)||move.getDir()==VectorInt3(0,-1,0)||
-	     move.getDir()==VectorInt3(0,0,1)||move.getDir()==VectorInt3(0,0,-1) )
-	{
-		  //get the position of the monomer to be moved (assume "lower left corner")
-		  VectorInt3 refPos=ingredients.getMolecules()[move.getIndex()];
-		  //get the direction of the move
-		  VectorInt3 direction=move.getDir();
-
-		  //shift refPos in the direction of the move. this defines then the
-		  //point around which the volume occupation must be checked
-		  if(direction.getX()>0 || direction.getY()>0 || direction.getZ()>0) refPos+=direction;
-		  refPos+=direction;
-
-		  //now the nine closest positions in the plane of refPos perpendicular to the
-		  //move direction must be checked
-
-		  /*get two directions perpendicular to vector directon of the move*/
-		  VectorInt3 perp1,perp2;
-		  /* first perpendicular direction is either (0 1 0) or (1 0 0)*/
-		  int32_t x1=((direction.getX()==0) ? 1 : 0);
-		  int32_t y1=((direction.getX()!=0) ? 1 : 0);
-		  perp1.setX(x1);
-		  perp1.setY(y1);
-		  perp1.setZ(0);
-
-		  /* second perpendicular direction is either (0 0 1) or (0 1 0)*/
-		  int32_t y2=((direction.getZ()==0) ? 0 : 1);
-		  int32_t z2=((direction.getZ()!=0) ? 0 : 1);
-		  perp2.setX(0);
-		  perp2.setY(y2);
-		  perp2.setZ(z2);
-
-
-	      //check if the lattice sites are free
-	      if(     (ingredients.getLatticeEntry(refPos))||
-		      (ingredients.getLatticeEntry(refPos+perp1))||
-		      (ingredients.getLatticeEntry(refPos+perp2))||
-		      (ingredients.getLatticeEntry(refPos+perp1+perp2))
-		) return false;
-	      else return true;
-	}
-	else 
+
+	//the sites entered by the cube of the monomer are tabulated in the move
+	const VectorInt3& pos=ingredients.getMolecules().getVertexUnchecked(move.getIndex()).getVector3D();
+	const VectorInt3* sites=move.getEnteredSites();
+	const uint32_t nSites=move.getNumMovedSites();
+
+	for(uint32_t i=0;i<nSites;i++)
 	{
-		//get the position of the monomer to be moved (assume "lower left corner")
-		VectorInt3 refPos=ingredients.getMolecules()[move.getIndex()];
-		//get the direction of the move
-		VectorInt3 direction=move.getDir();
-		VectorInt3 vec1, vec2,vec3;
-		//vec1 and vec2 are the orthogonal projections of the direction on the
-		//coordinate system. vec3 is perpendicular to both other vectors. 
-		if(direction.getX()==0){
-		  vec3=VectorInt3(1,0,0);
-		  if(direction.getY()==1){vec1=VectorInt3(0,1,0);refPos+=vec1;}
-		  else{vec1=VectorInt3(0,-1,0);}
-		  if(direction.getZ()==1){vec2=VectorInt3(0,0,1);refPos+=vec2;}
-		  else{vec2=VectorInt3(0,0,-1); }
-		}else if(direction.getY()==0){
-		  vec3=VectorInt3(0,1,0);
-		  if(direction.getX()==1){vec1=VectorInt3(1,0,0);refPos+=vec1;}
-		  else{vec1=VectorInt3(-1,0,0); }
-		  if(direction.getZ()==1){vec2=VectorInt3(0,0,1);refPos+=vec2;}
-		  else{vec2=VectorInt3(0,0,-1); }
-		}else if(direction.getZ()==0){
-		  vec3=VectorInt3(0,0,1);
-		  if(direction.getY()==1){vec1=VectorInt3(0,1,0);refPos+=vec1;}
-		  else{vec1=VectorInt3(0,-1,0); }
-		  if(direction.getX()==1){vec2=VectorInt3(1,0,0);refPos+=vec2;}
-		  else{vec2=VectorInt3(-1,0,0); }
-		}
-		//check if the lattice sites are free
-		if(
-		  (ingredients.getLatticeEntry(refPos+vec1))||
-		  (ingredients.getLatticeEntry(refPos+vec2))||
-		  (ingredients.getLatticeEntry(refPos+vec1+vec2))||
-		  (ingredients.getLatticeEntry(refPos+vec1+vec2+vec3)||
-		  (ingredients.getLatticeEntry(refPos+vec1+vec3))||
-		  (ingredients.getLatticeEntry(refPos+vec2+vec3)))
-		  ) return false;
-		else return true;
+		if(ingredients.getLatticeEntry(pos.getX()+sites[i].getX(),
+					       pos.getY()+sites[i].getY(),
+					       pos.getZ()+sites[i].getZ())) return false;
 	}
-	
+	return true;
 }
 /******************************************************************************/
 /**
@@ -449,85 +420,23 @@ void FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::applyMove(In
  * @brief updates the lattice ocupation according to the move for types MoveLocalScDiag 
  * 
  * @param [in] ingredients A reference to the IngredientsType - mainly the system.
- * @param [in] move A reference to MoveLocalSc.
+ * @param [in] move A reference to MoveLocalScDiag.
  * */
 /******************************************************************************/
 template<template<typename> class LatticeClassType, typename LatticeValueType>
 template<class IngredientsType>
 void FeatureExcludedVolumeSc<LatticeClassType<LatticeValueType> >::applyMove(IngredientsType& ing, const MoveLocalScDiag& move)
-{       
-	if(move.getDir()==VectorInt3(1,0,0)||move.getDir()==VectorInt3(-1,0,0)||
-	   move.getDir()==VectorInt3(0,1,0)||move.getDir()==VectorInt3(0,-1,0)||
-	   move.getDir()==VectorInt3(0,0,1)||move.getDir()==VectorInt3(0,0,-1))
-	{
-	    //get old position and direction of the move
-	    VectorInt3 oldPos=ing.getMolecules()[move.getIndex()];
-	    VectorInt3 direction=move.getDir();	
-	    
-	    /*get two directions perpendicular to vector directon of the move*/
-	    VectorInt3 perp1,perp2;
-	    /* first perpendicular direction is either (0 1 0) or (1 0 0)*/
-	    int32_t x1=((direction.getX()==0) ? 1 : 0);
-	    int32_t y1=((direction.getX()!=0) ? 1 : 0);
-	    perp1.setX(x1);
-	    perp1.setY(y1);
-	    perp1.setZ(0);
-	    
-	    /* second perpendicular direction is either (0 0 1) or (0 1 0)*/
-	    int32_t y2=((direction.getZ()==0) ? 0 : 1);
-	    int32_t z2=((direction.getZ()!=0) ? 0 : 1);
-	    perp2.setX(0);
-	    perp2.setY(y2);
-	    perp2.setZ(z2);
-	    
-	    
-	    if(direction.getX()<0 || direction.getY()<0 || direction.getZ()<0) oldPos-=direction;
-	    direction*=2;
-	    
-	    VectorInt3 oldPlusDir=oldPos+direction;
-	    
-	    //change lattice occupation accordingly
-	    ing.moveOnLattice(oldPos,oldPlusDir);
-	    ing.moveOnLattice(oldPos+perp1,oldPlusDir+perp1);
-	    ing.moveOnLattice(oldPos+perp2,oldPlusDir+perp2);
-	    ing.moveOnLattice(oldPos+perp1+perp2,oldPlusDir+perp1+perp2);
-	}
-	else
+{
+	//move the values from the left to the entered sites tabulated in the move
+	const VectorInt3& pos=ing.getMolecules().getVertexUnchecked(move.getIndex()).getVector3D();
+	const VectorInt3* entered=move.getEnteredSites();
+	const VectorInt3* left=move.getLeftSites();
+	const uint32_t nSites=move.getNumMovedSites();
+
+	for(uint32_t i=0;i<nSites;i++)
 	{
-	    //get the position of the monomer to be moved (assume "lower left corner")
-	    VectorInt3 refPos=ing.getMolecules()[move.getIndex()];
-	    //get the direction of the move
-	    VectorInt3 direction=move.getDir();
-	    VectorInt3 vec1, vec2,vec3;
-	    //vec1 and vec2 are the orthogonal projections of the direction on the
-	    //coordinate system. vec3 is perpendicular to both other vectors. 
-	    if(direction.getX()==0){
-	      vec3=VectorInt3(1,0,0);
-	      if(direction.getY()==1){vec1=VectorInt3(0,1,0);refPos+=vec1;}
-	      else{vec1=VectorInt3(0,-1,0);}
-	      if(direction.getZ()==1){vec2=VectorInt3(0,0,1);refPos+=vec2;}
-	      else{vec2=VectorInt3(0,0,-1); }
-	    }else if(direction.getY()==0){
-	      vec3=VectorInt3(0,1,0);
-	      if(direction.getX()==1){vec1=VectorInt3(1,0,0);refPos+=vec1;}
-	      else{vec1=VectorInt3(-1,0,0); }
-	      if(direction.getZ()==1){vec2=VectorInt3(0,0,1);refPos+=vec2;}
-	      else{vec2=VectorInt3(0,0,-1); }
-	    }else if(direction.getZ()==0){
-	      vec3=VectorInt3(0,0,1);
-	      if(direction.getY()==1){vec1=VectorInt3(0,1,0);refPos+=vec1;}
-	      else{vec1=VectorInt3(0,-1,0); }
-	      if(direction.getX()==1){vec2=VectorInt3(1,0,0);refPos+=vec2;}
-	      else{vec2=VectorInt3(-1,0,0); }
-	    }
-	    //change lattice occupation accordingly
-	    //it behaves like a mirror transformation
-	    ing.moveOnLattice(refPos-vec1,refPos+vec1);
-	    ing.moveOnLattice(refPos-vec2,refPos+vec2);
-	    ing.moveOnLattice(refPos-vec1-vec2,refPos+vec1+vec2);
-	    ing.moveOnLattice(refPos-vec1+vec3,refPos+vec1+vec3);
-	    ing.moveOnLattice(refPos-vec2+vec3,refPos+vec2+vec3);
-	    ing.moveOnLattice(refPos-vec1-vec2+vec3,refPos+vec1+vec2+vec3);
+		ing.moveOnLattice(pos.getX()+left[i].getX(),pos.getY()+left[i].getY(),pos.getZ()+left[i].getZ(),
+				  pos.getX()+entered[i].getX(),pos.getY()+entered[i].getY(),pos.getZ()+entered[i].getZ());
 	}
 }
 
@@ -629,45 +538,74 @@ template<template<typename> class LatticeClassType, typename LatticeValueType>
 template<class IngredientsType>
 void FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::fillLattice(IngredientsType& ingredients)
 {
+	//here we simply set a one on every occupied lattice
+	//site. this assumes that 1 can be cast to  LatticeClassType<LatticeValueType> ,
+	//even though in principle  LatticeClassType<LatticeValueType>  could be anything.
+	//note that this may be just a preliminiary initialization,
+	//as other features may assign more specific values to the
+	//lattice site.
+	fillLattice(ingredients,OccupiedValue());
+}
+
+/******************************************************************************/
+/**
+ * @fn void FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::fillLattice(IngredientsType& ingredients, const ValueFunction& value)
+ * @brief Populates the lattice with the values given by the functor value.
+ *
+ * @details The monomers are sorted into slabs and written in parallel (see
+ * LatticeFillScheduler). If the lattice uses incremental synchronization and
+ * was not reset since the last fill, only the monomers which changed position
+ * or value are removed from their old sites and written to the new ones.
+ *
+ * @param ingredients A reference to the IngredientsType - mainly the system.
+ * @param value functor returning the lattice value for monomer n
+ * */
+/******************************************************************************/
+template<template<typename> class LatticeClassType, typename LatticeValueType>
+template<class IngredientsType, class ValueFunction>
+void FeatureExcludedVolumeSc< LatticeClassType<LatticeValueType> >::fillLattice(IngredientsType& ingredients, const ValueFunction& value)
+{
+	typedef LatticeFillScheduler<LatticeValueType> Scheduler;
 	const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
-	//copy the lattice occupation from the monomer coordinates
-	for(size_t n=0;n<molecules.size();n++)
+	const LatticeCubeOccupier<IngredientsType,ValueFunction,LatticeValueType> occupy(ingredients,value);
+
+	bool success=true;
+	uint32_t failedIndex=0;
+	std::vector<uint32_t> changed;
+
+	if(ingredients.getIncrementalSynchronization() &&
+	   fillScheduler.findChangedMonomers(molecules,value,ingredients.getLatticeGeneration(),changed))
 	{
-		VectorInt3 pos=ingredients.getMolecules()[n];
-
-		if( ingredients.getLatticeEntry(pos)!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,0,0))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(0,1,0))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(0,0,1))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,1,0))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,0,1))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(0,1,1))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,1,1))!=0
-		)
-		{
-			throw std::runtime_error("********** FeatureExcludedVolume::fillLattice: multiple lattice occupation ******************");
-		}
-		else
+		//first free all old sites, because changed monomers may move onto each others old sites
+		for(size_t i=0;i<changed.size();i++)
+			Scheduler::setCube(ingredients,fillScheduler.getSnapshotPosition(changed[i]),LatticeValueType());
+
+		for(size_t i=0;i<changed.size() && success;i++)
 		{
-			//here we simply set a one on every occupied lattice
-			//site. this assumes that 1 can be cast to  LatticeClassType<LatticeValueType> ,
-			//even though in principle  LatticeClassType<LatticeValueType>  could be anything.
-			//note that this may be just a preliminiary initialization,
-			//as other features may assign more specific values to the
-			//lattice site.
-			VectorInt3 pos=molecules[n];
-
-			ingredients.setLatticeEntry(pos,1);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,0,0),1);
-			ingredients.setLatticeEntry(pos+VectorInt3(0,1,0),1);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,1,0),1);
-			ingredients.setLatticeEntry(pos+VectorInt3(0,0,1),1);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,0,1),1);
-			ingredients.setLatticeEntry(pos+VectorInt3(0,1,1),1);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,1,1),1);
+			success=occupy(changed[i]);
+			failedIndex=changed[i];
 		}
+	}
+	else
+	{
+		fillScheduler.sortIntoSlabs(molecules,ingredients.getBoxZ());
+		success=fillScheduler.forEachMonomer(occupy,failedIndex);
+	}
 
+	if(!success)
+	{
+		fillScheduler.clearSnapshot();
+		std::stringstream errormessage;
+		errormessage<<"********** FeatureExcludedVolume::fillLattice: multiple lattice occupation ******************\n"
+			<<"monomer "<<failedIndex<<" at "<<molecules[failedIndex].getVector3D();
+		throw std::runtime_error(errormessage.str());
 	}
+
+	if(ingredients.getIncrementalSynchronization())
+		fillScheduler.storeSnapshot(molecules,value,ingredients.getLatticeGeneration());
+	else
+		fillScheduler.clearSnapshot();
+
 	latticeFilledUp=true;
 }
 
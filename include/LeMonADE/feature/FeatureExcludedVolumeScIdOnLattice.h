@@ -111,6 +111,15 @@ protected:
 	//! Populates the lattice using the coordinates of molecules.
 	template<class IngredientsType> void fillLattice(
 			IngredientsType& ingredients);
+
+	//! Adapts the predicate to the value functor used by BaseClass::fillLattice
+	struct PredicateValue
+	{
+		PredicateValue(const Predicate& pred_):pred(pred_){}
+		template<class MoleculesType>
+		LatticeValueType operator()(const MoleculesType& molecules, uint32_t n) const {return LatticeValueType(pred(molecules,n));}
+		mutable Predicate pred;
+	};
 private:
   
 	//! predicate for the lattice occupation 
@@ -186,43 +195,8 @@ template<template<typename> class LatticeClassType, typename LatticeValueType, c
 template<class IngredientsType>
 void FeatureExcludedVolumeScIdOnLattice< LatticeClassType<LatticeValueType>, Predicate >::fillLattice(IngredientsType& ingredients)
 {
-  
-  std::cout << "Use the correct fillLattice" << std::endl;
-	const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
-	//copy the lattice occupation from the monomer coordinates
-	for(size_t n=0;n<molecules.size();n++)
-	{
-		VectorInt3 pos=ingredients.getMolecules()[n];
-
-		if( ingredients.getLatticeEntry(pos)!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,0,0))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(0,1,0))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(0,0,1))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,1,0))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,0,1))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(0,1,1))!=0 ||
-		  ingredients.getLatticeEntry(pos+VectorInt3(1,1,1))!=0
-		)
-		{
-			throw std::runtime_error("********** FeatureExcludedVolume::fillLattice: multiple lattice occupation ******************");
-		}
-		else
-		{
-			//here we use the functor pred to decide what should be written on the lattice
-			VectorInt3 pos=molecules[n];
-			LatticeValueType value=pred(molecules,n);
-			ingredients.setLatticeEntry(pos,value);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,0,0),value);
-			ingredients.setLatticeEntry(pos+VectorInt3(0,1,0),value);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,1,0),value);
-			ingredients.setLatticeEntry(pos+VectorInt3(0,0,1),value);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,0,1),value);
-			ingredients.setLatticeEntry(pos+VectorInt3(0,1,1),value);
-			ingredients.setLatticeEntry(pos+VectorInt3(1,1,1),value);
-		}
-
-	}
-	latticeFilledUp=true;
+	//here we use the functor pred to decide what should be written on the lattice
+	BaseClass::fillLattice(ingredients,PredicateValue(pred));
 }
 
 #endif
@@ -0,0 +1,574 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_FEATURE_FEATUREEXTERNALFIELD_H
+#define LEMONADE_FEATURE_FEATUREEXTERNALFIELD_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <LeMonADE/feature/Feature.h>
+#include <LeMonADE/updater/moves/MoveBase.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/updater/moves/MoveLocalScDiag.h>
+#include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureBoltzmann.h>
+#include <LeMonADE/io/FileImport.h>
+#include <LeMonADE/utility/Vector3D.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ *
+ * @class FeatureExternalField
+ * @brief External fields acting on monomers depending on their attribute tag
+ * @details Every monomer type (attribute tag) can be given
+ * * a constant force f, i.e. the potential energy -f*r, e.g. a pulling force
+ *   or a gravity-like gradient, and
+ * * for every axis a periodic potential profile V(c), with the potential of a
+ *   monomer at coordinate c given by V[c mod V.size()], e.g. a periodic
+ *   modulation (see setPeriodicModulation()) or an arbitrary tabulated
+ *   potential along the axis.
+ *
+ * All energies are in units of kT. The Boltzmann factors of the moves are
+ * precomputed whenever the parameters change: one table [type][direction]
+ * for the forces, and one table [type][axis][coordinate bin][step] for
+ * every profile. Checking a MoveLocalSc or MoveLocalScDiag is thus a single
+ * table lookup plus one lookup per profile along the axes the move steps in.
+ * Monomers with types without field are not affected.
+ *
+ * FeatureLinearForce with amplitude A corresponds to the force (-A,0,0) on
+ * type 4 and (A,0,0) on type 5.
+ *
+ * The potential energy of all monomers is kept up to date in applyMove()
+ * and recalculated in synchronize().
+ * */
+/*****************************************************************************/
+class FeatureExternalField:public Feature
+{
+public:
+
+	FeatureExternalField():fieldEnergy(0.0){}
+	virtual ~FeatureExternalField(){}
+
+	//the FeatureBoltzmann: adds a probability for the move
+	//the FeatureAttributes<>: provides the types of the monomers
+	typedef LOKI_TYPELIST_2(FeatureBoltzmann,FeatureAttributes<>) required_features_back;
+
+	//! For all unknown moves: this does nothing
+	template<class IngredientsType>
+	bool checkMove(const IngredientsType& ingredients,const MoveBase& move) const{return true;}
+
+	//! multiplies the probability of a MoveLocalSc with the Boltzmann factor of the field
+	template<class IngredientsType>
+	bool checkMove(const IngredientsType& ingredients,MoveLocalSc& move) const
+	{return checkLocalMove(ingredients,move);}
+
+	//! multiplies the probability of a MoveLocalScDiag with the Boltzmann factor of the field
+	template<class IngredientsType>
+	bool checkMove(const IngredientsType& ingredients,MoveLocalScDiag& move) const
+	{return checkLocalMove(ingredients,move);}
+
+	//! For all unknown moves: this does nothing
+	template<class IngredientsType>
+	void applyMove(const IngredientsType&,const MoveBase&){}
+
+	//! updates the energy for a MoveLocalSc
+	template<class IngredientsType>
+	void applyMove(const IngredientsType& ingredients,const MoveLocalSc& move)
+	{fieldEnergy+=getMoveEnergy(ingredients.getMolecules()[move.getIndex()].getAttributeTag(),ingredients.getMolecules()[move.getIndex()],move.getDir());}
+
+	//! updates the energy for a MoveLocalScDiag
+	template<class IngredientsType>
+	void applyMove(const IngredientsType& ingredients,const MoveLocalScDiag& move)
+	{fieldEnergy+=getMoveEnergy(ingredients.getMolecules()[move.getIndex()].getAttributeTag(),ingredients.getMolecules()[move.getIndex()],move.getDir());}
+
+	//! updates the energy for an added monomer
+	template<class IngredientsType,class TagType>
+	void applyMove(const IngredientsType& ingredients,const MoveAddMonomerSc<TagType>& move)
+	{fieldEnergy+=getPotential(int32_t(move.getTag()),move.getPosition());}
+
+	//! recalculates the energy from the positions of the monomers
+	template<class IngredientsType>
+	void synchronize(IngredientsType& ingredients);
+
+	//! potential energy of all monomers in the field in kT
+	double getFieldEnergy() const {return fieldEnergy;}
+
+	//! adds the potential energy to report (see EnergyReport)
+	template<class EnergyReportType>
+	void reportEnergy(EnergyReportType& report) const
+	{report.addEnergy("FeatureExternalField",fieldEnergy);}
+
+	//! sets the constant force on monomers of the given type (in kT per lattice unit)
+	void setForce(int32_t type, const VectorDouble3& force);
+
+	//! constant force on monomers of the given type
+	VectorDouble3 getForce(int32_t type) const
+	{return (uint32_t(type)<getNTypes()) ? forces[type] : VectorDouble3(0.0,0.0,0.0);}
+
+	//! sets the potential profile along axis (0,1,2) for the given type. An empty profile removes it.
+	void setPotentialProfile(int32_t type, uint32_t axis, const std::vector<double>& profile);
+
+	//! sets the profile V(c)=amplitude*cos(2*pi*c/period+phase) along axis for the given type
+	void setPeriodicModulation(int32_t type, uint32_t axis, double amplitude, uint32_t period, double phase=0.0);
+
+	//! potential profile along axis for the given type, empty if there is none
+	const std::vector<double>& getPotentialProfile(int32_t type, uint32_t axis) const;
+
+	//! removes all forces and profiles
+	void clearField();
+
+	//! writes the forces and profiles into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{
+		checkpoint.writeVector(forces);
+		for(size_t n=0;n<profiles.size();n++) checkpoint.writeVector(profiles[n]);
+	}
+
+	//! restores the forces and profiles and their tables. The energy is recalculated in synchronize()
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{
+		std::vector<VectorDouble3> savedForces;
+		std::vector<double> profile;
+		checkpoint.readVector(savedForces);
+		clearField();
+		for(uint32_t type=0;type<savedForces.size();type++){
+			setForce(type,savedForces[type]);
+			for(uint32_t axis=0;axis<3;axis++){
+				checkpoint.readVector(profile);
+				if(!profile.empty()) setPotentialProfile(type,axis,profile);
+			}
+		}
+		return false;
+	}
+
+	//! number of types with table entries, i.e. largest configured type +1
+	uint32_t getNTypes() const {return uint32_t(forces.size());}
+
+	//! potential energy of a monomer of the given type at pos in kT
+	double getPotential(int32_t type, const VectorInt3& pos) const;
+
+	//! energy difference of moving a monomer of the given type from pos by dir
+	double getMoveEnergy(int32_t type, const VectorInt3& pos, const VectorInt3& dir) const;
+
+	//! Export the relevant functionality for reading bfm-files to the responsible reader object
+	template <class IngredientsType>
+	void exportRead(FileImport <IngredientsType>& fileReader);
+
+	//! Export the relevant functionality for writing bfm-files to the responsible writer object
+	template <class IngredientsType>
+	void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& fileWriter) const;
+
+private:
+
+	//! number of entries per type in the direction tables, covering all steps with components -1,0,1
+	enum{ NDirections=27 };
+
+	//! index of a step with components -1,0,1 in the direction tables
+	static uint32_t getDirectionIndex(const VectorInt3& dir)
+	{return uint32_t((dir.getX()+1)*9+(dir.getY()+1)*3+(dir.getZ()+1));}
+
+	//! coordinate c folded into [0,period)
+	static uint32_t getBin(int32_t c, size_t period)
+	{
+		int64_t b=int64_t(c)%int64_t(period);
+		return uint32_t((b<0) ? b+int64_t(period) : b);
+	}
+
+	//! makes the tables large enough for type
+	void resizeTypes(int32_t type);
+
+	//! recalculates the force table of type
+	void updateForceTable(uint32_t type);
+
+	//! recalculates the profile tables of type along axis
+	void updateProfileTable(uint32_t type, uint32_t axis);
+
+	//! multiplies the probability of a local move with the tabulated Boltzmann factor
+	template<class IngredientsType, class LocalMoveType>
+	bool checkLocalMove(const IngredientsType& ingredients, LocalMoveType& move) const;
+
+	//! force per type
+	std::vector<VectorDouble3> forces;
+	//! potential profile per type and axis, index type*3+axis
+	std::vector<std::vector<double> > profiles;
+
+	//! Boltzmann factor exp(f*dir) per type and direction, index type*NDirections+direction
+	std::vector<double> forceFactor;
+	//! Boltzmann factor exp(-(V(c+s)-V(c))) per type and axis, index bin*3+s+1
+	std::vector<std::vector<double> > profileFactor;
+	//! per type bitmask of the axes with a potential profile
+	std::vector<uint8_t> profileAxes;
+
+	//! potential energy of all monomers in the field
+	double fieldEnergy;
+};
+
+/*****************************************************************************/
+//////////define member functions /////////////////////////////////////////////
+/*****************************************************************************/
+
+/**
+ * @throw <std::runtime_error> if type is negative
+ */
+inline void FeatureExternalField::resizeTypes(int32_t type)
+{
+	if(type<0){
+		std::stringstream errormessage;
+		errormessage<<"FeatureExternalField: invalid type "<<type<<". Types must not be negative.";
+		throw std::runtime_error(errormessage.str());
+	}
+	if(uint32_t(type)<getNTypes()) return;
+
+	const uint32_t oldNTypes=getNTypes();
+	forces.resize(type+1,VectorDouble3(0.0,0.0,0.0));
+	profiles.resize(3*(type+1));
+	forceFactor.resize(NDirections*(type+1),1.0);
+	profileFactor.resize(3*(type+1));
+	profileAxes.resize(type+1,0);
+	for(uint32_t t=oldNTypes;t<getNTypes();t++) updateForceTable(t);
+}
+
+inline void FeatureExternalField::updateForceTable(uint32_t type)
+{
+	for(int dx=-1;dx<=1;dx++)
+	for(int dy=-1;dy<=1;dy++)
+	for(int dz=-1;dz<=1;dz++){
+		const double work=forces[type].getX()*dx+forces[type].getY()*dy+forces[type].getZ()*dz;
+		forceFactor[type*NDirections+getDirectionIndex(VectorInt3(dx,dy,dz))]=std::exp(work);
+	}
+}
+
+inline void FeatureExternalField::updateProfileTable(uint32_t type, uint32_t axis)
+{
+	const std::vector<double>& profile=profiles[3*type+axis];
+	std::vector<double>& factor=profileFactor[3*type+axis];
+	const size_t period=profile.size();
+
+	factor.resize(3*period);
+	for(size_t c=0;c<period;c++){
+		factor[3*c  ]=std::exp(profile[c]-profile[(c+period-1)%period]);
+		factor[3*c+1]=1.0;
+		factor[3*c+2]=std::exp(profile[c]-profile[(c+1)%period]);
+	}
+
+	if(period>0) profileAxes[type]|=uint8_t(1<<axis);
+	else profileAxes[type]&=uint8_t(~(1<<axis));
+}
+
+inline void FeatureExternalField::setForce(int32_t type, const VectorDouble3& force)
+{
+	resizeTypes(type);
+	forces[type]=force;
+	updateForceTable(type);
+}
+
+/**
+ * @throw <std::runtime_error> if type is negative or axis is not 0,1 or 2
+ */
+inline void FeatureExternalField::setPotentialProfile(int32_t type, uint32_t axis, const std::vector<double>& profile)
+{
+	if(axis>2){
+		std::stringstream errormessage;
+		errormessage<<"FeatureExternalField::setPotentialProfile: invalid axis "<<axis<<". Valid axes are 0,1,2.";
+		throw std::runtime_error(errormessage.str());
+	}
+	resizeTypes(type);
+	profiles[3*type+axis]=profile;
+	updateProfileTable(type,axis);
+}
+
+inline void FeatureExternalField::setPeriodicModulation(int32_t type, uint32_t axis, double amplitude, uint32_t period, double phase)
+{
+	const double pi=3.14159265358979323846;
+	std::vector<double> profile(period);
+	for(uint32_t c=0;c<period;c++)
+		profile[c]=amplitude*std::cos(2.0*pi*double(c)/double(period)+phase);
+	setPotentialProfile(type,axis,profile);
+}
+
+inline const std::vector<double>& FeatureExternalField::getPotentialProfile(int32_t type, uint32_t axis) const
+{
+	static const std::vector<double> noProfile;
+	if(uint32_t(type)>=getNTypes() || axis>2) return noProfile;
+	return profiles[3*type+axis];
+}
+
+inline void FeatureExternalField::clearField()
+{
+	forces.clear();
+	profiles.clear();
+	forceFactor.clear();
+	profileFactor.clear();
+	profileAxes.clear();
+}
+
+inline double FeatureExternalField::getPotential(int32_t type, const VectorInt3& pos) const
+{
+	if(uint32_t(type)>=getNTypes()) return 0.0;
+
+	double energy=-(forces[type].getX()*pos.getX()+forces[type].getY()*pos.getY()+forces[type].getZ()*pos.getZ());
+	for(uint32_t axis=0;axis<3;axis++){
+		const std::vector<double>& profile=profiles[3*type+axis];
+		if(!profile.empty()) energy+=profile[getBin(pos.getCoordinate(axis),profile.size())];
+	}
+	return energy;
+}
+
+inline double FeatureExternalField::getMoveEnergy(int32_t type, const VectorInt3& pos, const VectorInt3& dir) const
+{
+	if(uint32_t(type)>=getNTypes()) return 0.0;
+
+	double energy=-(forces[type].getX()*dir.getX()+forces[type].getY()*dir.getY()+forces[type].getZ()*dir.getZ());
+	for(uint32_t axis=0;axis<3;axis++){
+		const std::vector<double>& profile=profiles[3*type+axis];
+		if(profile.empty() || dir.getCoordinate(axis)==0) continue;
+		const int32_t c=pos.getCoordinate(axis);
+		energy+=profile[getBin(c+dir.getCoordinate(axis),profile.size())]-profile[getBin(c,profile.size())];
+	}
+	return energy;
+}
+
+template<class IngredientsType, class LocalMoveType>
+bool FeatureExternalField::checkLocalMove(const IngredientsType& ingredients, LocalMoveType& move) const
+{
+	const uint32_t type=uint32_t(ingredients.getMolecules()[move.getIndex()].getAttributeTag());
+	if(type>=getNTypes()) return true;
+
+	const VectorInt3& dir=move.getDir();
+	double factor=forceFactor[type*NDirections+getDirectionIndex(dir)];
+
+	if(profileAxes[type]!=0){
+		const VectorInt3& pos=ingredients.getMolecules()[move.getIndex()];
+		for(uint32_t axis=0;axis<3;axis++){
+			if(((profileAxes[type]>>axis)&1)==0 || dir.getCoordinate(axis)==0) continue;
+			const std::vector<double>& table=profileFactor[3*type+axis];
+			factor*=table[3*getBin(pos.getCoordinate(axis),table.size()/3)+dir.getCoordinate(axis)+1];
+		}
+	}
+
+	if(factor!=1.0) move.multiplyProbability(factor);
+	return true;
+}
+
+template<class IngredientsType>
+void FeatureExternalField::synchronize(IngredientsType& ingredients)
+{
+	fieldEnergy=0.0;
+	for(size_t n=0;n<ingredients.getMolecules().size();n++)
+		fieldEnergy+=getPotential(ingredients.getMolecules()[n].getAttributeTag(),ingredients.getMolecules()[n]);
+}
+
+/*****************************************************************/
+/**
+ * @class ReadExternalForce
+ *
+ * @brief Handles BFM-File-Reads \b #!external_force
+ * @details Format: #!external_force=type fx fy fz
+ * @tparam IngredientsType Ingredients class storing all system information.
+ **/
+template < class IngredientsType>
+class ReadExternalForce: public ReadToDestination<IngredientsType>
+{
+public:
+	ReadExternalForce(IngredientsType& i):ReadToDestination<IngredientsType>(i){}
+	virtual ~ReadExternalForce(){}
+	virtual void execute();
+};
+
+template<class IngredientsType>
+void ReadExternalForce<IngredientsType>::execute()
+{
+	std::cout<<"reading #!external_force...";
+
+	int32_t type;
+	double fx, fy, fz;
+	std::istream& source=this->getInputStream();
+	source>>type>>fx>>fy>>fz;
+	if(source.fail())
+		throw std::runtime_error("ReadExternalForce<IngredientsType>::execute()\n Could not read external force");
+
+	this->getDestination().setForce(type,VectorDouble3(fx,fy,fz));
+	std::cout<<"type "<<type<<": "<<fx<<" "<<fy<<" "<<fz<<std::endl;
+}
+
+/*****************************************************************/
+/**
+ * @class WriteExternalForce
+ *
+ * @brief Handles BFM-File-Write \b #!external_force
+ * @tparam IngredientsType Ingredients class storing all system information.
+ **/
+template <class IngredientsType>
+class WriteExternalForce:public AbstractWrite<IngredientsType>
+{
+public:
+	WriteExternalForce(const IngredientsType& i)
+	:AbstractWrite<IngredientsType>(i){this->setHeaderOnly(true);}
+
+	virtual ~WriteExternalForce(){}
+
+	virtual void writeStream(std::ostream& strm);
+};
+
+template<class IngredientsType>
+void WriteExternalForce<IngredientsType>::writeStream(std::ostream& stream)
+{
+	const IngredientsType& source=this->getSource();
+	bool written=false;
+	std::streamsize oldPrecision=stream.precision(17);
+	for(uint32_t type=0;type<source.getNTypes();type++){
+		const VectorDouble3 force=source.getForce(type);
+		if(force.getX()==0.0 && force.getY()==0.0 && force.getZ()==0.0) continue;
+		stream<<"#!external_force="<<type<<" "<<force.getX()<<" "<<force.getY()<<" "<<force.getZ()<<"\n";
+		written=true;
+	}
+	stream.precision(oldPrecision);
+	if(written) stream<<"\n";
+}
+
+/*****************************************************************/
+/**
+ * @class ReadExternalPotentialProfile
+ *
+ * @brief Handles BFM-File-Reads \b #!external_potential_profile
+ * @details Format: #!external_potential_profile=type axis n V(0) ... V(n-1)
+ * @tparam IngredientsType Ingredients class storing all system information.
+ **/
+template < class IngredientsType>
+class ReadExternalPotentialProfile: public ReadToDestination<IngredientsType>
+{
+public:
+	ReadExternalPotentialProfile(IngredientsType& i):ReadToDestination<IngredientsType>(i){}
+	virtual ~ReadExternalPotentialProfile(){}
+	virtual void execute();
+};
+
+template<class IngredientsType>
+void ReadExternalPotentialProfile<IngredientsType>::execute()
+{
+	std::cout<<"reading #!external_potential_profile...";
+
+	int32_t type;
+	uint32_t axis;
+	size_t nBins;
+	std::istream& source=this->getInputStream();
+	source>>type>>axis>>nBins;
+
+	std::vector<double> profile(source.fail() ? 0 : nBins);
+	for(size_t c=0;c<profile.size();c++) source>>profile[c];
+
+	if(source.fail())
+		throw std::runtime_error("ReadExternalPotentialProfile<IngredientsType>::execute()\n Could not read external potential profile");
+
+	this->getDestination().setPotentialProfile(type,axis,profile);
+	std::cout<<"type "<<type<<", axis "<<axis<<", "<<nBins<<" bins"<<std::endl;
+}
+
+/*****************************************************************/
+/**
+ * @class WriteExternalPotentialProfile
+ *
+ * @brief Handles BFM-File-Write \b #!external_potential_profile
+ * @tparam IngredientsType Ingredients class storing all system information.
+ **/
+template <class IngredientsType>
+class WriteExternalPotentialProfile:public AbstractWrite<IngredientsType>
+{
+public:
+	WriteExternalPotentialProfile(const IngredientsType& i)
+	:AbstractWrite<IngredientsType>(i){this->setHeaderOnly(true);}
+
+	virtual ~WriteExternalPotentialProfile(){}
+
+	virtual void writeStream(std::ostream& strm);
+};
+
+template<class IngredientsType>
+void WriteExternalPotentialProfile<IngredientsType>::writeStream(std::ostream& stream)
+{
+	const IngredientsType& source=this->getSource();
+	bool written=false;
+	std::streamsize oldPrecision=stream.precision(17);
+	for(uint32_t type=0;type<source.getNTypes();type++)
+	for(uint32_t axis=0;axis<3;axis++){
+		const std::vector<double>& profile=source.getPotentialProfile(type,axis);
+		if(profile.empty()) continue;
+		stream<<"#!external_potential_profile="<<type<<" "<<axis<<" "<<profile.size();
+		for(size_t c=0;c<profile.size();c++) stream<<" "<<profile[c];
+		stream<<"\n";
+		written=true;
+	}
+	stream.precision(oldPrecision);
+	if(written) stream<<"\n";
+}
+
+/**
+ * @details The function is called by the Ingredients class when an object of type Ingredients
+ * is associated with an object of type FileImport. The export of the Reads is thus
+ * taken care automatically when it becomes necessary.\n
+ * Registered Read-In Commands:
+ * * #!external_force
+ * * #!external_potential_profile
+ *
+ * @param fileReader File importer for the bfm-file
+ * @tparam IngredientsType Ingredients class storing all system information.
+ **/
+template<class IngredientsType>
+void FeatureExternalField::exportRead(FileImport< IngredientsType >& fileReader)
+{
+	fileReader.registerRead("#!external_force", new ReadExternalForce<FeatureExternalField>(*this));
+	fileReader.registerRead("#!external_potential_profile", new ReadExternalPotentialProfile<FeatureExternalField>(*this));
+}
+
+/**
+ * The function is called by the Ingredients class when an object of type Ingredients
+ * is associated with an object of type AnalyzerWriteBfmFile. The export of the Writes is thus
+ * taken care automatically when it becomes necessary.\n
+ * Registered Write-Out Commands:
+ * * #!external_force
+ * * #!external_potential_profile
+ *
+ * @param fileWriter File writer for the bfm-file.
+ */
+template<class IngredientsType>
+void FeatureExternalField::exportWrite(AnalyzerWriteBfmFile< IngredientsType >& fileWriter) const
+{
+	fileWriter.registerWrite("#!external_force", new WriteExternalForce<FeatureExternalField>(*this));
+	fileWriter.registerWrite("#!external_potential_profile", new WriteExternalPotentialProfile<FeatureExternalField>(*this));
+}
+
+#endif /* LEMONADE_FEATURE_FEATUREEXTERNALFIELD_H */
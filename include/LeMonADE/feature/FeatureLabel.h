@@ -419,8 +419,11 @@ void FeatureLabel::fillLattice(IngredientsType& ingredients)
   labelLattice.setupLattice(nTendomers,nArms,2+nMonomersPerChain);
   const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
   //copy the lattice occupation from the monomer coordinates
+  //every tendomer writes its own sites, thus the tendomers are filled in parallel
+  bool multipleOccupation=false;
   //number of tendomers 
-  for(uint32_t n=0;n<nTendomers;n++)
+  #pragma omp parallel for schedule(static) reduction(||:multipleOccupation)
+  for(int32_t n=0;n<int32_t(nTendomers);n++)
     //number of arms
     for(uint32_t a=0;a<nArms;a++)
       //number of monomers per arm
@@ -440,7 +443,7 @@ void FeatureLabel::fillLattice(IngredientsType& ingredients)
 	      label=0;
 	    if( labelLattice.getLatticeEntry(pos)!=0 )
 	    {
-		    throw std::runtime_error("********** FeatureLabel::fillLattice: multiple lattice occupation ******************");
+		    multipleOccupation=true;
 	    }
 	    else if (label > 0)
 	    {
@@ -454,10 +457,20 @@ void FeatureLabel::fillLattice(IngredientsType& ingredients)
 		    // unoccupied monomers 
 		    labelLattice.setLatticeEntry(pos,label);
 	    }
-	    IDToCoordiantes[ID]=pos;
-// 	    std::cout << ID << " " << IDToCoordiantes[ID] << " " << label <<std::endl; 
 	  }
-// 	  std::cout << "labelLattice["<<n<<","<<a<<","<<m<<"]="<<labelLattice.getLatticeEntry(n,a,m)<<std::endl;
+      }
+
+  if(multipleOccupation)
+    throw std::runtime_error("********** FeatureLabel::fillLattice: multiple lattice occupation ******************");
+
+  //the IDs grow with (n,a,m), such that every insertion happens at the end of the map
+  IDToCoordiantes.clear();
+  for(uint32_t n=0;n<nTendomers;n++)
+    for(uint32_t a=0;a<nArms;a++)
+      for(uint32_t m=1;m<nMonomersPerChain+1;m++)
+      {
+	  uint32_t ID(m+n*nMonomersPerChain*nArms+a*nMonomersPerChain-1);
+	  IDToCoordiantes.insert(IDToCoordiantes.end(),std::make_pair(ID,VectorInt3(n,a,m)));
       }
   latticeFilledUp=true;
 }
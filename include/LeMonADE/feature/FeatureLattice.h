@@ -193,7 +193,9 @@ inline void FeatureLattice<ValueType>::setLatticeEntry(const int x, const int y,
  */
 template<class ValueType>
 inline uint32_t FeatureLattice<ValueType>::foldBackX(int value) const{
-	return (((value%this->_boxX)+this->_boxX)%this->_boxX);
+	const int box=int(this->_boxX);
+	const int folded=value%box;
+	return uint32_t(folded<0 ? folded+box : folded);
 }
 
 /**
@@ -204,7 +206,9 @@ inline uint32_t FeatureLattice<ValueType>::foldBackX(int value) const{
  */
 template<class ValueType>
 inline uint32_t FeatureLattice<ValueType>::foldBackY(int value) const{
-	return (((value%this->_boxY)+this->_boxY)%this->_boxY);
+	const int box=int(this->_boxY);
+	const int folded=value%box;
+	return uint32_t(folded<0 ? folded+box : folded);
 }
 
 /**
@@ -215,7 +219,9 @@ inline uint32_t FeatureLattice<ValueType>::foldBackY(int value) const{
  */
 template<class ValueType>
 inline uint32_t FeatureLattice<ValueType>::foldBackZ(int value) const{
-	return (((value%this->_boxZ)+this->_boxZ)%this->_boxZ);
+	const int box=int(this->_boxZ);
+	const int folded=value%box;
+	return uint32_t(folded<0 ? folded+box : folded);
 }
 
 
@@ -230,6 +236,11 @@ template<class ValueType>
 template<class IngredientsType>
 void FeatureLattice<ValueType>::synchronize(IngredientsType& ing) {
 
+	//keep the lattice content for the incremental update by the filling features
+		if(this->incrementalSynchronization && this->lattice!=NULL &&
+		   this->_boxX==uint32_t(ing.getBoxX()) && this->_boxY==uint32_t(ing.getBoxY()) && this->_boxZ==uint32_t(ing.getBoxZ()))
+			return;
+
 	//if the lattice is already initialized, free the memory first
 		if(this->lattice)
 			delete[] this->lattice;
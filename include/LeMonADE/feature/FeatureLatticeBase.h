@@ -29,6 +29,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #define LEMONADE_FEATURE_FEATURELATTICEBASE_H
 
 #include <iostream>
+#include <algorithm>
 
 #include <LeMonADE/feature/Feature.h>
 #include <LeMonADE/feature/FeatureBox.h>
@@ -109,6 +110,31 @@ public:
 	//delocate memory
         void deleteLattice();
 
+	/**
+	 * @brief Keeps the lattice content in synchronize(), if the box size did not change.
+	 *
+	 * @details The features filling the lattice then only update the sites of
+	 * monomers which changed since the last synchronization (see LatticeFillScheduler).
+	 * This is meant for stepping through frames of a trajectory, e.g. with
+	 * UpdaterReadBfmFile. It must not be used if moves are applied between
+	 * two calls of synchronize(), because these change the lattice already.
+	 */
+	void setIncrementalSynchronization(bool incremental){incrementalSynchronization=incremental;}
+
+	//! Returns true if the lattice content is kept in synchronize()
+	bool getIncrementalSynchronization() const {return incrementalSynchronization;}
+
+	//! Counter which changes whenever the lattice is allocated, cleared or replaced
+	uint64_t getLatticeGeneration() const {return latticeGeneration;}
+
+	//! Writes the lattice occupation into a checkpoint, if the checkpoint includes the lattice
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType& ingredients, CheckpointOut& checkpoint) const;
+
+	//! Restores the lattice occupation from a checkpoint. Returns false, if it has to be synchronized
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType& ingredients, CheckpointIn& checkpoint);
+
 protected:
 
 	//! Hold the value of lattice size in X
@@ -143,6 +169,12 @@ protected:
 	 * FeatureLatticePowerOfTwo: lattice[idx]=lattice[x+(y<<xPro)+(z<<proXY)]
 	 */
 	ValueType* lattice;
+
+	//! If true, synchronize() keeps the lattice content
+	bool incrementalSynchronization;
+
+	//! Incremented whenever the lattice content is reset
+	uint64_t latticeGeneration;
 };
 
 /******************************************************************************/
@@ -153,6 +185,7 @@ protected:
 template<template<typename> class SpecializedClass, typename ValueType>
 FeatureLatticeBase<SpecializedClass<ValueType> >::FeatureLatticeBase()
 	:_boxX(0),_boxY(0),_boxZ(0),boxXm1(0),boxYm1(0),boxZm1(0),xPro(0),proXY(0),lattice(NULL)
+	,incrementalSynchronization(false),latticeGeneration(0)
 {
 
 }
@@ -199,6 +232,8 @@ FeatureLatticeBase<SpecializedClass<ValueType> >::FeatureLatticeBase(const Featu
 
 	lattice = new ValueType[_boxX*_boxY*_boxZ];
 
+	incrementalSynchronization = copyFeatureLatticeBase.incrementalSynchronization;
+	latticeGeneration = copyFeatureLatticeBase.latticeGeneration+1;
 }
 
 
@@ -228,6 +263,9 @@ FeatureLatticeBase<SpecializedClass<ValueType> >&  FeatureLatticeBase<Specialize
     xPro   = FeatureLatticeBaseSource.xPro;
     proXY  = FeatureLatticeBaseSource.proXY;
 
+    incrementalSynchronization = FeatureLatticeBaseSource.incrementalSynchronization;
+    latticeGeneration = std::max(latticeGeneration,FeatureLatticeBaseSource.latticeGeneration)+1;
+
     if ( oldSize != newSize )
     {
         this->deleteLattice();
@@ -343,6 +381,51 @@ void FeatureLatticeBase<SpecializedClass<ValueType> >::synchronize(IngredientsTy
 
 
 
+/**
+ * @details The lattice is stored as raw memory together with its dimensions and
+ * indexing constants, such that restoring it does not require a synchronization.
+ * Nothing is written, if the checkpoint does not include the lattice.
+ */
+template<template<typename> class SpecializedClass, typename ValueType>
+template<class IngredientsType, class CheckpointOut>
+void FeatureLatticeBase<SpecializedClass<ValueType> >::writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+{
+	if(!checkpoint.includesLattice()) return;
+
+	uint8_t allocated=(lattice!=NULL);
+	checkpoint.write(allocated);
+	if(!allocated) return;
+
+	checkpoint.write(_boxX); checkpoint.write(_boxY); checkpoint.write(_boxZ);
+	checkpoint.write(boxXm1); checkpoint.write(boxYm1); checkpoint.write(boxZm1);
+	checkpoint.write(xPro); checkpoint.write(proXY);
+	checkpoint.writeArray(lattice,uint64_t(_boxX)*_boxY*_boxZ);
+}
+
+/**
+ * @return true if the lattice was restored, false if it is not part of the
+ * checkpoint and has to be synchronized.
+ */
+template<template<typename> class SpecializedClass, typename ValueType>
+template<class IngredientsType, class CheckpointIn>
+bool FeatureLatticeBase<SpecializedClass<ValueType> >::readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+{
+	if(!checkpoint.includesLattice()) return false;
+
+	uint8_t allocated;
+	checkpoint.read(allocated);
+	if(!allocated) return false;
+
+	deleteLattice();
+	checkpoint.read(_boxX); checkpoint.read(_boxY); checkpoint.read(_boxZ);
+	checkpoint.read(boxXm1); checkpoint.read(boxYm1); checkpoint.read(boxZm1);
+	checkpoint.read(xPro); checkpoint.read(proXY);
+	lattice = new ValueType[uint64_t(_boxX)*_boxY*_boxZ];
+	checkpoint.readArray(lattice,uint64_t(_boxX)*_boxY*_boxZ);
+	latticeGeneration++;
+	return true;
+}
+
 /**
  * This method allocates memory for the lattice and fill it with the native value of \a ValueType.
  */
@@ -357,6 +440,7 @@ void FeatureLatticeBase<SpecializedClass<ValueType> >::setupLattice()
 
 	for(uint32_t i = 0; i < _boxX*_boxY*_boxZ; i++)
 		lattice[i]=ValueType();
+	latticeGeneration++;
 
 	std::cout<<"done with size " << (_boxX*_boxY*_boxZ*sizeof(ValueType)) << " bytes = " << (_boxX*_boxY*_boxZ*sizeof(ValueType)/(1024.0*1024.0)) << " MB for lattice" <<std::endl;
 
@@ -394,6 +478,7 @@ void FeatureLatticeBase<SpecializedClass<ValueType> >::setupLattice(uint32_t box
 
 	for(uint32_t i = 0; i < _boxX*_boxY*_boxZ; i++)
 		lattice[i]=ValueType();
+	latticeGeneration++;
 
 	std::cout<<"done with size " << (_boxX*_boxY*_boxZ*sizeof(ValueType)) << " bytes = " << (_boxX*_boxY*_boxZ*sizeof(ValueType)/(1024.0*1024.0)) << " MB for lattice" <<std::endl;
 
@@ -411,6 +496,7 @@ void FeatureLatticeBase<SpecializedClass<ValueType> >::clearLattice()
 	// initialize to native value (=0)
 	for(uint32_t i = 0; i < _boxX*_boxY*_boxZ; i++)
 		lattice[i]=ValueType();
+	latticeGeneration++;
 }
 
 #endif /* LEMONADE_FEATURE_FEATURELATTICEBASE_H */
@@ -230,6 +230,11 @@ template<class ValueType>
 template<class IngredientsType>
 void FeatureLatticePowerOfTwo<ValueType>::synchronize(IngredientsType& val) {
 
+	//keep the lattice content for the incremental update by the filling features
+		if(this->incrementalSynchronization && this->lattice!=NULL &&
+		   this->_boxX==uint32_t(val.getBoxX()) && this->_boxY==uint32_t(val.getBoxY()) && this->_boxZ==uint32_t(val.getBoxZ()))
+			return;
+
 	//if the lattice is already initialized, free the memory first
 		if(this->lattice)
 			delete[] this->lattice;
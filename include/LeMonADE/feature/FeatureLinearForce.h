@@ -32,6 +32,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/updater/moves/MoveBase.h>
 #include <LeMonADE/updater/moves/MoveLocalSc.h>
 #include <LeMonADE/updater/moves/MoveLocalScDiag.h>
+#include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
 #include <LeMonADE/feature/FeatureAttributes.h>
 #include <LeMonADE/feature/FeatureBoltzmann.h>
 #include <LeMonADE/io/FileImport.h>
@@ -46,6 +47,12 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  *
  * @class FeatureLinearForce
  * @brief This Feature applies a force on certain monomers. 
+ * @details Monomers with attribute 4 are pulled in negative, monomers with
+ * attribute 5 in positive x-direction. The potential energy
+ * E=f*(sum_4 x - sum_5 x) is kept up to date in applyMove() and recalculated
+ * in synchronize(). It is zero while the force is switched off.
+ * @see FeatureExternalField for forces on arbitrary types and along arbitrary
+ * axes, and position dependent potentials.
  * @todo Substitute the FeatureAttributes<> by appropriate monomer extension 
  * */
 /*****************************************************************************/
@@ -57,7 +64,7 @@ class FeatureLinearForce:public Feature
 {
 public:
 
-	FeatureLinearForce(): ForceOn(false){};
+	FeatureLinearForce(): ForceOn(false),Amplitude_Force(0.0),prob(1.0),forceCoordinateSum(0){};
 	virtual ~FeatureLinearForce(){};
 	
 	//the FeatureBoltzmann: adds a probability for the move 
@@ -75,6 +82,37 @@ public:
     //! check for a MoveLocalScDiag
 	template<class IngredientsType> 
 	bool checkMove(const IngredientsType& ingredients,MoveLocalScDiag& move) const;
+
+	//! For all unknown moves: this does nothing
+	template<class IngredientsType>
+	void applyMove(const IngredientsType&,const MoveBase&){}
+
+	//! updates the energy for a MoveLocalSc
+	template<class IngredientsType>
+	void applyMove(const IngredientsType& ingredients,const MoveLocalSc& move)
+	{forceCoordinateSum+=forceDirection(ingredients.getMolecules()[move.getIndex()].getAttributeTag())*move.getDir().getX();}
+
+	//! updates the energy for a MoveLocalScDiag
+	template<class IngredientsType>
+	void applyMove(const IngredientsType& ingredients,const MoveLocalScDiag& move)
+	{forceCoordinateSum+=forceDirection(ingredients.getMolecules()[move.getIndex()].getAttributeTag())*move.getDir().getX();}
+
+	//! updates the energy for an added monomer
+	template<class IngredientsType,class TagType>
+	void applyMove(const IngredientsType& ingredients,const MoveAddMonomerSc<TagType>& move)
+	{forceCoordinateSum+=forceDirection(int32_t(move.getTag()))*move.getPosition().getX();}
+
+	//! recalculates the energy from the positions of the monomers
+	template<class IngredientsType>
+	void synchronize(IngredientsType& ingredients);
+
+	//! potential energy of the force sensitive monomers in kT
+	double getLinearForceEnergy() const {return ForceOn ? Amplitude_Force*double(forceCoordinateSum) : 0.0;}
+
+	//! adds the potential energy to report (see EnergyReport)
+	template<class EnergyReportType>
+	void reportEnergy(EnergyReportType& report) const
+	{report.addEnergy("FeatureLinearForce",getLinearForceEnergy());}
 	
 	//! set the strength of the force 
 	void setAmplitudeForce(double amplitudeForce){
@@ -90,6 +128,23 @@ public:
 
 	//! applies a force on the monomers or not
 	bool isForceOn() const {return ForceOn;}
+
+	//! writes the force settings into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{checkpoint.write(ForceOn); checkpoint.write(Amplitude_Force);}
+
+	//! restores the force settings from a checkpoint. The energy is recalculated in synchronize()
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{
+		bool forceOn;
+		double amplitudeForce;
+		checkpoint.read(forceOn); checkpoint.read(amplitudeForce);
+		setForceOn(forceOn);
+		setAmplitudeForce(amplitudeForce);
+		return false;
+	}
 	
 	//! Export the relevant functionality for reading bfm-files to the responsible reader object
 	template <class IngredientsType>
@@ -106,6 +161,10 @@ private:
 	double Amplitude_Force; 
     //!probability againest not prefered direction
     double prob;
+    //! sum of the x-coordinates of monomers with attribute 4 minus the ones with attribute 5
+    int64_t forceCoordinateSum;
+    //! +1 for attribute 4, -1 for attribute 5, 0 otherwise
+    static int64_t forceDirection(int32_t tag){return (tag==4) ? 1 : ((tag==5) ? -1 : 0);}
 };
 ////////////////////////////////////////////////////////////////////////////////
 //////////define member functions //////////////////////////////////////////////
@@ -170,6 +229,19 @@ bool FeatureLinearForce::checkMove(const IngredientsType& ingredients, MoveLocal
 	return true;
 }
 
+/**
+ * @details The sum of the coordinates is kept also while the force is
+ * switched off, such that setForceOn() and setAmplitudeForce() need no
+ * recalculation.
+ */
+template<class IngredientsType>
+void FeatureLinearForce::synchronize(IngredientsType& ingredients)
+{
+	forceCoordinateSum=0;
+	for(size_t n=0;n<ingredients.getMolecules().size();n++)
+		forceCoordinateSum+=forceDirection(ingredients.getMolecules()[n].getAttributeTag())*ingredients.getMolecules()[n].getX();
+}
+
 /*****************************************************************/
 /**
  * @class ReadForceFieldOn
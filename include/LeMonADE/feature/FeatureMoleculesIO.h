@@ -53,7 +53,7 @@ class FeatureMoleculesIO:public Feature
 public:
 	typedef LOKI_TYPELIST_2(FeatureBox,FeatureBondset< >) required_features_back;
 
-	FeatureMoleculesIO():numberOfMonomers(0),maxConnectivity(0){}
+	FeatureMoleculesIO():numberOfMonomers(0),maxConnectivity(0),mcsKeyframeInterval(1){}
 	//! Export the relevant functionality for reading bfm-files to the responsible reader object
 	template<class IngredientsType>
 	void exportRead(FileImport<IngredientsType>& fileReader);
@@ -95,11 +95,23 @@ public:
 	 * */
 	const std::map<size_t,size_t>& getCompressedOutputIndices() const {return solventIndices;}
 
+	/**
+	 * @brief set the number of frames between two complete conformations (!mcs) in the output
+	 * @details The frames in between are written as !mcs_delta containing only the
+	 * monomers moved since the previous frame. 0 and 1 (default) write every frame as !mcs.
+	 * */
+	void setMcsKeyframeInterval(uint32_t interval){mcsKeyframeInterval=interval;}
+
+	//! get the number of frames between two complete conformations (!mcs) in the output
+	uint32_t getMcsKeyframeInterval() const {return mcsKeyframeInterval;}
+
 private:
 	//metadata
 	uint numberOfMonomers,maxConnectivity;
 	//monomers to be compressed
 	std::map<size_t,size_t> solventIndices;
+	//frames between two complete conformations in the output
+	uint32_t mcsKeyframeInterval;
 
 };
 
@@ -118,6 +130,7 @@ private:
 * * !add_bonds
 * * !remove_bonds
 * * !mcs
+* * !mcs_delta
 *
 * @param fileReader File importer for the bfm-file
 * @tparam IngredientsType Features used in the system. See Ingredients.
@@ -132,6 +145,7 @@ void FeatureMoleculesIO::exportRead(FileImport<IngredientsType>& fileReader)
 	fileReader.registerRead("!add_bonds", new  ReadBonds< IngredientsType > (destination) );
 	fileReader.registerRead("!remove_bonds", new  ReadRemoveBonds< IngredientsType > (destination) );
 	fileReader.registerRead("!mcs", new  ReadMcs< IngredientsType > (destination) );
+	fileReader.registerRead("!mcs_delta", new  ReadMcsDelta< IngredientsType > (destination) );
 }
 
 
@@ -144,7 +158,7 @@ void FeatureMoleculesIO::exportRead(FileImport<IngredientsType>& fileReader)
 * * !bonds
 * * !add_bonds
 * * !remove_bonds
-* * !mcs
+* * !mcs (or !mcs_delta, see setMcsKeyframeInterval())
 *
 * @param fileWriter File writer for the bfm-file.
 * @tparam IngredientsType Features used in the system. See Ingredients.
@@ -157,7 +171,7 @@ void FeatureMoleculesIO::exportWrite(AnalyzerWriteBfmFile<IngredientsType>& file
 	fileWriter.registerWrite("!bonds", new WriteBonds <IngredientsType> (source));
 	fileWriter.registerWrite("!add_bonds", new WriteAddBonds<IngredientsType> (source,fileWriter.getCommandType()));
 	fileWriter.registerWrite("!remove_bonds", new WriteRemoveBonds<IngredientsType> (source,fileWriter.getCommandType()));
-	fileWriter.registerWrite("!mcs", new WriteMcs <IngredientsType> (source));
+	fileWriter.registerWrite("!mcs", new WriteMcs <IngredientsType> (source,fileWriter.getCommandType()));
 }
 
 
@@ -38,6 +38,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @todo MoveAddMonomerBcc is used here, which might be obsolete.
 **/
 
+#include <cmath>
+
 #include <LeMonADE/feature/Feature.h>
 #include <LeMonADE/updater/moves/MoveBase.h>
 #include <LeMonADE/updater/moves/MoveLocalBcc.h>
@@ -46,6 +48,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/feature/FeatureBoltzmann.h>
 #include <LeMonADE/feature/FeatureAttributes.h>
 #include <LeMonADE/feature/FeatureNNInteractionReadWrite.h>
+#include <LeMonADE/utility/LastCheckedMove.h>
 
 /**
  * @class FeatureNNInteractionBcc
@@ -69,6 +72,9 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * FeatureNNInteractionBcc<FeatureLatticePowerOfTwo> (2**n lattices)
  * The feature adds the bfm-file command !nn_interaction A B E
  * for monomers of types A B with interaction energy of E in kT.
+ * The feature keeps the total contact energy of the system, which is
+ * recalculated in synchronize() and updated with the energy difference of
+ * every applied MoveLocalBcc and MoveAddMonomerBcc.
 **/
 
 template<template<typename> class FeatureLatticeType>
@@ -85,11 +91,22 @@ private:
   //! Lookup table for exp(-interactionTable[a][b])
   double probabilityLookup[256][256];
 
+  //! Total contact energy of the system
+  double nnInteractionEnergy;
+
+  //! Factor exp(-dE) of the last checked move of type MoveLocalBcc
+  mutable LastCheckedMove lastChecked;
+
   //! Returns this feature's factor for the acceptance probability for the given Monte Carlo move
   template<class IngredientsType>
   double calculateAcceptanceProbability(const IngredientsType& ingredients,
 					const MoveLocalBcc& move) const;
 
+  //! Returns the contact energy of a monomer of given type at pos
+  template<class IngredientsType>
+  double calculateContactEnergy(const IngredientsType& ingredients,
+				const VectorInt3& pos,int32_t type) const;
+
   //! Occupies the lattice with the attribute tags of all monomers
   template<class IngredientsType>
   void fillLattice(IngredientsType& ingredients);
@@ -141,8 +158,10 @@ public:
   template<class IngredientsType>
     void applyMove(IngredientsType& ing, const MoveAddMonomerBcc<int32_t>& move);
 
-  //note: apply function for bcc-BFM local move is not necessary, because
-  //job of moving lattice entries is done by the underlying FeatureLatticeType
+  //! apply function for bcc-BFM local move, updates the contact energy
+  //(the lattice entries are moved by the underlying FeatureLatticeType)
+  template<class IngredientsType>
+    void applyMove(const IngredientsType& ing, const MoveLocalBcc& move);
 
   //! guarantees that the lattice is properly occupied with monomer attributes
   template<class IngredientsType>
@@ -154,6 +173,18 @@ public:
   //!returns the interaction energy between two types of monomers
   double getNNInteraction(int32_t typeA,int32_t typeB) const;
 
+  //!returns the total contact energy of the system in kT
+  double getNNInteractionEnergy() const {return nnInteractionEnergy;}
+
+  //!calculates the total contact energy of the system from the lattice
+  template<class IngredientsType>
+  double calculateNNInteractionEnergy(const IngredientsType& ingredients) const;
+
+  //!adds the contact energy to report (see EnergyReport)
+  template<class EnergyReportType>
+  void reportEnergy(EnergyReportType& report) const
+  {report.addEnergy("FeatureNNInteractionBcc",nnInteractionEnergy);}
+
   //!export bfm-file read command !nn_interaction
   template <class IngredientsType>
   void exportRead(FileImport <IngredientsType>& fileReader);
@@ -162,6 +193,22 @@ public:
   template <class IngredientsType>
   void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& fileWriter) const;
 
+  //!writes the contact energies into a checkpoint
+  template<class IngredientsType, class CheckpointOut>
+  void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+  {checkpoint.writeArray(&interactionTable[0][0],256*256);}
+
+  //!restores the contact energies and the probability lookup. The lattice and the contact energy are synchronized
+  template<class IngredientsType, class CheckpointIn>
+  bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+  {
+    checkpoint.readArray(&interactionTable[0][0],256*256);
+    for(size_t n=0;n<256;n++)
+      for(size_t m=0;m<256;m++)
+        probabilityLookup[m][n]=exp(-interactionTable[m][n]);
+    return false;
+  }
+
 };
 
 
@@ -172,6 +219,7 @@ public:
  **/
 template<template<typename> class LatticeClassType>
 FeatureNNInteractionBcc<LatticeClassType>::FeatureNNInteractionBcc()
+:nnInteractionEnergy(0.0)
 {
   //initialize the energy and probability lookups with default values
   for(size_t n=0;n<256;n++)
@@ -216,9 +264,40 @@ bool FeatureNNInteractionBcc<LatticeClassType>::checkMove(const IngredientsType&
   //because the total probability is evaluated by FeatureBoltzmann at the end
   double prob=calculateAcceptanceProbability(ingredients,move);
   move.multiplyProbability(prob);
+
+  lastChecked.set(move.getIndex(),move.getDir(),prob);
+
   return true;
 }
 
+/**
+ * @details Updates the contact energy. If the move is the one checked last,
+ * the energy difference is obtained from its probability factor exp(-dE),
+ * otherwise the contact energies at the old and new position are compared.
+ *
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] move Monte Carlo move of type MoveLocalBcc
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+void FeatureNNInteractionBcc<LatticeClassType>::applyMove(const IngredientsType& ing,
+							 const MoveLocalBcc& move)
+{
+  if(lastChecked.matches(move.getIndex(),move.getDir()))
+  {
+    nnInteractionEnergy+=lastChecked.getEnergyDifference();
+  }
+  else
+  {
+    //the old and new position are not part of each other's contact shell,
+    //so it does not matter whether the lattice entry was already moved
+    const VectorInt3 oldPos=ing.getMolecules()[move.getIndex()];
+    const int32_t monoType=ing.getMolecules()[move.getIndex()].getAttributeTag();
+    nnInteractionEnergy+=calculateContactEnergy(ing,oldPos+move.getDir(),monoType)
+                        -calculateContactEnergy(ing,oldPos,monoType);
+  }
+}
+
 /**
  * @details Because moves of type MoveLocalSc must not be used with this
  * feature, this function always throws an exception when called. The function
@@ -274,6 +353,8 @@ void FeatureNNInteractionBcc<LatticeClassType>::applyMove(IngredientsType& ing,
 
     //update lattice
     ing.setLatticeEntry(pos,type);
+
+    nnInteractionEnergy+=calculateContactEnergy(ing,pos,int32_t(type));
 }
 
 /**
@@ -311,6 +392,9 @@ void FeatureNNInteractionBcc<LatticeClassType>::synchronize(IngredientsType& ing
     //caution: this overwrites, what is currently written on the lattice
     fillLattice(ingredients);
 
+    //recalculate the contact energy, removing any drift of the running sum
+    nnInteractionEnergy=calculateNNInteractionEnergy(ingredients);
+
 }
 
 
@@ -546,6 +630,61 @@ double FeatureNNInteractionBcc<LatticeClassType>::calculateAcceptanceProbability
 
 }
 
+/**
+ * @details Sums the interaction energies of the 26 lattice sites at the
+ * relative positions (2i,2j,2k), i,j,k in {-1,0,1}, i.e. all sites within
+ * the interaction range sqrt(12) which are not blocked by excluded volume.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] pos position of the monomer
+ * @param [in] type attribute tag of the monomer
+ * @return contact energy of the monomer (in kT)
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+double FeatureNNInteractionBcc<LatticeClassType>::calculateContactEnergy(
+    const IngredientsType& ingredients,
+    const VectorInt3& pos,
+    int32_t type) const
+{
+    const double* energies=interactionTable[type];
+    double energy=0.0;
+
+    for(int32_t dx=-2;dx<=2;dx+=2)
+      for(int32_t dy=-2;dy<=2;dy+=2)
+        for(int32_t dz=-2;dz<=2;dz+=2)
+        {
+          if(dx==0 && dy==0 && dz==0) continue;
+          energy+=energies[ingredients.getLatticeEntry(pos.getX()+dx,pos.getY()+dy,pos.getZ()+dz)];
+        }
+
+    return energy;
+}
+
+/**
+ * @details Every contact is counted from both monomers, so half of the sum
+ * of the contact energies of all monomers is returned. The lattice must be
+ * filled with the attribute tags.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @return total contact energy of the system (in kT)
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+double FeatureNNInteractionBcc<LatticeClassType>::calculateNNInteractionEnergy(
+    const IngredientsType& ingredients) const
+{
+    const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+    double energy=0.0;
+
+    for(size_t n=0;n<molecules.size();n++)
+      energy+=calculateContactEnergy(ingredients,molecules[n],molecules[n].getAttributeTag());
+
+    return 0.5*energy;
+}
+
 /**
  * @param typeA monomer attribute tag in range [1,255]
  * @param typeB monomer attribute tag in range [1,255]
@@ -36,6 +36,9 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @brief Definition and implementation of class template FeatureNNInteractionSc
 **/
 
+#include <cmath>
+#include <memory>
+
 #include <LeMonADE/feature/Feature.h>
 #include <LeMonADE/updater/moves/MoveBase.h>
 #include <LeMonADE/updater/moves/MoveLocalSc.h>
@@ -43,6 +46,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/feature/FeatureBoltzmann.h>
 #include <LeMonADE/feature/FeatureAttributes.h>
 #include <LeMonADE/feature/FeatureNNInteractionReadWrite.h>
+#include <LeMonADE/utility/LastCheckedMove.h>
 
 /**
  * @class FeatureNNInteractionSc
@@ -68,6 +72,17 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * FeatureNNInteractionSc<FeatureLatticePowerOfTwo> (2**n lattices)
  * The feature adds the bfm-file command !nn_interaction A B E
  * for monomers of types A B with interaction energy of E in kT.
+ * The lookup tables (1MB) are shared between copies of the feature, e.g.
+ * the replicas of a ReplicaEnsemble, and are only copied when one of the
+ * copies changes an interaction.
+ *
+ * The acceptance probabilities can be calculated for a temperature T other
+ * than 1 (setNNInteractionTemperature), which rescales the factors to
+ * exp(-E/T) while the energies E stay the same. This is used for parallel
+ * tempering (UpdaterReplicaExchange).
+ * The feature keeps the total contact energy of the system (in kT at T=1),
+ * which is recalculated in synchronize() and updated with the energy
+ * difference of every applied MoveLocalSc and MoveAddMonomerSc.
 **/
 
 template<template<typename> class FeatureLatticeType>
@@ -78,11 +93,72 @@ private:
   //! Type for the underlying lattice, used as template parameter for FeatureLatticeType<...>
   typedef uint8_t lattice_value_type;
 
-  //! Interaction energies between monomer types. Max. type=255 given by max(uint8_t)=255
-  double interactionTable[256][256];
+  //! Energy and probability lookup tables
+  struct InteractionTables
+  {
+    //! Interaction energies between monomer types. Max. type=255 given by max(uint8_t)=255
+    double interactionTable[256][256];
+
+    //! Lookup table for exp(-interactionTable[a][b]/temperature)
+    double probabilityLookup[256][256];
+
+    //! Temperature the probabilities are calculated for
+    double temperature;
+  };
+
+  //! Lookup tables, shared with copies of this feature until one of them is modified
+  std::shared_ptr<InteractionTables> tables;
 
-  //! Lookup table for exp(-interactionTable[a][b])
-  double probabilityLookup[256][256];
+  //! Total contact energy of the system
+  double nnInteractionEnergy;
+
+  //! Factor exp(-dE/T) of the last checked move, applied moves are nearly always the one checked last
+  mutable LastCheckedMove lastChecked;
+
+  //! Makes sure the tables are not shared before they are modified
+  void detachTables(){
+    if(tables.use_count()>1)
+      tables=std::shared_ptr<InteractionTables>(new InteractionTables(*tables));
+  }
+
+  //! Multiplies the probability factors of gained contacts and divides by the ones of lost contacts
+  struct ProbabilityAccumulator
+  {
+    ProbabilityAccumulator(const FeatureNNInteractionSc& feature_,int32_t monoType_)
+    :feature(feature_),monoType(monoType_),prob(1.0),prob_div(1.0){}
+    void gained(int32_t type){prob*=feature.getProbabilityFactor(monoType,type);}
+    void lost(int32_t type){prob_div*=feature.getProbabilityFactor(monoType,type);}
+    const FeatureNNInteractionSc& feature;
+    int32_t monoType;
+    double prob,prob_div;
+  };
+
+  //! Sums the energies of gained and lost contacts
+  struct EnergyAccumulator
+  {
+    EnergyAccumulator(const InteractionTables& tables,int32_t monoType)
+    :energies(tables.interactionTable[monoType]),gainedEnergy(0.0),lostEnergy(0.0){}
+    void gained(int32_t type){gainedEnergy+=energies[type];}
+    void lost(int32_t type){lostEnergy+=energies[type];}
+    const double* energies;
+    double gainedEnergy,lostEnergy;
+  };
+
+  //! Passes the lattice entries of all sites where contacts change by the move to accumulator
+  template<class IngredientsType,class ContactAccumulator>
+  void visitChangedContacts(const IngredientsType& ingredients,
+			    const MoveLocalSc& move,
+			    ContactAccumulator& accumulator) const;
+
+  //! Returns the change of the contact energy caused by the move
+  template<class IngredientsType>
+  double calculateEnergyDifference(const IngredientsType& ingredients,
+				   const MoveLocalSc& move) const;
+
+  //! Returns the contact energy of a monomer of given type at pos
+  template<class IngredientsType>
+  double calculateContactEnergy(const IngredientsType& ingredients,
+				const VectorInt3& pos,int32_t type) const;
 
   //! Returns this feature's factor for the acceptance probability for the given Monte Carlo move
   template<class IngredientsType>
@@ -93,6 +169,34 @@ private:
   template<class IngredientsType>
   void fillLattice(IngredientsType& ingredients);
 
+  //! Lattice value of a monomer, i.e. its attribute tag
+  struct AttributeValue
+  {
+    template<class MoleculesType>
+    lattice_value_type operator()(const MoleculesType& molecules, uint32_t n) const
+    {return lattice_value_type(molecules[n].getAttributeTag());}
+  };
+
+  //! Writes the attribute tag of a monomer on its lattice sites. Fails for tags out of range
+  template<class IngredientsType>
+  class AttributeWriter
+  {
+  public:
+    AttributeWriter(IngredientsType& ingredients_):ingredients(ingredients_){}
+    bool operator()(uint32_t n) const
+    {
+      const int32_t tag=ingredients.getMolecules()[n].getAttributeTag();
+      if(int32_t(lattice_value_type(tag))!=tag) return false;
+      LatticeFillScheduler<lattice_value_type>::setCube(ingredients,ingredients.getMolecules()[n].getVector3D(),lattice_value_type(tag));
+      return true;
+    }
+  private:
+    IngredientsType& ingredients;
+  };
+
+  //! Parallel fill and snapshot for the incremental synchronization
+  LatticeFillScheduler<lattice_value_type> fillScheduler;
+
   //! Access to array probabilityLookup with extra checks in Debug mode
   double getProbabilityFactor(int32_t typeA,int32_t typeB) const;
 
@@ -140,8 +244,10 @@ public:
   template<class IngredientsType>
     void applyMove(IngredientsType& ing, const MoveAddMonomerSc<int32_t>& move);
 
-  //note: apply function for sc-BFM local move is not necessary, because
-  //job of moving lattice entries is done by the underlying FeatureLatticeType
+  //! apply function for sc-BFM local move, updates the contact energy
+  //(the lattice entries are moved by the underlying FeatureLatticeType)
+  template<class IngredientsType>
+    void applyMove(const IngredientsType& ing, const MoveLocalSc& move);
 
   //! guarantees that the lattice is properly occupied with monomer attributes
   template<class IngredientsType>
@@ -153,6 +259,31 @@ public:
   //!returns the interaction energy between two types of monomers
   double getNNInteraction(int32_t typeA,int32_t typeB) const;
 
+  //!returns true if other uses the same lookup tables as this feature
+  bool sharesNNInteractionTables(const FeatureNNInteractionSc& other) const
+  {return tables==other.tables;}
+
+  //!sets the temperature the acceptance probabilities exp(-E/T) are calculated for
+  void setNNInteractionTemperature(double temperature);
+
+  //!returns the temperature the acceptance probabilities are calculated for
+  double getNNInteractionTemperature() const {return tables->temperature;}
+
+  //!exchanges the lookup tables (and thus the temperatures) with other, which must have the same energies
+  void swapNNInteractionTables(FeatureNNInteractionSc& other){tables.swap(other.tables);}
+
+  //!returns the total contact energy of the system in kT at temperature 1
+  double getNNInteractionEnergy() const {return nnInteractionEnergy;}
+
+  //!calculates the total contact energy of the system from the lattice
+  template<class IngredientsType>
+  double calculateNNInteractionEnergy(const IngredientsType& ingredients) const;
+
+  //!adds the contact energy to report (see EnergyReport)
+  template<class EnergyReportType>
+  void reportEnergy(EnergyReportType& report) const
+  {report.addEnergy("FeatureNNInteractionSc",nnInteractionEnergy);}
+
   //!export bfm-file read command !nn_interaction
   template <class IngredientsType>
   void exportRead(FileImport <IngredientsType>& fileReader);
@@ -161,6 +292,26 @@ public:
   template <class IngredientsType>
   void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& fileWriter) const;
 
+  //!writes the temperature and the contact energies into a checkpoint
+  template<class IngredientsType, class CheckpointOut>
+  void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+  {
+    checkpoint.write(tables->temperature);
+    checkpoint.writeArray(&(tables->interactionTable[0][0]),256*256);
+  }
+
+  //!restores the contact energies and the probability lookup. The lattice and the contact energy are synchronized
+  template<class IngredientsType, class CheckpointIn>
+  bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+  {
+    double temperature;
+    checkpoint.read(temperature);
+    detachTables();
+    checkpoint.readArray(&(tables->interactionTable[0][0]),256*256);
+    setNNInteractionTemperature(temperature);
+    return false;
+  }
+
 };
 
 
@@ -171,14 +322,17 @@ public:
  **/
 template<template<typename> class LatticeClassType>
 FeatureNNInteractionSc<LatticeClassType>::FeatureNNInteractionSc()
+:tables(new InteractionTables),nnInteractionEnergy(0.0)
 {
+  tables->temperature=1.0;
+
   //initialize the energy and probability lookups with default values
   for(size_t n=0;n<256;n++)
     {
       for(size_t m=0;m<256;m++)
         {
-	  interactionTable[m][n]=0.0;
-	  probabilityLookup[m][n]=1.0;
+	  tables->interactionTable[m][n]=0.0;
+	  tables->probabilityLookup[m][n]=1.0;
         }
     }
 }
@@ -215,9 +369,31 @@ bool FeatureNNInteractionSc<LatticeClassType>::checkMove(const IngredientsType&
   //because the total probability is evaluated by FeatureBoltzmann at the end
   double prob=calculateAcceptanceProbability(ingredients,move);
   move.multiplyProbability(prob);
+
+  lastChecked.set(move.getIndex(),move.getDir(),prob);
   return true;
 }
 
+/**
+ * @details Updates the contact energy. If the move is the one checked last,
+ * the energy difference is T times the one stored from the factor exp(-dE/T),
+ * otherwise the changed contacts are counted again. The energy is counted
+ * from the lattice again in synchronize().
+ *
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] move Monte Carlo move of type MoveLocalSc
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+void FeatureNNInteractionSc<LatticeClassType>::applyMove(const IngredientsType& ing,
+							 const MoveLocalSc& move)
+{
+  if(lastChecked.matches(move.getIndex(),move.getDir()))
+    nnInteractionEnergy+=tables->temperature*lastChecked.getEnergyDifference();
+  else
+    nnInteractionEnergy+=calculateEnergyDifference(ing,move);
+}
+
 /**
  * @details Because moves of type MoveLocalBcc must not be used with this
  * feature, this function always throws an exception when called. The function
@@ -283,6 +459,8 @@ void FeatureNNInteractionSc<LatticeClassType>::applyMove(IngredientsType& ing,
     ing.setLatticeEntry(pos+dz+dx,type);
     ing.setLatticeEntry(pos+dz+dy,type);
     ing.setLatticeEntry(pos+dz+dx+dy,type);
+
+    nnInteractionEnergy+=calculateContactEnergy(ing,pos,int32_t(type));
 }
 
 /**
@@ -320,6 +498,9 @@ void FeatureNNInteractionSc<LatticeClassType>::synchronize(IngredientsType& ingr
     //caution: this overwrites, what is currently written on the lattice
     fillLattice(ingredients);
 
+    //recalculate the contact energy, removing any drift of the running sum
+    nnInteractionEnergy=calculateNNInteractionEnergy(ingredients);
+
 }
 
 
@@ -347,7 +528,7 @@ inline double FeatureNNInteractionSc<LatticeClassType>::getProbabilityFactor(int
   }
 #endif /*DEBUG*/
 
-  return probabilityLookup[typeA][typeB];
+  return tables->probabilityLookup[typeA][typeB];
 
 }
 
@@ -403,59 +584,72 @@ template<class IngredientsType>
 void FeatureNNInteractionSc<LatticeClassType>::fillLattice(IngredientsType& ingredients)
 {
     const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+    const AttributeWriter<IngredientsType> writeAttribute(ingredients);
 
-    for(size_t n=0;n<molecules.size();n++)
+    bool success=true;
+    uint32_t failedIndex=0;
+    std::vector<uint32_t> changed;
+
+    //FeatureExcludedVolumeSc synchronizes first and has already freed the old
+    //sites of moved monomers, so only changed monomers are written here
+    if(ingredients.getIncrementalSynchronization() &&
+       fillScheduler.findChangedMonomers(molecules,AttributeValue(),ingredients.getLatticeGeneration(),changed))
+    {
+        for(size_t i=0;i<changed.size() && success;i++)
+        {
+            success=writeAttribute(changed[i]);
+            failedIndex=changed[i];
+        }
+    }
+    else
     {
-        VectorInt3 pos=molecules[n];
-	lattice_value_type attribute=lattice_value_type(molecules[n].getAttributeTag());
-
-	if(int32_t(attribute)!=molecules[n].getAttributeTag()){
-	  std::stringstream errormessage;
-	  errormessage<<"***FeatureNNInteractionSc::fillLattice()***\n";
-	  errormessage<<"type "<<attribute<<" is out of the allowed range";
-
-	  throw std::runtime_error(errormessage.str());
-	}
-
-        ingredients.setLatticeEntry(pos,attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(1,0,0),attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(0,1,0),attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(1,1,0),attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(0,0,1),attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(1,0,1),attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(0,1,1),attribute);
-        ingredients.setLatticeEntry(pos+VectorInt3(1,1,1),attribute);
+        fillScheduler.sortIntoSlabs(molecules,ingredients.getBoxZ());
+        success=fillScheduler.forEachMonomer(writeAttribute,failedIndex);
+    }
 
+    if(!success)
+    {
+        fillScheduler.clearSnapshot();
+        std::stringstream errormessage;
+        errormessage<<"***FeatureNNInteractionSc::fillLattice()***\n";
+        errormessage<<"type "<<molecules[failedIndex].getAttributeTag()<<" is out of the allowed range";
+        throw std::runtime_error(errormessage.str());
     }
 
+    if(ingredients.getIncrementalSynchronization())
+        fillScheduler.storeSnapshot(molecules,AttributeValue(),ingredients.getLatticeGeneration());
+    else
+        fillScheduler.clearSnapshot();
 }
 
 
 /**
- * @details The function calculates the factor for the acceptance probability
- * for the local move given as argument. The calculation is based on the lattice
- * entries in the vicinity of the monomer to be moved. If the move is accepted,
- * 12 new contacts can potentially be made, and 12 contacts are lost. Thus a number
- * of 24 lattice positions around the monomer have to be checked.
+ * @details The function visits the lattice sites at which the contacts of the
+ * moving monomer change, if the local move given as argument is applied. The
+ * calculation is based on the lattice entries in the vicinity of the monomer
+ * to be moved. If the move is accepted, 12 new contacts can potentially be
+ * made, and 12 contacts are lost. Thus a number of 24 lattice positions around
+ * the monomer have to be checked. The sites are not touched by the move
+ * itself, so the function gives the same result before and after the lattice
+ * entries of the monomer were moved.
  *
  * @tparam IngredientsType The type of the system including all features
+ * @tparam ContactAccumulator provides gained(type) and lost(type), called with the lattice entry of each site
  * @param [in] ingredients A reference to the IngredientsType - mainly the system
  * @param [in] move reference to the local move for which the calculation is performed
- * @return acceptance probability factor for the move arising from nearest neighbor contacts
+ * @param accumulator collects the contributions of the sites
  **/
 template<template<typename> class LatticeClassType>
-template<class IngredientsType>
-double FeatureNNInteractionSc<LatticeClassType>::calculateAcceptanceProbability(
+template<class IngredientsType,class ContactAccumulator>
+void FeatureNNInteractionSc<LatticeClassType>::visitChangedContacts(
     const IngredientsType& ingredients,
-    const MoveLocalSc& move) const
+    const MoveLocalSc& move,
+    ContactAccumulator& accumulator) const
 {
 
     VectorInt3 oldPos=ingredients.getMolecules()[move.getIndex()];
     VectorInt3 direction=move.getDir();
 
-    double prob=1.0;
-    int32_t monoType=ingredients.getMolecules()[move.getIndex()].getAttributeTag();
-
     /*get two directions perpendicular to vector directon of the move*/
     VectorInt3 perp1,perp2;
     /* first perpendicular direction is either (0 1 0) or (1 0 0)*/
@@ -472,12 +666,10 @@ double FeatureNNInteractionSc<LatticeClassType>::calculateAcceptanceProbability(
     perp2.setY(y2);
     perp2.setZ(z2);
 
-    //the probability is calculated by going through all possible lattice sites
+    //the contacts are evaluated by going through all possible lattice sites
     //at which the contacts may have changed. At every site the type of the
-    //monomer sitting there is retrieved from the lattice. the additional
-    //factor for the probability (exp(-deltaE/kT)) is retrieved from the
-    //lookup using getProbabilityFactor. For new contacts this factor is multiplied
-    //with the probability, for contacts taken away the probability is devided.
+    //monomer sitting there is retrieved from the lattice and handed to the
+    //accumulator, for new contacts as gained, for contacts taken away as lost.
     VectorInt3 actual=oldPos;
 
     //first check front,i.e newly acquired contacts
@@ -485,62 +677,155 @@ double FeatureNNInteractionSc<LatticeClassType>::calculateAcceptanceProbability(
     actual+=direction;
 
     actual-=perp1;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp2;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual+perp2+perp1;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp1;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual+perp1-perp2;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual-=perp2;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual-perp1-perp2;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual-=perp1;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual+perp2+direction;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp2;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp1;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
     actual-=perp2;
-    prob*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.gained(int32_t(ingredients.getLatticeEntry(actual)));
 
     //now check back side (contacts taken away)
-    double prob_div=1.0;
     actual=oldPos;
     if(direction.getX()<0 || direction.getY()<0 || direction.getZ()<0) actual-=direction;
     actual-=perp1;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp2;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual+perp2+perp1;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp1;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual+perp1-perp2;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual-=perp2;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual-perp1-perp2;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual-=perp1;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual=actual+perp2-direction;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp2;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual+=perp1;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
     actual-=perp2;
-    prob_div*=getProbabilityFactor(monoType,int32_t(ingredients.getLatticeEntry(actual)));
+    accumulator.lost(int32_t(ingredients.getLatticeEntry(actual)));
+
+}
+
+/**
+ * @details The additional factor for the probability (exp(-deltaE/kT)) of
+ * every changed contact is retrieved from the lookup using getProbabilityFactor.
+ * For new contacts this factor is multiplied with the probability, for contacts
+ * taken away the probability is devided.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] move reference to the local move for which the calculation is performed
+ * @return acceptance probability factor for the move arising from nearest neighbor contacts
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+double FeatureNNInteractionSc<LatticeClassType>::calculateAcceptanceProbability(
+    const IngredientsType& ingredients,
+    const MoveLocalSc& move) const
+{
+    ProbabilityAccumulator accumulator(*this,ingredients.getMolecules()[move.getIndex()].getAttributeTag());
+    visitChangedContacts(ingredients,move,accumulator);
+    return accumulator.prob/accumulator.prob_div;
+}
 
-    prob/=prob_div;
-    return prob;
+/**
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] move reference to the local move for which the calculation is performed
+ * @return change of the contact energy (in kT at temperature 1) if the move is applied
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+double FeatureNNInteractionSc<LatticeClassType>::calculateEnergyDifference(
+    const IngredientsType& ingredients,
+    const MoveLocalSc& move) const
+{
+    EnergyAccumulator accumulator(*tables,ingredients.getMolecules()[move.getIndex()].getAttributeTag());
+    visitChangedContacts(ingredients,move,accumulator);
+    return accumulator.gainedEnergy-accumulator.lostEnergy;
+}
 
+/**
+ * @details Sums the interaction energies of the lattice sites adjacent to the
+ * six faces of the cube of the monomer, i.e. all its contacts.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] pos position of the monomer
+ * @param [in] type attribute tag of the monomer
+ * @return contact energy of the monomer (in kT at temperature 1)
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+double FeatureNNInteractionSc<LatticeClassType>::calculateContactEnergy(
+    const IngredientsType& ingredients,
+    const VectorInt3& pos,
+    int32_t type) const
+{
+    const double* energies=tables->interactionTable[type];
+    const int32_t x=pos.getX(), y=pos.getY(), z=pos.getZ();
+    double energy=0.0;
+
+    //the faces at offset -1 and +2 in each direction, 2x2 sites each
+    for(int32_t a=0;a<2;a++)
+    {
+      for(int32_t b=0;b<2;b++)
+      {
+        energy+=energies[ingredients.getLatticeEntry(x-1,y+a,z+b)];
+        energy+=energies[ingredients.getLatticeEntry(x+2,y+a,z+b)];
+        energy+=energies[ingredients.getLatticeEntry(x+a,y-1,z+b)];
+        energy+=energies[ingredients.getLatticeEntry(x+a,y+2,z+b)];
+        energy+=energies[ingredients.getLatticeEntry(x+a,y+b,z-1)];
+        energy+=energies[ingredients.getLatticeEntry(x+a,y+b,z+2)];
+      }
+    }
+
+    return energy;
+}
+
+/**
+ * @details Every contact is seen from both monomers, so the sum over the
+ * contact energies of all monomers is divided by two.
+ *
+ * @tparam IngredientsType The type of the system including all features
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @return total contact energy of the system (in kT at temperature 1)
+ **/
+template<template<typename> class LatticeClassType>
+template<class IngredientsType>
+double FeatureNNInteractionSc<LatticeClassType>::calculateNNInteractionEnergy(const IngredientsType& ingredients) const
+{
+    const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+    double energy=0.0;
+    for(size_t n=0;n<molecules.size();n++)
+      energy+=calculateContactEnergy(ingredients,molecules[n].getVector3D(),molecules[n].getAttributeTag());
+
+    return 0.5*energy;
 }
 
 /**
@@ -556,10 +841,13 @@ void FeatureNNInteractionSc<LatticeClassType>::setNNInteraction(int32_t typeA,
 {
     if(0<typeA && typeA<=255 && 0<typeB && typeB<=255)
       {
-        interactionTable[typeA][typeB]=energy;
-        interactionTable[typeB][typeA]=energy;
-        probabilityLookup[typeA][typeB]=exp(-energy);
-        probabilityLookup[typeB][typeA]=exp(-energy);
+        //copy on write, if the tables are shared with other copies
+        detachTables();
+
+        tables->interactionTable[typeA][typeB]=energy;
+        tables->interactionTable[typeB][typeA]=energy;
+        tables->probabilityLookup[typeA][typeB]=exp(-energy/tables->temperature);
+        tables->probabilityLookup[typeB][typeA]=exp(-energy/tables->temperature);
         std::cout<<"set interation between types ";
 	std::cout<<typeA<<" and "<<typeB<<" to "<<energy<<"kT\n";
       }
@@ -572,6 +860,30 @@ void FeatureNNInteractionSc<LatticeClassType>::setNNInteraction(int32_t typeA,
       }
 }
 
+/**
+ * @details Recalculates all probability factors as exp(-E/temperature).
+ * The energies and thus the contact energy of the system are not changed.
+ * @param temperature temperature in units of the reference temperature of the energies
+ * @throw std::runtime_error In case the temperature is not positive
+ **/
+template<template<typename> class LatticeClassType>
+void FeatureNNInteractionSc<LatticeClassType>::setNNInteractionTemperature(double temperature)
+{
+    if(!(temperature>0.0))
+      {
+	std::stringstream errormessage;
+	errormessage<<"FeatureNNInteractionSc::setNNInteractionTemperature(temperature).\n";
+	errormessage<<"temperature "<<temperature<<" must be positive\n";
+	throw std::runtime_error(errormessage.str());
+      }
+
+    detachTables();
+    tables->temperature=temperature;
+    for(size_t n=0;n<256;n++)
+      for(size_t m=0;m<256;m++)
+	tables->probabilityLookup[m][n]=exp(-tables->interactionTable[m][n]/temperature);
+}
+
 /**
  * @param typeA monomer attribute tag in range [1,255]
  * @param typeB monomer attribute tag in range [1,255]
@@ -584,7 +896,7 @@ double FeatureNNInteractionSc<LatticeClassType>::getNNInteraction(int32_t typeA,
 {
 
     if(0<typeA && typeA<=255 && 0<typeB && typeB<=255)
-        return interactionTable[typeA][typeB];
+        return tables->interactionTable[typeA][typeB];
     else
     {
       std::stringstream errormessage;
@@ -28,6 +28,10 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef LEMONADE_FEATURE_FEATUREREACTIVEBONDS_H
 #define LEMONADE_FEATURE_FEATUREREACTIVEBONDS_H
 
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
 #include <LeMonADE/feature/Feature.h>
 #include <LeMonADE/feature/FeatureConnectionSc.h>
 #include <LeMonADE/feature/FeatureBreak.h>
@@ -65,12 +69,6 @@ class MonomerReactivity
 	//! Getting the number of maximum possible bonds for the monomer.
 	 uint32_t getNumMaxLinks() const {return numMaxLinks;};
 
-	MonomerReactivity& operator= (const MonomerReactivity source)
-	{
-	  reactivity=source.isReactive();
-	  numMaxLinks=source.getNumMaxLinks();
-	  return *this;
-	}
 	const MonomerReactivity& getMonomerReactivity() const {return *this; }
 	
 	void setMonomerReactivity(const MonomerReactivity& react)
@@ -195,6 +193,10 @@ public:
  *
  * @details Works only in combination with an excluded volume feature. 
  * Considers only reactive monomers which are able to form a new bond.
+ * The unreacted monomers and the reacted bonds are kept in dense vectors
+ * together with an index of their positions, such that a random entry can be
+ * drawn and entries can be added or removed (swap with the last one) in O(1).
+ * The order of the entries therefore changes during the simulation.
  *
  * @tparam 
  * */
@@ -205,9 +207,10 @@ public:
 ///////////////////////////////////////////////////////////////////////////////
 
 class FeatureReactiveBonds : public Feature {
-    typedef std::pair < uint32_t, uint32_t > BondPair;
-    typedef uint32_t edge_type;
 public:
+    //! bond between two reactive monomers, stored as (smaller ID, larger ID)
+    typedef std::pair < uint32_t, uint32_t > BondPair;
+
     //! This Feature requires a monomer_extensions.
     typedef LOKI_TYPELIST_1(MonomerReactivity) monomer_extensions;
       typedef LOKI_TYPELIST_2(FeatureBreak, FeatureConnectionSc) required_features_back;
@@ -260,56 +263,101 @@ public:
     //!returns the total number of reactive monomers capable to form a bond
     uint32_t getNReactiveSites() const {return nReactiveSites;};
 
-    //!returns the bond table of the reacted reactive monomers.
-    const std::map<BondPair,edge_type>& getBondedMonomers()const {return BondedReactiveMonomers;};
+    //!returns the (unordered) list of bonds between reactive monomers. The pairs are stored as (smaller ID, larger ID)
+    const std::vector<BondPair>& getBondedMonomers()const {return BondedReactiveMonomers;};
 
     //! returns false if the bond does not exist
     bool checkReactiveBondExists(uint32_t Mon1, uint32_t Mon2) const 
     {
-      BondPair edge_key(std::min(Mon1,Mon2),std::max(Mon1,Mon2));
-      return (BondedReactiveMonomers.find(edge_key) != BondedReactiveMonomers.end()); 
+      return (BondedReactivePosition.find(bondKey(Mon1,Mon2)) != BondedReactivePosition.end()); 
     }
 
-    //! returns the map of unreacted monomers 
-    const std::map<uint32_t,uint32_t>& getUnreactiveMonomers() const {return UnbondedReactiveMonomers;};
+    //! returns the (unordered) list of reactive monomers which can form another bond
+    const std::vector<uint32_t>& getUnreactiveMonomers() const {return UnbondedReactiveMonomers;};
 
     //!returns the number of reactive monomers capable to form a bond 
     uint32_t getNUnreactedMonomers()const{return UnbondedReactiveMonomers.size();}
 
     //!returns true if the monomer can be connected to another monomer
-    bool checkCapableFormingBonds(uint32_t MonID )const { return (UnbondedReactiveMonomers.find(MonID) != UnbondedReactiveMonomers.end()); }
+    bool checkCapableFormingBonds(uint32_t MonID )const { 
+      return (MonID < UnbondedReactivePosition.size() && UnbondedReactivePosition[MonID] != notUnbonded); 
+    }
 
     //!get extent of reaction 
     double getConversion() const {return (double(nReactedBonds*2))/(double(nReactiveSites));}
+
+    //! writes the counters and the lists of bonded and unbonded reactive monomers in their current order into a checkpoint
+    template<class IngredientsType, class CheckpointOut>
+    void writeCheckpoint(const IngredientsType& ingredients, CheckpointOut& checkpoint) const;
+
+    //! restores the state written by writeCheckpoint(), such that random draws from the lists continue identically
+    template<class IngredientsType, class CheckpointIn>
+    bool readCheckpoint(IngredientsType& ingredients, CheckpointIn& checkpoint);
     
 private: 
     //!number of bonds from reactive monomers and the total number of reactive monomers 
     uint32_t nReactedBonds, nReactiveSites;
 
-    //! holds all bonded reactive monomers during simulation
-    std::map<BondPair, edge_type> BondedReactiveMonomers;
+    //! marks monomers in UnbondedReactivePosition which are not in UnbondedReactiveMonomers
+    enum{ notUnbonded=0xFFFFFFFFu };
+
+    //! holds all bonded reactive monomers during simulation (dense, for drawing a random bond in O(1))
+    std::vector<BondPair> BondedReactiveMonomers;
+
+    //! position of a bond in BondedReactiveMonomers, hashed by bondKey()
+    std::unordered_map<uint64_t,uint32_t> BondedReactivePosition;
+
+    //! holds the ids of all reactive monomers which can have another bonds (dense, for drawing a random monomer in O(1))
+    std::vector<uint32_t> UnbondedReactiveMonomers; 
 
-    //! holds the ids of all reactive monomers which can have another bonds
-    std::map<uint32_t,uint32_t> UnbondedReactiveMonomers; 
+    //! position of a monomer in UnbondedReactiveMonomers, indexed by monomer ID, notUnbonded if absent
+    std::vector<uint32_t> UnbondedReactivePosition;
 
-    //! adds the monomer to the map of unreacted monomers
-    void addReactiveMonomer(uint32_t MonID, uint32_t value=0){UnbondedReactiveMonomers[MonID]=value;} // adds a new entry if the 
+    //! unique key of the bond between Monomer1 and Monomer2
+    static uint64_t bondKey(uint32_t Monomer1, uint32_t Monomer2){
+      return (uint64_t(std::min(Monomer1,Monomer2))<<32) | uint64_t(std::max(Monomer1,Monomer2));
+    }
+
+    //! adds the monomer to the list of unreacted monomers, if not already there
+    void addReactiveMonomer(uint32_t MonID){
+      if(MonID >= UnbondedReactivePosition.size())
+	UnbondedReactivePosition.resize(MonID+1,notUnbonded);
+      if(UnbondedReactivePosition[MonID] != notUnbonded) return;
+      UnbondedReactivePosition[MonID]=UnbondedReactiveMonomers.size();
+      UnbondedReactiveMonomers.push_back(MonID);
+    }
 
-    //! erase the monomer ID from the map of unreacted monomers 
-    void eraseReactiveMonomer(uint32_t MonID, uint32_t value=0){UnbondedReactiveMonomers.erase(UnbondedReactiveMonomers.find(MonID));}
+    //! erase the monomer ID from the list of unreacted monomers by moving the last entry into its place
+    void eraseReactiveMonomer(uint32_t MonID){
+      if(!checkCapableFormingBonds(MonID)) return;
+      uint32_t position(UnbondedReactivePosition[MonID]);
+      uint32_t last(UnbondedReactiveMonomers.back());
+      UnbondedReactiveMonomers[position]=last;
+      UnbondedReactivePosition[last]=position;
+      UnbondedReactiveMonomers.pop_back();
+      UnbondedReactivePosition[MonID]=notUnbonded;
+    }
 
     //!add a bond to the container BondedReactiveMonomers
-    void addBondedPair(uint32_t Monomer1, uint32_t Monomer2, uint32_t attribute=0){
-      BondPair edge_key(std::min(Monomer1,Monomer2),std::max(Monomer1,Monomer2));
-      BondedReactiveMonomers[edge_key]=attribute;
+    void addBondedPair(uint32_t Monomer1, uint32_t Monomer2){
+      std::pair<std::unordered_map<uint64_t,uint32_t>::iterator,bool> inserted(
+	BondedReactivePosition.insert(std::make_pair(bondKey(Monomer1,Monomer2),uint32_t(BondedReactiveMonomers.size()))));
+      if(inserted.second)
+	BondedReactiveMonomers.push_back(BondPair(std::min(Monomer1,Monomer2),std::max(Monomer1,Monomer2)));
     }
 
-    //!erase a bond from the container BondedReactiveMonomers
-    void eraseBondedPair(uint32_t Monomer1, uint32_t Monomer2, uint32_t attribute=0){
-      BondPair edge_key(std::min(Monomer1,Monomer2),std::max(Monomer1,Monomer2));
-      typename std::map<BondPair, edge_type>::iterator it;
-      it=BondedReactiveMonomers.find(edge_key);
-      BondedReactiveMonomers.erase(it);
+    //!erase a bond from the container BondedReactiveMonomers by moving the last entry into its place
+    void eraseBondedPair(uint32_t Monomer1, uint32_t Monomer2){
+      std::unordered_map<uint64_t,uint32_t>::iterator it(BondedReactivePosition.find(bondKey(Monomer1,Monomer2)));
+      if(it == BondedReactivePosition.end()) return;
+      uint32_t position(it->second);
+      BondedReactivePosition.erase(it);
+      if(position+1 != BondedReactiveMonomers.size()){
+	const BondPair& last(BondedReactiveMonomers.back());
+	BondedReactivePosition[bondKey(last.first,last.second)]=position;
+	BondedReactiveMonomers[position]=last;
+      }
+      BondedReactiveMonomers.pop_back();
     }
 };
 ///////////////////////////////////////////////////////////////////////////////
@@ -402,7 +450,7 @@ void FeatureReactiveBonds ::applyMove(IngredientsType& ing, const MoveConnectBas
     nReactedBonds++;
     auto MonID(move.getIndex()); 
     auto Partner(move.getPartner());
-    addBondedPair(MonID,Partner,ing.getMolecules().getAge());
+    addBondedPair(MonID,Partner);
     if (ing.getMolecules()[MonID].getNumMaxLinks()==ing.getMolecules().getNumLinks(MonID) )
       eraseReactiveMonomer(MonID);
     if (ing.getMolecules()[Partner].getNumMaxLinks()==ing.getMolecules().getNumLinks(Partner) )
@@ -423,10 +471,55 @@ void FeatureReactiveBonds ::applyMove(IngredientsType& ing, const MoveBreakBase<
     auto MonID(move.getIndex()); 
     auto Partner(move.getPartner());
     eraseBondedPair(MonID,Partner);
-    addReactiveMonomer(MonID,ing.getMolecules().getAge());
-    addReactiveMonomer(Partner,ing.getMolecules().getAge());
+    addReactiveMonomer(MonID);
+    addReactiveMonomer(Partner);
   
 }
+/**
+ * @details The bonds are written as pairs of monomer indices. The position
+ * look-ups are rebuilt when reading.
+ */
+template<class IngredientsType, class CheckpointOut>
+void FeatureReactiveBonds::writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+{
+    checkpoint.write(nReactedBonds);
+    checkpoint.write(nReactiveSites);
+    uint64_t nBonds=BondedReactiveMonomers.size();
+    checkpoint.write(nBonds);
+    for(size_t n=0;n<BondedReactiveMonomers.size();n++){
+	checkpoint.write(BondedReactiveMonomers[n].first);
+	checkpoint.write(BondedReactiveMonomers[n].second);
+    }
+    checkpoint.writeVector(UnbondedReactiveMonomers);
+}
+
+/**
+ * @return true, no synchronization is required
+ */
+template<class IngredientsType, class CheckpointIn>
+bool FeatureReactiveBonds::readCheckpoint(IngredientsType& ingredients, CheckpointIn& checkpoint)
+{
+    std::vector<uint32_t> unbonded;
+    uint64_t nBonds;
+    checkpoint.read(nReactedBonds);
+    checkpoint.read(nReactiveSites);
+    checkpoint.read(nBonds);
+    BondedReactiveMonomers.clear();
+    BondedReactivePosition.clear();
+    for(uint64_t n=0;n<nBonds;n++){
+	uint32_t Monomer1, Monomer2;
+	checkpoint.read(Monomer1);
+	checkpoint.read(Monomer2);
+	addBondedPair(Monomer1,Monomer2);
+    }
+    checkpoint.readVector(unbonded);
+    UnbondedReactiveMonomers.clear();
+    UnbondedReactivePosition.assign(ingredients.getMolecules().size(),notUnbonded);
+    for(size_t n=0;n<unbonded.size();n++)
+	addReactiveMonomer(unbonded[n]);
+    return true;
+}
+
 /******************************************************************************/
 /**
  * @fn void FeatureReactiveBonds ::synchronize(IngredientsType& ingredients)
@@ -438,7 +531,9 @@ void FeatureReactiveBonds ::applyMove(IngredientsType& ing, const MoveBreakBase<
 template<class IngredientsType>
 void FeatureReactiveBonds::synchronize(IngredientsType& ingredients){
 	BondedReactiveMonomers.clear();
+	BondedReactivePosition.clear();
 	UnbondedReactiveMonomers.clear();
+	UnbondedReactivePosition.assign(ingredients.getMolecules().size(),notUnbonded);
     std::cout << "FeatureReactiveBonds::synchronizing ...\n";
     nReactedBonds=0;
     nReactiveSites=0;
@@ -454,7 +549,7 @@ void FeatureReactiveBonds::synchronize(IngredientsType& ingredients){
 				nIrreversibleBonds++;
 			}
 			if(ingredients.getMolecules()[i].getNumMaxLinks()-ingredients.getMolecules().getNumLinks(i) != 0)
-				addReactiveMonomer(i,ingredients.getMolecules().getAge());
+				addReactiveMonomer(i);
 			nReactiveSites+=(ingredients.getMolecules()[i].getNumMaxLinks()-nIrreversibleBonds);
       }
     }
@@ -464,13 +559,12 @@ void FeatureReactiveBonds::synchronize(IngredientsType& ingredients){
 				<< "Extent of reaction      : " << getConversion()
 				<<std::endl;
 	if (nReactiveSites != 0 ){
-    	BondedReactiveMonomers.clear();
 		auto edges=ingredients.getMolecules().getEdges();
 		for(auto it=edges.begin();it!=edges.end();++it){
 			auto MonID1(it->first.first);
 			auto MonID2(it->first.second);
 			if(ingredients.getMolecules()[MonID1].isReactive() && ingredients.getMolecules()[MonID2].isReactive())
-				addBondedPair(MonID1,MonID2,ingredients.getMolecules().getAge());
+				addBondedPair(MonID1,MonID2);
 		}
       }
     std::cout << "done\n";
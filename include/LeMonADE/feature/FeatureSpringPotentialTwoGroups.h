@@ -36,6 +36,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
 #include <LeMonADE/feature/FeatureBoltzmann.h>
 #include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/utility/LastCheckedMove.h>
 
 /**
  * @file
@@ -80,11 +81,12 @@ private:
  * @class FeatureSpringPotentialTwoGroups
  * @brief Extends vertex/monomer by an group tag (MonomerSpringPotentialGroupTag). Provides read/write functionality 
  * Implements the harmonic potential as external potential applied to the center of mass of the two groups. 
+ * The potential energy is kept up to date in applyMove() and recalculated in synchronize().
  **/
 class FeatureSpringPotentialTwoGroups:public Feature
 {
 public:
-	FeatureSpringPotentialTwoGroups(): equilibrium_length(0.0),spring_constant(0.0) {};
+	FeatureSpringPotentialTwoGroups(): equilibrium_length(0.0),spring_constant(0.0),springEnergy(0.0) {};
 	virtual ~FeatureSpringPotentialTwoGroups(){};
 	
 	//! This Feature require Feature Boltzmann afterwards to evaluate the potential energy change
@@ -108,6 +110,20 @@ public:
 
 	template<class IngredientsType>
 	bool checkMove(const IngredientsType& ingredients, MoveLocalScDiag& move) const;
+
+	//! apply function for all moves without special apply functions (does nothing)
+	template<class IngredientsType>
+	void applyMove(const IngredientsType&, const MoveBase&){}
+
+	//! updates the potential energy for a MoveLocalSc
+	template<class IngredientsType>
+	void applyMove(const IngredientsType& ingredients, const MoveLocalSc& move)
+	{updateSpringEnergy(ingredients,move.getIndex(),move.getDir());}
+
+	//! updates the potential energy for a MoveLocalScDiag
+	template<class IngredientsType>
+	void applyMove(const IngredientsType& ingredients, const MoveLocalScDiag& move)
+	{updateSpringEnergy(ingredients,move.getIndex(),move.getDir());}
 	
 	//! getter function for the harmonic potential spring length r0 in V(r)=k/2(r-r0)^2
 	double getEquilibriumLength() const{
@@ -133,6 +149,18 @@ public:
 	template<class IngredientsType>
 	VectorDouble3 getGroupCenterOfMass(const IngredientsType& ingredients,const std::vector<uint32_t>& group) const;
 
+	//! returns the potential energy V(r)=k/2(r-r0)^2 of the system in kT
+	double getSpringPotentialEnergy() const {return springEnergy;}
+
+	//! calculates the potential energy from the current centers of mass
+	template<class IngredientsType>
+	double calculateSpringPotentialEnergy(const IngredientsType& ingredients) const;
+
+	//! adds the potential energy to report (see EnergyReport)
+	template<class EnergyReportType>
+	void reportEnergy(EnergyReportType& report) const
+	{report.addEnergy("FeatureSpringPotentialTwoGroups",springEnergy);}
+
 	template<class IngredientsType>
 	void exportRead(FileImport <IngredientsType>& fileReader);
 	
@@ -142,6 +170,19 @@ public:
 	template<class IngredientsType>
 	void synchronize(IngredientsType& ingredients);
 
+	//! writes the parameters of the spring into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{checkpoint.write(equilibrium_length); checkpoint.write(spring_constant);}
+
+	//! restores the parameters of the spring. The groups and the energy are rebuilt in synchronize()
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{
+		checkpoint.read(equilibrium_length); checkpoint.read(spring_constant);
+		return false;
+	}
+
 private:
 	//! equilibrium length r0 in harmonic potential V(r)=k/2(r-r0)^2
 	double equilibrium_length;
@@ -155,6 +196,20 @@ private:
 	//! contains the indices of the monomers of type affectedMonomerType
 	std::vector<uint32_t> affectedMonomerGroup1;
 
+	//! potential energy of the system
+	double springEnergy;
+
+	//! factor exp(-dV) of the last checked move of a group monomer, for MoveLocalSc and MoveLocalScDiag
+	mutable LastCheckedMove lastChecked;
+
+	//! adds the energy difference of moving monomer index by direction
+	template<class IngredientsType>
+	void updateSpringEnergy(const IngredientsType& ingredients, uint32_t index, const VectorInt3& direction);
+
+	//! potential energy for a distance of the centers of mass
+	double springEnergyAt(double distance) const
+	{return 0.5*spring_constant*(distance-equilibrium_length)*(distance-equilibrium_length);}
+
 };
 
 
@@ -561,6 +616,7 @@ bool FeatureSpringPotentialTwoGroups::checkMove(const IngredientsType& ingredien
 
 	//std::cout << "prob: " <<  prob << std::endl;
 	move.multiplyProbability(prob);
+	lastChecked.set(move.getIndex(),move.getDir(),prob);
 
 	return true;
 
@@ -631,6 +687,7 @@ bool FeatureSpringPotentialTwoGroups::checkMove(const IngredientsType& ingredien
 
 	//std::cout << "prob: " <<  prob << std::endl;
 	move.multiplyProbability(prob);
+	lastChecked.set(move.getIndex(),move.getDir(),prob);
 
 	return true;
   
@@ -666,6 +723,60 @@ void FeatureSpringPotentialTwoGroups::synchronize(IngredientsType& ingredients)
 	std::cout<<"FeatureSpringPotentialTwoGroups::synchronize()...affected group size 1 ="<<affectedMonomerGroup0.size()<<
 			"...affected group size 2 ="<<affectedMonomerGroup1.size()<<std::endl;
 
+	//recalculate the potential energy, removing any drift of the running sum
+	springEnergy=calculateSpringPotentialEnergy(ingredients);
+}
+
+/**
+ * @details The energy is zero as long as one of the groups is empty.
+ *
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @return potential energy V=k/2(|R_COM1-R_COM2|-r0)^2 in kT
+ */
+template<class IngredientsType>
+double FeatureSpringPotentialTwoGroups::calculateSpringPotentialEnergy(const IngredientsType& ingredients) const
+{
+	if(affectedMonomerGroup0.empty() || affectedMonomerGroup1.empty()) return 0.0;
+
+	VectorDouble3 distance=getGroupCenterOfMass(ingredients,affectedMonomerGroup0)-getGroupCenterOfMass(ingredients,affectedMonomerGroup1);
+	return springEnergyAt(distance.getLength());
+}
+
+/**
+ * @details If the move is the one checked last, the energy difference is
+ * obtained from its probability factor exp(-dV), otherwise it is calculated
+ * from the centers of mass before and after the move. Moves of monomers
+ * which belong to none of the groups do not change the energy.
+ *
+ * @param [in] ingredients A reference to the IngredientsType - mainly the system
+ * @param [in] index index of the moved monomer
+ * @param [in] direction direction of the move
+ */
+template<class IngredientsType>
+void FeatureSpringPotentialTwoGroups::updateSpringEnergy(const IngredientsType& ingredients, uint32_t index, const VectorInt3& direction)
+{
+	uint32_t moveGroupTag=ingredients.getMolecules()[index].getMonomerGroupTag();
+	if(moveGroupTag!=GROUPA && moveGroupTag!=GROUPB) return;
+
+	if(lastChecked.matches(index,direction))
+	{
+		springEnergy+=lastChecked.getEnergyDifference();
+		return;
+	}
+
+	if(affectedMonomerGroup0.empty() || affectedMonomerGroup1.empty()) return;
+
+	//distance vector pointing from the other group to the group of the moved monomer
+	VectorDouble3 distance=getGroupCenterOfMass(ingredients,affectedMonomerGroup0)-getGroupCenterOfMass(ingredients,affectedMonomerGroup1);
+	double groupSize=double(affectedMonomerGroup0.size());
+	if(moveGroupTag==GROUPB)
+	{
+		distance*=-1.0;
+		groupSize=double(affectedMonomerGroup1.size());
+	}
+
+	VectorDouble3 step(direction.getX(),direction.getY(),direction.getZ());
+	springEnergy+=springEnergyAt((distance+step/groupSize).getLength())-springEnergyAt(distance.getLength());
 }
 
 template<class IngredientsType>
@@ -55,6 +55,16 @@ public:
 	template <class IngredientsType>
 	void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& filewriter) const;
 
+	//! writes the system information into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{checkpoint.write(generation); checkpoint.write(spacerLength); checkpoint.write(coreFunctionality); checkpoint.write(branchingPointFunctionality);}
+
+	//! restores the system information from a checkpoint
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{checkpoint.read(generation); checkpoint.read(spacerLength); checkpoint.read(coreFunctionality); checkpoint.read(branchingPointFunctionality); return true;}
+
 	//! getter function for dendrimer generation
 	uint32_t getGeneration() const {return generation;} 
 	//! setter function for dendrimer generation
@@ -65,6 +65,16 @@ public:
 	template <class IngredientsType>
 	void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& filewriter) const;
 
+	//! writes the system information into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{checkpoint.write(nChains); checkpoint.write(nCrossLinkers); checkpoint.write(chainLength); checkpoint.write(functionality); checkpoint.write(nMonomersPerCrossLink);}
+
+	//! restores the system information from a checkpoint
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{checkpoint.read(nChains); checkpoint.read(nCrossLinkers); checkpoint.read(chainLength); checkpoint.read(functionality); checkpoint.read(nMonomersPerCrossLink); return true;}
+
 	//!return the number of chains 
 	uint32_t getNumberofChains() const { return nChains; } 
 	
@@ -68,6 +68,16 @@ public:
 	template <class IngredientsType>
 	void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& filewriter) const;
 
+	//! writes the system information into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{checkpoint.write(nRings); checkpoint.write(nMonomersPerRing);}
+
+	//! restores the system information from a checkpoint
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{checkpoint.read(nRings); checkpoint.read(nMonomersPerRing); return true;}
+
 	//!
 	const uint32_t getNumRings() const {return nRings;} 
 	//!
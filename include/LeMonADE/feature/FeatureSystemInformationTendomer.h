@@ -59,6 +59,16 @@ public:
 	template <class IngredientsType>
 	void exportWrite(AnalyzerWriteBfmFile <IngredientsType>& filewriter) const;
 
+	//! writes the system information into a checkpoint
+	template<class IngredientsType, class CheckpointOut>
+	void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const
+	{checkpoint.write(nTendomers); checkpoint.write(nCrossLinkers); checkpoint.write(nMonomersPerChain); checkpoint.write(nLabelsPerTendomerArm);}
+
+	//! restores the system information from a checkpoint
+	template<class IngredientsType, class CheckpointIn>
+	bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint)
+	{checkpoint.read(nTendomers); checkpoint.read(nCrossLinkers); checkpoint.read(nMonomersPerChain); checkpoint.read(nLabelsPerTendomerArm); return true;}
+
 	//!
 	uint32_t getNumTendomers() const {return nTendomers;} 
 	//!
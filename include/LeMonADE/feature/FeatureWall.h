@@ -31,6 +31,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 
 #include <LeMonADE/core/Ingredients.h>
 #include <LeMonADE/utility/Vector3D.h>
@@ -47,6 +48,9 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @details For the \b sc-BFM this feature can hold an arbitrary
  * number of walls with normal vectors (1,0,0), (0,1,0) and (0,0,1) being the
  * unit vectors along the principal lattice directions.
+ * The walls are compiled into one bitmask of forbidden coordinates per axis,
+ * such that checking a position costs three bit lookups, independent of
+ * the number of walls.
  *
  * @todo Enable this feature for the \b bcc-BFM.
  * */
@@ -107,7 +111,7 @@ class FeatureWall: public Feature
 public:
 
     //! standard constructor
-    FeatureWall() {}
+    FeatureWall() {compileWalls();}
 
     //! standard destructor
     virtual ~FeatureWall(){}
@@ -133,7 +137,7 @@ public:
     void synchronize(const IngredientsType& ingredients);
 
     //! getter function for the walls container
-    std::vector<Wall> getWalls() const{
+    const std::vector<Wall>& getWalls() const{
         return walls;
     }
 
@@ -142,8 +146,10 @@ public:
      * @throw <std::runtime_error> monomer occupies a position on the walls
      **/
     void addWall(Wall wall){
-      if(wall.getNormal().getLength()!=0.0)
+      if(wall.getNormal().getLength()!=0.0){
         walls.push_back(wall);
+        compileWalls();
+      }
       else
 	throw std::runtime_error("wall is not well defined: normal vector has length 0");
     }
@@ -151,15 +157,100 @@ public:
     //! empty walls container
     void clearAllWalls(){
         walls.clear();
+        compileWalls();
+    }
+
+    //! writes the walls into a checkpoint
+    template<class IngredientsType, class CheckpointOut>
+    void writeCheckpoint(const IngredientsType&, CheckpointOut& checkpoint) const{
+        checkpoint.writeVector(walls);
+    }
+
+    //! restores the walls from a checkpoint. The monomers are checked against them in synchronize()
+    template<class IngredientsType, class CheckpointIn>
+    bool readCheckpoint(IngredientsType&, CheckpointIn& checkpoint){
+        checkpoint.readVector(walls);
+        compileWalls();
+        return false;
+    }
+
+    //! returns true if pos lies in one of the walls
+    bool isWallPosition(const VectorInt3& pos) const{
+        return isWallCoordinate(0,pos.getX()) || isWallCoordinate(1,pos.getY()) || isWallCoordinate(2,pos.getZ());
     }
 
 
 private:
+    //! returns the axis (0,1,2) the normal of wall points to
+    static uint32_t getAxis(const Wall& wall){
+        if(wall.getNormal().getX()!=0) return 0;
+        if(wall.getNormal().getY()!=0) return 1;
+        return 2;
+    }
+
+    //! returns the coordinate along its normal occupied by wall
+    static int64_t getWallCoordinate(const Wall& wall){
+        return int64_t(wall.getBase().getCoordinate(getAxis(wall)))-1;
+    }
+
+    //! returns true if the coordinate along axis lies in one of the walls
+    bool isWallCoordinate(uint32_t axis, int32_t coordinate) const{
+        const uint64_t n=uint64_t(int64_t(coordinate)-maskOffset[axis]);
+        return n<maskSize[axis] && ((mask[axis][n>>6]>>(n&63))&1);
+    }
+
+    //! rebuilds the bitmasks from the walls container
+    void compileWalls();
+
     //! walls container
     std::vector<Wall> walls;
 
+    //! per axis one bit for every coordinate in [maskOffset,maskOffset+maskSize), set if occupied by a wall
+    std::vector<uint64_t> mask[3];
+
+    //! smallest wall coordinate per axis
+    int64_t maskOffset[3];
+
+    //! number of coordinates covered by the mask per axis, 0 if there is no wall
+    uint64_t maskSize[3];
+
 };
 
+/**
+ * @details Each axis gets a bitmask spanning from the smallest to the largest
+ * coordinate of the walls with a normal along this axis.
+ */
+inline void FeatureWall::compileWalls()
+{
+    for(uint32_t axis=0;axis<3;axis++){
+        mask[axis].clear();
+        maskOffset[axis]=0;
+        maskSize[axis]=0;
+
+        int64_t minCoordinate=0, maxCoordinate=-1;
+        for(size_t w=0;w<walls.size();w++){
+            if(getAxis(walls[w])!=axis) continue;
+            const int64_t coordinate=getWallCoordinate(walls[w]);
+            if(maxCoordinate<minCoordinate){
+                minCoordinate=maxCoordinate=coordinate;
+            }else{
+                minCoordinate=std::min(minCoordinate,coordinate);
+                maxCoordinate=std::max(maxCoordinate,coordinate);
+            }
+        }
+        if(maxCoordinate<minCoordinate) continue;
+
+        maskOffset[axis]=minCoordinate;
+        maskSize[axis]=uint64_t(maxCoordinate-minCoordinate)+1;
+        mask[axis].assign((maskSize[axis]+63)/64,0);
+        for(size_t w=0;w<walls.size();w++){
+            if(getAxis(walls[w])!=axis) continue;
+            const uint64_t n=uint64_t(getWallCoordinate(walls[w])-minCoordinate);
+            mask[axis][n>>6]|=(uint64_t(1)<<(n&63));
+        }
+    }
+}
+
 
 /*****************************************************************/
 /**
@@ -213,27 +304,8 @@ class ReadWall : public ReadToDestination < IngredientsType >
 template<class IngredientsType>
 bool FeatureWall::checkMove(const IngredientsType& ingredients, MoveLocalSc& move)
 {
-    uint32_t counter(0);
-
-	for (size_t i = 0; i < ingredients.getWalls().size(); i++) { //check all walls in the system
-
-		uint8_t direction;
-        VectorInt3 unitX(1,0,0);
-        VectorInt3 unitY(0,1,0);
-        VectorInt3 unitZ(0,0,1);
-
-		if (ingredients.getWalls()[i].getNormal() == unitX) { direction = 0; } //points direction of normal and sets variable direction to look only on this part of the new position vector later
-		if (ingredients.getWalls()[i].getNormal() == unitY) { direction = 1; }
-		if (ingredients.getWalls()[i].getNormal() == unitZ) { direction = 2; }
-
-		if ((ingredients.getMolecules()[move.getIndex()] + move.getDir()).getCoordinate(direction) != ingredients.getWalls()[i].getBase().getCoordinate(direction)-1) { //if new position has NOT the same value in "direction" as the wall -1, permit the move
-			counter++;
-		}
-	}
-
-	if (counter == ingredients.getWalls().size()) {return true;}
-
-	return false;
+	//the new position must not have the same value along the normal as any wall -1
+	return !isWallPosition(ingredients.getMolecules()[move.getIndex()] + move.getDir());
 }
 
 /**
@@ -245,27 +317,8 @@ bool FeatureWall::checkMove(const IngredientsType& ingredients, MoveLocalSc& mov
 template<class IngredientsType, class TagType>
 bool FeatureWall::checkMove(const IngredientsType& ingredients, MoveAddMonomerSc<TagType>& addmove)
 {
-    uint32_t counter(0);
-
-	for (size_t i = 0; i < ingredients.getWalls().size(); i++) { //check all walls in the system
-
-		uint8_t direction;
-        VectorInt3 unitX(1,0,0);
-        VectorInt3 unitY(0,1,0);
-        VectorInt3 unitZ(0,0,1);
-
-		if (ingredients.getWalls()[i].getNormal() == unitX) { direction = 0; } //points direction of normal and sets variable direction to look only on this part of the new position vector later
-		if (ingredients.getWalls()[i].getNormal() == unitY) { direction = 1; }
-		if (ingredients.getWalls()[i].getNormal() == unitZ) { direction = 2; }
-
-		if (addmove.getPosition().getCoordinate(direction) != ingredients.getWalls()[i].getBase().getCoordinate(direction)-1) { //if new molecule has NOT the same value in "direction" as the wall -1, permit the move
-			counter++;
-		}
-	}
-
-	if (counter == ingredients.getWalls().size()) {return true;}
-
-	return false;
+	//the new monomer must not have the same value along the normal as any wall -1
+	return !isWallPosition(addmove.getPosition());
 }
 
 /**
@@ -279,20 +332,16 @@ bool FeatureWall::checkMove(const IngredientsType& ingredients, MoveAddMonomerSc
 template<class IngredientsType>
 void FeatureWall::synchronize(const IngredientsType& ingredients)
 {
-    uint8_t direction;
-    VectorInt3 unitX(1,0,0);
-    VectorInt3 unitY(0,1,0);
-    VectorInt3 unitZ(0,0,1);
-
     for (size_t i=0; i<ingredients.getMolecules().size(); i++) {
 
-        for (size_t w = 0; w < ingredients.getWalls().size(); w++) {
+        if (!isWallPosition(ingredients.getMolecules()[i])) continue;
+
+        //find the wall for the error message
+        for (size_t w = 0; w < walls.size(); w++) {
 
-            if (ingredients.getWalls()[w].getNormal() == unitX) { direction = 0; }
-            if (ingredients.getWalls()[w].getNormal() == unitY) { direction = 1; }
-            if (ingredients.getWalls()[w].getNormal() == unitZ) { direction = 2; }
+            const uint32_t direction=getAxis(walls[w]);
 
-            if (ingredients.getMolecules()[i].getCoordinate(direction) == ingredients.getWalls()[w].getBase().getCoordinate(direction)-1) {
+            if (ingredients.getMolecules()[i].getCoordinate(direction) == getWallCoordinate(walls[w])) {
                 std::ostringstream errorMessage;
                 errorMessage << "FeatureWall::synchronize(const IngredientsType& ingredients): Invalid monomer position of monomer " << i << " at " << ingredients.getMolecules()[i] << " in wall: normal: " << ingredients.getWalls()[w].getNormal().getX() << ingredients.getWalls()[w].getNormal().getY() << ingredients.getWalls()[w].getNormal().getZ() << ", base: " << ingredients.getWalls()[w].getBase().getCoordinate(direction)-1 << ".\n";
                 throw std::runtime_error(errorMessage.str());
@@ -0,0 +1,131 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_IO_BFMTOKENIZER_H
+#define LEMONADE_IO_BFMTOKENIZER_H
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Definition of class BfmTokenizer
+ * */
+/*****************************************************************************/
+
+#include <stdint.h>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @class BfmTokenizer
+ *
+ * @brief Sequential scanner for the commands of a bfm-file
+ *
+ * @details The tokenizer reads the stream in large blocks with istream::read
+ * and finds the line ends in the block with memchr. Lines beginning with ! or
+ * #! are reported as commands together with their byte offsets in the file.
+ * Except for reset(), the stream is never repositioned, and tellg() is never
+ * called, so scanning a file costs one read per block instead of several
+ * system calls per line as with Parser::findRead().
+ *
+ * The command names are the same as returned by Parser::findRead(): the
+ * line up to the first = if the line contains one, otherwise the first word.
+ * The argument offset is the position at which findRead() leaves the stream,
+ * i.e. where a Read for this command would start reading.
+ *
+ * The tokenizer consumes the stream. Its position and state are undefined
+ * afterwards, and it has to be reset by the caller before further use.
+ * */
+/*****************************************************************************/
+class BfmTokenizer
+{
+public:
+
+  //! a command found in the stream
+  struct Command
+  {
+    //! command string, e.g. !mcs or #!version
+    std::string name;
+    //! byte offset of the beginning of the line
+    uint64_t lineOffset;
+    //! byte offset behind the command string (and the =)
+    uint64_t argumentOffset;
+    //! rest of the line behind the command string, without line end
+    std::string arguments;
+  };
+
+  //! block size used if none is given
+  enum{ defaultBlockSize=1<<20 };
+
+  BfmTokenizer(std::istream& inputStream, size_t blockSize_=defaultBlockSize);
+
+  //! positions the stream at offset and discards the buffered data
+  void reset(uint64_t offset=0);
+
+  //! finds the next command. Returns false if the end of the stream is reached
+  bool next(Command& command);
+
+  //! number of bytes read from the stream since the last reset()
+  uint64_t getBytesRead() const {return bytesRead;}
+
+  /**
+   * @brief Parses an unsigned integer at the beginning of str like operator>>
+   * @param str string to parse, e.g. Command::arguments
+   * @param value the parsed value
+   * @param consumed number of characters up to the end of the number
+   * @return false if str contains no number after optional whitespace
+   */
+  static bool parseUnsigned(const std::string& str, uint64_t& value, size_t& consumed);
+
+private:
+
+  //! moves the incomplete line to the front and appends the next block. Returns false if nothing was read
+  bool fillBuffer();
+
+  std::istream& stream;
+
+  size_t blockSize;
+
+  std::vector<char> buffer;
+
+  //! unprocessed data is buffer[begin...end-1]
+  size_t begin;
+  size_t end;
+
+  //! file offset of buffer[0]
+  uint64_t bufferOffset;
+
+  uint64_t bytesRead;
+
+  //! true if the end of the stream was reached
+  bool streamEnd;
+};
+
+#endif /* LEMONADE_IO_BFMTOKENIZER_H */
@@ -0,0 +1,282 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_IO_CHECKPOINT_H
+#define LEMONADE_IO_CHECKPOINT_H
+
+/***********************************************************************/
+/**
+ *@file
+ *@brief Binary checkpoint files for the restart of simulations
+ */
+/***********************************************************************/
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <type_traits>
+
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+/***********************************************************************/
+/**
+ * @class CheckpointWriter
+ *
+ * @brief Writes a binary checkpoint file consisting of named sections.
+ *
+ * @details In contrast to the bfm-file, a checkpoint holds the complete
+ * simulation state as raw memory: the molecules including all monomer
+ * extensions, the state of the features and the state of the R250 random
+ * number generator. Restarting from a checkpoint therefore continues the
+ * simulation exactly (bitwise) and does not require to parse a text file
+ * and to synchronize the system.
+ *
+ * The file starts with the header "LMDCHKPT", a version and a set of flags.
+ * It is followed by sections, each consisting of its name, its length in
+ * bytes and the payload. The payload of a section is collected in memory
+ * and written in endSection(). The data is written to filename.tmp, which
+ * is renamed to filename in close(), such that an existing checkpoint is
+ * only replaced by a complete one.
+ *
+ * The data is stored in the byte order and with the type layout of the
+ * machine writing it. Checkpoints are thus meant for restarts with the same
+ * program on the same kind of machine and are no replacement for bfm-files.
+ */
+/***********************************************************************/
+class CheckpointWriter
+{
+public:
+
+	//! opens filename.tmp for writing. The lattice is only written if includeLattice is true
+	CheckpointWriter(const std::string& filename, bool includeLattice=true);
+
+	//! closes the file, if close() was not called before. The temporary file is removed then.
+	~CheckpointWriter();
+
+	//! writes the last section and moves the temporary file to the final file name
+	void close();
+
+	//! true, if features should write their lattice occupation
+	bool includesLattice() const {return withLattice;}
+
+	//! starts a new section with the given name
+	void beginSection(const std::string& name);
+
+	//! finishes the current section and writes it to the file
+	void endSection();
+
+	//! writes a single value of trivial type T
+	template < class T > void write(const T& value){writeArray(&value,1);}
+
+	//! writes n values of trivial type T
+	template < class T > void writeArray(const T* values, size_t n);
+
+	//! writes the size of the vector followed by its elements
+	template < class T > void writeVector(const std::vector<T>& values);
+
+	//! writes the length of the string followed by its characters
+	void writeString(const std::string& str);
+
+private:
+
+	std::string filename;
+	std::ofstream file;
+	bool withLattice;
+	bool sectionOpen;
+	std::string sectionName;
+	std::string sectionData;
+};
+
+/***********************************************************************/
+/**
+ * @class CheckpointReader
+ *
+ * @brief Reads a binary checkpoint file written by CheckpointWriter.
+ *
+ * @details Sections have to be read in the order they were written. A
+ * section with a different name than expected, a section which is not
+ * read completely and a truncated file result in a std::runtime_error.
+ */
+/***********************************************************************/
+class CheckpointReader
+{
+public:
+
+	//! opens the checkpoint and checks the header
+	CheckpointReader(const std::string& filename);
+
+	//! true, if the checkpoint contains the lattice occupation
+	bool includesLattice() const {return withLattice;}
+
+	//! reads the header of the next section, which must have the given name
+	void beginSection(const std::string& name);
+
+	//! finishes the current section. Throws, if it was not read completely
+	void endSection();
+
+	//! checks that all sections were read. Throws, if the file contains further data
+	void close();
+
+	//! reads a single value of trivial type T
+	template < class T > void read(T& value){readArray(&value,1);}
+
+	//! reads n values of trivial type T
+	template < class T > void readArray(T* values, size_t n);
+
+	//! reads a vector written by CheckpointWriter::writeVector()
+	template < class T > void readVector(std::vector<T>& values);
+
+	//! reads a string written by CheckpointWriter::writeString()
+	void readString(std::string& str);
+
+private:
+
+	//! reads nBytes raw bytes of the current section
+	void readBytes(char* destination, uint64_t nBytes);
+
+	std::string filename;
+	std::ifstream file;
+	bool withLattice;
+	std::string sectionName;
+	uint64_t sectionRemaining;
+};
+
+/*****************************************************************************/
+//template members
+/*****************************************************************************/
+
+/**
+ * @details T must be trivially copyable, i.e. it must not hold pointers,
+ * containers or a user defined copy operation.
+ */
+template < class T >
+void CheckpointWriter::writeArray(const T* values, size_t n)
+{
+	static_assert(std::is_trivially_copyable<T>::value,"CheckpointWriter: type must be trivially copyable");
+	sectionData.append(reinterpret_cast<const char*>(values),n*sizeof(T));
+}
+
+template < class T >
+void CheckpointWriter::writeVector(const std::vector<T>& values)
+{
+	uint64_t n=values.size();
+	write(n);
+	if(n>0) writeArray(&values[0],values.size());
+}
+
+template < class T >
+void CheckpointReader::readArray(T* values, size_t n)
+{
+	static_assert(std::is_trivially_copyable<T>::value,"CheckpointReader: type must be trivially copyable");
+	readBytes(reinterpret_cast<char*>(values),uint64_t(n)*sizeof(T));
+}
+
+template < class T >
+void CheckpointReader::readVector(std::vector<T>& values)
+{
+	uint64_t n;
+	read(n);
+	if(n*sizeof(T)>sectionRemaining)
+		throw std::runtime_error("CheckpointReader::readVector: vector exceeds section "+sectionName+" in "+filename);
+	values.resize(n);
+	if(n>0) readArray(&values[0],n);
+}
+
+/*****************************************************************************/
+//convenience functions
+/*****************************************************************************/
+
+/**
+ * @brief Writes the complete state of ingredients and the R250 state to filename.
+ *
+ * @details The sections are "Molecules", "R250" and one section per feature.
+ * Features store their state by implementing Feature::writeCheckpoint():
+ * box, bondset, lattice, the parameters of the potentials (nearest neighbor
+ * interactions, bending, springs, linear force, external field), walls, the
+ * reactive bond lists and the system information features. Energies and
+ * other quantities derived from the positions are recalculated by
+ * synchronize() on loading. Features without hooks (e.g. FeatureLabel,
+ * FeatureConnectionSc) hold only state which synchronize() rebuilds from
+ * the molecules.
+ *
+ * @param filename name of the checkpoint file
+ * @param ingredients the system to save
+ * @param includeLattice if false, the lattice occupation is not saved, but rebuilt on loading
+ */
+template < class IngredientsType >
+void saveCheckpoint(const std::string& filename, const IngredientsType& ingredients, bool includeLattice=true)
+{
+	CheckpointWriter checkpoint(filename,includeLattice);
+
+	checkpoint.beginSection("Molecules");
+	ingredients.getMolecules().writeCheckpoint(checkpoint);
+	checkpoint.endSection();
+
+	std::vector<uint32_t> rngState;
+	RandomNumberGenerators().getR250State(rngState);
+	checkpoint.beginSection("R250");
+	checkpoint.writeVector(rngState);
+	checkpoint.endSection();
+
+	ingredients.writeCheckpoint(checkpoint);
+	checkpoint.close();
+}
+
+/**
+ * @brief Restores a state written by saveCheckpoint() into ingredients.
+ *
+ * @details ingredients must have the same features as the saved system.
+ * Features without checkpoint support are synchronized after their
+ * predecessors were restored, thus no further call of synchronize() is
+ * required.
+ *
+ * @param filename name of the checkpoint file
+ * @param ingredients the system to restore
+ */
+template < class IngredientsType >
+void loadCheckpoint(const std::string& filename, IngredientsType& ingredients)
+{
+	CheckpointReader checkpoint(filename);
+
+	checkpoint.beginSection("Molecules");
+	ingredients.modifyMolecules().readCheckpoint(checkpoint);
+	checkpoint.endSection();
+
+	std::vector<uint32_t> rngState;
+	checkpoint.beginSection("R250");
+	checkpoint.readVector(rngState);
+	checkpoint.endSection();
+	RandomNumberGenerators().setR250State(rngState);
+
+	ingredients.readCheckpoint(checkpoint);
+	checkpoint.close();
+}
+
+#endif /* LEMONADE_IO_CHECKPOINT_H */
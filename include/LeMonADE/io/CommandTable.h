@@ -0,0 +1,182 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_IO_COMMANDTABLE_H
+#define LEMONADE_IO_COMMANDTABLE_H
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Definition of class template CommandTable
+ * */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/**
+ * @class CommandTable
+ *
+ * @brief Interns bfm command strings into dense integer ids
+ *
+ * @details Every name added with insert() gets the next id, starting from 0,
+ * and a value of type T stored in a flat vector indexed by the id. Iterating
+ * over the ids therefore visits the commands in the order of registration.
+ * Names are looked up from a character range via an open addressing hash
+ * table (FNV-1a, linear probing, load factor at most 1/2), such that no
+ * temporary std::string is needed. The full name is only compared, if the
+ * stored hash of a slot matches.
+ *
+ * @tparam T type of the value associated with each command, e.g. a pointer
+ * to the read or write object
+ * */
+/*****************************************************************************/
+template<class T>
+class CommandTable
+{
+public:
+
+	//! id returned by find() for names not in the table
+	static const int32_t notFound=-1;
+
+	CommandTable():slots(16,notFound){}
+
+	//! returns the id of name, or notFound
+	int32_t find(const char* name, size_t length) const;
+
+	//! returns the id of name, or notFound
+	int32_t find(const std::string& name) const {return find(name.data(),name.size());}
+
+	/**
+	 * @brief adds name with the given value, if it is not in the table yet
+	 * @return the id of name and true, if it was added. If it was already
+	 * present, its value is not changed and false is returned
+	 */
+	std::pair<int32_t,bool> insert(const std::string& name, const T& value);
+
+	//! number of interned names
+	size_t size() const {return names.size();}
+
+	//! name belonging to id
+	const std::string& getName(int32_t id) const {return names[id];}
+
+	//! value belonging to id
+	T& operator[](int32_t id){return values[id];}
+	//! value belonging to id
+	const T& operator[](int32_t id) const {return values[id];}
+
+	//! removes all names and values
+	void clear(){
+		names.clear();
+		values.clear();
+		hashes.clear();
+		slots.assign(16,notFound);
+	}
+
+private:
+
+	//! FNV-1a hash of the character range
+	static uint64_t hash(const char* name, size_t length){
+		uint64_t h=14695981039346656037ULL;
+		for(size_t n=0;n<length;n++){
+			h^=uint64_t((unsigned char)name[n]);
+			h*=1099511628211ULL;
+		}
+		return h;
+	}
+
+	//! rebuilds the slots with nSlots entries (a power of two)
+	void rehash(size_t nSlots);
+
+	std::vector<std::string> names;
+	std::vector<T> values;
+	std::vector<uint64_t> hashes;
+
+	//! hash table holding the ids, notFound marks empty slots
+	std::vector<int32_t> slots;
+};
+
+template<class T>
+const int32_t CommandTable<T>::notFound;
+
+template<class T>
+int32_t CommandTable<T>::find(const char* name, size_t length) const
+{
+	const uint64_t h=hash(name,length);
+	const size_t mask=slots.size()-1;
+
+	for(size_t s=size_t(h)&mask;;s=(s+1)&mask)
+	{
+		const int32_t id=slots[s];
+		if(id==notFound) return notFound;
+		if(hashes[id]==h && names[id].size()==length
+			&& std::memcmp(names[id].data(),name,length)==0)
+			return id;
+	}
+}
+
+template<class T>
+std::pair<int32_t,bool> CommandTable<T>::insert(const std::string& name, const T& value)
+{
+	int32_t id=find(name);
+	if(id!=notFound) return std::make_pair(id,false);
+
+	id=int32_t(names.size());
+	names.push_back(name);
+	values.push_back(value);
+	hashes.push_back(hash(name.data(),name.size()));
+
+	if(2*names.size()>slots.size()) rehash(2*slots.size());
+	else{
+		const size_t mask=slots.size()-1;
+		size_t s=size_t(hashes[id])&mask;
+		while(slots[s]!=notFound) s=(s+1)&mask;
+		slots[s]=id;
+	}
+
+	return std::make_pair(id,true);
+}
+
+template<class T>
+void CommandTable<T>::rehash(size_t nSlots)
+{
+	slots.assign(nSlots,notFound);
+	const size_t mask=nSlots-1;
+	for(size_t id=0;id<names.size();id++)
+	{
+		size_t s=size_t(hashes[id])&mask;
+		while(slots[s]!=notFound) s=(s+1)&mask;
+		slots[s]=int32_t(id);
+	}
+}
+
+#endif /* LEMONADE_IO_COMMANDTABLE_H */
@@ -37,7 +37,6 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <fstream>
 #include <map>
-#include <set>
 #include <utility>
 #include <iostream>
 #include <stdint.h>
@@ -45,6 +44,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <LeMonADE/Version.h>
 #include <LeMonADE/io/AbstractRead.h>
+#include <LeMonADE/io/BfmTokenizer.h>
+#include <LeMonADE/io/CommandTable.h>
 #include <LeMonADE/io/Parser.h>
 
 
@@ -172,13 +173,14 @@ private:
   Parser parser;
 
   //Read handling
-  //! Map of Read-strings (e.g. !box_x) associated Read objects
-  std::map <std::string, AbstractRead*> Reads;
-  //save the unknown commands found in the file in
-  //this set. This is used to make sure information about unknown reads is
+  //! Table of Read-strings (e.g. !box_x) interned to ids, with the associated Read objects
+  //unknown commands found in the file are interned, too, with a null
+  //Read object. This is used to make sure information about unknown reads is
   //not written out multiple times when printMetaData is used.
-  //! Set of Read-strings of unknown commands found in the file.
-  std::set <std::string> unknownReads;
+  CommandTable<AbstractRead*> Reads;
+
+  //! Buffer for the Read-string currently processed, reused to avoid allocations
+  std::string currentRead;
 
   //! Execute read of Read associated with string
   void executeRead(const std::string&);
@@ -193,6 +195,9 @@ private:
   //! Maps frame number to mcs.
   std::map<uint32_t,uint64_t> framePositionInFile;
 
+  //! Maps the mcs of every !mcs_delta frame to the mcs of the preceeding !mcs (keyframe).
+  std::map<uint64_t,uint64_t> keyframeOfDeltaFrame;
+
   //saves the complete first conformation. this is useful for
   //jumping back to the first conformation
   //! Holing the first conformation in the file. Useful for rewinding.
@@ -201,6 +206,9 @@ private:
   //! Scans the complete file for the positions of the !mcs commands
   void scanFile();
 
+  //! Reads the frame at it, for !mcs_delta frames starting from the keyframe.
+  bool readFrame(std::map<uint64_t,std::streampos>::const_iterator it);
+
 };
 
 /***********************************************************************
@@ -236,8 +244,8 @@ FileImport<IngredientsType>::FileImport(const std::string& sourcefile,Ingredient
   bfmData.exportRead(*this);
 
   //make the input file stream known to Read objects
-  for(typename std::map <std::string,AbstractRead*>::iterator ib=Reads.begin();ib!=Reads.end();++ib){
-    ib->second->setInputStream(&file);
+  for(size_t id=0;id<Reads.size();id++){
+    Reads[id]->setInputStream(&file);
   }
 
   dataStorage.setName(sourcefile);
@@ -256,10 +264,9 @@ FileImport<IngredientsType>::FileImport(const std::string& sourcefile,Ingredient
 template <class IngredientsType>
 FileImport<IngredientsType>::~FileImport()
 {
-	std::map <std::string, AbstractRead*>::iterator it;
-	for(it=Reads.begin();it!=Reads.end();++it){
-		delete it->second;
-		it->second=0;
+	for(size_t id=0;id<Reads.size();id++){
+		delete Reads[id];
+		Reads[id]=0;
 	}
 	Reads.clear();
 }
@@ -268,6 +275,9 @@ FileImport<IngredientsType>::~FileImport()
  *void FileImport::registerRead(string ReadString, AbstractRead* ReadObject)
  ******************************************************************************/
 /**
+ * @details The command string is interned into an id of the Read table. If the
+ * command was found in the file as unknown command before, the new Read
+ * object takes its place.
  *
  * @param ReadString bfm-keyword/command/user-command (e.g. !box_x, #!fixed_monomers)
  * @param ReadObject pointer to object providing the Read's functionality
@@ -276,7 +286,13 @@ template <class IngredientsType>
 void FileImport<IngredientsType>::registerRead(std::string ReadString, AbstractRead* ReadObject)
 {
   std::cout<<"registered bfm-Read "<<ReadString<<std::endl;
-  if( Reads.insert(std::pair<std::string,AbstractRead*> (ReadString, ReadObject)).second==false)
+  std::pair<int32_t,bool> inserted=Reads.insert(ReadString,ReadObject);
+  if(inserted.second==false && Reads[inserted.first]==0)
+  {
+    Reads[inserted.first]=ReadObject;
+    ReadObject->setInputStream(&file);
+  }
+  else if(inserted.second==false)
   {
     std::stringstream errormessage;
     errormessage<<"Could not register Read with command string "<<ReadString
@@ -298,16 +314,16 @@ template <class IngredientsType>
 void FileImport<IngredientsType>::replaceRead(std::string key,AbstractRead* newRead)
 {
 	//find the old read. if not present, throw exception. otherwise replace
-	std::map <std::string, AbstractRead*>::iterator it (this->Reads.find(key));
-	if ( it == Reads.end() )
+	int32_t id=Reads.find(key);
+	if ( id == Reads.notFound || Reads[id] == 0 )
 	{
 		std::ostringstream strm; strm << "Read command \"" << key << "\" not found for modification.";
 		throw std::runtime_error(strm.str());
 	}
 	else
 	{
-		delete it->second;
-		it->second=newRead;
+		delete Reads[id];
+		Reads[id]=newRead;
 		std::cerr << "WARNING: REPLACED READ COMMAND \"" << key << "\".\n";
 	}
 }
@@ -320,8 +336,8 @@ void FileImport<IngredientsType>::replaceRead(std::string key,AbstractRead* newR
 template <class IngredientsType> AbstractRead*
 FileImport<IngredientsType>::modifyRead(std::string key)
 {
-	std::map <std::string, AbstractRead*>::iterator it (this->Reads.find(key));
-	if ( it == Reads.end() )
+	int32_t id=Reads.find(key);
+	if ( id == Reads.notFound || Reads[id] == 0 )
 	{
 		std::ostringstream strm; strm << "Read command \"" << key << "\" not found for modification.";
 		throw std::runtime_error(strm.str());
@@ -330,7 +346,7 @@ FileImport<IngredientsType>::modifyRead(std::string key)
 	{
 		std::cout << "returning read command for modification \"" << key << "\".\n";
 	}
-	return it->second;
+	return Reads[id];
 }
 
 //Parse and process bfm-file up to first conformation (incl. read-in first !mcs)
@@ -340,7 +356,8 @@ void FileImport<IngredientsType>::readHeader()
 	double version;
 	bool versionInformationPresent=false;
 
-	std::string Read;
+	std::string& Read=currentRead;
+	Read.clear();
 	std::streampos beforeFirstMcs=file.tellg();
 
 	bool first_mcs_found=false;
@@ -348,7 +365,7 @@ void FileImport<IngredientsType>::readHeader()
 	//read file up to the first mcs command (including the first mcs)
 	while(!file.fail() && (Read != "endoffile") && (first_mcs_found == false))
 	{
-		Read=parser.findRead();
+		parser.findRead(Read);
 
 
 		if (Read=="!mcs")
@@ -394,15 +411,16 @@ template <class IngredientsType>
 bool FileImport<IngredientsType>::read()
 {
 
-	std::string Read;
+	std::string& Read=currentRead;
+	Read.clear();
 
 	//read and process file until eof or !mcs is reached (or file stream fails otherwise)
 	bool MCSFound = false;
 
 	while(!file.fail() && Read != "endoffile" )
 	{
-		Read=parser.findRead();
-		if ( Read == "!mcs")
+		parser.findRead(Read);
+		if ( Read == "!mcs" || Read == "!mcs_delta")
 			MCSFound = true;
 
 		executeRead(Read);
@@ -419,30 +437,29 @@ bool FileImport<IngredientsType>::read()
  ******************************************************************************/
 // Execute read of Read associated with string
 /**
+ * @details The lookup in the Read table does not allocate. Unknown commands
+ * are interned with a null Read object the first time they occur, and added
+ * to the comments of bfmData only then.
+ *
  * @param ReadString Keyword/command/user-command which should be executed.
  */
 template <class IngredientsType>
 void FileImport<IngredientsType>::executeRead(const std::string& ReadString)
 {
-  std::map<std::string,AbstractRead*>::iterator it;
-  //try to find ReadString in the map of registered Reads
-  it=Reads.find(ReadString);
+  //try to find ReadString in the table of registered Reads
+  int32_t id=Reads.find(ReadString);
 
   //if not found, react appropriately
-  if (it==Reads.end()){
+  if (id==Reads.notFound){
     //std::cout<<"unknown Read "<<ReadString<<std::endl;
-    if(unknownReads.count(ReadString)==0)
-    {
-      bfmData.addComment(ReadString + "\n");
-      unknownReads.insert(ReadString);
-    }
-    return;
+    Reads.insert(ReadString,0);
+    bfmData.addComment(ReadString + "\n");
   }
   //if found, call the appropriate function
-  else
+  else if (Reads[id]!=0)
   {
 	//std::cout << "found Read " << ReadString << std::endl;
-    it->second->execute();
+    Reads[id]->execute();
   }
 }
 
@@ -450,9 +467,15 @@ void FileImport<IngredientsType>::executeRead(const std::string& ReadString)
 /**
  * @details Scans the file for !mcs-commands and saves the positions of these commands in
  * the map mcsPositionInFile. The positions saved there are right after the
- * previous !mcs. It does \b NOT parse the !mcs nor it sets any system informations.
+ * previous !mcs. Frames written as !mcs_delta are treated as !mcs, additionally
+ * the keyframe they are based on is saved in keyframeOfDeltaFrame. The base
+ * frame named in the !mcs_delta header must be the frame preceeding it in the
+ * file. It does \b NOT parse the !mcs nor it sets any system informations.
+ * The file is scanned with a BfmTokenizer, i.e. in large blocks without
+ * repositioning the stream for every line.
  *
- * @throw <runtime_error> if IO-error (different from eof) occurs.
+ * @throw <runtime_error> if the time of an !mcs can not be read, or if an
+ * !mcs_delta is not based on the preceeding frame.
  *
  * @todo Rename to scanFileForMCS()!
  **/
@@ -462,64 +485,70 @@ void FileImport<IngredientsType>::scanFile()
 	std::cout<<"scanning file...this may take some seconds for large files...";
 	std::cout.flush();
 	//save this position and return to it after the operation
+	file.clear();
 	std::streampos startingPosition=file.tellg();
 
-	std::string read;
-	std::streampos mcsPosition;
-	uint64_t mcs;
-
-	//first go to the beginning of the file and find the position of
-	//the first mcs command. this position is not saved, because it
-	//is not necessarily clear, which commands preceeding the first
-	// !mcs area part of this !mcs (e.g. solvent). Therefore, the
-	//complete first conformation is saved in readHeader().
-	file.clear();
 	mcsPositionInFile.clear();
 	framePositionInFile.clear();
-	file.seekg(0,std::ios::beg);
+	keyframeOfDeltaFrame.clear();
 
-	//the information of the first frame/conformation is read-in by readHeader()
-	while(!file.fail() && (read != "endoffile"))
-	{
-		mcsPosition=file.tellg();
-
-		read=parser.findRead();
+	BfmTokenizer tokenizer(file);
+	tokenizer.reset(0);
+	BfmTokenizer::Command command;
 
-		if (read=="!mcs")
-		{
-			file>>mcs;
-			mcsPositionInFile.insert(std::make_pair(mcs,mcsPosition));
-			framePositionInFile.insert(std::make_pair(mcsPositionInFile.size(),mcs));
-			break;
-		}
-	}
-
-	//now save all the following positions of the !mcs commands
+	//the position saved for the first !mcs is behind the last command
+	//preceeding it. it is not necessarily clear, which commands preceeding
+	//the first !mcs area part of this !mcs (e.g. solvent). Therefore, the
+	//complete first conformation is saved in readHeader().
+	//the positions of the following !mcs are right behind the previous time
+	uint64_t mcsPosition=0;
+	uint64_t lastKeyframe=0;
+	uint64_t lastFrame=0;
 
-	while(!file.fail() && read != "endoffile" )
+	while(tokenizer.next(command))
 	{
-
-		mcsPosition=file.tellg();
-
-		read=parser.findRead();
-		while(read!="!mcs" && !file.fail() && read!="endoffile" )
+		bool isDeltaFrame=(command.name=="!mcs_delta");
+		if(command.name=="!mcs" || isDeltaFrame)
+		{
+			uint64_t mcs;
+			size_t consumed;
+			if(!BfmTokenizer::parseUnsigned(command.arguments,mcs,consumed))
 			{
-			read=parser.findRead();
-
+				std::stringstream errormessage;
+				errormessage<<"FileImport::scanFile(): error scanning mcs positions";
+				if(!mcsPositionInFile.empty())
+					errormessage<<" after mcs "<<mcsPositionInFile.rbegin()->first;
+				errormessage<<"\n";
+				throw std::runtime_error(errormessage.str());
 			}
-
-		if(!(read=="endoffile")) file>>mcs;
-
-		if(file.fail() && !(read=="endoffile"))
-		{
-			std::stringstream errormessage;
-            errormessage<<"FileImport::scanFile(): error scanning mcs positions after mcs "
-                          <<mcsPositionInFile.rbegin()->first<<"\n";
-			throw std::runtime_error(errormessage.str());
+			//std::cout<<"insterting mcs "<<mcs<<" at filepointer pos "<<mcsPosition<<std::endl;
+			if(isDeltaFrame && mcsPositionInFile.empty())
+				throw std::runtime_error("FileImport::scanFile(): !mcs_delta without preceeding !mcs\n");
+			if(isDeltaFrame)
+			{
+				//the delta must be based on the frame preceeding it in the file
+				size_t basePosition=command.arguments.find("base=",consumed);
+				uint64_t base;
+				size_t baseConsumed;
+				if(basePosition==std::string::npos
+					|| !BfmTokenizer::parseUnsigned(command.arguments.substr(basePosition+5),base,baseConsumed)
+					|| base!=lastFrame)
+				{
+					std::stringstream errormessage;
+					errormessage<<"FileImport::scanFile(): !mcs_delta="<<mcs
+						<<" is not based on the preceeding frame mcs "<<lastFrame<<"\n";
+					throw std::runtime_error(errormessage.str());
+				}
+				keyframeOfDeltaFrame[mcs]=lastKeyframe;
+			}
+			else lastKeyframe=mcs;
+			mcsPositionInFile.insert(std::make_pair(mcs,std::streampos(mcsPosition)));
+			framePositionInFile.insert(std::make_pair(mcsPositionInFile.size(),mcs));
+			mcsPosition=command.argumentOffset+consumed;
+			lastFrame=mcs;
 		}
-		//std::cout<<"insterting mcs "<<mcs<<" at filepointer pos "<<mcsPosition<<std::endl;
-		mcsPositionInFile.insert(std::make_pair(mcs,mcsPosition));
-		framePositionInFile.insert(std::make_pair(mcsPositionInFile.size(),mcs));
+		else if(mcsPositionInFile.empty())
+			mcsPosition=command.argumentOffset;
 	}
 
 	//go back to the position the file was at before this function was called
@@ -534,7 +563,8 @@ void FileImport<IngredientsType>::scanFile()
 /**
  * @details IMPORTANT: TOPOLOGY MIGHT NOT BE CORRECT IF IT IS CHANGING SOMEWHERE IN THE
  * MIDDLE OF THE FILE! It parses the time smaller or equal to the required one.
- * It returns if there is another !mcs after the required one.
+ * It returns if there is another !mcs after the required one. If the frame is
+ * a !mcs_delta, the preceeding keyframe and all frames in between are read.
  *
  * @param mcs The time in MCS in the file for forward-winding
  * @return True if another !mcs is there. False, otherwise.
@@ -546,7 +576,6 @@ bool FileImport<IngredientsType>::gotoMcs(uint64_t mcs)
 	file.clear();
 
   bool retVal;
-  std::streampos position;
   std::map<uint64_t,std::streampos>::iterator it;
   //check if smaller than min or larger than max
 
@@ -564,23 +593,45 @@ bool FileImport<IngredientsType>::gotoMcs(uint64_t mcs)
   {
     it=mcsPositionInFile.end();
     --it;
-    position=it->second;
-    file.seekg(position);
-    retVal=read();
+    retVal=readFrame(it);
   }
   //else got to the conformation with mcs smaller or equal to the
   //one required
   else
   {
     it=mcsPositionInFile.lower_bound(mcs);
-    position=it->second;
-    file.seekg(position);
-    retVal=read();
+    retVal=readFrame(it);
   }
 
   return retVal;
 }
 
+/**
+ * @details Seeks to the position of the frame given by it and reads it. If the
+ * frame is a !mcs_delta, it seeks to the preceeding keyframe instead and reads
+ * forward until the age of the frame is reached.
+ *
+ * @param it Entry of mcsPositionInFile of the frame to read.
+ * @return True if the frame was read. False, otherwise.
+ */
+template <class IngredientsType>
+bool FileImport<IngredientsType>::readFrame(std::map<uint64_t,std::streampos>::const_iterator it)
+{
+	std::map<uint64_t,uint64_t>::const_iterator itKeyframe=keyframeOfDeltaFrame.find(it->first);
+	if(itKeyframe==keyframeOfDeltaFrame.end())
+	{
+		file.seekg(it->second);
+		return read();
+	}
+
+	file.seekg(mcsPositionInFile.find(itKeyframe->second)->second);
+	bool retVal=read();
+	while(retVal && bfmData.getMolecules().getAge()<it->first)
+		retVal=read();
+
+	return retVal;
+}
+
 /**
  * @details IMPORTANT: TOPOLOGY MIGHT NOT BE CORRECT IF IT IS CHANGING SOMEWHERE IN THE
  * MIDDLE OF THE FILE! It parses the time smaller or equal to the required one.
@@ -608,14 +659,12 @@ template <class IngredientsType>
 bool FileImport<IngredientsType>::gotoEnd()
 {
 
-	std::streampos position;
-
-  position=mcsPositionInFile.rbegin()->second;
   file.clear();
 
-  file.seekg(position);
-  //now read until next mcs is processed
-  bool retVal=read();
+  //now read until the last mcs is processed
+  std::map<uint64_t,std::streampos>::const_iterator it=mcsPositionInFile.end();
+  --it;
+  bool retVal=readFrame(it);
 
   return retVal;
 }
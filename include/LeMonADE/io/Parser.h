@@ -44,6 +44,9 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @class Parser
  *
  * @brief Basic parser for files in *.bfm-format
+ *
+ * @details For scanning complete files without processing the commands,
+ * BfmTokenizer is much faster, since it does not reposition the stream.
  * */
 /*****************************************************************************/
 class Parser
@@ -59,9 +62,19 @@ public:
    */
   std::string findRead();
 
+  /**
+   * @brief Same as findRead(), but stores the ReadString in Read
+   * @details Read and the internal line buffer keep their capacity, such that
+   * parsing a file does not allocate a new string for every command.
+   */
+  void findRead(std::string& Read);
+
 private:
   //! Stream to be parsed
   std::istream& stream;
+
+  //! Buffer for the line currently examined
+  std::string line;
 };
 
 
@@ -28,6 +28,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef LEMONADE_UPDATER_ABSTRACTUPDATER_H
 #define LEMONADE_UPDATER_ABSTRACTUPDATER_H
 
+#include <stdint.h>
+
 /**
  * @file
  *
@@ -76,6 +78,17 @@ public:
    *
    **/
   virtual void cleanup() = 0;
+
+  /**
+   * @brief Number of moves attempted by this updater so far.
+   *
+   * @details Read by the TaskManager telemetry before and after every execute().
+   * Updaters which do not count their moves return 0.
+   **/
+  virtual uint64_t getNAttemptedMoves() const {return 0;}
+
+  //! Number of moves accepted by this updater so far, see getNAttemptedMoves()
+  virtual uint64_t getNAcceptedMoves() const {return 0;}
 };
 
 
@@ -38,10 +38,23 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @details This abstract class provides the three basic functions to create systems: add a single monomer, add a connected monomer and move the system to find some free space.
  * This Updater requires FeatureAttributes.
  *
+ * Dense systems are built without blind retry loops: single monomers are drawn
+ * from a list of candidate sites, from which every site found occupied is removed,
+ * and connected monomers try every bond direction once in random order. If a
+ * monomer can not be placed, only the molecule it is attached to is relaxed
+ * at first, the whole system is moved only if this does not help.
+ *
  * @tparam IngredientsType
  *
  **/
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
 #include <LeMonADE/updater/AbstractUpdater.h>
 #include <LeMonADE/utility/MonomerGroup.h>
 #include <LeMonADE/utility/DepthIterator.h>
@@ -53,7 +66,7 @@ template<class IngredientsType>
 class UpdaterAbstractCreate:public AbstractUpdater
 {
 public:
-  UpdaterAbstractCreate(IngredientsType& ingredients_):ingredients(ingredients_){}
+  UpdaterAbstractCreate(IngredientsType& ingredients_):ingredients(ingredients_),nCandidateSites(0),candidateSitesAge(0),candidateSitesNMonomers(0){}
 
   virtual void initialize();
   virtual bool execute();
@@ -89,9 +102,51 @@ protected:
   //! function to get a random bondvector of length 2
   VectorInt3 randomBondvector();
 
+  //! function to move the monomers connected to a monomer
+  void relaxConnectedGroup(uint32_t index, int32_t nsteps);
+
 private:
   RandomNumberGenerators rng;
 
+  //! writes the six bondvectors of length 2 in random order to bondvectors
+  void shuffledBondvectors(VectorInt3* bondvectors);
+
+  //! draws a free position from the candidate sites, returns false if there is none
+  bool drawFreeSite(MoveAddMonomerSc<>& addmove);
+
+  //! draws a free position bonded to parent_id, returns false if there is none
+  bool drawFreeBondvector(uint32_t parent_id, MoveAddMonomerSc<>& addmove);
+
+  //! number of blind attempts in addSingleMonomer before the candidate sites are used
+  enum{ NBlindAttempts=64 };
+
+  //! number of failed local relaxations after which the whole system is moved
+  enum{ NLocalRelaxations=8 };
+
+  //! maximum number of monomers moved by relaxConnectedGroup
+  enum{ MaxRelaxedGroupSize=256 };
+
+  //! all lattice sites packed as x+boxX*(y+boxY*z), the first nCandidateSites are candidates
+  std::vector<uint32_t> candidateSites;
+
+  //! number of sites in candidateSites that have not been found occupied
+  size_t nCandidateSites;
+
+  //! age of the molecules at the last call of drawFreeSite
+  uint64_t candidateSitesAge;
+
+  //! number of monomers at the last call of drawFreeSite
+  size_t candidateSitesNMonomers;
+
+  //! box size the candidate sites were set up for
+  VectorInt3 candidateSitesBox;
+
+  //! monomers of the group moved in relaxConnectedGroup
+  std::vector<uint32_t> relaxedGroup;
+
+  //! bondvectors of the bondset drawn from in drawFreeBondvector
+  std::vector<VectorInt3> bondsetVectors;
+
 };
 
 /**
@@ -127,8 +182,17 @@ void UpdaterAbstractCreate<IngredientsType>::cleanup(){
 /******************************************************************************/
 /**
  * @brief function to add a standalone monomer
+ *
+ * @details The position is chosen with equal probability among all free
+ * positions of the box. A few random positions are tried first, which is
+ * sufficient in dilute systems. If all of them are occupied, the position is
+ * drawn from the list of candidate sites, removing every site that is found
+ * occupied. The list is reset whenever the molecules changed in between, e.g.
+ * because the system was moved. Thus the function only fails if there is no
+ * free position left in the box.
+ *
  * @param type attribute tag of the new monomer
- * @return <b false> if position is not free, <b true> if move was applied
+ * @return <b false> if there is no free position, <b true> if move was applied
  */
 template<class IngredientsType>
 bool UpdaterAbstractCreate<IngredientsType>::addSingleMonomer(int32_t type){
@@ -137,17 +201,20 @@ bool UpdaterAbstractCreate<IngredientsType>::addSingleMonomer(int32_t type){
   addmove.init(ingredients);
   addmove.setTag(type);
 
-  int32_t counter(0);
-  while(counter<10000){
-    VectorInt3 newPosition((rng.r250_rand32() % (ingredients.getBoxX()-1)),
-				  (rng.r250_rand32() % (ingredients.getBoxY()-1)),
-				  (rng.r250_rand32() % (ingredients.getBoxZ()-1)));
+  for(int32_t counter=0;counter<NBlindAttempts;counter++){
+    VectorInt3 newPosition((rng.r250_rand32() % ingredients.getBoxX()),
+			  (rng.r250_rand32() % ingredients.getBoxY()),
+			  (rng.r250_rand32() % ingredients.getBoxZ()));
     addmove.setPosition(newPosition);
     if(addmove.check(ingredients)==true){
       addmove.apply(ingredients);
       return true;
     }
-    counter++;
+  }
+
+  if(drawFreeSite(addmove)){
+    addmove.apply(ingredients);
+    return true;
   }
   return false;
 }
@@ -155,6 +222,12 @@ bool UpdaterAbstractCreate<IngredientsType>::addSingleMonomer(int32_t type){
 /******************************************************************************/
 /**
  * @brief function to add a monomer to a parent monomer
+ *
+ * @details The bondvectors of length 2 are tried first, then all other
+ * bondvectors of the bondset. If none of them leads to a free position, the
+ * molecule of the parent is moved a bit, and every NLocalRelaxations attempts
+ * the whole system.
+ *
  * @param parent_id id of monomer to connect with
  * @param type attribute tag of the new monomer
  * @return <b false> if position is not free, <b true> if move was applied
@@ -166,14 +239,15 @@ bool UpdaterAbstractCreate<IngredientsType>::addMonomerToParent(uint32_t parent_
   addmove.init(ingredients);
   addmove.setTag(type);
 
+  VectorInt3 bondvectors[6];
   int32_t counter(0);
 
   while(counter<10000){
-    //try at most 30 random bondvectors to find a new monomer position
-    for(uint i=0;i<30;i++){
-      VectorInt3 bondvector(randomBondvector());
+    //try all bondvectors in random order to find a new monomer position
+    shuffledBondvectors(bondvectors);
+    for(uint i=0;i<6;i++){
       // set position of new monomer
-      addmove.setPosition(ingredients.getMolecules()[parent_id]+bondvector);
+      addmove.setPosition(ingredients.getMolecules()[parent_id]+bondvectors[i]);
 
       // check new position (excluded volume)
       if(addmove.check(ingredients)==true){
@@ -182,9 +256,16 @@ bool UpdaterAbstractCreate<IngredientsType>::addMonomerToParent(uint32_t parent_
 	return true;
       }
     }
-    // if no position matches, we need to move the system a bit
-    moveSystem(2);
+    // try the other bondvectors of the bondset in random order
+    if(drawFreeBondvector(parent_id,addmove)){
+      addmove.apply(ingredients);
+      ingredients.modifyMolecules().connect( parent_id, (ingredients.getMolecules().size()-1) );
+      return true;
+    }
+    // if no position matches, we need to move the molecule or the system a bit
     counter++;
+    if(counter%NLocalRelaxations==0) moveSystem(2);
+    else relaxConnectedGroup(parent_id,2);
   }
   return false;
 }
@@ -229,15 +310,15 @@ bool UpdaterAbstractCreate<IngredientsType>::addMonomerInsideConnectedPair(uint3
   addmove.init(ingredients);
   addmove.setTag(type);
 
+  VectorInt3 bondvectors[6];
   int32_t counter(0);
 
   while(counter<10000){
-    //try at most 30 random bondvectors to find a new monomer position
-    for(uint i=0;i<30;i++){
-      // get a random bondvector
-      VectorInt3 bondvector(randomBondvector());
+    //try all bondvectors in random order to find a new monomer position
+    shuffledBondvectors(bondvectors);
+    for(uint i=0;i<6;i++){
       // set position of new monomer
-      addmove.setPosition(ingredients.getMolecules()[indexA]+bondvector);
+      addmove.setPosition(ingredients.getMolecules()[indexA]+bondvectors[i]);
 
       // check new position (excluded volume, other features)
       if(addmove.check(ingredients)==true){
@@ -252,9 +333,10 @@ bool UpdaterAbstractCreate<IngredientsType>::addMonomerInsideConnectedPair(uint3
 	}
       }
     }
-    // if no position matches, we need to move the system a bit
-    moveSystem(2);
+    // if no position matches, we need to move the molecule or the system a bit
     counter++;
+    if(counter%NLocalRelaxations==0) moveSystem(2);
+    else relaxConnectedGroup(indexA,2);
   }
   return false;
 }
@@ -276,15 +358,15 @@ bool UpdaterAbstractCreate<IngredientsType>::addMonomerAtConnectedPair(uint32_t
   addmove.init(ingredients);
   addmove.setTag(type);
 
+  VectorInt3 bondvectors[6];
   int32_t counter(0);
 
   while(counter<10000){
-    //try at most 30 random bondvectors to find a new monomer position
-    for(uint i=0;i<30;i++){
-      // get a random bondvector
-      VectorInt3 bondvector(randomBondvector());
+    //try all bondvectors in random order to find a new monomer position
+    shuffledBondvectors(bondvectors);
+    for(uint i=0;i<6;i++){
       // set position of new monomer
-      addmove.setPosition(ingredients.getMolecules()[indexA]+bondvector);
+      addmove.setPosition(ingredients.getMolecules()[indexA]+bondvectors[i]);
 
       // check new position (excluded volume, other features)
       if(addmove.check(ingredients)==true){
@@ -298,9 +380,10 @@ bool UpdaterAbstractCreate<IngredientsType>::addMonomerAtConnectedPair(uint32_t
 	}
       }
     }
-    // if no position matches, we need to move the system a bit
-    moveSystem(2);
+    // if no position matches, we need to move the molecule or the system a bit
     counter++;
+    if(counter%NLocalRelaxations==0) moveSystem(2);
+    else relaxConnectedGroup(indexA,2);
   }
   return false;
 }
@@ -466,6 +549,9 @@ bool UpdaterAbstractCreate<IngredientsType>::addRing(uint32_t parent, int32_t ty
  */
 template<class IngredientsType>
 void UpdaterAbstractCreate<IngredientsType>::moveSystem(int32_t nsteps){
+  //moved monomers may have freed some of the sites found occupied before
+  nCandidateSites=candidateSites.size();
+
   MoveLocalSc move;
   for(int32_t n=0;n<nsteps;n++){
     for(int32_t m=0;m<ingredients.getMolecules().size();m++){
@@ -477,6 +563,49 @@ void UpdaterAbstractCreate<IngredientsType>::moveSystem(int32_t nsteps){
   }
 }
 
+/******************************************************************************/
+/**
+ * @brief function to move the monomers connected to a monomer
+ *
+ * @details Moves the monomers reached from index along the bonds, i.e. the
+ * molecule index belongs to, but at most MaxRelaxedGroupSize monomers
+ * closest to index along the bonds. This is much cheaper than moveSystem
+ * if a single molecule is built up in a dense system.
+ *
+ * @param index monomer the moved group is centered around
+ * @param nsteps number of MCS to move the group
+ */
+template<class IngredientsType>
+void UpdaterAbstractCreate<IngredientsType>::relaxConnectedGroup(uint32_t index, int32_t nsteps){
+  const typename IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+
+  //breadth first search along the bonds
+  relaxedGroup.clear();
+  relaxedGroup.push_back(index);
+  for(size_t n=0;n<relaxedGroup.size() && relaxedGroup.size()<MaxRelaxedGroupSize;n++){
+    for(size_t l=0;l<molecules.getNumLinks(relaxedGroup[n]);l++){
+      uint32_t neighbor(molecules.getNeighborIdx(relaxedGroup[n],l));
+      if(std::find(relaxedGroup.begin(),relaxedGroup.end(),neighbor)==relaxedGroup.end()){
+	relaxedGroup.push_back(neighbor);
+	if(relaxedGroup.size()==MaxRelaxedGroupSize) break;
+      }
+    }
+  }
+
+  //moved monomers may have freed some of the sites found occupied before
+  nCandidateSites=candidateSites.size();
+
+  MoveLocalSc move;
+  for(int32_t n=0;n<nsteps;n++){
+    for(size_t m=0;m<relaxedGroup.size();m++){
+      move.init(ingredients,relaxedGroup[rng.r250_rand32() % relaxedGroup.size()]);
+      if(move.check(ingredients)==true){
+	move.apply(ingredients);
+      }
+    }
+  }
+}
+
 /******************************************************************************/
 /**
  * @brief function to find groups of connected monomers and resort ingredients
@@ -544,4 +673,114 @@ VectorInt3 UpdaterAbstractCreate<IngredientsType>::randomBondvector(){
   }else
     throw std::runtime_error("UpdaterAbstractCreate::randomBondvector: bondvectors not part of the bondvectorset.");
 }
+
+/******************************************************************************/
+/**
+ * @brief writes the six bondvectors of length 2 in random order to bondvectors
+ * @param bondvectors array of at least six elements
+ */
+template<class IngredientsType>
+void UpdaterAbstractCreate<IngredientsType>::shuffledBondvectors(VectorInt3* bondvectors){
+  bondvectors[0].setAllCoordinates( 2, 0, 0);
+  bondvectors[1].setAllCoordinates( 0, 2, 0);
+  bondvectors[2].setAllCoordinates( 0, 0, 2);
+  bondvectors[3].setAllCoordinates(-2, 0, 0);
+  bondvectors[4].setAllCoordinates( 0,-2, 0);
+  bondvectors[5].setAllCoordinates( 0, 0,-2);
+
+  for(uint32_t i=0;i<6;i++){
+    //check if bondvector is part of the bondvectorset
+    if(!ingredients.getBondset().isValid(bondvectors[i]))
+      throw std::runtime_error("UpdaterAbstractCreate::shuffledBondvectors: bondvectors not part of the bondvectorset.");
+  }
+
+  //Fisher-Yates shuffle
+  for(uint32_t i=5;i>0;i--){
+    std::swap(bondvectors[i],bondvectors[rng.r250_rand32() % (i+1)]);
+  }
+}
+
+/******************************************************************************/
+/**
+ * @brief draws a free position bonded to parent_id
+ *
+ * @details Tries all bondvectors of the bondset in random order, which
+ * finds a position for the new monomer much more often than the six bondvectors
+ * of length 2 alone, if the parent is surrounded by other monomers.
+ *
+ * @param parent_id id of monomer to connect with
+ * @param addmove initialized move, its position is set to the free position
+ * @return <b false> if no bonded position is free
+ */
+template<class IngredientsType>
+bool UpdaterAbstractCreate<IngredientsType>::drawFreeBondvector(uint32_t parent_id, MoveAddMonomerSc<>& addmove){
+  bondsetVectors.clear();
+  for(std::map<int32_t,VectorInt3>::const_iterator it=ingredients.getBondset().begin();it!=ingredients.getBondset().end();++it){
+    bondsetVectors.push_back(it->second);
+  }
+
+  for(size_t nLeft=bondsetVectors.size();nLeft>0;nLeft--){
+    std::swap(bondsetVectors[nLeft-1],bondsetVectors[rng.r250_rand32() % nLeft]);
+    addmove.setPosition(ingredients.getMolecules()[parent_id]+bondsetVectors[nLeft-1]);
+    if(addmove.check(ingredients)==true) return true;
+  }
+  return false;
+}
+
+/******************************************************************************/
+/**
+ * @brief draws a free position from the candidate sites
+ *
+ * @details Draws sites with equal probability from the candidates and checks
+ * them with addmove. Every checked site is removed from the candidates, the
+ * free one as well because the monomer is going to be placed there. All sites
+ * become candidates again if monomers were moved by this updater, or if the
+ * age of the molecules changed, monomers were removed or the box changed
+ * since the last call. The list of all sites is only set up on the first
+ * call, dilute systems never need it.
+ *
+ * @param addmove initialized move, its position is set to the free site
+ * @return <b false> if no candidate site is free
+ */
+template<class IngredientsType>
+bool UpdaterAbstractCreate<IngredientsType>::drawFreeSite(MoveAddMonomerSc<>& addmove){
+  const uint32_t boxX(ingredients.getBoxX());
+  const uint32_t boxY(ingredients.getBoxY());
+  const uint32_t boxZ(ingredients.getBoxZ());
+  const VectorInt3 box(boxX,boxY,boxZ);
+
+  if(candidateSitesBox!=box || candidateSites.empty()){
+    if(uint64_t(boxX)*uint64_t(boxY)*uint64_t(boxZ)>uint64_t(std::numeric_limits<uint32_t>::max())){
+      std::stringstream errormessage;
+      errormessage<<"UpdaterAbstractCreate::drawFreeSite: box "<<box<<" has too many lattice sites.";
+      throw std::runtime_error(errormessage.str());
+    }
+    candidateSites.resize(size_t(boxX)*size_t(boxY)*size_t(boxZ));
+    for(size_t n=0;n<candidateSites.size();n++) candidateSites[n]=uint32_t(n);
+    candidateSitesBox=box;
+    nCandidateSites=candidateSites.size();
+  }
+  else if(candidateSitesAge!=ingredients.getMolecules().getAge() || candidateSitesNMonomers>ingredients.getMolecules().size()){
+    nCandidateSites=candidateSites.size();
+  }
+  candidateSitesAge=ingredients.getMolecules().getAge();
+  candidateSitesNMonomers=ingredients.getMolecules().size();
+
+  //the candidates are the first nCandidateSites entries, removed ones are
+  //swapped behind them
+  while(nCandidateSites>0){
+    size_t n(rng.r250_rand32() % nCandidateSites);
+    uint32_t site(candidateSites[n]);
+    std::swap(candidateSites[n],candidateSites[nCandidateSites-1]);
+    nCandidateSites--;
+
+    addmove.setPosition(VectorInt3(site%boxX,(site/boxX)%boxY,site/(boxX*boxY)));
+    if(addmove.check(ingredients)==true){
+      //the monomer is going to be placed at this site
+      candidateSitesNMonomers++;
+      return true;
+    }
+  }
+  return false;
+}
 #endif /* LEMONADE_UPDATER_ABSTRACT_CREATE_H */
@@ -0,0 +1,114 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UPDATER_UPDATERFUSEDSIMULATOR_H
+#define LEMONADE_UPDATER_UPDATERFUSEDSIMULATOR_H
+
+#include <chrono>
+#include <iostream>
+
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/updater/moves/FusedLocalScSweep.h>
+
+/**
+ * @file
+ *
+ * @class UpdaterFusedSimulator
+ *
+ * @brief Simulation updater for local moves on the simple cubic lattice using a fused sweep kernel
+ *
+ * @details Drop-in replacement for UpdaterSimpleSimulator<IngredientsType,MoveLocalSc>.
+ * The moves are performed by FusedLocalScSweep, which yields the same
+ * trajectory, but avoids the generic check and apply chains of the features
+ * if all features of the system are known to the kernel.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
+ */
+template<class IngredientsType>
+class UpdaterFusedSimulator:public AbstractUpdater
+{
+public:
+  /**
+   * @brief Standard Constructor initialized with ref to Ingredients and MCS per cycle
+   *
+   * @param ing a reference to the IngredientsType - mainly the system
+   * @param steps MCS per cycle to performed by execute()
+   */
+  UpdaterFusedSimulator(IngredientsType& ing,uint32_t steps)
+  :ingredients(ing),nsteps(steps),nAttemptedMoves(0),nAcceptedMoves(0)
+  {}
+
+  /**
+   * @brief Performs \a steps MCS and sets the age of the system.
+   *
+   * @return True if function are done.
+   */
+  bool execute()
+  {
+	std::chrono::steady_clock::time_point startTimer = std::chrono::steady_clock::now();
+	std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " passed time " << 0 <<std::endl;
+
+	for(uint32_t n=0;n<nsteps;n++)
+		nAcceptedMoves+=kernel.sweep(ingredients,ingredients.getMolecules().size());
+
+	ingredients.modifyMolecules().setAge(ingredients.modifyMolecules().getAge()+nsteps);
+	nAttemptedMoves+=uint64_t(nsteps)*ingredients.getMolecules().size();
+
+	double passedTime=std::chrono::duration<double>(std::chrono::steady_clock::now()-startTimer).count();
+	if(passedTime>0.0)
+		std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " with " << (((1.0*nsteps)*ingredients.getMolecules().size())/passedTime ) << " [attempted moves/s]" <<std::endl;
+	std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " passed time " << passedTime << " with " << nsteps << " MCS "<<std::endl;
+	return true;
+  }
+
+  virtual void initialize(){};
+
+  virtual void cleanup(){};
+
+  //! Number of moves attempted so far
+  virtual uint64_t getNAttemptedMoves() const {return nAttemptedMoves;}
+
+  //! Number of moves accepted so far
+  virtual uint64_t getNAcceptedMoves() const {return nAcceptedMoves;}
+
+private:
+  //! A reference to the IngredientsType - mainly the system
+  IngredientsType& ingredients;
+
+  //! Fused kernel performing the moves
+  FusedLocalScSweep<IngredientsType> kernel;
+
+  //! Number of mcs to be executed
+  uint32_t nsteps;
+
+  //! Move counters reported to the TaskManager telemetry
+  uint64_t nAttemptedMoves;
+  uint64_t nAcceptedMoves;
+};
+
+#endif /* LEMONADE_UPDATER_UPDATERFUSEDSIMULATOR_H */
@@ -0,0 +1,413 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UPDATER_UPDATERKINETICCONNECTION_H
+#define LEMONADE_UPDATER_UPDATERKINETICCONNECTION_H
+
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "extern/loki/Typelist.h"
+
+#include <LeMonADE/feature/FeatureBoltzmann.h>
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/FenwickTree.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+/**
+ * @file
+ *
+ * @class KineticConnectionCheck
+ *
+ * @brief Checks a move with all features of a typelist except FeatureBoltzmann
+ *
+ * @details The checks of the features are deterministic, only FeatureBoltzmann
+ * draws a random number to compare with the probability collected by the
+ * others. Leaving it out gives whether a move is possible at all and its
+ * acceptance probability move.getProbability(), without touching the random
+ * number sequence.
+ */
+template<class FeatureList> struct KineticConnectionCheck;
+
+template<> struct KineticConnectionCheck< ::Loki::NullType >
+{
+  template<class IngredientsType,class MoveType>
+  static bool check(IngredientsType&, MoveType&){return true;}
+};
+
+template<class Head, class Tail> struct KineticConnectionCheck< ::Loki::Typelist<Head,Tail> >
+{
+  template<class IngredientsType,class MoveType>
+  static bool check(IngredientsType& ingredients, MoveType& move){
+    return static_cast<Head&>(ingredients).checkMove(ingredients,move) && KineticConnectionCheck<Tail>::check(ingredients,move);
+  }
+};
+
+template<class Tail> struct KineticConnectionCheck< ::Loki::Typelist<FeatureBoltzmann,Tail> >
+{
+  template<class IngredientsType,class MoveType>
+  static bool check(IngredientsType& ingredients, MoveType& move){
+    return KineticConnectionCheck<Tail>::check(ingredients,move);
+  }
+};
+
+/**
+ * @class UpdaterKineticConnection
+ *
+ * @brief Rejection-free (n-fold way) connection updater for reactive systems
+ *
+ * @details Each MCS consists of one sweep of spatial moves (MoveType) and one
+ * time unit of reactions (ConnectionMoveType), as in UpdaterSimpleConnection.
+ * Instead of attempting connections at random monomers, which are almost
+ * always rejected in dilute systems, the updater keeps a catalogue of the
+ * currently possible reactions: for every monomer the shell positions
+ * (+-2,0,0),(0,+-2,0),(0,0,+-2) at which a partner is found and
+ * ConnectionMoveType passes the checks of all features except FeatureBoltzmann
+ * (see KineticConnectionCheck), e.g. the bond capacity of both monomers and
+ * the validity of the bond vector. The acceptance probability collected by
+ * these checks, which FeatureBoltzmann would compare to a random number, is
+ * used as a factor of the rate instead: each possible reaction happens with
+ * the rate \a reactionRate times its acceptance probability per MCS. The
+ * rates per monomer are kept in a FenwickTree, from which the next reaction
+ * is drawn with probability proportional to them. The waiting times are
+ * exponentially distributed with the total rate, and the reactions of one MCS
+ * are executed until the next waiting time exceeds the end of the MCS. Building
+ * the catalogue does not use random numbers.
+ *
+ * The catalogue is updated incrementally: after a spatial move of a reactive
+ * monomer or after a reaction only the monomers found via getIdFromLattice on
+ * the shell positions around the affected sites are checked again, i.e. the
+ * acceptance probabilities may only depend on this neighborhood. The
+ * catalogue is rebuilt at the beginning of every execute(), such that changes
+ * by other updaters between two calls are taken into account.
+ *
+ * The default rate 1/6 corresponds to every unreacted monomer probing one of
+ * its 6 shell positions per MCS.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information, must contain FeatureReactiveBonds
+ * @tparam MoveType name of the specialized move, must provide getIndex()
+ * @tparam ConnectionMoveType name of the specialized connection move, e.g. MoveConnectScReactive
+ */
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+class UpdaterKineticConnection:public AbstractUpdater
+{
+public:
+
+  /**
+   * @param ing a reference to the IngredientsType - mainly the system
+   * @param steps MCS per cycle to performed by execute()
+   * @param rate rate of every possible reaction per MCS
+   */
+  UpdaterKineticConnection(IngredientsType& ing,uint32_t steps=1,double rate=1.0/6.0);
+
+  //! runs steps MCS of spatial moves and reactions
+  virtual bool execute();
+
+  //! builds the catalogue of possible reactions
+  virtual void initialize();
+
+  virtual void cleanup(){}
+
+  //! checks all unreacted monomers for possible reactions
+  void rebuildCatalogue();
+
+  //! number of currently possible reactions
+  uint32_t getNPossibleReactions() const {return catalogue.getTotal();}
+
+  //! number of currently possible reactions of monomer index
+  uint32_t getNPossibleReactions(uint32_t index) const {return catalogue.get(index);}
+
+  //! sum of the rates of all currently possible reactions
+  double getTotalRate() const {return reactionRate*rateFactors.getTotal();}
+
+  //! sum of the acceptance probabilities of the possible reactions of monomer index
+  double getRateFactor(uint32_t index) const {return rateFactors.get(index);}
+
+  //! number of reactions executed by this updater
+  uint64_t getNReactions() const {return nReactions;}
+
+  //! number of attempted spatial moves
+  virtual uint64_t getNAttemptedMoves() const {return nAttemptedMoves;}
+
+  //! number of accepted spatial moves
+  virtual uint64_t getNAcceptedMoves() const {return nAcceptedMoves;}
+
+protected:
+
+  //! A reference to the IngredientsType - mainly the system
+  IngredientsType& ingredients;
+
+  //! Specialized move to be used for the movement of the monomers
+  MoveType move;
+
+  //! Specialized move to be used for the connection between reactive monomers
+  ConnectionMoveType connectionMove;
+
+  //! random number generator (seed set in main program)
+  RandomNumberGenerators rng;
+
+private:
+
+  //! checks the shell positions of monomer index for possible reactions
+  void refreshMonomer(uint32_t index);
+
+  //! refreshes all monomers on the shell positions around pos
+  void refreshNeighborhood(const VectorInt3& pos);
+
+  //! draws one reaction from the catalogue and applies it
+  void executeReaction();
+
+  //! Number of mcs to be executed
+  uint32_t nsteps;
+
+  //! rate of every possible reaction per MCS
+  double reactionRate;
+
+  //! number of possible reactions per monomer
+  FenwickTree<uint32_t> catalogue;
+
+  //! sum of the acceptance probabilities of the possible reactions per monomer
+  FenwickTree<double> rateFactors;
+
+  //! acceptance probability of the reaction of monomer n towards shellPositions[k] at 6*n+k, zero if not possible
+  std::vector<double> reactionProbabilities;
+
+  //! the 6 bond partner positions of the connection moves
+  VectorInt3 shellPositions[6];
+
+  //! number of reactions executed
+  uint64_t nReactions;
+
+  //! spatial move counters reported to the TaskManager telemetry
+  uint64_t nAttemptedMoves;
+  uint64_t nAcceptedMoves;
+};
+
+/*****************************************************************************/
+//members of class UpdaterKineticConnection
+/*****************************************************************************/
+
+/**
+ * @throw std::runtime_error if the rate is not positive
+ */
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::UpdaterKineticConnection(IngredientsType& ing,
+												 uint32_t steps,
+												 double rate)
+:ingredients(ing),nsteps(steps),reactionRate(rate),nReactions(0),nAttemptedMoves(0),nAcceptedMoves(0)
+{
+  if(!(reactionRate>0.0))
+  {
+    std::stringstream errormessage;
+    errormessage<<"UpdaterKineticConnection: reaction rate must be positive, got "<<reactionRate;
+    throw std::runtime_error(errormessage.str());
+  }
+
+  shellPositions[0]=VectorInt3( 2, 0, 0);
+  shellPositions[1]=VectorInt3(-2, 0, 0);
+  shellPositions[2]=VectorInt3( 0, 2, 0);
+  shellPositions[3]=VectorInt3( 0,-2, 0);
+  shellPositions[4]=VectorInt3( 0, 0, 2);
+  shellPositions[5]=VectorInt3( 0, 0,-2);
+}
+
+/**
+ * @details The spatial moves are the same as in UpdaterSimpleConnection. The
+ * reactions of one MCS are drawn with exponential waiting times at the total
+ * rate. Since the waiting times are memoryless, the time left at the end of
+ * the MCS is discarded without bias.
+ */
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+bool UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::execute()
+{
+  rebuildCatalogue();
+
+  for(uint32_t n=0;n<nsteps;n++)
+  {
+    //spatial moves
+    for(size_t m=0;m<ingredients.getMolecules().size();m++)
+    {
+      move.init(ingredients);
+      if(move.check(ingredients)==true)
+      {
+        const uint32_t index=move.getIndex();
+        const VectorInt3 oldPosition(ingredients.getMolecules()[index]);
+        move.apply(ingredients);
+        nAcceptedMoves++;
+
+        //non-reactive monomers are no bond partners, their moves do not change the catalogue
+        if(ingredients.getMolecules()[index].isReactive())
+        {
+          refreshNeighborhood(oldPosition);
+          refreshNeighborhood(ingredients.getMolecules()[index]);
+          refreshMonomer(index);
+        }
+      }
+    }
+    nAttemptedMoves+=ingredients.getMolecules().size();
+
+    //reactions during one time unit
+    double timeLeft=1.0;
+    while(catalogue.getTotal()>0)
+    {
+      double u=rng.r250_drand();
+      while(!(u>0.0)) u=rng.r250_drand();
+
+      timeLeft+=std::log(u)/getTotalRate();
+      if(timeLeft<0.0) break;
+
+      executeReaction();
+    }
+
+    //increase time
+    ingredients.modifyMolecules().setAge(ingredients.getMolecules().getAge()+1);
+  }
+
+  return true;
+}
+
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+void UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::initialize()
+{
+  rebuildCatalogue();
+}
+
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+void UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::rebuildCatalogue()
+{
+  const size_t nMonomers=ingredients.getMolecules().size();
+  catalogue.assign(nMonomers);
+  rateFactors.assign(nMonomers);
+  reactionProbabilities.assign(6*nMonomers,0.0);
+
+  const std::vector<uint32_t>& unreacted=ingredients.getUnreactiveMonomers();
+  for(size_t n=0;n<unreacted.size();n++)
+    refreshMonomer(unreacted[n]);
+}
+
+/**
+ * @details A reaction is possible if a partner is found at the shell position
+ * and all features except FeatureBoltzmann accept the connection move. Its
+ * acceptance probability must be positive.
+ */
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+void UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::refreshMonomer(uint32_t index)
+{
+  uint32_t nPossible=0;
+  double sumProbabilities=0.0;
+
+  for(uint32_t k=0;k<6;k++)
+  {
+    double probability=0.0;
+    if(ingredients.checkCapableFormingBonds(index))
+    {
+      connectionMove.init(ingredients,index,shellPositions[k]);
+      if(connectionMove.getPartner()!=std::numeric_limits<uint32_t>::max() &&
+         KineticConnectionCheck<typename IngredientsType::feature_list>::check(ingredients,connectionMove))
+        probability=connectionMove.getProbability();
+    }
+
+    reactionProbabilities[6*index+k]=probability;
+    if(probability>0.0)
+    {
+      nPossible++;
+      sumProbabilities+=probability;
+    }
+  }
+
+  catalogue.set(index,nPossible);
+  rateFactors.set(index,sumProbabilities);
+}
+
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+void UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::refreshNeighborhood(const VectorInt3& pos)
+{
+  for(uint32_t k=0;k<6;k++)
+  {
+    uint32_t neighbor(ingredients.getIdFromLattice(pos+shellPositions[k]));
+    if(neighbor!=std::numeric_limits<uint32_t>::max())
+      refreshMonomer(neighbor);
+  }
+}
+
+/**
+ * @details The monomer is drawn proportional to the sum of the acceptance
+ * probabilities of its reactions, then one of its reactions proportional to
+ * its acceptance probability. The reaction is applied without the Metropolis
+ * test of FeatureBoltzmann, which is already part of its rate.
+ *
+ * @throw std::runtime_error if the drawn reaction is not possible, i.e. the catalogue is out of date
+ */
+template<class IngredientsType,class MoveType,class ConnectionMoveType>
+void UpdaterKineticConnection<IngredientsType,MoveType,ConnectionMoveType>::executeReaction()
+{
+  //the incrementally updated sum may exceed the sum of the entries by rounding
+  uint32_t index;
+  do{
+    index=rateFactors.find(rng.r250_drand()*rateFactors.getTotal());
+  }while(index>=rateFactors.size());
+
+  double x=rng.r250_drand()*rateFactors.get(index);
+  uint32_t k=0;
+  for(uint32_t l=0;l<6;l++)
+  {
+    const double probability=reactionProbabilities[6*index+l];
+    if(probability>0.0)
+    {
+      k=l;
+      if(x<probability) break;
+      x-=probability;
+    }
+  }
+
+  connectionMove.init(ingredients,index,shellPositions[k]);
+  if(connectionMove.getPartner()==std::numeric_limits<uint32_t>::max() ||
+     !KineticConnectionCheck<typename IngredientsType::feature_list>::check(ingredients,connectionMove))
+  {
+    std::stringstream errormessage;
+    errormessage<<"UpdaterKineticConnection::executeReaction(): catalogue entry of monomer "<<index
+		<<" in direction "<<shellPositions[k]<<" is not a possible reaction";
+    throw std::runtime_error(errormessage.str());
+  }
+
+  const uint32_t partner=connectionMove.getPartner();
+  connectionMove.apply(ingredients);
+  nReactions++;
+
+  //the monomers around both reaction partners may have lost them as possible partners
+  refreshNeighborhood(ingredients.getMolecules()[index]);
+  refreshNeighborhood(ingredients.getMolecules()[partner]);
+  refreshMonomer(index);
+  refreshMonomer(partner);
+}
+
+#endif /* LEMONADE_UPDATER_UPDATERKINETICCONNECTION_H */
@@ -2,8 +2,12 @@
 #define UpdaterLipidsCreator_H
 
 #include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
 #include <LeMonADE/utility/Vector3D.h>
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 
 /**
  * @file
@@ -24,6 +28,15 @@
  * \b Nano_particles: Tag 7.<br>
  * \b Facially_Amphiphlic_Copolymers: backbone monomers Tag 7 and side group monomers Tag 8.<br>
  * 
+ * By default (RANDOM_INSERTION) every lipid, object and solvent monomer is placed
+ * at random positions until a free one is found. With setGenerationMode(SLOT_FILLING)
+ * the lipids are distributed over a shuffled list of the grid slots of each leaflet. Solvent
+ * and objects are still inserted at random positions while these are mostly vacant, but
+ * once they are not, the vacant positions are found by scanning the lattice, one xy-layer
+ * per thread if compiled with OpenMP, and taken in random order. This gives the same
+ * distribution as the random insertion, but never repeats a check and throws instead of
+ * looping forever if the box is too full.
+ * 
  * @tparam IngredientsType
  *
  * @param ingredients_ The system, holding an empty simulation box for system setup.
@@ -88,6 +101,15 @@ public:
     //!Function to get upperleaflet lipids.     
     int32_t getUpperleafletLipids(){return leafletcounter;}
 
+    //!Ways of finding the positions of lipids, objects and solvent.
+    enum GenerationMode{RANDOM_INSERTION, SLOT_FILLING};
+
+    //!Set how positions are found, default is RANDOM_INSERTION.
+    void setGenerationMode(GenerationMode mode){generationMode=mode;}
+
+    //!Get how positions are found.
+    GenerationMode getGenerationMode() const {return generationMode;}
+
 protected:
     //!Ingredients holding the simulation box
     IngredientsType& ingredients;
@@ -110,6 +132,32 @@ protected:
     int32_t n1,n2,shorterlipid_length,longerlipid_length,shorterlipid_number,longerlipid_number;
     int32_t NanoType,NanoNumber,polylength,numpoly;
     double n_fraction;
+
+    GenerationMode generationMode;
+
+    //!Shuffled (x,y) slots of the lower[0] and upper[1] leaflet not used yet in SLOT_FILLING mode.
+    std::vector<VectorInt3> leafletSlots[2];
+
+    //!True once leafletSlots[leaflet] was filled, such that an exhausted leaflet is not set up again.
+    bool leafletSlotsSetUp[2];
+
+    //!Fills leafletSlots[leaflet] with all grid slots of the leaflet in random order.
+    void setupLeafletSlots(int32_t leaflet);
+
+    //!Collects all positions where shape fits with layers z in [zBegin,zEnd) as tiles.
+    void collectVacantPositions(const std::vector<VectorInt3>& shape, int32_t zBegin, int32_t zEnd, std::vector<VectorInt3>& positions);
+
+    //!True if the 8 lattice sites of a monomer at position are empty. Only reads the lattice.
+    bool isVacantCube(const VectorInt3& position) const;
+
+    //!Brings the positions in random order using rand().
+    void shufflePositions(std::vector<VectorInt3>& positions);
+
+    //!True if solvent may be placed at position in the lower[0] or upper[1] half of solvent.
+    bool isSolventRegion(const VectorInt3& position, int32_t half) const;
+
+    //!Solvent creation for SLOT_FILLING mode.
+    void solventSlotCreator(MoveAddMonomerSc<int32_t>& move, size_t numsol);
 };
 
 /**
@@ -129,8 +177,11 @@ UpdaterLipidsCreator<IngredientsType>::UpdaterLipidsCreator(IngredientsType& ing
     NanoType(NanoType_),
     NanoNumber(NanoNum_),
     polylength(polylength_),
-    numpoly(numpoly_)
+    numpoly(numpoly_),
+    generationMode(RANDOM_INSERTION)
 {
+    leafletSlotsSetUp[0]=false;
+    leafletSlotsSetUp[1]=false;
 
     upperleafletBondvecs.push_back(ingredients.getBondset().getBondVector(21));
     upperleafletBondvecs.push_back(ingredients.getBondset().getBondVector(33));
@@ -297,6 +348,22 @@ VectorInt3 UpdaterLipidsCreator<IngredientsType>::vacantLipidPosFinder(MoveAddMo
       
     int32_t height_lipids=shorterlipid_length+2;
 
+    if(generationMode==SLOT_FILLING){
+        //take the slots of the leaflet in random order, the slots do not overlap
+        if(!leafletSlotsSetUp[leaflet])
+            setupLeafletSlots(leaflet);
+        do{
+            if(leafletSlots[leaflet].empty())
+                throw std::runtime_error("UpdaterLipidsCreator: no vacant lipid slot left in leaflet, too many lipids");
+            x=leafletSlots[leaflet].back().getX();
+            y=leafletSlots[leaflet].back().getY();
+            leafletSlots[leaflet].pop_back();
+            z=(ingredients.getBoxZ()/2)+height_lipids*grow;
+            position.setAllCoordinates(x,y,z);
+            move.setPosition(position);
+        }while(move.check(ingredients)==false);
+    }
+    else{
     //do-while loop performs till a vacant position is found
       
        do{ 
@@ -329,6 +396,7 @@ VectorInt3 UpdaterLipidsCreator<IngredientsType>::vacantLipidPosFinder(MoveAddMo
          position.setAllCoordinates(x,y,z);
          move.setPosition(position);
          }while(move.check(ingredients)==false);
+    }
         
      //Change z position if longer lipids have to be grown.
         
@@ -342,6 +410,32 @@ VectorInt3 UpdaterLipidsCreator<IngredientsType>::vacantLipidPosFinder(MoveAddMo
     }
 }	
 
+/**
+* @brief Fills the slots of a leaflet in random order for SLOT_FILLING mode.
+*
+* @details The slots are the same grid positions vacantLipidPosFinder draws from
+* in RANDOM_INSERTION mode. The slots are set up only once per leaflet.
+*
+* @param leaflet upper(1) or lower(0) leaflet.
+*/
+
+template<class IngredientsType>
+void UpdaterLipidsCreator<IngredientsType>::setupLeafletSlots(int32_t leaflet){
+    int32_t nSlotsX=(Bilayer_Half)?(3*(ingredients.getBoxX())/16):((ingredients.getBoxX())/4);
+    int32_t slotDistanceY=(ringHead)?6:4;
+    int32_t nSlotsY=(ingredients.getBoxY())/slotDistanceY;
+
+    std::vector<VectorInt3>& slots=leafletSlots[leaflet];
+    slots.clear();
+    for(int32_t i=0;i<nSlotsX;i++)
+        for(int32_t j=0;j<nSlotsY;j++)
+            slots.push_back(VectorInt3(4*i,slotDistanceY*j,0));
+
+    for(size_t n=slots.size();n>1;n--)
+        std::swap(slots[n-1],slots[rand()%n]);
+    leafletSlotsSetUp[leaflet]=true;
+}
+
 /**
 * @brief Creates a single lipid on given any intial position, total monomers present in lipid and leaflet(upper or lower). 
 *
@@ -504,6 +598,40 @@ VectorInt3 UpdaterLipidsCreator<IngredientsType>::vacantShapeFinder(MoveAddMonom
     VectorInt3 position;
 
     bool occupied;
+
+    //If random positions are occupied, draw from all vacant positions.
+    if(generationMode==SLOT_FILLING){
+        for(int32_t attempt=0;attempt<100;attempt++){
+            position.setAllCoordinates(rand()%(ingredients.getBoxX()),rand()%(ingredients.getBoxY()),rand()%(ingredients.getBoxZ()));
+            occupied=false;
+            for(int32_t monNum=0;monNum<shape.size();monNum++){
+                move.init(ingredients);
+                move.setPosition(position+shape[monNum]);
+                if(move.check(ingredients)==false) {occupied= true; break;}
+            }
+            if(!occupied) return position;
+        }
+
+        //the scan only reads the lattice, the drawn position is checked with all features
+        std::vector<VectorInt3> positions;
+        collectVacantPositions(shape,0,ingredients.getBoxZ(),positions);
+        while(!positions.empty()){
+            size_t n=rand()%positions.size();
+            occupied=false;
+            for(int32_t monNum=0;monNum<shape.size();monNum++){
+                move.init(ingredients);
+                move.setPosition(positions[n]+shape[monNum]);
+                if(move.check(ingredients)==false) {occupied= true; break;}
+            }
+            if(!occupied){
+                move.init(ingredients);
+                return positions[n];
+            }
+            positions[n]=positions.back();
+            positions.pop_back();
+        }
+        throw std::runtime_error("Could not find vacant position for object; too many objects");
+    }
             
       //Do till an unoccupied position is found.
      
@@ -738,6 +866,13 @@ void UpdaterLipidsCreator<IngredientsType>::solventCreator(MoveAddMonomerSc<int3
     
     int32_t initIndex=total_monomers_added-1;
 
+    if(generationMode==SLOT_FILLING){
+        solventSlotCreator(move,numsol);
+        if(ingredients.getMolecules().size()>size_t(total_monomers_added))
+            ingredients.setCompressedOutputIndices(initIndex+1,ingredients.getMolecules().size()-1);
+        return;
+    }
+
     size_t i=0;
     int32_t Midplane=ingredients.getBoxZ()/2;
     
@@ -776,5 +911,155 @@ void UpdaterLipidsCreator<IngredientsType>::solventCreator(MoveAddMonomerSc<int3
         ingredients.setCompressedOutputIndices(initIndex+1,lastMonomerAdded); 
         }
 };
+
+/**
+* @brief Collects all positions where a shape fits in the layers [zBegin,zEnd).
+*
+* @details Every xy-layer is a tile scanned independently (in parallel if compiled
+* with OpenMP). The scan only reads the occupancy of the lattice (see isVacantCube),
+* it does not check moves, which may draw shared random numbers, e.g. in
+* FeatureBoltzmann. The callers check the move of a position before applying it.
+* The positions are ordered by z, y and x independent of the number of threads.
+*
+* @param shape relative positions of the monomers of the object, (0,0,0) for solvent.
+* @param zBegin first layer.
+* @param zEnd layer after the last one.
+* @param positions vector the positions are written to.
+*/
+
+template<class IngredientsType>
+void UpdaterLipidsCreator<IngredientsType>::collectVacantPositions(const std::vector<VectorInt3>& shape, int32_t zBegin, int32_t zEnd, std::vector<VectorInt3>& positions)
+{
+    positions.clear();
+    if(zEnd<=zBegin) return;
+
+    const int32_t boxX=ingredients.getBoxX();
+    const int32_t boxY=ingredients.getBoxY();
+    const int32_t nTiles=zEnd-zBegin;
+    std::vector< std::vector<VectorInt3> > tilePositions(nTiles);
+
+    #pragma omp parallel for schedule(dynamic,1)
+    for(int32_t tile=0;tile<nTiles;tile++){
+        for(int32_t y=0;y<boxY;y++)
+            for(int32_t x=0;x<boxX;x++){
+                VectorInt3 position(x,y,zBegin+tile);
+                bool vacant=true;
+                for(size_t monNum=0;monNum<shape.size()&&vacant;monNum++)
+                    vacant=isVacantCube(position+shape[monNum]);
+                if(vacant) tilePositions[tile].push_back(position);
+            }
+    }
+
+    for(int32_t tile=0;tile<nTiles;tile++)
+        positions.insert(positions.end(),tilePositions[tile].begin(),tilePositions[tile].end());
+}
+
+template<class IngredientsType>
+bool UpdaterLipidsCreator<IngredientsType>::isVacantCube(const VectorInt3& position) const
+{
+    for(int32_t i=0;i<8;i++)
+        if(ingredients.getLatticeEntry(position.getX()+(i&1),position.getY()+((i>>1)&1),position.getZ()+((i>>2)&1)))
+            return false;
+    return true;
+}
+
+/**
+* @brief Brings the positions in random order using rand(), like the positions drawn in RANDOM_INSERTION mode.
+*/
+
+template<class IngredientsType>
+void UpdaterLipidsCreator<IngredientsType>::shufflePositions(std::vector<VectorInt3>& positions)
+{
+    for(size_t n=positions.size();n>1;n--)
+        std::swap(positions[n-1],positions[rand()%n]);
+}
+
+/**
+* @brief Region solvent is created in, see solventCreator.
+*
+* @details The lower half of solvent is kept below Midplane-10, the upper half
+* above Midplane+10. In the case of bilayer half, the region without lipids
+* (x>=3/4 of the box) is open to both halves.
+*
+* @param position lattice position of the solvent monomer.
+* @param half lower(0) or upper(1) half of solvent.
+*/
+
+template<class IngredientsType>
+bool UpdaterLipidsCreator<IngredientsType>::isSolventRegion(const VectorInt3& position, int32_t half) const
+{
+    int32_t Midplane=ingredients.getBoxZ()/2;
+    if(Bilayer_Half && position.getX()>=int32_t(3*ingredients.getBoxX()/4))
+        return true;
+    if(half==0)
+        return position.getZ()<Midplane-10;
+    else
+        return position.getZ()>=Midplane+10 && position.getZ()<2*Midplane;
+}
+
+/**
+* @brief Creates numsol solvent monomers in SLOT_FILLING mode.
+*
+* @details Solvent is inserted at random vacant positions like in RANDOM_INSERTION
+* mode, as long as the attempts at occupied positions cost less than scanning
+* the lattice. Then all vacant positions are collected and visited in random order, adding a
+* solvent monomer wherever the position is still vacant. Both give the same
+* distribution, but the second one ends once no vacant position is left.
+*
+* @param move MoveAddMonomerSc type move used create the solvent particles.
+* @param numsol number of solvent monomers to create.
+*/
+
+template<class IngredientsType>
+void UpdaterLipidsCreator<IngredientsType>::solventSlotCreator(MoveAddMonomerSc<int32_t>& move, size_t numsol)
+{
+    //the lower half first, then the upper one
+    size_t target[2]={numsol/2,numsol-numsol/2};
+    int32_t Midplane=ingredients.getBoxZ()/2;
+    std::vector<VectorInt3> positions;
+
+    for(int32_t half=0;half<2;half++){
+        //layers of the solvent region of this half
+        int32_t zBegin=(half==0)?0:Midplane+10;
+        int32_t zEnd=(half==0)?Midplane-10:2*Midplane;
+        if(Bilayer_Half){zBegin=0; zEnd=ingredients.getBoxZ();}
+
+        //random insertion is stopped once it checked as many occupied positions
+        //as the scan of the region would check
+        size_t failedAttempts=0;
+        const size_t maxFailedAttempts=size_t(ingredients.getBoxX())*size_t(ingredients.getBoxY())*size_t(std::max(zEnd-zBegin,0));
+
+        size_t added=0;
+        while(added<target[half] && failedAttempts<maxFailedAttempts){
+            VectorInt3 position(rand()%(ingredients.getBoxX()),rand()%(ingredients.getBoxY()),zBegin+rand()%(zEnd-zBegin));
+            if(!isSolventRegion(position,half)) continue;
+            move.init(ingredients);
+            move.setTag(5);
+            move.setPosition(position);
+            if(move.check(ingredients)==true){
+                move.apply(ingredients);
+                added++;
+            }
+            else failedAttempts++;
+        }
+        if(added==target[half]) continue;
+
+        //the random positions are mostly occupied, visit all vacant ones
+        collectVacantPositions(std::vector<VectorInt3>(1,VectorInt3(0,0,0)),zBegin,zEnd,positions);
+        shufflePositions(positions);
+        for(size_t n=0;n<positions.size()&&added<target[half];n++){
+            if(!isSolventRegion(positions[n],half)) continue;
+            move.init(ingredients);
+            move.setTag(5);
+            move.setPosition(positions[n]);
+            if(move.check(ingredients)==true){
+                move.apply(ingredients);
+                added++;
+            }
+        }
+        if(added<target[half])
+            throw std::runtime_error("UpdaterLipidsCreator: no vacant position left for solvent, mean lattice occupancy too high");
+    }
+}
 	
 #endif	 
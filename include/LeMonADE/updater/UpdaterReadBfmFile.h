@@ -43,6 +43,11 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @class UpdaterReadBfmFile
  *
  * @brief Updater that reads configurations from bfm-file. On each execute call it reads the next configuration.
+ *
+ * @details Every frame is followed by a synchronization of the system. For
+ * systems with a lattice, FeatureLatticeBase::setIncrementalSynchronization(true)
+ * avoids refilling the complete lattice for every frame, if no moves are
+ * applied in between (e.g. in analysis programs).
  **/
 template <class IngredientsType>
 class UpdaterReadBfmFile: public AbstractUpdater
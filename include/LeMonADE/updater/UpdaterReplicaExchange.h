@@ -0,0 +1,280 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UPDATER_UPDATERREPLICAEXCHANGE_H
+#define LEMONADE_UPDATER_UPDATERREPLICAEXCHANGE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/utility/ReplicaEnsemble.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+/**
+ * @file
+ *
+ * @class UpdaterReplicaExchange
+ *
+ * @brief Parallel tempering over the contact energies of FeatureNNInteractionSc
+ *
+ * @details The updater keeps one replica of the system per temperature in a
+ * ReplicaEnsemble. The acceptance probabilities of every replica are
+ * calculated at its temperature (FeatureNNInteractionSc::setNNInteractionTemperature).
+ * One execute() runs \a nExchanges rounds. In every round, all replicas
+ * are simulated concurrently for \a mcsPerExchange MCS, then swaps between
+ * neighboring temperatures are attempted with the Metropolis criterion
+ * min(1,exp((1/T_i-1/T_j)(E_i-E_j))), alternating between the even and the odd
+ * pairs. The energies E are the running contact energies of the feature, so no
+ * recalculation is needed. An accepted swap exchanges the temperatures, i.e.
+ * the lookup tables, of the two replicas instead of their configurations.
+ *
+ * getIngredientsAtTemperature() gives the replica currently at a temperature.
+ * If an output file name is given, cleanup() writes one file per temperature
+ * (e.g. energy.dat -> energy_T0000.dat, energy_T0001.dat,...) with the time series of the energy
+ * and the replica at this temperature, and the acceptance rates of the swaps.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information, must contain FeatureNNInteractionSc
+ * @tparam MoveType name of the specialized move.
+ */
+template<class IngredientsType,class MoveType>
+class UpdaterReplicaExchange:public AbstractUpdater
+{
+public:
+
+  /**
+   * @param ingredients system copied into every replica
+   * @param temperatures_ temperatures of the replicas, in ascending order
+   * @param mcsPerExchange MCS between two attempts to swap temperatures
+   * @param nExchanges_ number of swap rounds per execute()
+   * @param outputFile base name of the per temperature output files (no output if empty)
+   */
+  UpdaterReplicaExchange(const IngredientsType& ingredients,
+			 const std::vector<double>& temperatures_,
+			 uint32_t mcsPerExchange,
+			 uint32_t nExchanges_,
+			 const std::string& outputFile="");
+
+  //! runs nExchanges rounds of simulation and swap attempts
+  virtual bool execute();
+
+  //! synchronizes all replicas
+  virtual void initialize();
+
+  //! writes the per temperature output
+  virtual void cleanup();
+
+  //! number of temperatures
+  size_t getNTemperatures() const {return temperatures.size();}
+
+  //! temperature k
+  double getTemperature(size_t k) const {return temperatures.at(k);}
+
+  //! index of the replica at temperature k
+  size_t getReplicaAtTemperature(size_t k) const {return replicaAtTemperature.at(k);}
+
+  //! system currently at temperature k
+  const IngredientsType& getIngredientsAtTemperature(size_t k) const
+  {return ensemble.getReplica(replicaAtTemperature.at(k));}
+
+  //! the ensemble of replicas, indexed by replica
+  ReplicaEnsemble<IngredientsType,MoveType>& getEnsemble(){return ensemble;}
+
+  //! number of local moves attempted in all replicas, the swaps are counted by getAcceptanceRate()
+  virtual uint64_t getNAttemptedMoves() const {return ensemble.getNAttemptedMoves();}
+
+  //! number of local moves accepted in all replicas
+  virtual uint64_t getNAcceptedMoves() const {return ensemble.getNAcceptedMoves();}
+
+  //! fraction of accepted swaps between temperatures k and k+1
+  double getAcceptanceRate(size_t k) const {
+    return (attemptedSwaps.at(k)>0) ? double(acceptedSwaps[k])/double(attemptedSwaps[k]) : 0.0;
+  }
+
+private:
+
+  //! attempts swaps between the pairs (k,k+1) with k%2==parity
+  void attemptSwaps(size_t parity);
+
+  //! stores energies and replicas at the current age
+  void recordTimeSeries();
+
+  ReplicaEnsemble<IngredientsType,MoveType> ensemble;
+
+  std::vector<double> temperatures;
+
+  //! replica index at each temperature
+  std::vector<size_t> replicaAtTemperature;
+
+  uint32_t nExchanges;
+
+  //! number of rounds done so far, alternates the pairs
+  uint64_t nRounds;
+
+  std::vector<uint64_t> attemptedSwaps;
+  std::vector<uint64_t> acceptedSwaps;
+
+  std::string outputFile;
+
+  //! per temperature columns mcs, energy, replica
+  std::vector<std::vector<std::vector<double> > > timeSeries;
+
+  RandomNumberGenerators rng;
+};
+
+/*****************************************************************************/
+//members of class UpdaterReplicaExchange
+/*****************************************************************************/
+
+/**
+ * @throw std::runtime_error if there are no temperatures or they are not positive and ascending
+ */
+template<class IngredientsType,class MoveType>
+UpdaterReplicaExchange<IngredientsType,MoveType>::UpdaterReplicaExchange(const IngredientsType& ingredients,
+									 const std::vector<double>& temperatures_,
+									 uint32_t mcsPerExchange,
+									 uint32_t nExchanges_,
+									 const std::string& outputFile_)
+:ensemble(mcsPerExchange)
+,temperatures(temperatures_)
+,nExchanges(nExchanges_)
+,nRounds(0)
+,outputFile(outputFile_)
+{
+  if(temperatures.empty())
+    throw std::runtime_error("UpdaterReplicaExchange: no temperatures given");
+
+  for(size_t k=0;k<temperatures.size();k++)
+  {
+    if(!(temperatures[k]>0.0) || (k>0 && !(temperatures[k]>temperatures[k-1])))
+    {
+      std::stringstream errormessage;
+      errormessage<<"UpdaterReplicaExchange: temperatures must be positive and ascending, got "
+		  <<temperatures[k]<<" at position "<<k;
+      throw std::runtime_error(errormessage.str());
+    }
+  }
+  for(size_t k=0;k<temperatures.size();k++)
+  {
+    size_t replica=ensemble.addReplica(ingredients);
+    ensemble.getReplica(replica).setNNInteractionTemperature(temperatures[k]);
+    replicaAtTemperature.push_back(replica);
+  }
+
+  attemptedSwaps.resize(temperatures.size()-1,0);
+  acceptedSwaps.resize(temperatures.size()-1,0);
+  timeSeries.resize(temperatures.size(),std::vector<std::vector<double> >(3));
+}
+
+template<class IngredientsType,class MoveType>
+void UpdaterReplicaExchange<IngredientsType,MoveType>::initialize()
+{
+  ensemble.initialize();
+}
+
+template<class IngredientsType,class MoveType>
+bool UpdaterReplicaExchange<IngredientsType,MoveType>::execute()
+{
+  for(uint32_t n=0;n<nExchanges;n++)
+  {
+    ensemble.run(1);
+    attemptSwaps(nRounds%2);
+    nRounds++;
+    recordTimeSeries();
+  }
+
+  return true;
+}
+
+/**
+ * @details The random numbers for the swaps are drawn from the stream of the
+ * calling thread, not from the streams of the replicas.
+ */
+template<class IngredientsType,class MoveType>
+void UpdaterReplicaExchange<IngredientsType,MoveType>::attemptSwaps(size_t parity)
+{
+  for(size_t k=parity;k+1<temperatures.size();k+=2)
+  {
+    IngredientsType& lower=ensemble.getReplica(replicaAtTemperature[k]);
+    IngredientsType& upper=ensemble.getReplica(replicaAtTemperature[k+1]);
+
+    const double delta=(1.0/temperatures[k]-1.0/temperatures[k+1])
+		      *(lower.getNNInteractionEnergy()-upper.getNNInteractionEnergy());
+
+    attemptedSwaps[k]++;
+    if(delta>=0.0 || rng.r250_drand()<std::exp(delta))
+    {
+      lower.swapNNInteractionTables(upper);
+      std::swap(replicaAtTemperature[k],replicaAtTemperature[k+1]);
+      acceptedSwaps[k]++;
+    }
+  }
+}
+
+template<class IngredientsType,class MoveType>
+void UpdaterReplicaExchange<IngredientsType,MoveType>::recordTimeSeries()
+{
+  for(size_t k=0;k<temperatures.size();k++)
+  {
+    const IngredientsType& replica=ensemble.getReplica(replicaAtTemperature[k]);
+    timeSeries[k][0].push_back(double(replica.getMolecules().getAge()));
+    timeSeries[k][1].push_back(replica.getNNInteractionEnergy());
+    timeSeries[k][2].push_back(double(replicaAtTemperature[k]));
+  }
+}
+
+template<class IngredientsType,class MoveType>
+void UpdaterReplicaExchange<IngredientsType,MoveType>::cleanup()
+{
+  ensemble.cleanup();
+
+  if(outputFile.empty()) return;
+
+  for(size_t k=0;k<temperatures.size();k++)
+  {
+    std::stringstream comment;
+    comment<<"Created by UpdaterReplicaExchange\n";
+    comment<<"temperature "<<temperatures[k]<<" (index "<<k<<" of "<<temperatures.size()<<")\n";
+    if(k>0) comment<<"acceptance rate of swaps with temperature "<<temperatures[k-1]<<": "<<getAcceptanceRate(k-1)<<"\n";
+    if(k+1<temperatures.size()) comment<<"acceptance rate of swaps with temperature "<<temperatures[k+1]<<": "<<getAcceptanceRate(k)<<"\n";
+    comment<<"format: mcs\t contact energy\t replica\n";
+
+    ResultFormattingTools::writeResultFile(ReplicaEnsemble<IngredientsType,MoveType>::replicaFilename(outputFile,k,"_T"),
+					   getIngredientsAtTemperature(k),
+					   timeSeries[k],
+					   comment.str());
+  }
+}
+
+#endif /* LEMONADE_UPDATER_UPDATERREPLICAEXCHANGE_H */
@@ -29,11 +29,22 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #define LEMONADE_UPDATER_UPDATERSIMPLECONNECTION_H
 
 
+#include <chrono>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "extern/loki/Typelist.h"
+#include "extern/loki/TypeManip.h"
+
 #include <LeMonADE/updater/moves/MoveLocalBase.h>
 #include <LeMonADE/utility/RandomNumberGenerators.h>
 #include<LeMonADE/updater/AbstractUpdater.h>
 #include <LeMonADE/updater/moves/MoveConnectSc.h>
 
+class FeatureReactiveBonds;
+
 /**
  * @file
  *
@@ -44,6 +55,26 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @details It takes the type of move as template argument MoveType
  * and the number of mcs to be executed as argument for the constructor
  *
+ * By default every mcs consists of a sweep of N spatial moves followed by a
+ * sweep of N connection moves, N being the number of monomers. The schedule
+ * of the connection moves can be changed:
+ * * setConnectionSweepSize(SWEEP_REACTIVE_SITES) makes the connection sweep
+ *   as long as the number of unreacted monomers at the beginning of the mcs.
+ *   This is meant for connection moves drawing among the unreacted monomers
+ *   only, e.g. MoveConnectScReactive. Once no unreacted monomer is left, no
+ *   connection move is attempted anymore.
+ * * setInterleaveRatio(r) with r>0 attempts one connection move after every
+ *   r spatial moves, instead of running the two sweeps one after the other.
+ *   Connection attempts not done in the spatial sweep follow after it.
+ * * setConversionTarget(c) stops the connection moves as soon as the
+ *   conversion of FeatureReactiveBonds reaches c.
+ * * setReportPeriod(p) prints the conversion and the spatial and connection
+ *   moves per second every p mcs.
+ *
+ * SWEEP_REACTIVE_SITES, the conversion target and the conversion in the
+ * report need FeatureReactiveBonds. Without it, e.g. with MoveConnectSc and
+ * FeatureConnectionSc, only the default sweep size is available.
+ *
  * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
  * @tparam MoveType name of the specialized move.
  */
@@ -60,7 +91,50 @@ public:
    * @param steps MCS per cycle to performed by execute()
    */
   UpdaterSimpleConnection(IngredientsType& ing,uint32_t steps = 1 )
-  :ingredients(ing),nsteps(steps){}
+  :ingredients(ing),nsteps(steps),sweepSize(SWEEP_ALL_MONOMERS),interleaveRatio(0)
+  ,conversionTarget(std::numeric_limits<double>::max()),reportPeriod(0)
+  ,nAttemptedMoves(0),nAcceptedMoves(0),nAttemptedConnections(0),nAcceptedConnections(0)
+  ,periodMcs(0),periodMoves(0),periodConnections(0),periodSeconds(0.0){}
+
+  //! determines the number of connection attempts per mcs
+  enum ConnectionSweepSize{
+	SWEEP_ALL_MONOMERS=0,	//!< one attempt per monomer
+	SWEEP_REACTIVE_SITES=1	//!< one attempt per unreacted monomer
+  };
+
+  //! sets how the number of connection attempts per mcs is determined
+  void setConnectionSweepSize(ConnectionSweepSize size){
+    if(size==SWEEP_REACTIVE_SITES) requireReactiveBonds("setConnectionSweepSize(SWEEP_REACTIVE_SITES)");
+    sweepSize=size;
+  }
+  ConnectionSweepSize getConnectionSweepSize() const {return sweepSize;}
+
+  //! attempts one connection move after every ratio spatial moves. 0 runs the two sweeps one after the other
+  void setInterleaveRatio(uint32_t ratio){interleaveRatio=ratio;}
+  uint32_t getInterleaveRatio() const {return interleaveRatio;}
+
+  //! no connection moves are attempted once the conversion reached target
+  void setConversionTarget(double target){
+    requireReactiveBonds("setConversionTarget()");
+    conversionTarget=target;
+  }
+  double getConversionTarget() const {return conversionTarget;}
+
+  //! prints conversion and throughput every period mcs, 0 switches the report off
+  void setReportPeriod(uint32_t period){reportPeriod=period;}
+  uint32_t getReportPeriod() const {return reportPeriod;}
+
+  //! number of attempted spatial moves
+  virtual uint64_t getNAttemptedMoves() const {return nAttemptedMoves;}
+
+  //! number of accepted spatial moves
+  virtual uint64_t getNAcceptedMoves() const {return nAcceptedMoves;}
+
+  //! number of attempted connection moves
+  uint64_t getNAttemptedConnections() const {return nAttemptedConnections;}
+
+  //! number of applied connection moves
+  uint64_t getNAcceptedConnections() const {return nAcceptedConnections;}
 
   
  
@@ -109,9 +183,56 @@ protected:
   
 private:
 
+  //! 1 if the system contains FeatureReactiveBonds, which provides the conversion and the unreacted monomers
+  enum{HAS_REACTIVE_BONDS=(::Loki::TL::IndexOf<typename IngredientsType::feature_list,FeatureReactiveBonds>::value!=-1)};
+
+  //! throws if the system does not contain FeatureReactiveBonds
+  void requireReactiveBonds(const char* setting) const {
+    if(!HAS_REACTIVE_BONDS)
+      throw std::runtime_error(std::string("UpdaterSimpleConnection::")+setting+" requires FeatureReactiveBonds");
+  }
+
+  //! conversion and number of unreacted monomers of FeatureReactiveBonds, not used without it
+  static double getConversion(const IngredientsType& ing, ::Loki::Int2Type<1>){return ing.getConversion();}
+  static double getConversion(const IngredientsType&, ::Loki::Int2Type<0>){return 0.0;}
+  static size_t getNUnreactedMonomers(const IngredientsType& ing, ::Loki::Int2Type<1>){return ing.getNUnreactedMonomers();}
+  static size_t getNUnreactedMonomers(const IngredientsType&, ::Loki::Int2Type<0>){return 0;}
+
+  double getConversion() const {return getConversion(ingredients,::Loki::Int2Type<HAS_REACTIVE_BONDS>());}
+  size_t getNUnreactedMonomers() const {return getNUnreactedMonomers(ingredients,::Loki::Int2Type<HAS_REACTIVE_BONDS>());}
+
+  //! attempts a connection move, returns false if no further connection move should be attempted in this mcs
+  bool attemptConnection();
+
+  //! true if connection moves are to be attempted, i.e. the conversion target is not set or not reached
+  bool isConnecting() const {
+    return conversionTarget==std::numeric_limits<double>::max() || getConversion()<conversionTarget;
+  }
+
+  //! prints conversion and throughput of the last report period
+  void report();
+
   //! Number of mcs to be executed
   uint32_t nsteps;
 
+  //! scheduler settings, see the setters
+  ConnectionSweepSize sweepSize;
+  uint32_t interleaveRatio;
+  double conversionTarget;
+  uint32_t reportPeriod;
+
+  //! move counters
+  uint64_t nAttemptedMoves;
+  uint64_t nAcceptedMoves;
+  uint64_t nAttemptedConnections;
+  uint64_t nAcceptedConnections;
+
+  //! mcs, attempted spatial and connection moves and wall time in the current report period
+  uint32_t periodMcs;
+  uint64_t periodMoves;
+  uint64_t periodConnections;
+  double periodSeconds;
+
 };
 /**Implementation of the member functions
  * @brief 
@@ -119,39 +240,90 @@ private:
 template<class IngredientsType,class MoveType, class ConnectionMoveType>
 bool UpdaterSimpleConnection<IngredientsType,MoveType,ConnectionMoveType>::execute()
 {
-  
-// 	time_t startTimer = time(NULL); //in seconds
-// 	std::cout<<"connection mcs "<<ingredients.getMolecules().getAge() << " passed time " << ((difftime(time(NULL), startTimer)) ) <<std::endl;
-
 	for(int n=0;n<nsteps;n++)
 	{
-      // spacial move
-      for(size_t m=0;m<ingredients.getMolecules().size();m++)
+      std::chrono::steady_clock::time_point startTimer=std::chrono::steady_clock::now();
+      const uint64_t startMoves=nAttemptedMoves;
+      const uint64_t startConnections=nAttemptedConnections;
+
+      const size_t nMoves=ingredients.getMolecules().size();
+      size_t nConnections=0;
+      if(isConnecting())
+        nConnections=(sweepSize==SWEEP_REACTIVE_SITES) ? getNUnreactedMonomers() : nMoves;
+
+      // spacial move, interleaved with connection moves if requested
+      size_t nConnectionsDone=0;
+      for(size_t m=0;m<nMoves;m++)
       {
         move.init(ingredients);
         if(move.check(ingredients)==true)
         {
             move.apply(ingredients);
+            nAcceptedMoves++;
         }
-      }
-      //connection move
-      for(size_t m=0;m<ingredients.getMolecules().size();m++)
-      {
-        connectionMove.init(ingredients);
-        if ( connectionMove.check(ingredients) )
+        if(interleaveRatio!=0 && nConnectionsDone<nConnections && (m+1)%interleaveRatio==0)
         {
-            connectionMove.apply(ingredients);
+          nConnectionsDone++;
+          if(!attemptConnection()) nConnections=nConnectionsDone;
         }
       }
+      nAttemptedMoves+=nMoves;
+
+      //remaining connection moves
+      for(;nConnectionsDone<nConnections;nConnectionsDone++)
+      {
+        if(!attemptConnection()) break;
+      }
+
       //increase time 
       ingredients.modifyMolecules().setAge(ingredients.getMolecules().getAge()+1);
+
+      if(reportPeriod!=0)
+      {
+        periodMcs++;
+        periodMoves+=nAttemptedMoves-startMoves;
+        periodConnections+=nAttemptedConnections-startConnections;
+        periodSeconds+=std::chrono::duration<double>(std::chrono::steady_clock::now()-startTimer).count();
+        if(periodMcs>=reportPeriod) report();
+      }
     }
-// 	std::cout <<"Conversion at "<<ingredients.getMolecules().getAge() << " is " << getConversion()  << std::endl;
-// 	std::cout<<"connection mcs "<<ingredients.getMolecules().getAge() << " with " << (((1.0*nsteps)*ingredients.getMolecules().size())/(difftime(time(NULL), startTimer)) ) << " [attempted connections/s]" <<std::endl;
-// 	std::cout<<"connection mcs "<<ingredients.getMolecules().getAge() << " passed time " << ((difftime(time(NULL), startTimer)) ) << " with " << nsteps << "connection MCS "<<std::endl;
 	return false;
 };
 
+/**
+ * @details The connection phase ends, if the conversion target is reached or
+ * no unreacted monomer is left while the sweep is sized by the reactive sites.
+ */
+template<class IngredientsType,class MoveType, class ConnectionMoveType>
+bool UpdaterSimpleConnection<IngredientsType,MoveType,ConnectionMoveType>::attemptConnection()
+{
+	nAttemptedConnections++;
+	connectionMove.init(ingredients);
+	if ( connectionMove.check(ingredients) )
+	{
+		connectionMove.apply(ingredients);
+		nAcceptedConnections++;
+		if(!isConnecting()) return false;
+		if(sweepSize==SWEEP_REACTIVE_SITES && getNUnreactedMonomers()==0) return false;
+	}
+	return true;
+}
+
+template<class IngredientsType,class MoveType, class ConnectionMoveType>
+void UpdaterSimpleConnection<IngredientsType,MoveType,ConnectionMoveType>::report()
+{
+	//guard against a zero elapsed time on coarse clocks
+	const double seconds=(periodSeconds>0.0) ? periodSeconds : 1e-9;
+	std::cout<<"connection mcs "<<ingredients.getMolecules().getAge();
+	if(HAS_REACTIVE_BONDS) std::cout<<" conversion "<<getConversion();
+	std::cout<<" with "<<(double(periodMoves)/seconds)<<" [attempted moves/s] and "
+		 <<(double(periodConnections)/seconds)<<" [attempted connections/s]"<<std::endl;
+	periodMcs=0;
+	periodMoves=0;
+	periodConnections=0;
+	periodSeconds=0.0;
+}
+
 template<class IngredientsType,class MoveType, class ConnectionMoveType>
 void  UpdaterSimpleConnection<IngredientsType,MoveType,ConnectionMoveType>::initialize()
 {
@@ -28,6 +28,9 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef LEMONADE_UPDATER_UPDATERSIMPLESIMULATOR_H
 #define LEMONADE_UPDATER_UPDATERSIMPLESIMULATOR_H
 
+#include <chrono>
+#include <iostream>
+
 #include <LeMonADE/updater/AbstractUpdater.h>
 #include <LeMonADE/updater/moves/MoveLocalBase.h>
 
@@ -56,7 +59,7 @@ public:
    * @param steps MCS per cycle to performed by execute()
    */
   UpdaterSimpleSimulator(IngredientsType& ing,uint32_t steps)
-  :ingredients(ing),nsteps(steps)
+  :ingredients(ing),nsteps(steps),printProgress(true),nAttemptedMoves(0),nAcceptedMoves(0)
   {}
 
   /**
@@ -70,8 +73,9 @@ public:
    */
   bool execute()
   {
-	time_t startTimer = time(NULL); //in seconds
-	std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " passed time " << ((difftime(time(NULL), startTimer)) ) <<std::endl;
+	std::chrono::steady_clock::time_point startTimer = std::chrono::steady_clock::now();
+	if(printProgress)
+	  std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " passed time " << 0 <<std::endl;
 
 
     for(uint32_t n=0;n<nsteps;n++){
@@ -83,15 +87,22 @@ public:
 		if(move.check(ingredients)==true)
 		{
 			move.apply(ingredients);
+			nAcceptedMoves++;
 		}
 	}
 
     }
 
     ingredients.modifyMolecules().setAge(ingredients.modifyMolecules().getAge()+nsteps);
-
-    std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " with " << (((1.0*nsteps)*ingredients.getMolecules().size())/(difftime(time(NULL), startTimer)) ) << " [attempted moves/s]" <<std::endl;
-    std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " passed time " << ((difftime(time(NULL), startTimer)) ) << " with " << nsteps << " MCS "<<std::endl;
+    nAttemptedMoves+=uint64_t(nsteps)*ingredients.getMolecules().size();
+
+    if(printProgress)
+    {
+      double passedTime=std::chrono::duration<double>(std::chrono::steady_clock::now()-startTimer).count();
+      if(passedTime>0.0)
+        std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " with " << (((1.0*nsteps)*ingredients.getMolecules().size())/passedTime ) << " [attempted moves/s]" <<std::endl;
+      std::cout<<"mcs "<<ingredients.getMolecules().getAge() << " passed time " << passedTime << " with " << nsteps << " MCS "<<std::endl;
+    }
 
     return true;
   }
@@ -114,6 +125,15 @@ public:
    **/
   virtual void cleanup(){};
 
+  //! Number of moves attempted so far
+  virtual uint64_t getNAttemptedMoves() const {return nAttemptedMoves;}
+
+  //! Number of moves accepted so far
+  virtual uint64_t getNAcceptedMoves() const {return nAcceptedMoves;}
+
+  //! Switches the mcs and simulation speed output of execute() on or off (default: on)
+  void setPrintProgress(bool print){printProgress=print;}
+
 private:
   //! A reference to the IngredientsType - mainly the system
   IngredientsType& ingredients;
@@ -123,6 +143,13 @@ private:
 
   //! Number of mcs to be executed
   uint32_t nsteps;
+
+  //! true if execute() prints the mcs and the simulation speed
+  bool printProgress;
+
+  //! Move counters reported to the TaskManager telemetry
+  uint64_t nAttemptedMoves;
+  uint64_t nAcceptedMoves;
 };
 
 #endif
@@ -0,0 +1,329 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UPDATER_UPDATERSPATIALREORDER_H
+#define LEMONADE_UPDATER_UPDATERSPATIALREORDER_H
+
+#include <stdint.h>
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/SpaceFillingCurve.h>
+
+/**
+ * @file
+ *
+ * @class UpdaterSpatialReorder
+ *
+ * @brief Simulation updater working on monomers stored in the order of a space filling curve
+ *
+ * @details Works like UpdaterSimpleSimulator, but before the moves are
+ * performed the monomers are permuted in memory such that their storage order
+ * follows a Hilbert (or Morton) curve through their folded lattice positions.
+ * Monomers with neighboring indices are then close on the lattice. Since the
+ * monomers diffuse, the order is recalculated every \a reorderPeriod MCS.
+ *
+ * The locality pays off with the sequential sweep mode, in which every MCS
+ * attempts one move per monomer in storage order instead of drawing random
+ * indices. This fulfills balance, but not detailed balance. In the default
+ * random sweep mode the dynamics is the same as with UpdaterSimpleSimulator.
+ *
+ * The storage order is kept between the calls of execute() and the order is
+ * recalculated every \a reorderPeriod MCS, counted over all calls. The
+ * original order is restored at the end of every \a outputPeriod -th call of
+ * execute(), in cleanup() and by restoreOriginalOrder(). With the default
+ * output period of 1, analyzers, file output and groups of monomer indices
+ * (e.g. MonomerGroup) outside of this updater always see the original indices.
+ * If the analyzers run only every k-th cycle of the TaskManager, an output
+ * period of k saves the permutations in between. While the monomers are
+ * reordered, the permutation table translates between storage indices and
+ * original indices.
+ * After every permutation the ingredients are synchronized, which rebuilds
+ * all index dependent information of the features (e.g. ids on the lattice).
+ * Features keeping index dependent state that is not rebuilt by synchronize()
+ * must not be used with this updater.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
+ * @tparam MoveType name of the specialized move.
+ */
+template<class IngredientsType,class MoveType>
+class UpdaterSpatialReorder:public AbstractUpdater
+{
+public:
+
+  //! space filling curves the monomers can be ordered along
+  enum CurveType{HILBERT_CURVE,MORTON_CURVE};
+
+  //! order in which moves are attempted during one MCS
+  enum SweepType{RANDOM_SWEEP,SEQUENTIAL_SWEEP};
+
+  /**
+   * @brief Constructor initialized with ref to Ingredients, MCS per cycle and reorder period
+   *
+   * @param ing a reference to the IngredientsType - mainly the system
+   * @param steps MCS per cycle to performed by execute()
+   * @param period the storage order is recalculated every period MCS
+   */
+  UpdaterSpatialReorder(IngredientsType& ing,uint32_t steps,uint32_t period=100)
+  :ingredients(ing),nsteps(steps),reorderPeriod(period>0?period:1),outputPeriod(1)
+  ,curve(HILBERT_CURVE),sweep(RANDOM_SWEEP),reordered(false),nExecutions(0),mcsSinceReorder(0)
+  ,nAttemptedMoves(0),nAcceptedMoves(0)
+  {}
+
+  virtual void initialize(){};
+
+  bool execute();
+
+  //! restores the original order
+  virtual void cleanup(){restoreOriginalOrder();};
+
+  void setCurveType(CurveType type){curve=type;}
+  CurveType getCurveType() const {return curve;}
+
+  void setSweepType(SweepType type){sweep=type;}
+  SweepType getSweepType() const {return sweep;}
+
+  void setReorderPeriod(uint32_t period){reorderPeriod=(period>0?period:1);}
+  uint32_t getReorderPeriod() const {return reorderPeriod;}
+
+  //! the original order is restored after every period-th execute(), never if period is 0
+  void setOutputPeriod(uint32_t period){outputPeriod=period;}
+  uint32_t getOutputPeriod() const {return outputPeriod;}
+
+  //! true if the monomers are currently stored in the order of the curve
+  bool isReordered() const {return reordered;}
+
+  //! original index of the monomer currently stored at index storageIdx
+  uint32_t getOriginalIndex(uint32_t storageIdx) const {return originalIndex.at(storageIdx);}
+
+  //! index the monomer with original index originalIdx is currently stored at
+  uint32_t getStorageIndex(uint32_t originalIdx) const {return storageIndex.at(originalIdx);}
+
+  //! calculates the order of the current storage along the space filling curve
+  void calculateOrder(std::vector<uint32_t>& order) const;
+
+  //! brings the monomers back into their original order, if they are reordered
+  void restoreOriginalOrder();
+
+  //! Number of moves attempted so far
+  virtual uint64_t getNAttemptedMoves() const {return nAttemptedMoves;}
+
+  //! Number of moves accepted so far
+  virtual uint64_t getNAcceptedMoves() const {return nAcceptedMoves;}
+
+private:
+
+  //! recalculates the order and permutes the storage, updating the permutation table
+  void reorder();
+
+  //! key of the folded lattice position of the monomer stored at index n
+  uint64_t curveKey(uint32_t n, uint32_t bits) const;
+
+  //! A reference to the IngredientsType - mainly the system
+  IngredientsType& ingredients;
+
+  //! Specialized move to be used
+  MoveType move;
+
+  //! Number of mcs to be executed
+  uint32_t nsteps;
+
+  //! Number of mcs after which the order is recalculated
+  uint32_t reorderPeriod;
+
+  //! Number of calls of execute() after which the original order is restored
+  uint32_t outputPeriod;
+
+  CurveType curve;
+  SweepType sweep;
+
+  //! true if the storage differs from the original order
+  bool reordered;
+
+  //! Number of calls of execute()
+  uint64_t nExecutions;
+
+  //! Number of mcs performed since the last reorder()
+  uint32_t mcsSinceReorder;
+
+  //! originalIndex[storage index] = original index
+  std::vector<uint32_t> originalIndex;
+
+  //! storageIndex[original index] = storage index
+  std::vector<uint32_t> storageIndex;
+
+  //! Move counters reported to the TaskManager telemetry
+  uint64_t nAttemptedMoves;
+  uint64_t nAcceptedMoves;
+};
+
+/**
+ * @details The storage is reordered before the first move and every
+ * reorderPeriod MCS after that. Monomers added since the last call are
+ * appended to the storage with their original index.
+ *
+ * @throw <std::runtime_error> if monomers were removed while the storage was reordered
+ * @return True if function are done.
+ */
+template<class IngredientsType,class MoveType>
+bool UpdaterSpatialReorder<IngredientsType,MoveType>::execute()
+{
+	const uint32_t nMonomers=ingredients.getMolecules().size();
+	if(nMonomers<originalIndex.size())
+		throw std::runtime_error("UpdaterSpatialReorder::execute(): monomers were removed from the reordered system");
+	for(uint32_t n=originalIndex.size();n<nMonomers;n++)
+	{
+		originalIndex.push_back(n);
+		storageIndex.push_back(n);
+	}
+
+	for(uint32_t n=0;n<nsteps;n++)
+	{
+		if(!reordered || mcsSinceReorder>=reorderPeriod) reorder();
+
+		if(sweep==SEQUENTIAL_SWEEP)
+		{
+			for(uint32_t m=0;m<nMonomers;m++)
+			{
+				move.init(ingredients,m);
+				if(move.check(ingredients)==true)
+				{
+					move.apply(ingredients);
+					nAcceptedMoves++;
+				}
+			}
+		}
+		else
+		{
+			for(uint32_t m=0;m<nMonomers;m++)
+			{
+				move.init(ingredients);
+				if(move.check(ingredients)==true)
+				{
+					move.apply(ingredients);
+					nAcceptedMoves++;
+				}
+			}
+		}
+		mcsSinceReorder++;
+	}
+	nAttemptedMoves+=uint64_t(nsteps)*nMonomers;
+
+	ingredients.modifyMolecules().setAge(ingredients.modifyMolecules().getAge()+nsteps);
+
+	nExecutions++;
+	if(outputPeriod>0 && nExecutions%outputPeriod==0) restoreOriginalOrder();
+
+	return true;
+}
+
+/**
+ * @details The positions are folded into the box and the curve is laid
+ * through the smallest cube of edge 2^bits containing the box. Monomers with
+ * equal keys keep their relative order.
+ *
+ * @param order on return, order[i] is the current storage index of the monomer to be stored at i
+ */
+template<class IngredientsType,class MoveType>
+void UpdaterSpatialReorder<IngredientsType,MoveType>::calculateOrder(std::vector<uint32_t>& order) const
+{
+	const uint32_t nMonomers=ingredients.getMolecules().size();
+
+	uint32_t maxBox=std::max(ingredients.getBoxX(),std::max(ingredients.getBoxY(),ingredients.getBoxZ()));
+	uint32_t bits=0;
+	while(bits<21 && (uint32_t(1)<<bits)<maxBox) bits++;
+
+	std::vector<std::pair<uint64_t,uint32_t> > keys(nMonomers);
+	for(uint32_t n=0;n<nMonomers;n++)
+		keys[n]=std::make_pair(curveKey(n,bits),n);
+	std::sort(keys.begin(),keys.end());
+
+	order.resize(nMonomers);
+	for(uint32_t n=0;n<nMonomers;n++)
+		order[n]=keys[n].second;
+}
+
+template<class IngredientsType,class MoveType>
+uint64_t UpdaterSpatialReorder<IngredientsType,MoveType>::curveKey(uint32_t n, uint32_t bits) const
+{
+	const int32_t boxX=ingredients.getBoxX();
+	const int32_t boxY=ingredients.getBoxY();
+	const int32_t boxZ=ingredients.getBoxZ();
+	const typename IngredientsType::molecules_type::vertex_type& monomer=ingredients.getMolecules().getVertexUnchecked(n);
+
+	uint32_t x=uint32_t(((int32_t(monomer.getX())%boxX)+boxX)%boxX);
+	uint32_t y=uint32_t(((int32_t(monomer.getY())%boxY)+boxY)%boxY);
+	uint32_t z=uint32_t(((int32_t(monomer.getZ())%boxZ)+boxZ)%boxZ);
+
+	if(curve==MORTON_CURVE) return mortonKey3D(x,y,z);
+	return hilbertKey3D(x,y,z,bits);
+}
+
+template<class IngredientsType,class MoveType>
+void UpdaterSpatialReorder<IngredientsType,MoveType>::reorder()
+{
+	std::vector<uint32_t> order;
+	calculateOrder(order);
+
+	//the monomer now stored at order[i] moves to i
+	std::vector<uint32_t> newOriginalIndex(order.size());
+	for(uint32_t i=0;i<order.size();i++)
+	{
+		newOriginalIndex[i]=originalIndex[order[i]];
+		storageIndex[newOriginalIndex[i]]=i;
+	}
+	originalIndex.swap(newOriginalIndex);
+
+	ingredients.modifyMolecules().permute(order);
+	ingredients.synchronize(ingredients);
+	reordered=true;
+	mcsSinceReorder=0;
+}
+
+/**
+ * @details Does nothing if the monomers are in their original order. The next
+ * execute() starts with a new reorder().
+ */
+template<class IngredientsType,class MoveType>
+void UpdaterSpatialReorder<IngredientsType,MoveType>::restoreOriginalOrder()
+{
+	if(!reordered) return;
+
+	//the monomer with original index i is currently stored at storageIndex[i]
+	ingredients.modifyMolecules().permute(storageIndex);
+	ingredients.synchronize(ingredients);
+
+	for(uint32_t n=0;n<storageIndex.size();n++)
+		originalIndex[n]=storageIndex[n]=n;
+	reordered=false;
+}
+
+#endif /* LEMONADE_UPDATER_UPDATERSPATIALREORDER_H */
@@ -0,0 +1,360 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UPDATER_MOVES_FUSEDLOCALSCSWEEP_H
+#define LEMONADE_UPDATER_MOVES_FUSEDLOCALSCSWEEP_H
+
+#include <stdint.h>
+#include <stdexcept>
+
+#include "extern/loki/Typelist.h"
+
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureBox.h>
+#include <LeMonADE/feature/FeatureBondset.h>
+#include <LeMonADE/feature/FeatureFixedMonomers.h>
+#include <LeMonADE/feature/FeatureLattice.h>
+#include <LeMonADE/feature/FeatureLatticePowerOfTwo.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Compile time fused sweep of MoveLocalSc for fixed feature sets
+ * */
+/*****************************************************************************/
+
+/**
+ * @class FusedLocalScStage
+ * @brief Describes what a Feature contributes to the check and apply of a MoveLocalSc
+ *
+ * @details Features without specialization are not SUPPORTED, and a feature
+ * list containing them is simulated with the generic move. Features which do
+ * not overload checkMove() and applyMove() for local moves are SUPPORTED
+ * without any stage and are pruned from the fused kernel.
+ */
+template<class FeatureType> struct FusedLocalScStage
+{
+	enum{SUPPORTED=0, CHECKS_MOVABLE=0, CHECKS_BOX=0, CHECKS_BONDS=0, CHECKS_VOLUME=0};
+};
+
+//! Feature without influence on local moves
+struct FusedLocalScNoStage
+{
+	enum{SUPPORTED=1, CHECKS_MOVABLE=0, CHECKS_BOX=0, CHECKS_BONDS=0, CHECKS_VOLUME=0};
+};
+
+template<> struct FusedLocalScStage<FeatureMoleculesIO>:public FusedLocalScNoStage{};
+template<class TagType> struct FusedLocalScStage<FeatureAttributes<TagType> >:public FusedLocalScNoStage{};
+template<class ValueType> struct FusedLocalScStage<FeatureLattice<ValueType> >:public FusedLocalScNoStage{};
+template<class ValueType> struct FusedLocalScStage<FeatureLatticePowerOfTwo<ValueType> >:public FusedLocalScNoStage{};
+
+//! the walls of non-periodic directions, skipped at run time if all directions are periodic
+template<> struct FusedLocalScStage<FeatureBox>
+{
+	enum{SUPPORTED=1, CHECKS_MOVABLE=0, CHECKS_BOX=1, CHECKS_BONDS=0, CHECKS_VOLUME=0};
+};
+
+template<> struct FusedLocalScStage<FeatureFixedMonomers>
+{
+	enum{SUPPORTED=1, CHECKS_MOVABLE=1, CHECKS_BOX=0, CHECKS_BONDS=0, CHECKS_VOLUME=0};
+};
+
+template<> struct FusedLocalScStage<FeatureBondset<FastBondset> >
+{
+	enum{SUPPORTED=1, CHECKS_MOVABLE=0, CHECKS_BOX=0, CHECKS_BONDS=1, CHECKS_VOLUME=0};
+};
+
+template<class LatticeClassType> struct FusedLocalScStage<FeatureExcludedVolumeSc<LatticeClassType> >
+{
+	enum{SUPPORTED=1, CHECKS_MOVABLE=0, CHECKS_BOX=0, CHECKS_BONDS=0, CHECKS_VOLUME=1};
+};
+
+/**
+ * @class FusedLocalScStages
+ * @brief Combines the FusedLocalScStage of all features in a typelist
+ */
+template<class FeatureList> struct FusedLocalScStages;
+
+template<> struct FusedLocalScStages< ::Loki::NullType >
+{
+	enum{SUPPORTED=1, CHECKS_MOVABLE=0, CHECKS_BOX=0, CHECKS_BONDS=0, CHECKS_VOLUME=0};
+};
+
+template<class Head, class Tail> struct FusedLocalScStages< ::Loki::Typelist<Head,Tail> >
+{
+	enum{
+		SUPPORTED=(FusedLocalScStage<Head>::SUPPORTED && FusedLocalScStages<Tail>::SUPPORTED),
+		CHECKS_MOVABLE=(FusedLocalScStage<Head>::CHECKS_MOVABLE || FusedLocalScStages<Tail>::CHECKS_MOVABLE),
+		CHECKS_BOX=(FusedLocalScStage<Head>::CHECKS_BOX || FusedLocalScStages<Tail>::CHECKS_BOX),
+		CHECKS_BONDS=(FusedLocalScStage<Head>::CHECKS_BONDS || FusedLocalScStages<Tail>::CHECKS_BONDS),
+		CHECKS_VOLUME=(FusedLocalScStage<Head>::CHECKS_VOLUME || FusedLocalScStages<Tail>::CHECKS_VOLUME)
+	};
+};
+
+/**
+ * @class FusedLocalScSweep
+ *
+ * @brief Performs MoveLocalSc attempts with the checks of all features fused into one loop
+ *
+ * @details For a given Ingredients type, the stages of the features are
+ * selected at compile time (see FusedLocalScStage). Stages of features that
+ * do not act on local moves are pruned, and the remaining ones (movable tag,
+ * walls of non-periodic box directions, bond check, excluded volume) work on
+ * the position of the monomer, which is
+ * read once per attempt and kept in local variables from the random choice to
+ * the update of the lattice. The geometry of the six directions is tabulated.
+ *
+ * The random numbers are drawn exactly as in MoveLocalSc::init(), and a move
+ * is accepted under exactly the same conditions, so a sweep produces the same
+ * trajectory as the same number of attempts with UpdaterSimpleSimulator and
+ * MoveLocalSc. If the feature list contains a feature without a
+ * FusedLocalScStage specialization, sweep() falls back to the generic
+ * init/check/apply sequence of MoveLocalSc.
+ *
+ * @tparam IngredientsType Ingredients class storing all system information
+ */
+template<class IngredientsType>
+class FusedLocalScSweep
+{
+public:
+
+	typedef FusedLocalScStages<typename IngredientsType::feature_list> Stages;
+
+	//! true if the feature list is simulated by the fused kernel
+	enum{IS_FUSED=Stages::SUPPORTED};
+
+	FusedLocalScSweep();
+
+	//! performs nMoves attempts of local moves of random monomers. Returns the number of accepted moves
+	uint64_t sweep(IngredientsType& ingredients, uint64_t nMoves)
+	{
+		return sweep(ingredients,nMoves,Loki::Int2Type<IS_FUSED>());
+	}
+
+private:
+
+	//! generic implementation using MoveLocalSc
+	uint64_t sweep(IngredientsType& ingredients, uint64_t nMoves, Loki::Int2Type<0>);
+
+	//! fused implementation
+	uint64_t sweep(IngredientsType& ingredients, uint64_t nMoves, Loki::Int2Type<1>);
+
+	//! movable tag of the monomer, if FeatureFixedMonomers is used
+	template<class MonomerType>
+	static bool isMovable(const MonomerType& monomer, Loki::Int2Type<1>){return monomer.getMovableTag();}
+	template<class MonomerType>
+	static bool isMovable(const MonomerType& monomer, Loki::Int2Type<0>){return true;}
+
+	//! true if the box has walls in a non-periodic direction, if FeatureBox is used
+	static bool hasWalls(const IngredientsType& ing, Loki::Int2Type<1>){
+		return !(ing.isPeriodicX() && ing.isPeriodicY() && ing.isPeriodicZ());
+	}
+	static bool hasWalls(const IngredientsType& ing, Loki::Int2Type<0>){return false;}
+
+	//! checks that the new position (x,y,z) lies inside the box in the non-periodic directions, as FeatureBox::checkMove()
+	static bool insideBox(const IngredientsType& ing, int32_t x, int32_t y, int32_t z){
+		return (ing.isPeriodicX() || (x<(ing.getBoxX()-1) && x>=0)) &&
+		       (ing.isPeriodicY() || (y<(ing.getBoxY()-1) && y>=0)) &&
+		       (ing.isPeriodicZ() || (z<(ing.getBoxZ()-1) && z>=0));
+	}
+
+	//! checks the bonds at the new position (x,y,z) of monomer idx, if a bondset is used
+	static bool bondsValid(const IngredientsType& ing, uint32_t idx, int32_t x, int32_t y, int32_t z, Loki::Int2Type<1>);
+	static bool bondsValid(const IngredientsType& ing, uint32_t idx, int32_t x, int32_t y, int32_t z, Loki::Int2Type<0>){return true;}
+
+	//! updates the bond index cache of FeatureBondset before monomer idx is moved by step, if the cache is used
+	static void moveBondIndices(IngredientsType& ing, uint32_t idx, const int32_t* step, Loki::Int2Type<1>){
+		if(ing.isBondIndexCacheActive())
+			ing.updateBondIndexCache(ing.modifyMolecules(),idx,VectorInt3(step[0],step[1],step[2]));
+	}
+	static void moveBondIndices(IngredientsType& ing, uint32_t idx, const int32_t* step, Loki::Int2Type<0>){}
+
+	//! checks the excluded volume for the move of (x,y,z) in direction dir, if FeatureExcludedVolumeSc is used
+	bool volumeFree(const IngredientsType& ing, int32_t x, int32_t y, int32_t z, uint32_t dir, Loki::Int2Type<1>) const;
+	bool volumeFree(const IngredientsType& ing, int32_t x, int32_t y, int32_t z, uint32_t dir, Loki::Int2Type<0>) const {return true;}
+
+	//! moves the cube at (x,y,z) on the lattice in direction dir
+	void moveVolume(IngredientsType& ing, int32_t x, int32_t y, int32_t z, uint32_t dir, Loki::Int2Type<1>) const;
+	void moveVolume(IngredientsType& ing, int32_t x, int32_t y, int32_t z, uint32_t dir, Loki::Int2Type<0>) const {}
+
+	//! throws, if the lattice of FeatureExcludedVolumeSc is not filled
+	static void requireLattice(const IngredientsType& ing, Loki::Int2Type<1>){
+		if(!ing.isLatticeFilledUp())
+			throw std::runtime_error("FusedLocalScSweep::sweep(): lattice is not populated. Run synchronize!\n");
+	}
+	static void requireLattice(const IngredientsType& ing, Loki::Int2Type<0>){}
+
+	//! geometry of one of the six directions of MoveLocalSc
+	struct Direction
+	{
+		//! displacement of the monomer
+		int32_t step[3];
+		//! corner of the plane of sites to be free (relative to the monomer). The cube moves from checkCorner-2*step to this plane
+		int32_t checkCorner[3];
+		//! the two directions spanning both planes
+		int32_t perp1[3];
+		int32_t perp2[3];
+	};
+
+	Direction directions[6];
+
+	RandomNumberGenerators randomNumbers;
+};
+
+/**
+ * @details The geometry follows FeatureExcludedVolumeSc::checkMove() and
+ * applyMove() for MoveLocalSc, with the directions in the order of MoveLocalSc.
+ */
+template<class IngredientsType>
+FusedLocalScSweep<IngredientsType>::FusedLocalScSweep()
+{
+	const int32_t steps[6][3]={{1,0,0},{-1,0,0},{0,1,0},{0,-1,0},{0,0,1},{0,0,-1}};
+	for(uint32_t d=0;d<6;d++)
+	{
+		Direction& dir=directions[d];
+		const bool positive=(steps[d][0]>0 || steps[d][1]>0 || steps[d][2]>0);
+		for(uint32_t c=0;c<3;c++)
+		{
+			dir.step[c]=steps[d][c];
+			dir.checkCorner[c]=(positive ? 2 : 1)*steps[d][c];
+		}
+		dir.perp1[0]=(steps[d][0]==0 ? 1 : 0);
+		dir.perp1[1]=(steps[d][0]!=0 ? 1 : 0);
+		dir.perp1[2]=0;
+		dir.perp2[0]=0;
+		dir.perp2[1]=(steps[d][2]==0 ? 0 : 1);
+		dir.perp2[2]=(steps[d][2]!=0 ? 0 : 1);
+	}
+}
+
+template<class IngredientsType>
+uint64_t FusedLocalScSweep<IngredientsType>::sweep(IngredientsType& ingredients, uint64_t nMoves, Loki::Int2Type<0>)
+{
+	MoveLocalSc move;
+	uint64_t nAccepted=0;
+	for(uint64_t n=0;n<nMoves;n++)
+	{
+		move.init(ingredients);
+		if(move.check(ingredients)==true)
+		{
+			move.apply(ingredients);
+			nAccepted++;
+		}
+	}
+	return nAccepted;
+}
+
+template<class IngredientsType>
+uint64_t FusedLocalScSweep<IngredientsType>::sweep(IngredientsType& ingredients, uint64_t nMoves, Loki::Int2Type<1>)
+{
+	typedef typename IngredientsType::molecules_type MoleculesType;
+	const uint32_t nMonomers=ingredients.getMolecules().size();
+	if(nMonomers==0 || nMoves==0) return 0;
+
+	requireLattice(ingredients,Loki::Int2Type<Stages::CHECKS_VOLUME>());
+	const bool checkWalls=hasWalls(ingredients,Loki::Int2Type<Stages::CHECKS_BOX>());
+
+	uint64_t nAccepted=0;
+	for(uint64_t n=0;n<nMoves;n++)
+	{
+		//same sequence of random numbers as MoveLocalSc::init()
+		const uint32_t idx=randomNumbers.r250_rand32()%nMonomers;
+		const uint32_t dir=randomNumbers.r250_rand32()%6;
+
+		const MoleculesType& molecules=ingredients.getMolecules();
+		const typename MoleculesType::vertex_type& monomer=molecules.getVertexUnchecked(idx);
+		if(!isMovable(monomer,Loki::Int2Type<Stages::CHECKS_MOVABLE>())) continue;
+
+		const int32_t x=monomer.getX();
+		const int32_t y=monomer.getY();
+		const int32_t z=monomer.getZ();
+		const Direction& d=directions[dir];
+
+		if(checkWalls && !insideBox(ingredients,x+d.step[0],y+d.step[1],z+d.step[2])) continue;
+		if(!volumeFree(ingredients,x,y,z,dir,Loki::Int2Type<Stages::CHECKS_VOLUME>())) continue;
+		if(!bondsValid(ingredients,idx,x+d.step[0],y+d.step[1],z+d.step[2],Loki::Int2Type<Stages::CHECKS_BONDS>())) continue;
+
+		moveVolume(ingredients,x,y,z,dir,Loki::Int2Type<Stages::CHECKS_VOLUME>());
+		moveBondIndices(ingredients,idx,d.step,Loki::Int2Type<Stages::CHECKS_BONDS>());
+		ingredients.modifyMolecules()[idx].setAllCoordinates(x+d.step[0],y+d.step[1],z+d.step[2]);
+		nAccepted++;
+	}
+	return nAccepted;
+}
+
+template<class IngredientsType>
+bool FusedLocalScSweep<IngredientsType>::bondsValid(const IngredientsType& ing, uint32_t idx, int32_t x, int32_t y, int32_t z, Loki::Int2Type<1>)
+{
+	const typename IngredientsType::molecules_type& molecules=ing.getMolecules();
+	const uint32_t nLinks=molecules.getNumLinksUnchecked(idx);
+	for(uint32_t j=0;j<nLinks;j++)
+	{
+		const typename IngredientsType::molecules_type::vertex_type& neighbor=molecules.getVertexUnchecked(molecules.getNeighborIdxUnchecked(idx,j));
+		if(!ing.getBondset().isValidStrongCheck(VectorInt3(neighbor.getX()-x,neighbor.getY()-y,neighbor.getZ()-z))) return false;
+	}
+	return true;
+}
+
+template<class IngredientsType>
+bool FusedLocalScSweep<IngredientsType>::volumeFree(const IngredientsType& ing, int32_t x, int32_t y, int32_t z, uint32_t dir, Loki::Int2Type<1>) const
+{
+	const Direction& d=directions[dir];
+	const int32_t cx=x+d.checkCorner[0];
+	const int32_t cy=y+d.checkCorner[1];
+	const int32_t cz=z+d.checkCorner[2];
+
+	return !( ing.getLatticeEntry(cx,cy,cz) ||
+		  ing.getLatticeEntry(cx+d.perp1[0],cy+d.perp1[1],cz+d.perp1[2]) ||
+		  ing.getLatticeEntry(cx+d.perp2[0],cy+d.perp2[1],cz+d.perp2[2]) ||
+		  ing.getLatticeEntry(cx+d.perp1[0]+d.perp2[0],cy+d.perp1[1]+d.perp2[1],cz+d.perp1[2]+d.perp2[2]) );
+}
+
+template<class IngredientsType>
+void FusedLocalScSweep<IngredientsType>::moveVolume(IngredientsType& ing, int32_t x, int32_t y, int32_t z, uint32_t dir, Loki::Int2Type<1>) const
+{
+	const Direction& d=directions[dir];
+	const int32_t nx=x+d.checkCorner[0];
+	const int32_t ny=y+d.checkCorner[1];
+	const int32_t nz=z+d.checkCorner[2];
+	const int32_t ox=nx-2*d.step[0];
+	const int32_t oy=ny-2*d.step[1];
+	const int32_t oz=nz-2*d.step[2];
+	const int32_t* p1=d.perp1;
+	const int32_t* p2=d.perp2;
+
+	ing.moveOnLattice(ox,oy,oz,nx,ny,nz);
+	ing.moveOnLattice(ox+p1[0],oy+p1[1],oz+p1[2],nx+p1[0],ny+p1[1],nz+p1[2]);
+	ing.moveOnLattice(ox+p2[0],oy+p2[1],oz+p2[2],nx+p2[0],ny+p2[1],nz+p2[2]);
+	ing.moveOnLattice(ox+p1[0]+p2[0],oy+p1[1]+p2[1],oz+p1[2]+p2[2],nx+p1[0]+p2[0],ny+p1[1]+p2[1],nz+p1[2]+p2[2]);
+}
+
+#endif /* LEMONADE_UPDATER_MOVES_FUSEDLOCALSCSWEEP_H */
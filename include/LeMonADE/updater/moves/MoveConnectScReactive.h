@@ -107,9 +107,7 @@ void MoveConnectScReactive::init(const IngredientsType& ing)
   }
   else {
     auto index(this->randomNumbers.r250_rand32() % nUnreactedMonomers);
-    auto it (ing.getUnreactiveMonomers().cbegin());
-    std::advance( it, index);
-    this->setIndex(it->first);
+    this->setIndex(ing.getUnreactiveMonomers()[index]);
     //draw direction
     VectorInt3 randomDir(shellPositions[ this->randomNumbers.r250_rand32() % 6]);
     this->setDir(randomDir);
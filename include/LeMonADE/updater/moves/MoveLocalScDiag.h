@@ -39,6 +39,11 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @brief Standard local bfm-move on simple cubic lattice for the scBFM.
  *
  * @details The class is a specialization of MoveLocalBase using the (CRTP) to avoid virtual functions.
+ * Besides the 6 moves along the lattice axes it performs the 12 moves along the
+ * face diagonals. For every direction, the lattice sites entered and left by the
+ * cube of the monomer are tabulated in the constructor, such that excluded volume
+ * features check and update only these 4 (axes) or 6 (diagonals) sites without
+ * working out the geometry of the move again.
  **/
 /*****************************************************************************/
 class MoveLocalScDiag:public MoveLocalBase<MoveLocalScDiag>
@@ -65,6 +70,29 @@ public:
 	steps[15]=VectorInt3(1,-1,0);
 	steps[16]=VectorInt3(-1,1,0);
 	steps[17]=VectorInt3(-1,-1,0);    
+
+	//tabulate the sites entered and left by the cube of the monomer,
+	//which occupies the sites (0..1,0..1,0..1) relative to its position.
+	//an entered site with a coordinate 2 (-1) is paired with the left
+	//site having 0 (1) instead, i.e. the site it is mirrored from.
+	for(uint32_t d=0;d<18;d++)
+	{
+		nSites[d]=0;
+		for(int32_t x=0;x<2;x++)
+		for(int32_t y=0;y<2;y++)
+		for(int32_t z=0;z<2;z++)
+		{
+			VectorInt3 entered=VectorInt3(x,y,z)+steps[d];
+			if(entered.getX()>=0 && entered.getX()<2 &&
+			   entered.getY()>=0 && entered.getY()<2 &&
+			   entered.getZ()>=0 && entered.getZ()<2) continue;
+
+			enteredSites[d][nSites[d]]=entered;
+			leftSites[d][nSites[d]]=VectorInt3(mirrorSite(entered.getX()),mirrorSite(entered.getY()),mirrorSite(entered.getZ()));
+			nSites[d]++;
+		}
+	}
+	dirIndex=0;
   }
   
   template <class IngredientsType> void init(const IngredientsType& ing);
@@ -74,8 +102,33 @@ public:
   
   template <class IngredientsType> bool check(IngredientsType& ing);
   template< class IngredientsType> void apply(IngredientsType& ing);
+
+  //! number of lattice sites entered (and left) by the cube of the monomer: 4 for axes, 6 for diagonals
+  uint32_t getNumMovedSites() const {return nSites[dirIndex];}
+  //! sites relative to the monomer position which are entered by the move
+  const VectorInt3* getEnteredSites() const {return enteredSites[dirIndex];}
+  //! sites relative to the monomer position which are left by the move, in the order of getEnteredSites()
+  const VectorInt3* getLeftSites() const {return leftSites[dirIndex];}
     
 private:
+  //! sets the direction steps[index]
+  void setDirIndex(uint32_t index){dirIndex=index; this->setDir(steps[index]);}
+
+  //! returns the index of dir in steps, or 18 if dir is not a valid direction
+  uint32_t findDirIndex(const VectorInt3& dir) const
+  {
+	uint32_t index=0;
+	while(index<18 && !(dir==steps[index])) index++;
+	return index;
+  }
+
+  //! maps a coordinate of an entered site to the one of the left site
+  static int32_t mirrorSite(int32_t coordinate){
+	if(coordinate==2) return 0;
+	if(coordinate==-1) return 1;
+	return coordinate;
+  }
+
   // holds the possible move directions
   /**
    * @brief Array that holds the 6 possible move directions
@@ -91,6 +144,15 @@ private:
    * * Plus the moves diagonal with square length 2.  
    */
   VectorInt3 steps[18];
+
+  //! index of the current direction in steps
+  uint32_t dirIndex;
+  //! number of sites entered by a move in direction steps[i]
+  uint32_t nSites[18];
+  //! sites relative to the monomer position entered by a move in direction steps[i]
+  VectorInt3 enteredSites[18][6];
+  //! sites relative to the monomer position left by a move in direction steps[i]
+  VectorInt3 leftSites[18][6];
 };
 
 
@@ -116,7 +178,7 @@ void MoveLocalScDiag::init(const IngredientsType& ing)
   //draw direction
   uint32_t randomDir(this->randomNumbers.r250_rand32() % 18);
   
-  this->setDir(steps[randomDir]);
+  setDirIndex(randomDir);
 
 }
 
@@ -144,7 +206,7 @@ void MoveLocalScDiag::init(const IngredientsType& ing, uint32_t index)
   //draw direction
   uint32_t randomDir(this->randomNumbers.r250_rand32() % 18);
   
-  this->setDir(steps[randomDir]);
+  setDirIndex(randomDir);
 
 }
 
@@ -167,26 +229,9 @@ void MoveLocalScDiag::init(const IngredientsType& ing, VectorInt3 dir)
   this->setIndex( (this->randomNumbers.r250_rand32()) %(ing.getMolecules().size()) );
   
  //set direction
-  if(dir==steps[ 0] ||
-     dir==steps[ 1] ||
-     dir==steps[ 2] ||
-     dir==steps[ 3] ||
-     dir==steps[ 4] ||
-     dir==steps[ 5] ||
-     dir==steps[ 6] ||
-     dir==steps[ 7] ||
-     dir==steps[ 8] ||
-     dir==steps[ 9] ||
-     dir==steps[10] ||
-     dir==steps[11] ||
-     dir==steps[12] ||
-     dir==steps[13] ||
-     dir==steps[14] ||
-     dir==steps[15] ||
-     dir==steps[16] ||
-     dir==steps[17] 
-    )
-    this->setDir(dir);
+  uint32_t dirIdx=findDirIndex(dir);
+  if(dirIdx<18)
+    setDirIndex(dirIdx);
   else
     throw std::runtime_error("MoveLocalScDiag::init(ing, dir): direction vector out of range!");
 }
@@ -214,26 +259,9 @@ void MoveLocalScDiag::init(const IngredientsType& ing, uint32_t index, VectorInt
     throw std::runtime_error("MoveLocalScDiag::init(ing, index, dir): index out of range!");
   
  //set direction
-  if(dir==steps[ 0] ||
-     dir==steps[ 1] ||
-     dir==steps[ 2] ||
-     dir==steps[ 3] ||
-     dir==steps[ 4] ||
-     dir==steps[ 5] ||
-     dir==steps[ 6] ||
-     dir==steps[ 7] ||
-     dir==steps[ 8] ||
-     dir==steps[ 9] ||
-     dir==steps[10] ||
-     dir==steps[11] ||
-     dir==steps[12] ||
-     dir==steps[13] ||
-     dir==steps[14] ||
-     dir==steps[15] ||
-     dir==steps[16] ||
-     dir==steps[17] 
-    )
-    this->setDir(dir);
+  uint32_t dirIdx=findDirIndex(dir);
+  if(dirIdx<18)
+    setDirIndex(dirIdx);
   else
     throw std::runtime_error("MoveLocalScDiag::init(ing, index, dir): direction vector out of range!");
 }
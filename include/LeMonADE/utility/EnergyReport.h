@@ -0,0 +1,131 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UTILITY_ENERGYREPORT_H
+#define LEMONADE_UTILITY_ENERGYREPORT_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+/***********************************************************/
+/**
+ * @file
+ * @class EnergyReport
+ *
+ * @brief Collects the energies of all features of a system
+ *
+ * @details Features contributing to the energy (e.g. FeatureNNInteractionSc,
+ * FeatureBendingPotential) keep the current value of their energy up to date
+ * in applyMove() and recalculate it from scratch in synchronize(). Passing an
+ * EnergyReport to Ingredients::reportEnergy() (or constructing it from the
+ * ingredients) collects these values in the order of the features, without
+ * any calculation. The energies are in units of kT.
+ *
+ * Usage:
+ * @code
+ * EnergyReport report(ingredients);
+ * for(size_t n=0;n<report.size();n++)
+ *   std::cout<<report.getName(n)<<" "<<report.getEnergy(n)<<std::endl;
+ * std::cout<<"total "<<report.getTotalEnergy()<<std::endl;
+ * @endcode
+ */
+/***********************************************************/
+class EnergyReport
+{
+public:
+
+	EnergyReport(){}
+
+	//! collects the energies of all features of ingredients
+	template < class IngredientsType >
+	explicit EnergyReport(const IngredientsType& ingredients){ingredients.reportEnergy(*this);}
+
+	//! adds the energy of a feature. Called by the features in reportEnergy()
+	void addEnergy(const std::string& name, double energy){
+		names.push_back(name);
+		energies.push_back(energy);
+	}
+
+	//! number of features which reported an energy
+	size_t size() const {return energies.size();}
+
+	//! name of the n-th feature
+	const std::string& getName(size_t n) const {return names.at(n);}
+
+	//! energy of the n-th feature
+	double getEnergy(size_t n) const {return energies.at(n);}
+
+	//! energy of the feature with the given name
+	double getEnergy(const std::string& name) const;
+
+	//! returns true if a feature with the given name reported its energy
+	bool hasEnergy(const std::string& name) const;
+
+	//! sum of the energies of all features
+	double getTotalEnergy() const;
+
+	//! removes all entries, e.g. before reusing the report
+	void clear(){names.clear(); energies.clear();}
+
+private:
+
+	std::vector<std::string> names;
+	std::vector<double> energies;
+};
+
+inline bool EnergyReport::hasEnergy(const std::string& name) const
+{
+	for(size_t n=0;n<names.size();n++)
+		if(names[n]==name) return true;
+	return false;
+}
+
+/**
+ * @throw std::runtime_error if no feature with this name reported an energy
+ */
+inline double EnergyReport::getEnergy(const std::string& name) const
+{
+	for(size_t n=0;n<names.size();n++)
+		if(names[n]==name) return energies[n];
+
+	std::stringstream errormessage;
+	errormessage<<"EnergyReport::getEnergy(name): no energy reported for "<<name;
+	throw std::runtime_error(errormessage.str());
+}
+
+inline double EnergyReport::getTotalEnergy() const
+{
+	double total=0.0;
+	for(size_t n=0;n<energies.size();n++)
+		total+=energies[n];
+	return total;
+}
+
+#endif /* LEMONADE_UTILITY_ENERGYREPORT_H */
@@ -58,9 +58,6 @@ private:
 	//! Look-up table telling if a certain bond-vector is valid.
 	bool bondsetLookup[512];
 
-	//! Translates bond-vector to index in the (fast) look-up table (bondsetLookup).
-	uint32_t bondVectorToIndex(const VectorInt3& bondVector) const;
-
 protected:
 
 	//! Each bond-vector is represented by a std::map <int32_t, VectorInt3>, where the identifier is stored as int32_t
@@ -108,6 +105,21 @@ public:
 	//! Check if a vector is a valid bond-vector (i.e. part of the set)
 	bool isValidStrongCheck(const VectorInt3& bondVector) const;
 
+	//! Translates bond-vector to index in the (fast) look-up table (bondsetLookup).
+	uint32_t bondVectorToIndex(const VectorInt3& bondVector) const;
+
+	//! Check if the bond-vector with look-up index bondIndex is valid, rejecting components +-4
+	bool isValidIndexStrongCheck(uint32_t bondIndex) const;
+
+	//! Returns the look-up index of the bond-vector with index bondIndex plus shift
+	static uint32_t shiftBondIndex(uint32_t bondIndex, const VectorInt3& shift);
+
+	//! Returns the look-up index of the reversed bond-vector with index bondIndex
+	static uint32_t reverseBondIndex(uint32_t bondIndex);
+
+	//! Returns true if bondIndex is an index of the look-up table (0...511)
+	static bool isBondIndex(uint32_t bondIndex){return bondIndex<512;}
+
 
 	//! Clear the look-up table and storing map of bond-vectors
 	void clear();
@@ -204,4 +216,50 @@ inline uint32_t FastBondset::bondVectorToIndex(const VectorInt3& bondVector) con
 	return (bondVector.getX() & 7) + ((bondVector.getY() &7) << 3) + ((bondVector.getZ() &7) << 6);
 }
 
+/**
+ * @details Works on look-up indices as given by bondVectorToIndex(). Components
+ * of +-4 share the field value 4 and are rejected, as in isValidStrongCheck().
+ * Thus, for all vectors with components -4 <= x,y,z <= 4 the result agrees with
+ * isValidStrongCheck(), without knowing the vector itself.
+ *
+ * @param bondIndex look-up index of the bond-vector to check (0...511).
+ * @return True if bond-vector is allowed, false otherwise.
+ */
+inline bool FastBondset::isValidIndexStrongCheck(uint32_t bondIndex) const
+{
+	//a field is 4 (100 in binary) if its highest bit is set and the others are not
+	if(((bondIndex>>2) & ~(bondIndex>>1) & ~bondIndex & 0x49) != 0)
+		return false;
+
+	return bondsetLookup[bondIndex];
+}
+
+/**
+ * @details Adds the components of shift to the three fields of bondIndex.
+ * The result is the look-up index of the shifted bond-vector, if its components
+ * are in the range -4 <= x,y,z <= 4. This is the case e.g. for a valid bond
+ * after a local move, where bond-vector and shift have components of at most 3 and 1.
+ *
+ * @param bondIndex look-up index of the bond-vector (0...511).
+ * @param shift vector added to the bond-vector.
+ * @return look-up index of the bond-vector plus shift.
+ */
+inline uint32_t FastBondset::shiftBondIndex(uint32_t bondIndex, const VectorInt3& shift)
+{
+	return ((bondIndex + shift.getX()) & 7)
+	     + ((((bondIndex>>3) + shift.getY()) & 7) << 3)
+	     + ((((bondIndex>>6) + shift.getZ()) & 7) << 6);
+}
+
+/**
+ * @param bondIndex look-up index of the bond-vector (0...511).
+ * @return look-up index of the bond-vector with opposite direction.
+ */
+inline uint32_t FastBondset::reverseBondIndex(uint32_t bondIndex)
+{
+	return ((8 - bondIndex) & 7)
+	     + (((8 - (bondIndex>>3)) & 7) << 3)
+	     + (((8 - (bondIndex>>6)) & 7) << 6);
+}
+
 #endif /* LEMONADE_UTILITY_FASTBONDSET_H */
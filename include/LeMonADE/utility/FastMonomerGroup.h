@@ -0,0 +1,290 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_UTILITY_FASTMONOMERGROUP_H
+#define LEMONADE_UTILITY_FASTMONOMERGROUP_H
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <sstream>
+
+#include <LeMonADE/utility/MonomerGroup.h>
+
+/***********************************************************/
+/**
+ * @file
+ * @class FastMonomerGroup
+ *
+ * @brief Group of monomer indices with sorted storage and logarithmic membership test.
+ *
+ * @details In contrast to MonomerGroup, the indices are kept sorted and unique
+ * in a std::vector<uint32_t>, so a membership query is a binary search and the
+ * set operations (union, intersection, difference) are linear merges. The
+ * memory of a group is proportional to its size and not to the size of the
+ * system, such that many small groups (e.g. from fill_connected_groups) are
+ * cheap. Indices added in ascending order (the common case when filling
+ * groups in a loop over the molecules) are appended in O(1).
+ * The gather functions copy the coordinates of all group members into
+ * contiguous arrays (one per component) without boundary checks, which is
+ * the layout used by the reductions in the analyzers.
+ *
+ * @tparam MoleculesType type of the molecules container the indices refer to
+ */
+/***********************************************************/
+template < class MoleculesType > class FastMonomerGroup
+{
+public:
+
+	typedef typename MoleculesType::vertex_type vertex_type;
+
+	//! iterator over the (sorted) true indices of the group
+	typedef std::vector<uint32_t>::const_iterator const_iterator;
+
+	//! constructs an empty group referring to the monomers in molecules_
+	FastMonomerGroup(const MoleculesType& molecules_)
+	:molecules(&molecules_){}
+
+	//! constructs the group from the indices of a MonomerGroup
+	FastMonomerGroup(const MoleculesType& molecules_, const MonomerGroup<MoleculesType>& group);
+
+	//! adds the monomer with index idx. Returns false, if it was already part of the group
+	bool insert(uint32_t idx);
+
+	//! same as insert. Provided for use with fill_connected_groups and group_by_property
+	void push_back(uint32_t idx){insert(idx);}
+
+	//! removes the n-th particle from the group. n is NOT the true index of the particle!
+	void erase(size_t n);
+
+	//! removes the monomer with index n from the group. here n is the true index of the particle
+	void removeFromGroup(uint32_t n);
+
+	//! returns true if the monomer with index idx is part of the group
+	bool contains(uint32_t idx) const {
+		return std::binary_search(indices.begin(),indices.end(),idx);
+	}
+
+	//! returns the n-th monomer of the group
+	const vertex_type& operator[] (size_t n) const {return molecules->getVertexUnchecked(indices[n]);}
+
+	//! returns the true index of the n-th monomer of the group
+	uint32_t trueIndex(size_t n) const {return indices.at(n);}
+
+	//! returns the sorted list of true indices
+	const std::vector<uint32_t>& getIndices() const {return indices;}
+
+	const_iterator begin() const {return indices.begin();}
+	const_iterator end() const {return indices.end();}
+
+	size_t size() const {return indices.size();}
+
+	uint64_t getAge() const {return molecules->getAge();}
+
+	void clear(){indices.clear();}
+
+	//! union: adds all monomers of rhs to this group
+	FastMonomerGroup& operator += (const FastMonomerGroup& rhs);
+
+	//! difference: removes all monomers of rhs from this group
+	FastMonomerGroup& operator -= (const FastMonomerGroup& rhs);
+
+	//! intersection: keeps only monomers which are also part of rhs
+	FastMonomerGroup& operator &= (const FastMonomerGroup& rhs);
+
+	//! copies the coordinates of the group members into x,y,z (resized to size())
+	template < class T >
+	void gatherCoordinates(std::vector<T>& x, std::vector<T>& y, std::vector<T>& z) const;
+
+	//! copies the coordinates of the group members into x,y,z, which must hold at least size() elements
+	template < class T >
+	void gatherCoordinates(T* x, T* y, T* z) const;
+
+	//! converts to a MonomerGroup holding the same indices
+	MonomerGroup<MoleculesType> toMonomerGroup() const;
+
+private:
+
+	//! pointer to the molecules the indices refer to
+	const MoleculesType* molecules;
+
+	//! sorted and unique indices of the group members
+	std::vector<uint32_t> indices;
+};
+
+/*****************************************************************************/
+//members of class FastMonomerGroup
+/*****************************************************************************/
+
+template<class MoleculesType>
+FastMonomerGroup<MoleculesType>::FastMonomerGroup(const MoleculesType& molecules_,
+	const MonomerGroup<MoleculesType>& group)
+:molecules(&molecules_)
+{
+	indices.reserve(group.size());
+	for(size_t n=0;n<group.size();n++)
+		indices.push_back(group.trueIndex(n));
+
+	std::sort(indices.begin(),indices.end());
+	indices.erase(std::unique(indices.begin(),indices.end()),indices.end());
+}
+
+/**
+ * @details If idx is larger than all current members, it is appended.
+ * Otherwise it is inserted at its sorted position.
+ * @param idx true index of the monomer
+ * @return true if the monomer was added, false if it was already part of the group
+ */
+template<class MoleculesType>
+bool FastMonomerGroup<MoleculesType>::insert(uint32_t idx)
+{
+	if(indices.empty() || indices.back()<idx){
+		indices.push_back(idx);
+		return true;
+	}
+
+	std::vector<uint32_t>::iterator it=std::lower_bound(indices.begin(),indices.end(),idx);
+	if(*it==idx) return false;
+
+	indices.insert(it,idx);
+	return true;
+}
+
+template<class MoleculesType>
+void FastMonomerGroup<MoleculesType>::erase(size_t n)
+{
+	if(n<indices.size()){
+		indices.erase(indices.begin()+n);
+	}
+	else{
+		std::stringstream errormessage;
+		errormessage<<"FastMonomerGroup::erase(size_t n): n="<<n<<" index out of bounds";
+		throw std::runtime_error(errormessage.str());
+	}
+}
+
+template<class MoleculesType>
+void FastMonomerGroup<MoleculesType>::removeFromGroup(uint32_t n)
+{
+	std::vector<uint32_t>::iterator it=std::lower_bound(indices.begin(),indices.end(),n);
+	if(it==indices.end() || *it!=n){
+		std::stringstream errormessage;
+		errormessage<<"FastMonomerGroup::removeFromGroup(uint32_t n): n="<<n<<" is not part of the group";
+		throw std::runtime_error(errormessage.str());
+	}
+
+	indices.erase(it);
+}
+
+template<class MoleculesType>
+FastMonomerGroup<MoleculesType>& FastMonomerGroup<MoleculesType>::operator += (const FastMonomerGroup& rhs)
+{
+	std::vector<uint32_t> result;
+	result.reserve(indices.size()+rhs.indices.size());
+	std::set_union(indices.begin(),indices.end(),
+		       rhs.indices.begin(),rhs.indices.end(),
+		       std::back_inserter(result));
+	indices.swap(result);
+
+	return *this;
+}
+
+template<class MoleculesType>
+FastMonomerGroup<MoleculesType>& FastMonomerGroup<MoleculesType>::operator -= (const FastMonomerGroup& rhs)
+{
+	//merge with the sorted indices of rhs, compacting the kept indices in place
+	size_t nKept=0;
+	size_t m=0;
+	for(size_t n=0;n<indices.size();n++){
+		while(m<rhs.indices.size() && rhs.indices[m]<indices[n]) m++;
+		const bool inRhs=(m<rhs.indices.size() && rhs.indices[m]==indices[n]);
+		if(!inRhs) indices[nKept++]=indices[n];
+	}
+	indices.resize(nKept);
+
+	return *this;
+}
+
+template<class MoleculesType>
+FastMonomerGroup<MoleculesType>& FastMonomerGroup<MoleculesType>::operator &= (const FastMonomerGroup& rhs)
+{
+	//merge with the sorted indices of rhs, compacting the kept indices in place
+	size_t nKept=0;
+	size_t m=0;
+	for(size_t n=0;n<indices.size();n++){
+		while(m<rhs.indices.size() && rhs.indices[m]<indices[n]) m++;
+		const bool inRhs=(m<rhs.indices.size() && rhs.indices[m]==indices[n]);
+		if(inRhs) indices[nKept++]=indices[n];
+	}
+	indices.resize(nKept);
+
+	return *this;
+}
+
+/**
+ * @details The coordinates are read without boundary check on the molecules.
+ * The group must therefore only contain indices smaller than molecules.size().
+ */
+template<class MoleculesType>
+template<class T>
+void FastMonomerGroup<MoleculesType>::gatherCoordinates(std::vector<T>& x, std::vector<T>& y, std::vector<T>& z) const
+{
+	x.resize(indices.size());
+	y.resize(indices.size());
+	z.resize(indices.size());
+
+	if(!indices.empty())
+		gatherCoordinates(&x[0],&y[0],&z[0]);
+}
+
+template<class MoleculesType>
+template<class T>
+void FastMonomerGroup<MoleculesType>::gatherCoordinates(T* x, T* y, T* z) const
+{
+	const size_t nMonomers=indices.size();
+	for(size_t n=0;n<nMonomers;n++)
+	{
+		const vertex_type& monomer=molecules->getVertexUnchecked(indices[n]);
+		x[n]=T(monomer.getX());
+		y[n]=T(monomer.getY());
+		z[n]=T(monomer.getZ());
+	}
+}
+
+template<class MoleculesType>
+MonomerGroup<MoleculesType> FastMonomerGroup<MoleculesType>::toMonomerGroup() const
+{
+	MonomerGroup<MoleculesType> group(*molecules);
+	for(size_t n=0;n<indices.size();n++)
+		group.push_back(indices[n]);
+
+	return group;
+}
+
+#endif /* LEMONADE_UTILITY_FASTMONOMERGROUP_H */
@@ -0,0 +1,170 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UTILITY_FENWICKTREE_H
+#define LEMONADE_UTILITY_FENWICKTREE_H
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************/
+/**
+ * @file
+ * @class FenwickTree
+ *
+ * @brief Binary indexed tree over non-negative weights
+ *
+ * @details Stores n weights w_0...w_{n-1} such that changing a weight, the
+ * prefix sums and the search for the entry belonging to a value in [0,total)
+ * all take O(log n). This is the selection step of rejection-free (n-fold way)
+ * Monte-Carlo schemes: an entry is drawn with probability w_i/total by
+ * find(u*total) with u uniform in [0,1).
+ * With an unsigned integer type T the sums are exact, since differences
+ * wrap around consistently. Floating point types accumulate rounding errors
+ * over many updates and should be rebuilt with assign() from time to time.
+ *
+ * @tparam T type of the weights
+ */
+/***********************************************************/
+template < class T >
+class FenwickTree
+{
+public:
+
+	FenwickTree():total(0){}
+
+	//! tree of n weights, all zero
+	explicit FenwickTree(size_t n):tree(n+1,T(0)),values(n,T(0)),total(0){}
+
+	//! resets the tree to n weights, all zero
+	void assign(size_t n){
+		tree.assign(n+1,T(0));
+		values.assign(n,T(0));
+		total=T(0);
+	}
+
+	//! builds the tree from the weights in O(n)
+	void assign(const std::vector<T>& weights);
+
+	//! number of weights
+	size_t size() const {return values.size();}
+
+	//! weight of entry i
+	T get(size_t i) const {return values[i];}
+
+	//! sum of all weights
+	T getTotal() const {return total;}
+
+	//! sets the weight of entry i to w
+	void set(size_t i, T w);
+
+	//! sum of the weights of the entries 0...n-1
+	T prefixSum(size_t n) const;
+
+	//! index i with prefixSum(i) <= x < prefixSum(i+1). x must be smaller than getTotal()
+	size_t find(T x) const;
+
+private:
+
+	//! tree[k] holds the sum of the weights k-(k&-k)...k-1
+	std::vector<T> tree;
+
+	//! the weights itself
+	std::vector<T> values;
+
+	T total;
+};
+
+/*****************************************************************************/
+//members of class FenwickTree
+/*****************************************************************************/
+
+template<class T>
+void FenwickTree<T>::assign(const std::vector<T>& weights)
+{
+	values=weights;
+	tree.assign(values.size()+1,T(0));
+	total=T(0);
+
+	for(size_t k=1;k<tree.size();k++)
+	{
+		tree[k]+=values[k-1];
+		total+=values[k-1];
+		size_t parent=k+(k&(~k+1));
+		if(parent<tree.size()) tree[parent]+=tree[k];
+	}
+}
+
+template<class T>
+void FenwickTree<T>::set(size_t i, T w)
+{
+	if(values[i]==w) return;
+
+	const T delta=w-values[i];
+	values[i]=w;
+	total+=delta;
+
+	for(size_t k=i+1;k<tree.size();k+=(k&(~k+1)))
+		tree[k]+=delta;
+}
+
+template<class T>
+T FenwickTree<T>::prefixSum(size_t n) const
+{
+	T sum(0);
+	for(size_t k=n;k>0;k-=(k&(~k+1)))
+		sum+=tree[k];
+
+	return sum;
+}
+
+/**
+ * @details Descends from the largest power of two not exceeding size(),
+ * such that entries with zero weight are never returned.
+ */
+template<class T>
+size_t FenwickTree<T>::find(T x) const
+{
+	const size_t n=values.size();
+	size_t step=1;
+	while((step<<1)<=n) step<<=1;
+
+	size_t pos=0;
+	for(;step>0;step>>=1)
+	{
+		if(pos+step<=n && !(x<tree[pos+step]))
+		{
+			pos+=step;
+			x-=tree[pos];
+		}
+	}
+
+	return pos;
+}
+
+#endif /* LEMONADE_UTILITY_FENWICKTREE_H */
@@ -0,0 +1,228 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_UTILITY_GYRATIONTENSOR_H
+#define LEMONADE_UTILITY_GYRATIONTENSOR_H
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+/***********************************************************/
+/**
+ * @file
+ * @class GyrationTensor
+ *
+ * @brief Gyration tensor and derived shape descriptors of a set of positions
+ *
+ * @details The tensor is calculated from coordinates stored in three contiguous
+ * arrays (structure of arrays), as provided by the gather functions of
+ * MonomerGroup and FastMonomerGroup. The calculation uses two passes: the
+ * first one determines the center of mass, the second one sums the products
+ * of the coordinates relative to it. This avoids the cancellation of the
+ * one-pass formula <x^2>-<x>^2 for groups far away from the origin.
+ * Both passes accumulate into several independent partial sums, so that the
+ * loops can be vectorized by the compiler. All six tensor components are
+ * obtained in the second pass, such that the shape descriptors come at no
+ * additional cost compared to Rg^2 alone.
+ */
+/***********************************************************/
+class GyrationTensor
+{
+public:
+
+	GyrationTensor():nPositions(0),xx(0.0),yy(0.0),zz(0.0),xy(0.0),xz(0.0),yz(0.0){}
+
+	//! calculates the tensor of the n positions (x[i],y[i],z[i])
+	template < class T >
+	void calculate(const T* x, const T* y, const T* z, size_t n);
+
+	//! number of positions the tensor was calculated from
+	size_t getNumberOfPositions() const {return nPositions;}
+
+	//! center of mass of the positions
+	const VectorDouble3& getCenterOfMass() const {return centerOfMass;}
+
+	double getXX() const {return xx;}
+	double getYY() const {return yy;}
+	double getZZ() const {return zz;}
+	double getXY() const {return xy;}
+	double getXZ() const {return xz;}
+	double getYZ() const {return yz;}
+
+	//! diagonal of the tensor, i.e. the components (Rg^2_x, Rg^2_y, Rg^2_z)
+	VectorDouble3 getRg2Components() const {return VectorDouble3(xx,yy,zz);}
+
+	//! squared radius of gyration, i.e. the trace of the tensor
+	double getRg2() const {return xx+yy+zz;}
+
+	//! eigenvalues of the tensor in ascending order
+	VectorDouble3 getEigenvalues() const;
+
+	//! asphericity b=l3-(l1+l2)/2 with eigenvalues l1<=l2<=l3
+	double getAsphericity() const {
+		VectorDouble3 l=getEigenvalues();
+		return l.getZ()-0.5*(l.getX()+l.getY());
+	}
+
+	//! acylindricity c=l2-l1 with eigenvalues l1<=l2<=l3
+	double getAcylindricity() const {
+		VectorDouble3 l=getEigenvalues();
+		return l.getY()-l.getX();
+	}
+
+	//! relative shape anisotropy k^2=1-3(l1l2+l2l3+l1l3)/(l1+l2+l3)^2. Zero for an empty or point-like group
+	double getRelativeShapeAnisotropy() const {
+		VectorDouble3 l=getEigenvalues();
+		double trace=l.getX()+l.getY()+l.getZ();
+		if(trace<=0.0) return 0.0;
+		return 1.0-3.0*(l.getX()*l.getY()+l.getY()*l.getZ()+l.getX()*l.getZ())/(trace*trace);
+	}
+
+private:
+
+	//! number of independent partial sums in the reduction loops
+	enum{ NLanes=4 };
+
+	size_t nPositions;
+	VectorDouble3 centerOfMass;
+	double xx,yy,zz,xy,xz,yz;
+};
+
+/**
+ * @details For n==0 all components are set to zero.
+ * @param x,y,z arrays holding at least n coordinates each
+ * @param n number of positions
+ */
+template < class T >
+void GyrationTensor::calculate(const T* x, const T* y, const T* z, size_t n)
+{
+	nPositions=n;
+	centerOfMass=VectorDouble3(0.0,0.0,0.0);
+	xx=yy=zz=xy=xz=yz=0.0;
+
+	if(n==0) return;
+
+	const size_t nBlocked=n-n%NLanes;
+
+	//first pass: center of mass
+	double sumX[NLanes]={0.0}, sumY[NLanes]={0.0}, sumZ[NLanes]={0.0};
+	for(size_t i=0;i<nBlocked;i+=NLanes)
+	{
+		for(size_t l=0;l<NLanes;l++)
+		{
+			sumX[l]+=double(x[i+l]);
+			sumY[l]+=double(y[i+l]);
+			sumZ[l]+=double(z[i+l]);
+		}
+	}
+	for(size_t i=nBlocked;i<n;i++)
+	{
+		sumX[0]+=double(x[i]);
+		sumY[0]+=double(y[i]);
+		sumZ[0]+=double(z[i]);
+	}
+
+	const double inv_N=1.0/double(n);
+	const double comX=(sumX[0]+sumX[1]+sumX[2]+sumX[3])*inv_N;
+	const double comY=(sumY[0]+sumY[1]+sumY[2]+sumY[3])*inv_N;
+	const double comZ=(sumZ[0]+sumZ[1]+sumZ[2]+sumZ[3])*inv_N;
+	centerOfMass=VectorDouble3(comX,comY,comZ);
+
+	//second pass: all components of the tensor relative to the center of mass
+	double sXX[NLanes]={0.0}, sYY[NLanes]={0.0}, sZZ[NLanes]={0.0};
+	double sXY[NLanes]={0.0}, sXZ[NLanes]={0.0}, sYZ[NLanes]={0.0};
+	for(size_t i=0;i<nBlocked;i+=NLanes)
+	{
+		for(size_t l=0;l<NLanes;l++)
+		{
+			const double dx=double(x[i+l])-comX;
+			const double dy=double(y[i+l])-comY;
+			const double dz=double(z[i+l])-comZ;
+			sXX[l]+=dx*dx; sYY[l]+=dy*dy; sZZ[l]+=dz*dz;
+			sXY[l]+=dx*dy; sXZ[l]+=dx*dz; sYZ[l]+=dy*dz;
+		}
+	}
+	for(size_t i=nBlocked;i<n;i++)
+	{
+		const double dx=double(x[i])-comX;
+		const double dy=double(y[i])-comY;
+		const double dz=double(z[i])-comZ;
+		sXX[0]+=dx*dx; sYY[0]+=dy*dy; sZZ[0]+=dz*dz;
+		sXY[0]+=dx*dy; sXZ[0]+=dx*dz; sYZ[0]+=dy*dz;
+	}
+
+	xx=(sXX[0]+sXX[1]+sXX[2]+sXX[3])*inv_N;
+	yy=(sYY[0]+sYY[1]+sYY[2]+sYY[3])*inv_N;
+	zz=(sZZ[0]+sZZ[1]+sZZ[2]+sZZ[3])*inv_N;
+	xy=(sXY[0]+sXY[1]+sXY[2]+sXY[3])*inv_N;
+	xz=(sXZ[0]+sXZ[1]+sXZ[2]+sXZ[3])*inv_N;
+	yz=(sYZ[0]+sYZ[1]+sYZ[2]+sYZ[3])*inv_N;
+}
+
+/**
+ * @details Uses the closed form solution for symmetric 3x3 matrices
+ * (O. K. Smith, Comm. ACM 4, 168 (1961)).
+ */
+inline VectorDouble3 GyrationTensor::getEigenvalues() const
+{
+	const double offDiagonal=xy*xy+xz*xz+yz*yz;
+
+	//diagonal tensor: the eigenvalues are the diagonal elements
+	if(offDiagonal==0.0)
+	{
+		double l[3]={xx,yy,zz};
+		std::sort(l,l+3);
+		return VectorDouble3(l[0],l[1],l[2]);
+	}
+
+	const double q=(xx+yy+zz)/3.0;
+	const double p=std::sqrt(((xx-q)*(xx-q)+(yy-q)*(yy-q)+(zz-q)*(zz-q)+2.0*offDiagonal)/6.0);
+
+	//B=(A-q*1)/p, r=det(B)/2
+	const double bxx=(xx-q)/p, byy=(yy-q)/p, bzz=(zz-q)/p;
+	const double bxy=xy/p, bxz=xz/p, byz=yz/p;
+	const double r=0.5*( bxx*(byy*bzz-byz*byz)
+			    -bxy*(bxy*bzz-byz*bxz)
+			    +bxz*(bxy*byz-byy*bxz) );
+
+	const double pi=3.14159265358979323846;
+	double phi;
+	if(r<=-1.0) phi=pi/3.0;
+	else if(r>=1.0) phi=0.0;
+	else phi=std::acos(r)/3.0;
+
+	const double largest=q+2.0*p*std::cos(phi);
+	const double smallest=q+2.0*p*std::cos(phi+2.0*pi/3.0);
+	const double middle=3.0*q-largest-smallest;
+
+	return VectorDouble3(smallest,middle,largest);
+}
+
+#endif /* LEMONADE_UTILITY_GYRATIONTENSOR_H */
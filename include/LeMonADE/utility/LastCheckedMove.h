@@ -0,0 +1,80 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#ifndef LEMONADE_UTILITY_LASTCHECKEDMOVE_H
+#define LEMONADE_UTILITY_LASTCHECKEDMOVE_H
+
+#include <cmath>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+/***********************************************************/
+/**
+ * @file
+ * @class LastCheckedMove
+ *
+ * @brief Remembers the probability factor of the local move checked last
+ *
+ * @details A move is usually applied right after it was checked. Features
+ * keeping a running energy (see EnergyReport) store their factor exp(-dE)
+ * from checkMove() here and obtain dE in applyMove() from
+ * getEnergyDifference(), instead of evaluating the move a second time. The
+ * features decide themselves how to handle moves which were not checked last.
+ */
+/***********************************************************/
+class LastCheckedMove
+{
+public:
+
+	LastCheckedMove():factor(1.0),index(0),direction(0,0,0){}
+
+	//! stores the factor exp(-dE) of moving monomer idx in direction dir
+	void set(uint32_t idx, const VectorInt3& dir, double prob){
+		index=idx;
+		direction=dir;
+		factor=prob;
+	}
+
+	//! true if the move of monomer idx in direction dir was checked last
+	bool matches(uint32_t idx, const VectorInt3& dir) const {
+		return idx==index && dir==direction;
+	}
+
+	//! probability factor of the move checked last
+	double getFactor() const {return factor;}
+
+	//! energy difference -ln(factor) of the move checked last. No logarithm is needed for the frequent factor 1
+	double getEnergyDifference() const {return (factor==1.0) ? 0.0 : -std::log(factor);}
+
+private:
+
+	double factor;
+	uint32_t index;
+	VectorInt3 direction;
+};
+
+#endif /* LEMONADE_UTILITY_LASTCHECKEDMOVE_H */
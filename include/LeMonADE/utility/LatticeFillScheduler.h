@@ -0,0 +1,291 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UTILITY_LATTICEFILLSCHEDULER_H
+#define LEMONADE_UTILITY_LATTICEFILLSCHEDULER_H
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+#include <LeMonADE/utility/Vector3D.h>
+
+/***********************************************************/
+/**
+ * @file
+ * @class LatticeFillScheduler
+ *
+ * @brief Parallel and incremental filling of the lattice occupation of sc-monomers.
+ *
+ * @details Every monomer occupies the 2x2x2 lattice sites in front of its
+ * position. For a parallel fill, the monomers are sorted into slabs of the
+ * folded z-coordinate, each at least two sites thick. A monomer in slab s
+ * therefore only touches sites of the slabs s and s+1, and monomers of the
+ * even slabs (and of the odd slabs, respectively) never touch the same site.
+ * forEachMonomer() processes the even slabs concurrently, followed by the
+ * odd ones. The number of slabs is even, such that this also holds across
+ * the periodic boundary. Without OpenMP the slabs are processed serially,
+ * which still improves the memory locality compared to the index order.
+ *
+ * For the incremental synchronization, the positions and lattice values of
+ * the last fill are kept as snapshot together with the lattice generation
+ * (see FeatureLatticeBase::getLatticeGeneration()). If the lattice was not
+ * reset since, only monomers whose position or value changed have to be
+ * written again.
+ *
+ * @tparam ValueType type of the values written on the lattice
+ */
+/***********************************************************/
+template < class ValueType >
+class LatticeFillScheduler
+{
+public:
+
+	LatticeFillScheduler():snapshotGeneration(0),hasSnapshot(false){}
+
+	//! sorts the monomer indices into slabs of the folded z-coordinate
+	template < class MoleculesType >
+	void sortIntoSlabs(const MoleculesType& molecules, int32_t boxZ);
+
+	/**
+	 * @brief Applies operation(n) to all monomers sorted by sortIntoSlabs()
+	 *
+	 * @details The operation is called concurrently for monomers of
+	 * non-neighboring slabs. It must only write to the lattice sites
+	 * occupied by monomer n and returns false on failure.
+	 * @param[out] failedIndex smallest index for which the operation failed
+	 * @return true if the operation succeeded for all monomers
+	 */
+	template < class Operation >
+	bool forEachMonomer(const Operation& operation, uint32_t& failedIndex) const;
+
+	//! stores the positions and lattice values of all monomers as snapshot
+	template < class MoleculesType, class ValueFunction >
+	void storeSnapshot(const MoleculesType& molecules, const ValueFunction& value, uint64_t latticeGeneration);
+
+	//! releases the snapshot, such that the next fill is a complete one
+	void clearSnapshot(){
+		hasSnapshot=false;
+		std::vector<VectorInt3>().swap(snapshotPositions);
+		std::vector<ValueType>().swap(snapshotValues);
+	}
+
+	/**
+	 * @brief Finds the monomers which changed position or value since the snapshot
+	 *
+	 * @return false if there is no valid snapshot for the given lattice generation
+	 * or the number of monomers changed. A complete fill is required then.
+	 */
+	template < class MoleculesType, class ValueFunction >
+	bool findChangedMonomers(const MoleculesType& molecules, const ValueFunction& value,
+				 uint64_t latticeGeneration, std::vector<uint32_t>& changed) const;
+
+	//! position of monomer n in the snapshot
+	const VectorInt3& getSnapshotPosition(uint32_t n) const {return snapshotPositions[n];}
+
+	//! true if all sites of the 2x2x2 cube at pos are empty
+	template < class IngredientsType >
+	static bool isCubeEmpty(const IngredientsType& ingredients, const VectorInt3& pos);
+
+	//! writes value to all sites of the 2x2x2 cube at pos
+	template < class IngredientsType >
+	static void setCube(IngredientsType& ingredients, const VectorInt3& pos, ValueType value);
+
+private:
+
+	//! maximum number of slabs, limits the scheduling overhead for large boxes
+	enum{ MaxSlabs=256 };
+
+	//! monomer indices sorted by slab
+	std::vector<uint32_t> sortedIndices;
+
+	//! sortedIndices[slabStart[s]] to sortedIndices[slabStart[s+1]-1] are in slab s
+	std::vector<uint32_t> slabStart;
+
+	std::vector<VectorInt3> snapshotPositions;
+	std::vector<ValueType> snapshotValues;
+	uint64_t snapshotGeneration;
+	bool hasSnapshot;
+};
+
+/**
+ * @class LatticeCubeOccupier
+ * @brief Operation for LatticeFillScheduler::forEachMonomer writing the cube
+ * of a monomer, if it is empty.
+ *
+ * @tparam ValueFunction provides ValueType operator()(const molecules_type&, uint32_t) const
+ */
+template < class IngredientsType, class ValueFunction, class ValueType >
+class LatticeCubeOccupier
+{
+public:
+	LatticeCubeOccupier(IngredientsType& ingredients_, const ValueFunction& value_)
+	:ingredients(ingredients_),value(value_){}
+
+	bool operator()(uint32_t n) const {
+		const VectorInt3& pos=ingredients.getMolecules()[n].getVector3D();
+		if(!LatticeFillScheduler<ValueType>::isCubeEmpty(ingredients,pos)) return false;
+		LatticeFillScheduler<ValueType>::setCube(ingredients,pos,value(ingredients.getMolecules(),n));
+		return true;
+	}
+
+private:
+	IngredientsType& ingredients;
+	const ValueFunction& value;
+};
+
+/*****************************************************************************/
+//members of class LatticeFillScheduler
+/*****************************************************************************/
+
+/**
+ * @details Uses a counting sort, such that the monomers of a slab stay in
+ * index order. Boxes thinner than four sites result in a single slab.
+ */
+template < class ValueType >
+template < class MoleculesType >
+void LatticeFillScheduler<ValueType>::sortIntoSlabs(const MoleculesType& molecules, int32_t boxZ)
+{
+	int32_t nSlabs=std::min<int32_t>(boxZ/2,MaxSlabs);
+	nSlabs-=nSlabs%2;
+	if(nSlabs<2) nSlabs=1;
+
+	const uint32_t nMonomers=molecules.size();
+	std::vector<uint32_t> slabOfMonomer(nMonomers);
+	slabStart.assign(nSlabs+1,0);
+
+	for(uint32_t n=0;n<nMonomers;n++)
+	{
+		int32_t z=molecules[n].getZ()%boxZ;
+		if(z<0) z+=boxZ;
+		slabOfMonomer[n]=uint32_t((int64_t(z)*nSlabs)/boxZ);
+		slabStart[slabOfMonomer[n]+1]++;
+	}
+	for(int32_t s=0;s<nSlabs;s++) slabStart[s+1]+=slabStart[s];
+
+	std::vector<uint32_t> nextPosition(slabStart.begin(),slabStart.end()-1);
+	sortedIndices.resize(nMonomers);
+	for(uint32_t n=0;n<nMonomers;n++)
+		sortedIndices[nextPosition[slabOfMonomer[n]]++]=n;
+}
+
+template < class ValueType >
+template < class Operation >
+bool LatticeFillScheduler<ValueType>::forEachMonomer(const Operation& operation, uint32_t& failedIndex) const
+{
+	const int32_t nSlabs=int32_t(slabStart.size())-1;
+	const uint32_t noFailure=0xFFFFFFFFu;
+	uint32_t firstFailure=noFailure;
+
+	for(int32_t phase=0;phase<2;phase++)
+	{
+		#pragma omp parallel for schedule(dynamic,1)
+		for(int32_t slab=phase;slab<nSlabs;slab+=2)
+		{
+			for(uint32_t i=slabStart[slab];i<slabStart[slab+1];i++)
+			{
+				if(!operation(sortedIndices[i]))
+				{
+					#pragma omp critical(LatticeFillSchedulerFailure)
+					firstFailure=std::min(firstFailure,sortedIndices[i]);
+					break;
+				}
+			}
+		}
+		if(firstFailure!=noFailure) break;
+	}
+
+	failedIndex=firstFailure;
+	return firstFailure==noFailure;
+}
+
+template < class ValueType >
+template < class MoleculesType, class ValueFunction >
+void LatticeFillScheduler<ValueType>::storeSnapshot(const MoleculesType& molecules, const ValueFunction& value, uint64_t latticeGeneration)
+{
+	const uint32_t nMonomers=molecules.size();
+	snapshotPositions.resize(nMonomers);
+	snapshotValues.resize(nMonomers);
+	for(uint32_t n=0;n<nMonomers;n++)
+	{
+		snapshotPositions[n]=molecules[n].getVector3D();
+		snapshotValues[n]=value(molecules,n);
+	}
+	snapshotGeneration=latticeGeneration;
+	hasSnapshot=true;
+}
+
+template < class ValueType >
+template < class MoleculesType, class ValueFunction >
+bool LatticeFillScheduler<ValueType>::findChangedMonomers(const MoleculesType& molecules, const ValueFunction& value,
+	uint64_t latticeGeneration, std::vector<uint32_t>& changed) const
+{
+	changed.clear();
+	if(!hasSnapshot || snapshotGeneration!=latticeGeneration || snapshotPositions.size()!=molecules.size())
+		return false;
+
+	const uint32_t nMonomers=molecules.size();
+	for(uint32_t n=0;n<nMonomers;n++)
+	{
+		if(snapshotPositions[n]!=molecules[n].getVector3D() || !(snapshotValues[n]==value(molecules,n)))
+			changed.push_back(n);
+	}
+	return true;
+}
+
+template < class ValueType >
+template < class IngredientsType >
+bool LatticeFillScheduler<ValueType>::isCubeEmpty(const IngredientsType& ingredients, const VectorInt3& pos)
+{
+	const int32_t x=pos.getX(), y=pos.getY(), z=pos.getZ();
+	return ingredients.getLatticeEntry(x  ,y  ,z  )==0 &&
+	       ingredients.getLatticeEntry(x+1,y  ,z  )==0 &&
+	       ingredients.getLatticeEntry(x  ,y+1,z  )==0 &&
+	       ingredients.getLatticeEntry(x  ,y  ,z+1)==0 &&
+	       ingredients.getLatticeEntry(x+1,y+1,z  )==0 &&
+	       ingredients.getLatticeEntry(x+1,y  ,z+1)==0 &&
+	       ingredients.getLatticeEntry(x  ,y+1,z+1)==0 &&
+	       ingredients.getLatticeEntry(x+1,y+1,z+1)==0;
+}
+
+template < class ValueType >
+template < class IngredientsType >
+void LatticeFillScheduler<ValueType>::setCube(IngredientsType& ingredients, const VectorInt3& pos, ValueType value)
+{
+	const int32_t x=pos.getX(), y=pos.getY(), z=pos.getZ();
+	ingredients.setLatticeEntry(x  ,y  ,z  ,value);
+	ingredients.setLatticeEntry(x+1,y  ,z  ,value);
+	ingredients.setLatticeEntry(x  ,y+1,z  ,value);
+	ingredients.setLatticeEntry(x+1,y+1,z  ,value);
+	ingredients.setLatticeEntry(x  ,y  ,z+1,value);
+	ingredients.setLatticeEntry(x+1,y  ,z+1,value);
+	ingredients.setLatticeEntry(x  ,y+1,z+1,value);
+	ingredients.setLatticeEntry(x+1,y+1,z+1,value);
+}
+
+#endif /* LEMONADE_UTILITY_LATTICEFILLSCHEDULER_H */
@@ -30,6 +30,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdexcept>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 /**
  * @brief Basic operation on MonomerGroup
@@ -64,16 +66,19 @@ public:
   const vertex_type& operator[] (int i) const { return (*moleculesGroup)[indices.at(i)];}
 
   void operator += (const MonomerGroup& rhs) {
+    //mark all elements already in the group, so the check below is O(1)
+    int maxIndex=-1;
+    for(size_t i=0;i<indices.size();i++) maxIndex=std::max(maxIndex,indices[i]);
+    for(size_t i=0;i<rhs.indices.size();i++) maxIndex=std::max(maxIndex,rhs.indices[i]);
+    std::vector<bool> isMember(maxIndex+1,false);
+    for(size_t i=0;i<indices.size();i++) isMember[indices[i]]=true;
+
     //loop over all elemtns of right hand side
     for(size_t i=0;i<rhs.indices.size();i++){
-      std::vector<int>::iterator it;
-      for(it=indices.begin();it!=indices.end();++it){
-	//check if element is already there
-	if(*it == rhs.indices.at(i)) break;
-      }
-      if(it==indices.end()){
-	// if not, add element
-	indices.push_back(rhs.indices.at(i));
+      //check if element is already there, if not, add element
+      if(!isMember[rhs.indices[i]]){
+	isMember[rhs.indices[i]]=true;
+	indices.push_back(rhs.indices[i]);
       }
     }
   }
@@ -94,8 +99,30 @@ public:
 
   void clear(){indices.clear();}
 
+  //! copies the coordinates of the group members into x,y,z (resized to size()) without boundary checks
+  template < class T >
+  void gatherCoordinates(std::vector<T>& x, std::vector<T>& y, std::vector<T>& z) const;
+
 };
 
+template<class MoleculesType>
+template<class T>
+void MonomerGroup<MoleculesType>::gatherCoordinates(std::vector<T>& x, std::vector<T>& y, std::vector<T>& z) const
+{
+	const size_t nMonomers=indices.size();
+	x.resize(nMonomers);
+	y.resize(nMonomers);
+	z.resize(nMonomers);
+
+	for(size_t n=0;n<nMonomers;n++)
+	{
+		const vertex_type& monomer=moleculesGroup->getVertexUnchecked(indices[n]);
+		x[n]=T(monomer.getX());
+		y[n]=T(monomer.getY());
+		z[n]=T(monomer.getZ());
+	}
+}
+
 
 template<class MoleculesType>
 MoleculesType MonomerGroup<MoleculesType>::copyGroup() const
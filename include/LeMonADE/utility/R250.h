@@ -89,6 +89,13 @@ public:
 	//! initializes the internal state array with 256 values from argument stateArray.
 	void setState( uint32_t const * stateArray );
 
+	//! number of uint32_t values in the complete state (array and positions of the internal pointers)
+	enum{ FULL_STATE_SIZE=R250_RANDOM_PREFETCH+4 };
+	//! copies the complete state into fullState, which must hold FULL_STATE_SIZE values
+	void getFullState( uint32_t* fullState ) const;
+	//! restores a complete state written by getFullState, such that the sequence continues exactly
+	void setFullState( uint32_t const * fullState );
+
 private:
 	//! applies the random number algorithm to the internal state array (next 256 numbers are generated)
 	void refresh();
@@ -58,6 +58,12 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * Furthermore, the class provides a convenience function for randomly seeding std::rand()
  * from /dev/urandom
  *
+ * A thread can bind its own R250 engine with bindThreadR250(). All calls to
+ * the R250 functions (drawing, seeding, state access) from this thread then
+ * use the bound engine instead of the shared one. This gives independent
+ * streams to simulations running concurrently, e.g. the replicas of a
+ * ReplicaEnsemble.
+ *
  **/
 
 class RandomNumberGenerators
@@ -71,9 +77,9 @@ class RandomNumberGenerators
 
 		//R250Engine
 		//! returns random unsignet 32 bit integer from R250Engine
-		inline uint32_t r250_rand32(){return r250Engine->r250_rand();} //range [0:2e31-1]
+		inline uint32_t r250_rand32(){return activeR250()->r250_rand();} //range [0:2e31-1]
 		//! returns random double from R250Engine
-		inline double r250_drand(){return r250Engine->r250_uniform();} //range [0.0:1.0]
+		inline double r250_drand(){return activeR250()->r250_uniform();} //range [0.0:1.0]
 
 #ifdef RANDOMNUMBERGENERATOR_ENABLE_CPP11
 		//std::mt19937 (32 bit Mersenne Twister)
@@ -98,6 +104,10 @@ class RandomNumberGenerators
 		void seedR250();
 		//! seed R250Engine with array given as argument
 		void seedR250( uint32_t const * seedArray );
+		//! copies the complete R250Engine state (for checkpoints) into state
+		void getR250State( std::vector<uint32_t>& state ) const;
+		//! restores a complete R250Engine state obtained from getR250State
+		void setR250State( std::vector<uint32_t> const & state );
 		//! randomly seed std:rand()
 		void seedSTDRAND();
 		void seedSTDRAND( uint32_t seed );
@@ -105,6 +115,11 @@ class RandomNumberGenerators
         //! initializes all provided RNGs with default values
 		void seedDefaultValuesAll();
 
+		//! binds engine to the calling thread, 0 restores the shared R250Engine
+		static void bindThreadR250( R250* engine ){threadR250Engine=engine;}
+		//! returns the engine bound to the calling thread, or 0 if it uses the shared one
+		static R250* getThreadR250(){return threadR250Engine;}
+
 #ifdef RANDOMNUMBERGENERATOR_ENABLE_CPP11
 		//! randomly seed only Mersenne Twister from /dev/urandom
 		void seedMT();
@@ -122,6 +137,12 @@ class RandomNumberGenerators
 		//! static instance of R250Engine
 		static R250* r250Engine;
 
+		//! engine bound to the current thread, overrides r250Engine if not 0
+		static thread_local R250* threadR250Engine;
+
+		//! returns the engine used by the calling thread
+		static R250* activeR250(){return (threadR250Engine!=0)?threadR250Engine:r250Engine;}
+
 #ifdef RANDOMNUMBERGENERATOR_ENABLE_CPP11
 		static std::mt19937* mt19937Engine;
 #endif /*RANDOMNUMBERGENERATOR_ENABLE_CPP11*/
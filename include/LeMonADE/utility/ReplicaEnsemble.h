@@ -0,0 +1,362 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UTILITY_REPLICAENSEMBLE_H
+#define LEMONADE_UTILITY_REPLICAENSEMBLE_H
+
+#include <stdint.h>
+#include <cstdio>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <LeMonADE/analyzer/AbstractAnalyzer.h>
+#include <LeMonADE/updater/UpdaterSimpleSimulator.h>
+#include <LeMonADE/utility/R250.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/utility/TaskManager.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ *
+ * @class ReplicaEnsemble
+ *
+ * @brief Runs many independent systems (replicas) in one process
+ *
+ * @details Each replica owns a copy of the ingredients it was added with, its
+ * own R250 random number stream and its own TaskManager. The TaskManager
+ * executes an UpdaterSimpleSimulator with \a mcsPerBlock MCS per cycle,
+ * followed by the analyzers added for this replica, such that the analyzer
+ * output stays separated per replica (see replicaFilename()). The simulation
+ * updaters of the replicas do not print their progress, because the lines of
+ * replicas running at the same time would interleave on std::cout.
+ *
+ * run() distributes the replicas over OpenMP threads with dynamic scheduling,
+ * so idle threads pick up the next waiting replica. While a replica runs, its
+ * random number stream is bound to the thread (RandomNumberGenerators::bindThreadR250),
+ * so the moves, updaters and analyzers of the replica draw from its stream
+ * only. The trajectory of every replica is therefore the same for any number
+ * of threads. Read-only tables of the features are shared between the copies
+ * where the features support it (e.g. the lookup tables of FeatureNNInteractionSc).
+ *
+ * Usage:
+ * @code
+ * ReplicaEnsemble<Ing,MoveLocalSc> ensemble(100);
+ * for(int i=0;i<64;i++){
+ *   size_t r=ensemble.addReplica(ingredients);
+ *   ensemble.addAnalyzer(r,new AnalyzerWriteBfmFile<Ing>(ensemble.replicaFilename("config.bfm",r),ensemble.getReplica(r)));
+ * }
+ * ensemble.initialize();
+ * ensemble.run(1000);
+ * ensemble.cleanup();
+ * @endcode
+ *
+ * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
+ * @tparam MoveType name of the specialized move.
+ */
+/*****************************************************************************/
+template<class IngredientsType,class MoveType>
+class ReplicaEnsemble
+{
+public:
+
+  //! sets up an empty ensemble executing mcsPerBlock MCS per cycle of each replica
+  ReplicaEnsemble(uint32_t mcsPerBlock):nMcsPerBlock(mcsPerBlock){}
+
+  ~ReplicaEnsemble();
+
+  //! adds a copy of ingredients as new replica, seeding its stream from the current random number stream
+  size_t addReplica(const IngredientsType& ingredients);
+
+  //! adds a copy of ingredients as new replica, seeding its stream with R250_RANDOM_PREFETCH values
+  size_t addReplica(const IngredientsType& ingredients, const std::vector<uint32_t>& seeds);
+
+  //! adds an analyzer to replica i. The ensemble takes ownership of the analyzer
+  void addAnalyzer(size_t i, AbstractAnalyzer* analyzer, int period=1){replicas.at(i)->tasks.addAnalyzer(analyzer,period);}
+
+  //! adds an updater to replica i, executed after the simulation updater. The ensemble takes ownership
+  void addUpdater(size_t i, AbstractUpdater* updater, int period=1){replicas.at(i)->tasks.addUpdater(updater,period);}
+
+  //! number of replicas
+  size_t getNReplicas() const {return replicas.size();}
+
+  //! ingredients of replica i
+  IngredientsType& getReplica(size_t i){return replicas.at(i)->ingredients;}
+  const IngredientsType& getReplica(size_t i) const {return replicas.at(i)->ingredients;}
+
+  //! random number stream of replica i
+  R250& getRandomStream(size_t i){return replicas.at(i)->rng;}
+
+  //! number of moves attempted by the simulation updaters of all replicas
+  uint64_t getNAttemptedMoves() const;
+
+  //! number of moves accepted by the simulation updaters of all replicas
+  uint64_t getNAcceptedMoves() const;
+
+  //! synchronizes all replicas and initializes their analyzers
+  void initialize();
+
+  //! executes nBlocks cycles of every replica
+  void run(uint32_t nBlocks);
+
+  //! calls the cleanup routines of the analyzers of all replicas
+  void cleanup();
+
+  //! inserts tag and the replica number before the file extension, e.g. config.bfm -> config_r0003.bfm
+  static std::string replicaFilename(const std::string& filename, size_t i, const std::string& tag="_r");
+
+private:
+
+  //! everything owned by a single replica
+  struct Replica
+  {
+    Replica(const IngredientsType& ingredients_):ingredients(ingredients_),simulator(0){}
+
+    IngredientsType ingredients;
+    R250 rng;
+    TaskManager tasks;
+
+    //! the simulation updater, owned by tasks
+    UpdaterSimpleSimulator<IngredientsType,MoveType>* simulator;
+  };
+
+  //! runs operation on every replica with its stream bound to the executing thread
+  template<class Operation>
+  void forEachReplica(Operation operation);
+
+  //! binds a stream to the executing thread and restores the previously bound one when going out of scope
+  class ThreadR250Binding
+  {
+  public:
+    ThreadR250Binding(R250* engine):previousEngine(RandomNumberGenerators::getThreadR250())
+    {RandomNumberGenerators::bindThreadR250(engine);}
+    ~ThreadR250Binding(){RandomNumberGenerators::bindThreadR250(previousEngine);}
+  private:
+    R250* previousEngine;
+  };
+
+  //! executes nBlocks cycles of a replica
+  struct RunBlocks
+  {
+    RunBlocks(uint32_t nBlocks_):nBlocks(nBlocks_){}
+    void operator()(Replica& replica) const {replica.tasks.run(nBlocks);}
+    uint32_t nBlocks;
+  };
+
+  //! synchronizes a replica and initializes its tasks
+  struct InitializeReplica
+  {
+    void operator()(Replica& replica) const {replica.ingredients.synchronize(); replica.tasks.initialize();}
+  };
+
+  //! cleans up the tasks of a replica
+  struct CleanupReplica
+  {
+    void operator()(Replica& replica) const {replica.tasks.cleanup();}
+  };
+
+  uint32_t nMcsPerBlock;
+
+  //! replicas are kept by pointer, because the updaters refer to their ingredients
+  std::vector<Replica*> replicas;
+
+  //no copies, the ensemble owns the replicas
+  ReplicaEnsemble(const ReplicaEnsemble&);
+  ReplicaEnsemble& operator=(const ReplicaEnsemble&);
+};
+
+/*****************************************************************************/
+//members of class ReplicaEnsemble
+/*****************************************************************************/
+
+template<class IngredientsType,class MoveType>
+ReplicaEnsemble<IngredientsType,MoveType>::~ReplicaEnsemble()
+{
+  for(size_t i=0;i<replicas.size();i++)
+    delete replicas[i];
+}
+
+/**
+ * @details The seeds are drawn from the stream of the calling thread, so
+ * seeding the RandomNumberGenerators once makes the whole ensemble reproducible.
+ * @param ingredients system to be copied into the new replica
+ * @return index of the new replica
+ */
+template<class IngredientsType,class MoveType>
+size_t ReplicaEnsemble<IngredientsType,MoveType>::addReplica(const IngredientsType& ingredients)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> seeds(R250_RANDOM_PREFETCH);
+  for(size_t n=0;n<seeds.size();n++)
+    seeds[n]=rng.r250_rand32();
+
+  return addReplica(ingredients,seeds);
+}
+
+/**
+ * @param ingredients system to be copied into the new replica
+ * @param seeds R250_RANDOM_PREFETCH random values used as initial state of the stream
+ * @return index of the new replica
+ * @throw std::runtime_error if the number of seeds is wrong
+ */
+template<class IngredientsType,class MoveType>
+size_t ReplicaEnsemble<IngredientsType,MoveType>::addReplica(const IngredientsType& ingredients,
+								 const std::vector<uint32_t>& seeds)
+{
+  if(seeds.size()!=R250_RANDOM_PREFETCH)
+  {
+    std::stringstream errormessage;
+    errormessage<<"ReplicaEnsemble::addReplica: expected "<<R250_RANDOM_PREFETCH<<" seeds, got "<<seeds.size();
+    throw std::runtime_error(errormessage.str());
+  }
+
+  Replica* replica=new Replica(ingredients);
+
+  //same as R250::setState, i.e. the seeds are refreshed before the first number
+  //is drawn, but without printing the state
+  std::vector<uint32_t> state(seeds);
+  state.push_back(R250_RANDOM_PREFETCH);
+  state.push_back(250);
+  state.push_back(250-147);
+  state.push_back(0);
+  replica->rng.setFullState(&state[0]);
+
+  replica->simulator=new UpdaterSimpleSimulator<IngredientsType,MoveType>(replica->ingredients,nMcsPerBlock);
+  replica->simulator->setPrintProgress(false);
+  replica->tasks.addUpdater(replica->simulator);
+  replicas.push_back(replica);
+
+  return replicas.size()-1;
+}
+
+template<class IngredientsType,class MoveType>
+uint64_t ReplicaEnsemble<IngredientsType,MoveType>::getNAttemptedMoves() const
+{
+  uint64_t nMoves=0;
+  for(size_t i=0;i<replicas.size();i++)
+    nMoves+=replicas[i]->simulator->getNAttemptedMoves();
+  return nMoves;
+}
+
+template<class IngredientsType,class MoveType>
+uint64_t ReplicaEnsemble<IngredientsType,MoveType>::getNAcceptedMoves() const
+{
+  uint64_t nMoves=0;
+  for(size_t i=0;i<replicas.size();i++)
+    nMoves+=replicas[i]->simulator->getNAcceptedMoves();
+  return nMoves;
+}
+
+template<class IngredientsType,class MoveType>
+void ReplicaEnsemble<IngredientsType,MoveType>::initialize()
+{
+  forEachReplica(InitializeReplica());
+}
+
+/**
+ * @param nBlocks number of cycles, i.e. nBlocks*mcsPerBlock MCS per replica
+ */
+template<class IngredientsType,class MoveType>
+void ReplicaEnsemble<IngredientsType,MoveType>::run(uint32_t nBlocks)
+{
+  forEachReplica(RunBlocks(nBlocks));
+}
+
+template<class IngredientsType,class MoveType>
+void ReplicaEnsemble<IngredientsType,MoveType>::cleanup()
+{
+  forEachReplica(CleanupReplica());
+}
+
+template<class IngredientsType,class MoveType>
+std::string ReplicaEnsemble<IngredientsType,MoveType>::replicaFilename(const std::string& filename, size_t i, const std::string& tag)
+{
+  char number[32];
+  std::snprintf(number,sizeof(number),"%04lu",(unsigned long)i);
+
+  size_t dot=filename.find_last_of('.');
+  size_t slash=filename.find_last_of('/');
+  if(dot==std::string::npos || (slash!=std::string::npos && dot<slash))
+    return filename+tag+number;
+
+  return filename.substr(0,dot)+tag+number+filename.substr(dot);
+}
+
+/**
+ * @details Exceptions thrown by a replica are collected and rethrown after
+ * all threads have finished, because they must not leave the parallel region.
+ * The thread is bound to its previous stream again in any case.
+ * @throw std::runtime_error with the message of the first failing replica
+ */
+template<class IngredientsType,class MoveType>
+template<class Operation>
+void ReplicaEnsemble<IngredientsType,MoveType>::forEachReplica(Operation operation)
+{
+  const int32_t nReplicas=int32_t(replicas.size());
+  int32_t firstFailure=nReplicas;
+  std::string failureMessage;
+
+  #pragma omp parallel for schedule(dynamic,1)
+  for(int32_t i=0;i<nReplicas;i++)
+  {
+    ThreadR250Binding binding(&(replicas[i]->rng));
+    bool failed=false;
+    std::string message;
+    try{
+      operation(*replicas[i]);
+    }
+    catch(std::exception& e){
+      failed=true;
+      message=e.what();
+    }
+    catch(...){
+      failed=true;
+      message="unknown exception";
+    }
+    if(failed){
+      #pragma omp critical(ReplicaEnsembleFailure)
+      {
+	if(i<firstFailure){
+	  firstFailure=i;
+	  failureMessage=message;
+	}
+      }
+    }
+  }
+
+  if(firstFailure<nReplicas)
+  {
+    std::stringstream errormessage;
+    errormessage<<"ReplicaEnsemble: replica "<<firstFailure<<" failed:\n"<<failureMessage;
+    throw std::runtime_error(errormessage.str());
+  }
+}
+
+#endif /* LEMONADE_UTILITY_REPLICAENSEMBLE_H */
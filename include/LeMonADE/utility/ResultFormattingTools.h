@@ -37,6 +37,9 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdexcept>
 #include <limits>
 #include <iomanip>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
 
 
 /**
@@ -47,6 +50,15 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  * @brief Helper function for formating and writing text output
  *
  * @details It provides IO-operation, writing all system information and the used Feature.
+ * Two output formats are available:
+ * - TextFormat: tab separated columns with a commented header. The rows are
+ *   formatted into one buffer without iostreams and written in a single call.
+ * - BinaryFormat: raw column blocks behind a small header (see writeBinaryResultFile()).
+ *   Appending a block only writes the block, so high frequency observables can
+ *   be dumped at the cost of a memcpy.
+ *
+ * Most functions take an optional first column (usually the mcs times), such that
+ * callers storing it separately from the data do not have to copy the results.
  *
  * @tparam IngredientsType Ingredients class storing all system information( e.g. monomers, bonds, etc).
  *
@@ -61,6 +73,45 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  **/
 namespace ResultFormattingTools {
 
+//! output formats for writeOutputFile() and appendToOutputFile()
+enum OutputFormat { TextFormat, BinaryFormat };
+
+//! format used by analyzers which are not explicitly configured (initially TextFormat)
+OutputFormat getDefaultOutputFormat();
+
+//! sets the format used by analyzers which are not explicitly configured
+void setDefaultOutputFormat(OutputFormat format);
+
+/**
+ * @brief Returns the name of the file written for filename in the given format.
+ *
+ * @details Text files use filename as it is. Binary files get the extension
+ * ".bin" appended (unless filename already ends with it), such that they can
+ * not be mistaken for text files of the same analyzer.
+ */
+std::string outputFilename(OutputFormat format, const std::string& filename);
+
+/**
+ * @brief Appends the text representation of value to buffer.
+ *
+ * @details Floating point values are written in fixed notation with max_digits10
+ * digits after the decimal point, integers without any decimals. This is
+ * the same result as with a default constructed std::ostream.
+ */
+template<class T>
+void formatValue(std::string& buffer, T value);
+
+/**
+ * @brief Appends all rows of the results to buffer, columns separated by tabs.
+ *
+ * @param buffer string the rows are appended to
+ * @param results List of results to format and write
+ * @param firstColumn if not NULL, written as first column in front of results
+ */
+template<class ResultType>
+void formatRows(std::string& buffer, const ResultType& results,
+		const typename ResultType::value_type* firstColumn=NULL);
+
 /**
  * @brief Writes all given results into a given stream as table.
  *
@@ -70,7 +121,7 @@ namespace ResultFormattingTools {
  */
 template<class ResultType>
 void writeTable(std::ostream& stream,
-		ResultType results, std::string comment = "\n");
+		const ResultType& results, std::string comment = "\n");
 
 /**
  * @brief Adding a comment to the stream.
@@ -88,7 +139,13 @@ void addComment(std::stringstream& stream);
  */
 template<class IngredientsType, class ResultType>
 void writeResultFile(std::string filename,const IngredientsType& ingredients,
-		ResultType& results, std::string comment = "\n");
+		const ResultType& results, std::string comment = "\n");
+
+//! same as above, with firstColumn written in front of results
+template<class IngredientsType, class ResultType>
+void writeResultFile(std::string filename,const IngredientsType& ingredients,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results, std::string comment = "\n");
 
 /**
  * @brief Appends all given results into a given stream as formatted output.
@@ -97,37 +154,234 @@ void writeResultFile(std::string filename,const IngredientsType& ingredients,
  * @param results List of results to format and write
  */
 template<class ResultType>
-void appendToResultFile(std::string filename,ResultType& results);
-}
+void appendToResultFile(std::string filename,const ResultType& results);
 
+//! same as above, with firstColumn written in front of results
+template<class ResultType>
+void appendToResultFile(std::string filename,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results);
 
+/**
+ * @brief Creates a binary result file holding the header and the first block of results.
+ *
+ * @details Layout (host byte order):
+ * - char[8] magic "LMDCOLS" (null terminated)
+ * - uint32_t format version, currently 1
+ * - uint32_t number of columns
+ * - uint32_t size of one value in bytes
+ * - uint32_t kind of value: 0 unsigned integer, 1 signed integer, 2 floating point
+ * - uint64_t length of the header text, followed by the text itself
+ *   (meta data of the ingredients and the comment, as in the text format)
+ *
+ * followed by any number of blocks, each consisting of a uint64_t number of
+ * rows followed by the values of the columns one after the other.
+ *
+ * @param filename Specify the name of the output-file.
+ * @param ingredients A reference to the IngredientsType - mainly the system
+ * @param firstColumn if not NULL, written as first column in front of results
+ * @param results List of results to write
+ * @param comment Additional comments for the output
+ */
+template<class IngredientsType, class ResultType>
+void writeBinaryResultFile(std::string filename,const IngredientsType& ingredients,
+		const typename ResultType::value_type* firstColumn,
+		const ResultType& results, std::string comment = "\n");
 
+/**
+ * @brief Appends one block of results to a file created by writeBinaryResultFile()
+ *
+ * @param filename Specify the name of the output-file.
+ * @param firstColumn if not NULL, written as first column in front of results
+ * @param results List of results to write
+ */
+template<class ResultType>
+void appendToBinaryResultFile(std::string filename,
+		const typename ResultType::value_type* firstColumn,
+		const ResultType& results);
 
+/**
+ * @brief Reads all blocks of a file written by writeBinaryResultFile() into columns.
+ *
+ * @param filename Name of the input-file.
+ * @param columns is resized to the number of columns in the file
+ * @param header if not NULL, the header text is stored here
+ */
+template<class T>
+void readBinaryResultFile(std::string filename,
+		std::vector<std::vector<T> >& columns, std::string* header=NULL);
+
+/**
+ * @brief Creates the output file in the given format. See writeResultFile() and writeBinaryResultFile()
+ *
+ * @details The binary file is named outputFilename(BinaryFormat,filename).
+ */
+template<class IngredientsType, class ResultType>
+void writeOutputFile(OutputFormat format, std::string filename,const IngredientsType& ingredients,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results, std::string comment = "\n");
 
+/**
+ * @brief Appends to the output file in the given format. See appendToResultFile() and appendToBinaryResultFile()
+ */
 template<class ResultType>
-void ResultFormattingTools::writeTable(std::ostream& stream,
-		ResultType results, std::string comment) {
+void appendToOutputFile(OutputFormat format, std::string filename,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results);
+}
 
-	std::stringstream commentStream(comment);
-	addComment(commentStream);
-	stream << commentStream.str() << std::endl;
+/*****************************************************************************/
+//internal helpers
+/*****************************************************************************/
+namespace ResultFormattingTools {
+namespace detail {
+
+//! formatting and binary type code of floating point values
+template<class T, bool isInteger=std::numeric_limits<T>::is_integer>
+struct ValueTraits
+{
+	enum{ kind=2 };
+
+	static void format(std::string& buffer, T value)
+	{
+		char tmp[64];
+		const int digits=std::numeric_limits<T>::max_digits10;
+		int n=std::snprintf(tmp,sizeof(tmp),"%.*Lf",digits,static_cast<long double>(value));
+		if(n<0)
+			throw std::runtime_error("ResultFormattingTools::formatValue(): formatting error\n");
+
+		if(size_t(n)<sizeof(tmp)){
+			buffer.append(tmp,n);
+		}
+		//very large numbers in fixed notation
+		else{
+			std::vector<char> large(n+1);
+			std::snprintf(&large[0],large.size(),"%.*Lf",digits,static_cast<long double>(value));
+			buffer.append(&large[0],n);
+		}
+	}
+};
+
+//! formatting and binary type code of integer values
+template<class T>
+struct ValueTraits<T,true>
+{
+	enum{ kind=(std::numeric_limits<T>::is_signed ? 1 : 0) };
+
+	static void format(std::string& buffer, T value)
+	{
+		char tmp[24];
+		char* end=tmp+sizeof(tmp);
+		char* begin=end;
+
+		//work on the absolute value as unsigned, which is safe for the minimum value
+		bool negative=(value<T(0));
+		unsigned long long absValue=negative ? 0ULL-static_cast<unsigned long long>(value)
+						     : static_cast<unsigned long long>(value);
+		do{
+			*--begin=char('0'+absValue%10);
+			absValue/=10;
+		}while(absValue!=0);
+
+		if(negative) *--begin='-';
+		buffer.append(begin,end-begin);
+	}
+};
+
+//! character types are written as characters, as by std::ostream
+template<class T>
+struct CharValueTraits
+{
+	enum{ kind=(std::numeric_limits<T>::is_signed ? 1 : 0) };
 
-	//check if all column have the same size
-	size_t columnSize = results[0].size();
+	static void format(std::string& buffer, T value)
+	{
+		buffer+=char(value);
+	}
+};
+
+template<> struct ValueTraits<char,true>:public CharValueTraits<char>{};
+template<> struct ValueTraits<signed char,true>:public CharValueTraits<signed char>{};
+template<> struct ValueTraits<unsigned char,true>:public CharValueTraits<unsigned char>{};
+
+//! checks that all columns have the size of the first one (or firstColumn, if given)
+template<class ResultType>
+size_t checkColumnSizes(const ResultType& results,
+			const typename ResultType::value_type* firstColumn,
+			const std::string& caller)
+{
+	if(results.size()==0 && firstColumn==NULL)
+		throw std::runtime_error("ResultFormattingTools::"+caller+"(): no columns given\n");
+
+	size_t columnSize=(firstColumn!=NULL) ? firstColumn->size() : results[0].size();
 	for (size_t i = 0; i < results.size(); ++i) {
-		if (results[i].size() != columnSize)
-			throw std::runtime_error("ResultFormattingTools::writeTable():Columns do not have the same size\n");
+		if (results[i].size() != columnSize){
+			std::stringstream errormessage;
+			errormessage<<"ResultFormattingTools::"<<caller<<"():Columns do not have the same size\n";
+			errormessage<<"first colums size "<<columnSize<<" column no "<<i<<" size "<<results[i].size()<<std::endl;
+			throw std::runtime_error(errormessage.str());
+		}
 	}
+	return columnSize;
+}
 
-	for (size_t row = 0; row < results[0].size(); ++row) {
+//! writes one block of the binary format to file
+template<class ResultType>
+void writeBinaryBlock(std::ofstream& file, const ResultType& results,
+		      const typename ResultType::value_type* firstColumn)
+{
+	typedef typename ResultType::value_type::value_type value_type;
+
+	uint64_t nRows=checkColumnSizes(results,firstColumn,"writeBinaryBlock");
+	file.write(reinterpret_cast<const char*>(&nRows),sizeof(nRows));
+	if(nRows==0) return;
+
+	if(firstColumn!=NULL)
+		file.write(reinterpret_cast<const char*>(&(*firstColumn)[0]),nRows*sizeof(value_type));
+	for(size_t column=0;column<results.size();++column)
+		file.write(reinterpret_cast<const char*>(&results[column][0]),nRows*sizeof(value_type));
+}
+
+}//end namespace detail
+}//end namespace ResultFormattingTools
+
+
+template<class T>
+void ResultFormattingTools::formatValue(std::string& buffer, T value)
+{
+	detail::ValueTraits<T>::format(buffer,value);
+}
+
+template<class ResultType>
+void ResultFormattingTools::formatRows(std::string& buffer, const ResultType& results,
+		const typename ResultType::value_type* firstColumn)
+{
+	size_t nRows=detail::checkColumnSizes(results,firstColumn,"formatRows");
+
+	for (size_t row = 0; row < nRows; ++row) {
+		if(firstColumn!=NULL){
+			formatValue(buffer,(*firstColumn)[row]);
+			buffer+='\t';
+		}
 		for (size_t column = 0; column < results.size(); ++column) {
-                        stream.precision(std::numeric_limits<typename ResultType::value_type::value_type>::max_digits10);
-                        stream.setf( std::ios::fixed, std:: ios::floatfield );
-			stream << results[column][row] << "\t";
+			formatValue(buffer,results[column][row]);
+			buffer+='\t';
 		}
-		stream << std::endl;
+		buffer+='\n';
 	}
+}
+
+template<class ResultType>
+void ResultFormattingTools::writeTable(std::ostream& stream,
+		const ResultType& results, std::string comment) {
+
+	std::stringstream commentStream(comment);
+	addComment(commentStream);
+	stream << commentStream.str() << std::endl;
 
+	std::string rows;
+	formatRows(rows,results);
+	stream.write(rows.data(),rows.size());
 }
 
 
@@ -135,7 +389,7 @@ void ResultFormattingTools::writeTable(std::ostream& stream,
 
 template<class IngredientsType, class ResultType>
 void ResultFormattingTools::writeResultFile(std::string filename,const IngredientsType& ingredients,
-		ResultType& results, std::string comment) {
+		const ResultType& results, std::string comment) {
 
 	std::ofstream file;
 	file.open(filename.c_str());
@@ -157,8 +411,42 @@ void ResultFormattingTools::writeResultFile(std::string filename,const Ingredien
 	file.close();
 }
 
+template<class IngredientsType, class ResultType>
+void ResultFormattingTools::writeResultFile(std::string filename,const IngredientsType& ingredients,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results, std::string comment) {
+
+	std::ofstream file;
+	file.open(filename.c_str());
+
+	if(!file.is_open())
+		throw std::runtime_error("ResultFormattingTools::writeResultFile(): error opening output file"+filename+"\n");
+	std::stringstream contents;
+
+	// write Header
+
+	ingredients.printMetaData(contents);
+
+	addComment(contents);
+
+	std::stringstream commentStream(comment);
+	addComment(commentStream);
+	contents << commentStream.str() << std::endl;
+
+	file << contents.str();
+
+	std::string rows;
+	formatRows(rows,results,&firstColumn);
+	file.write(rows.data(),rows.size());
+
+	file.close();
+}
+
 template<class ResultType>
-void ResultFormattingTools::appendToResultFile(std::string filename,ResultType& results) {
+void ResultFormattingTools::appendToResultFile(std::string filename,const ResultType& results) {
+
+	std::string rows;
+	formatRows(rows,results);
 
 	std::ofstream file;
 	file.open(filename.c_str(),std::ios_base::app);
@@ -166,28 +454,155 @@ void ResultFormattingTools::appendToResultFile(std::string filename,ResultType&
 	if(!file.is_open())
 		throw std::runtime_error("ResultFormattingTools::appendToResultFile(): error opening output file"+filename+"\n");
 
-	//check if all column have the same size
-	size_t columnSize = results[0].size();
-	for (size_t i = 0; i < results.size(); ++i) {
-		if (results[i].size() != columnSize){
-			std::stringstream errormessage;
-			errormessage<<"ResultFormattingTools::appendToResultFile():Columns do not have the same size\n";
-			errormessage<<"first colums size "<<columnSize<<" column no "<<i<<" size "<<results[i].size()<<std::endl;
-			throw std::runtime_error(errormessage.str());
-		}
-	}
+	file.write(rows.data(),rows.size());
+	file.close();
+}
 
-	//write content
-	for (size_t row = 0; row < results[0].size(); ++row) {
-		for (size_t column = 0; column < results.size(); ++column) {
-                        file.precision(std::numeric_limits<typename ResultType::value_type::value_type>::max_digits10);
-                        file.setf( std::ios::fixed, std:: ios::floatfield );
-			file << results[column][row] << "\t";
+template<class ResultType>
+void ResultFormattingTools::appendToResultFile(std::string filename,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results) {
+
+	std::string rows;
+	formatRows(rows,results,&firstColumn);
+
+	std::ofstream file;
+	file.open(filename.c_str(),std::ios_base::app);
+
+	if(!file.is_open())
+		throw std::runtime_error("ResultFormattingTools::appendToResultFile(): error opening output file"+filename+"\n");
+
+	file.write(rows.data(),rows.size());
+	file.close();
+}
+
+template<class IngredientsType, class ResultType>
+void ResultFormattingTools::writeBinaryResultFile(std::string filename,const IngredientsType& ingredients,
+		const typename ResultType::value_type* firstColumn,
+		const ResultType& results, std::string comment) {
+
+	typedef typename ResultType::value_type::value_type value_type;
+
+	std::ofstream file;
+	file.open(filename.c_str(),std::ios_base::binary);
+
+	if(!file.is_open())
+		throw std::runtime_error("ResultFormattingTools::writeBinaryResultFile(): error opening output file"+filename+"\n");
+
+	//header text, same content as in the text format
+	std::stringstream contents;
+	ingredients.printMetaData(contents);
+	addComment(contents);
+	std::stringstream commentStream(comment);
+	addComment(commentStream);
+	contents << commentStream.str();
+	std::string headerText=contents.str();
+
+	const char magic[8]="LMDCOLS";
+	uint32_t version=1;
+	uint32_t nColumns=uint32_t(results.size()+(firstColumn!=NULL ? 1 : 0));
+	uint32_t valueSize=sizeof(value_type);
+	uint32_t valueKind=detail::ValueTraits<value_type>::kind;
+	uint64_t headerLength=headerText.size();
+
+	file.write(magic,sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&version),sizeof(version));
+	file.write(reinterpret_cast<const char*>(&nColumns),sizeof(nColumns));
+	file.write(reinterpret_cast<const char*>(&valueSize),sizeof(valueSize));
+	file.write(reinterpret_cast<const char*>(&valueKind),sizeof(valueKind));
+	file.write(reinterpret_cast<const char*>(&headerLength),sizeof(headerLength));
+	file.write(headerText.data(),headerText.size());
+
+	detail::writeBinaryBlock(file,results,firstColumn);
+
+	file.close();
+}
+
+template<class ResultType>
+void ResultFormattingTools::appendToBinaryResultFile(std::string filename,
+		const typename ResultType::value_type* firstColumn,
+		const ResultType& results) {
+
+	std::ofstream file;
+	file.open(filename.c_str(),std::ios_base::app | std::ios_base::binary);
+
+	if(!file.is_open())
+		throw std::runtime_error("ResultFormattingTools::appendToBinaryResultFile(): error opening output file"+filename+"\n");
+
+	detail::writeBinaryBlock(file,results,firstColumn);
+
+	file.close();
+}
+
+template<class T>
+void ResultFormattingTools::readBinaryResultFile(std::string filename,
+		std::vector<std::vector<T> >& columns, std::string* header) {
+
+	std::ifstream file;
+	file.open(filename.c_str(),std::ios_base::binary);
+
+	if(!file.is_open())
+		throw std::runtime_error("ResultFormattingTools::readBinaryResultFile(): error opening input file"+filename+"\n");
+
+	char magic[8];
+	uint32_t version, nColumns, valueSize, valueKind;
+	uint64_t headerLength;
+
+	file.read(magic,sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version),sizeof(version));
+	file.read(reinterpret_cast<char*>(&nColumns),sizeof(nColumns));
+	file.read(reinterpret_cast<char*>(&valueSize),sizeof(valueSize));
+	file.read(reinterpret_cast<char*>(&valueKind),sizeof(valueKind));
+	file.read(reinterpret_cast<char*>(&headerLength),sizeof(headerLength));
+
+	if(!file || std::strncmp(magic,"LMDCOLS",sizeof(magic))!=0 || version!=1)
+		throw std::runtime_error("ResultFormattingTools::readBinaryResultFile(): "+filename+" is not a binary result file\n");
+	if(valueSize!=sizeof(T) || valueKind!=uint32_t(detail::ValueTraits<T>::kind))
+		throw std::runtime_error("ResultFormattingTools::readBinaryResultFile(): value type does not match the file "+filename+"\n");
+
+	std::string headerText(headerLength,'\0');
+	if(headerLength>0)
+		file.read(&headerText[0],headerLength);
+	if(header!=NULL)
+		header->swap(headerText);
+
+	columns.assign(nColumns,std::vector<T>(0));
+
+	uint64_t nRows;
+	while(file.read(reinterpret_cast<char*>(&nRows),sizeof(nRows)))
+	{
+		for(size_t column=0;column<nColumns;++column)
+		{
+			size_t offset=columns[column].size();
+			columns[column].resize(offset+nRows);
+			if(nRows>0)
+				file.read(reinterpret_cast<char*>(&columns[column][offset]),nRows*sizeof(T));
 		}
-		file << std::endl;
+		if(!file)
+			throw std::runtime_error("ResultFormattingTools::readBinaryResultFile(): truncated block in "+filename+"\n");
 	}
+}
 
-	file.close();
+template<class IngredientsType, class ResultType>
+void ResultFormattingTools::writeOutputFile(OutputFormat format, std::string filename,const IngredientsType& ingredients,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results, std::string comment) {
+
+	if(format==BinaryFormat)
+		writeBinaryResultFile(outputFilename(format,filename),ingredients,&firstColumn,results,comment);
+	else
+		writeResultFile(filename,ingredients,firstColumn,results,comment);
+}
+
+template<class ResultType>
+void ResultFormattingTools::appendToOutputFile(OutputFormat format, std::string filename,
+		const typename ResultType::value_type& firstColumn,
+		const ResultType& results) {
+
+	if(format==BinaryFormat)
+		appendToBinaryResultFile(outputFilename(format,filename),&firstColumn,results);
+	else
+		appendToResultFile(filename,firstColumn,results);
 }
 
 #endif /* LEMONADE_UTILITY_RESULTFORMATTINGTOOLS_H */
@@ -88,6 +88,9 @@ public:
 	//! Check if a vector is a valid bond-vector (i.e. part of the set)
 	bool isValidStrongCheck(const VectorInt3& bondVector ) const;
 
+	//! Not supported by SlowBondset, throws an exception
+	bool isValidIndexStrongCheck(uint32_t bondIndex) const;
+
 private:
 
   //! lookup table telling if a certain bondvector is valid
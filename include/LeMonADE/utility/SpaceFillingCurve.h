@@ -0,0 +1,113 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UTILITY_SPACEFILLINGCURVE_H
+#define LEMONADE_UTILITY_SPACEFILLINGCURVE_H
+
+#include <stdint.h>
+
+/***********************************************************/
+/**
+ * @file
+ * @brief Keys of lattice positions along three dimensional space filling curves
+ *
+ * @details Sorting positions by these keys orders them such that positions
+ * close along the curve are close in space. Both functions take coordinates
+ * in [0,2^bits) with bits<=21, such that the key fits into 64 bits.
+ * The Morton (Z-order) key simply interleaves the bits of the coordinates.
+ * The Hilbert key additionally guarantees that consecutive keys belong to
+ * neighboring lattice sites, which avoids the long jumps of the Z-order curve
+ * at the borders of its octants.
+ */
+/***********************************************************/
+
+//! spreads the lowest 21 bits of v such that two zero bits follow each bit
+inline uint64_t spreadBits3D(uint32_t v)
+{
+	uint64_t x=v&0x1fffff;
+	x=(x|(x<<32))&0x1f00000000ffffULL;
+	x=(x|(x<<16))&0x1f0000ff0000ffULL;
+	x=(x|(x<<8)) &0x100f00f00f00f00fULL;
+	x=(x|(x<<4)) &0x10c30c30c30c30c3ULL;
+	x=(x|(x<<2)) &0x1249249249249249ULL;
+	return x;
+}
+
+//! Morton (Z-order) key of the lattice position (x,y,z), x being the most significant coordinate
+inline uint64_t mortonKey3D(uint32_t x, uint32_t y, uint32_t z)
+{
+	return (spreadBits3D(x)<<2)|(spreadBits3D(y)<<1)|spreadBits3D(z);
+}
+
+/**
+ * @brief Hilbert key of the lattice position (x,y,z) on a cube of edge 2^bits
+ *
+ * @details Uses the transposition algorithm of J. Skilling,
+ * AIP Conf. Proc. 707, 381 (2004): the coordinates are transformed in place
+ * into the transposed Hilbert index, whose bits are then interleaved.
+ */
+inline uint64_t hilbertKey3D(uint32_t x, uint32_t y, uint32_t z, uint32_t bits)
+{
+	if(bits==0) return 0;
+
+	uint32_t X[3]={x,y,z};
+	const uint32_t M=uint32_t(1)<<(bits-1);
+
+	//inverse undo of the excess work
+	for(uint32_t Q=M;Q>1;Q>>=1)
+	{
+		const uint32_t P=Q-1;
+		for(int i=0;i<3;i++)
+		{
+			if(X[i]&Q) X[0]^=P;
+			else{
+				uint32_t t=(X[0]^X[i])&P;
+				X[0]^=t;
+				X[i]^=t;
+			}
+		}
+	}
+
+	//Gray encode
+	X[1]^=X[0];
+	X[2]^=X[1];
+	uint32_t t=0;
+	for(uint32_t Q=M;Q>1;Q>>=1)
+		if(X[2]&Q) t^=Q-1;
+	X[0]^=t; X[1]^=t; X[2]^=t;
+
+	//interleave the transposed index, most significant bits first
+	uint64_t key=0;
+	for(int b=int(bits)-1;b>=0;b--)
+		for(int i=0;i<3;i++)
+			key=(key<<1)|((X[i]>>b)&1);
+
+	return key;
+}
+
+#endif /* LEMONADE_UTILITY_SPACEFILLINGCURVE_H */
@@ -37,10 +37,13 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 #include <list>
+#include <string>
+#include <typeinfo>
 #include <vector>
 
 #include <LeMonADE/analyzer/AbstractAnalyzer.h>
 #include <LeMonADE/updater/AbstractUpdater.h>
+#include <LeMonADE/utility/TaskTelemetry.h>
 
 using std::vector;
 
@@ -84,6 +87,14 @@ public:
   //! Calles cleanup() routine on all updater- and analyzer-objects
   void cleanup();
 
+  //! Writes timing and move statistics of all tasks to filename every period circles
+  void enableTelemetry(const std::string& filename, int period=1,
+		       TaskTelemetry::Format format=TaskTelemetry::JSONLines,
+		       bool hardwareCounters=false);
+
+  //! Statistics of the tasks, indexed in the order the updaters and analyzers were added
+  const TaskTelemetry& getTelemetry() const {return telemetry;}
+
 private:
 
   //! Holds an analyzer and executes it with period execution_period
@@ -102,6 +113,15 @@ private:
 
   //! nCircles counter for execution loops
   int nCircles;
+
+  //! Timing and move statistics, disabled unless enableTelemetry() is called
+  TaskTelemetry telemetry;
+
+  //! Executes the updater, measured by the telemetry if enabled
+  bool executeUpdater(UpdaterObject* u);
+
+  //! Executes the analyzer, measured by the telemetry if enabled
+  void executeAnalyzer(AnalyzerObject* a);
 };
 
 /*****************************************************************************/
@@ -116,8 +136,8 @@ private:
  **/
 class TaskManager::AnalyzerObject{
 public:
-  AnalyzerObject(AbstractAnalyzer* a,unsigned int period)
-    :myAnalyzer(a),execution_period(period),isFirstExecution(true){};
+  AnalyzerObject(AbstractAnalyzer* a,unsigned int period,size_t telemetryIndex_)
+    :myAnalyzer(a),execution_period(period),isFirstExecution(true),telemetryIndex(telemetryIndex_){};
 
   ~AnalyzerObject(){delete myAnalyzer;};
 
@@ -134,6 +154,9 @@ public:
   //! Calls the analyzer's cleanup routine
   void cleanup(){myAnalyzer->cleanup();}
 
+  //! Index of the analyzer in the TaskTelemetry
+  size_t getTelemetryIndex() const {return telemetryIndex;}
+
   //! Decides whether or not to execute in execution circle given as argument
   bool shouldExecute(int nCircles){
     if(execution_period!=0) return (nCircles%execution_period==0);
@@ -146,6 +169,7 @@ private:
   AbstractAnalyzer* myAnalyzer;
   unsigned int execution_period;
   bool isFirstExecution;
+  size_t telemetryIndex;
 };
 
 /*****************************************************************************/
@@ -160,8 +184,8 @@ private:
  **/
 class TaskManager::UpdaterObject{
 public:
-  UpdaterObject(AbstractUpdater* u, unsigned int period)
-    :myUpdater(u),execution_period(period),isFirstExecution(true){};
+  UpdaterObject(AbstractUpdater* u, unsigned int period, size_t telemetryIndex_)
+    :myUpdater(u),execution_period(period),isFirstExecution(true),telemetryIndex(telemetryIndex_){};
 
   ~UpdaterObject(){delete myUpdater;};
 
@@ -178,6 +202,15 @@ public:
   //! Calls the updater's cleanup routine
   void cleanup(){myUpdater->cleanup();}
 
+  //! Moves attempted by the updater so far
+  uint64_t getNAttemptedMoves() const {return myUpdater->getNAttemptedMoves();}
+
+  //! Moves accepted by the updater so far
+  uint64_t getNAcceptedMoves() const {return myUpdater->getNAcceptedMoves();}
+
+  //! Index of the updater in the TaskTelemetry
+  size_t getTelemetryIndex() const {return telemetryIndex;}
+
   //! Decides whether or not to execute in execution circle given as argument
   bool shouldExecute(int nCircles){
     if(execution_period!=0) return (nCircles%execution_period==0);
@@ -191,6 +224,7 @@ private:
   AbstractUpdater* myUpdater;
   unsigned int execution_period;
   bool isFirstExecution;
+  size_t telemetryIndex;
 };
 
 #endif /* LEMONADE_UTILITY_TASKMANAGER_H */
@@ -0,0 +1,185 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#ifndef LEMONADE_UTILITY_TASKTELEMETRY_H
+#define LEMONADE_UTILITY_TASKTELEMETRY_H
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Definitions of class TaskTelemetry
+ **/
+/*****************************************************************************/
+
+#include <stdint.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/*****************************************************************************/
+/**
+ * @class TaskTelemetry
+ *
+ * @brief Wall time, move and hardware counter statistics of the tasks of a TaskManager
+ *
+ * @details The TaskManager registers every updater and analyzer with addTask()
+ * and brackets each of their execute() calls with startTask() and stopTask().
+ * For every task the number of calls, the wall time measured with
+ * std::chrono::steady_clock, the attempted and accepted moves reported by the
+ * updaters and, if requested and permitted by the kernel, the CPU cycles and
+ * instructions counted with perf_event_open are accumulated.
+ *
+ * Every \a period circles endCircle() writes one record per task with the
+ * values accumulated since the last record, followed by a record of kind
+ * "total" with the wall time of the whole interval, such that the time spent
+ * outside of the tasks becomes visible. The records are written either as
+ * JSON lines, i.e. one object per line, or as CSV with a header line.
+ * The totals over the whole run are available through the getters.
+ *
+ * If no log file is opened, the telemetry is disabled and the TaskManager
+ * does not call it at all.
+ **/
+class TaskTelemetry
+{
+public:
+
+  //! format of the log file
+  enum Format{ JSONLines, CSV };
+
+  TaskTelemetry();
+  ~TaskTelemetry();
+
+  //! opens the log file and enables the telemetry
+  void open(const std::string& filename, int period=1, Format format=JSONLines, bool hardwareCounters=false);
+
+  //! writes the pending records and closes the log file
+  void close();
+
+  //! true if a log file is open
+  bool isEnabled() const {return enabled;}
+
+  //! true if cycles and instructions are counted
+  bool hasHardwareCounters() const {return perfGroupFd>=0;}
+
+  //! registers a task of the given kind ("updater","analyzer") and name, returns its index
+  size_t addTask(const std::string& kind, const std::string& name);
+
+  //! starts the timer and counters of task
+  void startTask(size_t task);
+
+  //! stops the timer and counters of task, adds the moves done during the call
+  void stopTask(size_t task, uint64_t attemptedMoves=0, uint64_t acceptedMoves=0);
+
+  //! writes the records of the interval if nCircles is a multiple of the period
+  void endCircle(int nCircles);
+
+  //! number of registered tasks
+  size_t getNTasks() const {return tasks.size();}
+
+  //! name of task
+  const std::string& getName(size_t task) const {return tasks.at(task).name;}
+
+  //! number of execute() calls of task
+  uint64_t getNCalls(size_t task) const {return tasks.at(task).total.calls;}
+
+  //! wall time of task in s
+  double getWallTime(size_t task) const {return tasks.at(task).total.seconds;}
+
+  //! attempted moves of task
+  uint64_t getNAttemptedMoves(size_t task) const {return tasks.at(task).total.attempted;}
+
+  //! accepted moves of task
+  uint64_t getNAcceptedMoves(size_t task) const {return tasks.at(task).total.accepted;}
+
+  //! readable name of a type, demangled if supported by the compiler
+  static std::string typeName(const std::type_info& type);
+
+private:
+
+  typedef std::chrono::steady_clock Clock;
+
+  //! accumulated values of a task
+  struct Counters
+  {
+    Counters():calls(0),seconds(0.0),attempted(0),accepted(0),cycles(0),instructions(0){}
+    void add(const Counters& c){
+      calls+=c.calls; seconds+=c.seconds; attempted+=c.attempted; accepted+=c.accepted;
+      cycles+=c.cycles; instructions+=c.instructions;
+    }
+    uint64_t calls;
+    double seconds;
+    uint64_t attempted;
+    uint64_t accepted;
+    uint64_t cycles;
+    uint64_t instructions;
+  };
+
+  struct Task
+  {
+    std::string kind;
+    std::string name;
+    //! values since the last record
+    Counters interval;
+    //! values since the start
+    Counters total;
+    Clock::time_point start;
+    uint64_t startCycles;
+    uint64_t startInstructions;
+  };
+
+  //! opens the cycle and instruction counters, leaves perfGroupFd negative on failure
+  void openHardwareCounters();
+
+  //! reads the current cycle and instruction counts
+  void readHardwareCounters(uint64_t& cycles, uint64_t& instructions) const;
+
+  //! writes one record
+  void writeRecord(int nCircles, size_t index, const std::string& kind, const std::string& name, const Counters& c);
+
+  //! writes the records of all tasks and resets the interval values
+  void writeInterval(int nCircles);
+
+  std::vector<Task> tasks;
+
+  std::ofstream log;
+  bool enabled;
+  int period;
+  Format format;
+
+  //! circle of the last endCircle() call and begin of the current interval
+  int lastCircle;
+  Clock::time_point intervalStart;
+
+  //! file descriptors of the perf event group (leader counts cycles), -1 if not used
+  int perfGroupFd;
+  int perfInstructionsFd;
+};
+
+#endif /* LEMONADE_UTILITY_TASKTELEMETRY_H */
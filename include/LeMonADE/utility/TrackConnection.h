@@ -121,9 +121,6 @@ private:
 template< class T >
 void TrackLinks<T>::dumpReactions()
 {
-  	//fist make a single vector<vector<double> > for writing the results
-	std::vector<std::vector<T> > resultsTimeseries=Connection;
-
 	//if it is written for the first time, include comment in the output file
 	if(isFirstFileDump){
 	  
@@ -133,7 +130,7 @@ void TrackLinks<T>::dumpReactions()
 		if(!file.is_open())
 			throw std::runtime_error("TrackLinks::dumpReactions(): error opening output file"+filename+"\n");
 		std::stringstream contents;
-		ResultFormattingTools::writeTable(contents, resultsTimeseries, comment);
+		ResultFormattingTools::writeTable(contents, Connection, comment);
 
 		file << contents.str();
 
@@ -144,7 +141,7 @@ void TrackLinks<T>::dumpReactions()
 	//otherwise just append the new data
 	else{
 		ResultFormattingTools::appendToResultFile(filename,
-							  resultsTimeseries);
+							  Connection);
 	}
 	//set all time series vectors back to zero size
 	resetConnection();
@@ -0,0 +1,111 @@
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+
+#include <LeMonADE/io/BfmTokenizer.h>
+#include <LeMonADE/io/Parser.h>
+
+//writes a file with nFrames conformations of nMonomers lines each
+void writeTestFile(const std::string& filename, uint32_t nMonomers, uint32_t nFrames)
+{
+	std::ofstream file(filename.c_str());
+	file<<"#!version=2.0\n";
+	file<<"!number_of_monomers="<<nMonomers<<"\n";
+	file<<"!box_x=256\n!box_y=256\n!box_z=256\n";
+	for(uint32_t f=0;f<nFrames;f++)
+	{
+		file<<"\n!mcs="<<1000*(f+1)<<"\n";
+		for(uint32_t n=0;n<nMonomers;n++)
+			file<<(2*n)%256<<" "<<(5*n)%256<<" "<<(7*n+f)%256<<"\n";
+	}
+}
+
+//the line by line search of the previous Parser::findRead, for comparison
+std::string findReadLineByLine(std::istream& stream)
+{
+	std::string line, Read;
+	std::streampos linestart;
+
+	while(!stream.eof() && !stream.fail()){
+		linestart=stream.tellg();
+		getline(stream,line);
+		if(line.size()>1 && (line.at(0)=='!' || (line.at(0)=='#' && line.at(1)=='!'))){
+			stream.seekg(linestart);
+			if(line.find("=")==std::string::npos) stream>>Read;
+			else getline(stream,Read,'=');
+			return Read;
+		}
+	}
+	return "endoffile";
+}
+
+double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+/**
+ * Benchmark of scanning a bfm-file for its commands. Compares the previous
+ * line by line search with tellg/seekg, Parser::findRead, and BfmTokenizer,
+ * and prints the throughput in MB/s.
+ */
+int main(int argc, char* argv[])
+{
+  try{
+	uint32_t nMonomers=100000;
+	uint32_t nFrames=20;
+	std::string filename("BfmScanBenchmark.bfm");
+
+	if(argc==2 && strcmp(argv[1],"--help")==0)
+	{
+		std::cout<<"usage: ./BfmScanBenchmark [n_monomers=100000] [n_frames=20]\n";
+		std::cout<<"writes "<<filename<<" and prints the scan throughput of the parsers\n";
+		return 0;
+	}
+	if(argc>1) nMonomers=atoi(argv[1]);
+	if(argc>2) nFrames=atoi(argv[2]);
+
+	writeTestFile(filename,nMonomers,nFrames);
+
+	std::chrono::steady_clock::time_point start;
+	uint32_t nLineByLine=0, nParser=0, nTokenizer=0;
+
+	std::ifstream file1(filename.c_str(),std::ios_base::in|std::ios_base::binary);
+	start=std::chrono::steady_clock::now();
+	while(findReadLineByLine(file1)!="endoffile") nLineByLine++;
+	double lineByLineTime=seconds(start);
+
+	std::ifstream file2(filename.c_str(),std::ios_base::in|std::ios_base::binary);
+	Parser parser(file2);
+	start=std::chrono::steady_clock::now();
+	while(parser.findRead()!="endoffile") nParser++;
+	double parserTime=seconds(start);
+
+	std::ifstream file3(filename.c_str(),std::ios_base::in|std::ios_base::binary);
+	BfmTokenizer tokenizer(file3);
+	BfmTokenizer::Command command;
+	start=std::chrono::steady_clock::now();
+	tokenizer.reset();
+	while(tokenizer.next(command)) nTokenizer++;
+	double tokenizerTime=seconds(start);
+
+	double megabytes=double(tokenizer.getBytesRead())/(1024.0*1024.0);
+	std::cout<<"file size "<<std::fixed<<std::setprecision(1)<<megabytes<<" MB, commands "
+		 <<nLineByLine<<" / "<<nParser<<" / "<<nTokenizer<<"\n";
+	std::cout<<std::setprecision(4);
+	std::cout<<"line by line with tellg/seekg\t"<<lineByLineTime<<" s\t"<<megabytes/lineByLineTime<<" MB/s\n";
+	std::cout<<"Parser::findRead\t\t"<<parserTime<<" s\t"<<megabytes/parserTime<<" MB/s\n";
+	std::cout<<"BfmTokenizer\t\t\t"<<tokenizerTime<<" s\t"<<megabytes/tokenizerTime<<" MB/s\n";
+
+	std::remove(filename.c_str());
+	}
+	catch(std::exception& err){std::cerr<<err.what();}
+	return 0;
+
+}
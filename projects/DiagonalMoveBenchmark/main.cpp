@@ -0,0 +1,162 @@
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureFixedMonomers.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/updater/UpdaterSimpleSimulator.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/updater/moves/MoveLocalScDiag.h>
+
+
+typedef LOKI_TYPELIST_4(FeatureMoleculesIO, FeatureFixedMonomers,FeatureAttributes<>,FeatureExcludedVolumeSc<>) Features;
+typedef ConfigureSystem<VectorInt3,Features,6> Config;
+typedef Ingredients<Config> Ing;
+
+//sets up stretched linear chains of chainLength monomers on a grid with spacing 2
+void setupMelt(Ing& ingredients, uint32_t boxSize, uint32_t nChains, uint32_t chainLength)
+{
+	uint32_t half=boxSize/2;
+	uint32_t chainsPerRow=half/chainLength;
+	ingredients.setBoxX(boxSize);
+	ingredients.setBoxY(boxSize);
+	ingredients.setBoxZ(boxSize);
+	ingredients.setPeriodicX(true);
+	ingredients.setPeriodicY(true);
+	ingredients.setPeriodicZ(true);
+	ingredients.modifyBondset().addBFMclassicBondset();
+
+	for(uint32_t c=0;c<nChains;c++)
+	{
+		uint32_t row=c/chainsPerRow;
+		for(uint32_t m=0;m<chainLength;m++)
+		{
+			uint32_t idx=ingredients.modifyMolecules().addMonomer(int(2*((c%chainsPerRow)*chainLength+m)),int(2*(row%half)),int(2*(row/half)));
+			ingredients.modifyMolecules()[idx].setMovableTag(true);
+			ingredients.modifyMolecules()[idx].setAttributeTag(1);
+			if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+		}
+	}
+	ingredients.synchronize();
+}
+
+//end-to-end vectors of all chains
+std::vector<VectorInt3> endToEndVectors(const Ing& ingredients, uint32_t chainLength)
+{
+	std::vector<VectorInt3> vectors;
+	for(uint32_t n=0;n+chainLength<=ingredients.getMolecules().size();n+=chainLength)
+		vectors.push_back(ingredients.getMolecules()[n+chainLength-1].getVector3D()-ingredients.getMolecules()[n].getVector3D());
+	return vectors;
+}
+
+//runs the updater and returns the wall time in seconds
+double timeUpdater(AbstractUpdater& updater)
+{
+	//the updaters report their progress on std::cout
+	std::streambuf* originalBuffer=std::cout.rdbuf();
+	std::ostringstream discard;
+	std::cout.rdbuf(discard.rdbuf());
+
+	std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+	updater.execute();
+	double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	std::cout.rdbuf(originalBuffer);
+	return seconds;
+}
+
+/**
+ * runs the system with MoveType until the autocorrelation of the end-to-end
+ * vectors drops below 1/e and prints the mcs and wall time needed
+ */
+template<class MoveType>
+void measureDecorrelation(const Ing& equilibrated, const char* name, uint32_t chainLength, uint32_t interval, uint32_t max_mcs)
+{
+	Ing ingredients(equilibrated);
+	UpdaterSimpleSimulator<Ing,MoveType> updater(ingredients,interval);
+
+	std::vector<VectorInt3> start=endToEndVectors(ingredients,chainLength);
+	double norm=0.0;
+	for(size_t c=0;c<start.size();c++) norm+=start[c]*start[c];
+
+	double seconds=0.0;
+	double correlation=1.0;
+	uint32_t mcs=0;
+	while(correlation>std::exp(-1.0) && mcs<max_mcs)
+	{
+		seconds+=timeUpdater(updater);
+		mcs+=interval;
+
+		std::vector<VectorInt3> current=endToEndVectors(ingredients,chainLength);
+		double product=0.0;
+		for(size_t c=0;c<start.size();c++) product+=current[c]*start[c];
+		correlation=product/norm;
+	}
+
+	double attempts=double(mcs)*ingredients.getMolecules().size();
+	std::cout<<name<<"\t"<<mcs<<" mcs\t"<<seconds<<" s\t"<<attempts/seconds<<" attempted moves/s";
+	if(correlation>std::exp(-1.0)) std::cout<<"\t(not decorrelated, C="<<correlation<<")";
+	std::cout<<"\n";
+}
+
+/**
+ * Benchmark of UpdaterSimpleSimulator with MoveLocalScDiag against MoveLocalSc
+ * on the feature set of the SimpleSimulator project. A melt of linear chains
+ * is equilibrated with MoveLocalSc, then both moves are run from this
+ * conformation until the autocorrelation function of the end-to-end vectors
+ * drops below 1/e. Printed are the mcs and the wall time to decorrelation.
+ */
+int main(int argc, char* argv[])
+{
+  try{
+	uint32_t boxSize=64;
+	uint32_t nChains=512;
+	uint32_t chainLength=16;
+	uint32_t equilibration=2000;
+	uint32_t interval=50;
+	uint32_t max_mcs=100000;
+
+	if(argc==2 && strcmp(argv[1],"--help")==0)
+	{
+		std::cout<<"usage: ./DiagonalMoveBenchmark [box_size=64] [n_chains=512] [chain_length=16] [equilibration_mcs=2000]\n";
+		std::cout<<"Prints the mcs and wall time until the end-to-end vectors decorrelate for MoveLocalSc and MoveLocalScDiag\n";
+		return 0;
+	}
+	if(argc>1) boxSize=atoi(argv[1]);
+	if(argc>2) nChains=atoi(argv[2]);
+	if(argc>3) chainLength=atoi(argv[3]);
+	if(argc>4) equilibration=atoi(argv[4]);
+
+	if(boxSize%2!=0 || chainLength==0 || chainLength>boxSize/2
+	   || nChains>((boxSize/2)/chainLength)*(boxSize/2)*(boxSize/2))
+		throw std::runtime_error("DiagonalMoveBenchmark: box size must be even and hold n_chains chains on the grid with spacing 2\n");
+
+	RandomNumberGenerators rng;
+	rng.seedAll();
+
+	Ing ingredients;
+	setupMelt(ingredients,boxSize,nChains,chainLength);
+	UpdaterSimpleSimulator<Ing,MoveLocalSc> equilibrator(ingredients,equilibration);
+	timeUpdater(equilibrator);
+
+	std::cout<<"monomers "<<ingredients.getMolecules().size()<<", chain length "<<chainLength
+		 <<", equilibrated for "<<equilibration<<" mcs\n";
+	std::cout<<std::fixed<<std::setprecision(4);
+	measureDecorrelation<MoveLocalSc>(ingredients,"MoveLocalSc    ",chainLength,interval,max_mcs);
+	measureDecorrelation<MoveLocalScDiag>(ingredients,"MoveLocalScDiag",chainLength,interval,max_mcs);
+
+	}
+	catch(std::exception& err){std::cerr<<err.what();}
+	return 0;
+
+}
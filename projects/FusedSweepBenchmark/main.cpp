@@ -0,0 +1,125 @@
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureFixedMonomers.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/updater/UpdaterSimpleSimulator.h>
+#include <LeMonADE/updater/UpdaterFusedSimulator.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+
+//same features as in the SimpleSimulator project
+typedef LOKI_TYPELIST_4(FeatureMoleculesIO, FeatureFixedMonomers,FeatureAttributes<>,FeatureExcludedVolumeSc<>) Features;
+typedef ConfigureSystem<VectorInt3,Features,6> Config;
+typedef Ingredients<Config> Ing;
+
+//linear chains stretched along x on a grid with spacing 2
+void setupMelt(Ing& ingredients, uint32_t boxSize, uint32_t nChains)
+{
+	uint32_t half=boxSize/2;
+	ingredients.setBoxX(boxSize);
+	ingredients.setBoxY(boxSize);
+	ingredients.setBoxZ(boxSize);
+	ingredients.setPeriodicX(true);
+	ingredients.setPeriodicY(true);
+	ingredients.setPeriodicZ(true);
+	ingredients.modifyBondset().addBFMclassicBondset();
+
+	for(uint32_t c=0;c<nChains;c++)
+	{
+		for(uint32_t m=0;m<half;m++)
+		{
+			uint32_t idx=ingredients.modifyMolecules().addMonomer(int(2*m),int(2*(c%half)),int(2*(c/half)));
+			ingredients.modifyMolecules()[idx].setMovableTag(true);
+			ingredients.modifyMolecules()[idx].setAttributeTag(1);
+			if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+		}
+	}
+	ingredients.synchronize();
+}
+
+//runs the updater for max_mcs and returns the wall time in seconds
+double timeUpdater(AbstractUpdater& updater)
+{
+	//the updaters report their progress on std::cout
+	std::streambuf* originalBuffer=std::cout.rdbuf();
+	std::ostringstream discard;
+	std::cout.rdbuf(discard.rdbuf());
+
+	std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+	updater.execute();
+	double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+	std::cout.rdbuf(originalBuffer);
+	return seconds;
+}
+
+/**
+ * Benchmark of UpdaterFusedSimulator against UpdaterSimpleSimulator with
+ * MoveLocalSc on the feature set of the SimpleSimulator project. Both run the
+ * same melt of linear chains with the same random numbers, and the final
+ * conformations are compared to make sure both produce the same trajectory.
+ */
+int main(int argc, char* argv[])
+{
+  try{
+	uint32_t boxSize=64;
+	uint32_t nChains=512;
+	uint32_t max_mcs=200;
+
+	if(argc==2 && strcmp(argv[1],"--help")==0)
+	{
+		std::cout<<"usage: ./FusedSweepBenchmark [box_size=64] [n_chains=512] [max_mcs=200]\n";
+		std::cout<<"chains have box_size/2 monomers. Prints the wall time of UpdaterSimpleSimulator and UpdaterFusedSimulator\n";
+		return 0;
+	}
+	if(argc>1) boxSize=atoi(argv[1]);
+	if(argc>2) nChains=atoi(argv[2]);
+	if(argc>3) max_mcs=atoi(argv[3]);
+
+	if(boxSize%2!=0 || nChains>(boxSize/2)*(boxSize/2))
+		throw std::runtime_error("FusedSweepBenchmark: box size must be even and hold n_chains rows of the grid with spacing 2\n");
+
+	RandomNumberGenerators rng;
+	rng.seedAll();
+	std::vector<uint32_t> rngState;
+	rng.getR250State(rngState);
+
+	Ing simpleIngredients;
+	setupMelt(simpleIngredients,boxSize,nChains);
+	UpdaterSimpleSimulator<Ing,MoveLocalSc> simpleUpdater(simpleIngredients,max_mcs);
+	double simpleTime=timeUpdater(simpleUpdater);
+
+	rng.setR250State(rngState);
+	Ing fusedIngredients;
+	setupMelt(fusedIngredients,boxSize,nChains);
+	UpdaterFusedSimulator<Ing> fusedUpdater(fusedIngredients,max_mcs);
+	double fusedTime=timeUpdater(fusedUpdater);
+
+	uint32_t nDifferent=0;
+	for(uint32_t n=0;n<simpleIngredients.getMolecules().size();n++)
+		if(simpleIngredients.getMolecules()[n]!=fusedIngredients.getMolecules()[n]) nDifferent++;
+
+	double attempts=double(max_mcs)*simpleIngredients.getMolecules().size();
+	std::cout<<"monomers "<<simpleIngredients.getMolecules().size()<<", mcs "<<max_mcs
+		 <<", fused kernel "<<(FusedLocalScSweep<Ing>::IS_FUSED ? "enabled" : "disabled (generic fallback)")<<"\n";
+	std::cout<<std::fixed<<std::setprecision(4);
+	std::cout<<"UpdaterSimpleSimulator<Ing,MoveLocalSc>\t"<<simpleTime<<" s\t"<<attempts/simpleTime<<" attempted moves/s\n";
+	std::cout<<"UpdaterFusedSimulator<Ing>\t\t"<<fusedTime<<" s\t"<<attempts/fusedTime<<" attempted moves/s\n";
+	std::cout<<"speedup "<<simpleTime/fusedTime<<"\n";
+	std::cout<<"monomers at different positions "<<nDifferent<<"\n";
+
+	}
+	catch(std::exception& err){std::cerr<<err.what();}
+	return 0;
+
+}
@@ -0,0 +1,103 @@
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/feature/FeatureReactiveBonds.h>
+#include <LeMonADE/updater/UpdaterSimpleConnection.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/updater/moves/MoveConnectScReactive.h>
+
+/**
+ * Benchmark for the network formation with FeatureReactiveBonds.
+ * Reactive monomers (bifunctional, and tetrafunctional crosslinkers in
+ * stoichiometric ratio) are placed randomly in a periodic box and connected
+ * by UpdaterSimpleConnection. The conversion is printed against the wall time,
+ * such that the cost of the connection moves at low and high conversion can
+ * be compared.
+ */
+int main(int argc, char* argv[])
+{
+  try{
+	uint32_t boxSize=64;
+	uint32_t nMonomers=8192;
+	uint32_t max_mcs=100;
+	bool reactiveSweep=false;
+
+	if(argc==2 && strcmp(argv[1],"--help")==0)
+	{
+		std::cout<<"usage: ./ReactiveNetworkBenchmark [box_size=64] [n_monomers=8192] [max_mcs=100] [sweep=all|reactive]\n";
+		std::cout<<"prints mcs, wall time (s) and conversion of a network formation run\n";
+		return 0;
+	}
+	if(argc>1) boxSize=atoi(argv[1]);
+	if(argc>2) nMonomers=atoi(argv[2]);
+	if(argc>3) max_mcs=atoi(argv[3]);
+	if(argc>4) reactiveSweep=(strcmp(argv[4],"reactive")==0);
+
+	//monomers are placed on a grid with spacing 2, i.e. (boxSize/2)^3 sites
+	uint32_t nSites=(boxSize/2)*(boxSize/2)*(boxSize/2);
+	if(boxSize%2!=0 || nMonomers>nSites)
+		throw std::runtime_error("ReactiveNetworkBenchmark: box size must be even and hold all monomers on a grid with spacing 2\n");
+
+	RandomNumberGenerators rng;
+	rng.seedAll();
+
+	typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureReactiveBonds, FeatureExcludedVolumeSc<>) Features;
+	typedef ConfigureSystem<VectorInt3,Features,4> Config;
+	typedef Ingredients<Config> Ing;
+	Ing ingredients;
+
+	ingredients.setBoxX(boxSize);
+	ingredients.setBoxY(boxSize);
+	ingredients.setBoxZ(boxSize);
+	ingredients.setPeriodicX(true);
+	ingredients.setPeriodicY(true);
+	ingredients.setPeriodicZ(true);
+	ingredients.modifyBondset().addBFMclassicBondset();
+
+	//random subset of the grid sites
+	std::vector<uint32_t> sites(nSites);
+	for(uint32_t n=0;n<nSites;n++) sites[n]=n;
+	for(uint32_t n=0;n<nMonomers;n++)
+		std::swap(sites[n],sites[n+rng.r250_rand32()%(nSites-n)]);
+
+	//one tetrafunctional crosslinker per two bifunctional monomers
+	uint32_t half=boxSize/2;
+	for(uint32_t n=0;n<nMonomers;n++)
+	{
+		uint32_t site=sites[n];
+		ingredients.modifyMolecules().addMonomer(int(2*(site%half)),int(2*((site/half)%half)),int(2*(site/(half*half))));
+		ingredients.modifyMolecules()[n].setReactive(true);
+		ingredients.modifyMolecules()[n].setNumMaxLinks(n%3==0 ? 4 : 2);
+	}
+	ingredients.synchronize();
+
+	typedef UpdaterSimpleConnection<Ing,MoveLocalSc,MoveConnectScReactive> Updater;
+	Updater updater(ingredients,1);
+	if(reactiveSweep) updater.setConnectionSweepSize(Updater::SWEEP_REACTIVE_SITES);
+	updater.initialize();
+
+	std::cout<<"# mcs\t wall time [s]\t conversion\t unreacted monomers\n";
+	std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+	for(uint32_t mcs=1;mcs<=max_mcs;mcs++)
+	{
+		updater.execute();
+		double seconds=std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		std::cout<<mcs<<"\t"<<std::fixed<<std::setprecision(4)<<seconds<<"\t"
+			 <<ingredients.getConversion()<<"\t"<<ingredients.getNUnreactedMonomers()<<"\n";
+	}
+	updater.cleanup();
+
+	}
+	catch(std::exception& err){std::cerr<<err.what();}
+	return 0;
+
+}
@@ -12,6 +12,8 @@
 #include <LeMonADE/utility/TaskManager.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
 #include <LeMonADE/updater/UpdaterSimpleSimulator.h>
+#include <LeMonADE/analyzer/AnalyzerWriteCheckpoint.h>
+#include <LeMonADE/io/Checkpoint.h>
 #include <LeMonADE/Version.h>
 
 int main(int argc, char* argv[])
@@ -21,6 +23,7 @@ int main(int argc, char* argv[])
 	std::string outfile;
 	uint32_t max_mcs=0;
 	uint32_t save_interval=0;
+	bool restart=false;
 
 	outfile="outfile.bfm";
 
@@ -32,9 +35,12 @@ int main(int argc, char* argv[])
 		errormessage+="maximum number of connections per monomer is 6\n";
 		errormessage+="If output_filename specified, the results are written to the new file\n";
 		errormessage+="otherwise the results are appended to the old input file\n";
+		errormessage+="After every save_interval the state is saved to output_filename.chk\n";
+		errormessage+="If input_filename ends with .chk, the simulation is restarted from this checkpoint\n";
+		errormessage+="and the results are appended to output_filename, which is required then\n";
 		errormessage+="Features used: FeatureFixedMonomers, FeatureBondset,FeatureAttributes,FeatureExcludedVolume<FeatureLattice<bool> >\n";
 		errormessage+="Updaters used: ReadFullBFMFile, SimpleSimulator\n";
-		errormessage+="Analyzers used: WriteBfmFile\n";
+		errormessage+="Analyzers used: WriteBfmFile, WriteCheckpoint\n";
 		throw std::runtime_error(errormessage);
 
 	}
@@ -44,7 +50,9 @@ int main(int argc, char* argv[])
 		max_mcs=atoi(argv[2]);
 		save_interval=atoi(argv[3]);
 
+		restart=(infile.size()>4 && infile.compare(infile.size()-4,4,".chk")==0);
 		if(argc==5) outfile=argv[4];
+		else if(restart) throw std::runtime_error("output_filename is required for a restart from a checkpoint\n");
 		else outfile=argv[1];
 	}
 	  
@@ -76,12 +84,15 @@ int main(int argc, char* argv[])
 	Ing myIngredients;
 
 	TaskManager taskmanager;
-	taskmanager.addUpdater(new UpdaterReadBfmFile<Ing>(infile,myIngredients,UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
+	//a checkpoint restores the system including the state of the random number generator
+	if(restart) loadCheckpoint(infile,myIngredients);
+	else taskmanager.addUpdater(new UpdaterReadBfmFile<Ing>(infile,myIngredients,UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE),0);
 	//here you can choose to use MoveLocalBcc instead. Careful though: no real tests made yet
 	//(other than for latticeOccupation, valid bonds, frozen monomers...)
 	taskmanager.addUpdater(new UpdaterSimpleSimulator<Ing,MoveLocalSc>(myIngredients,save_interval));
 
 	taskmanager.addAnalyzer(new AnalyzerWriteBfmFile<Ing>(outfile,myIngredients));
+	taskmanager.addAnalyzer(new AnalyzerWriteCheckpoint<Ing>(outfile+".chk",myIngredients));
 
 	taskmanager.initialize();
 	taskmanager.run(max_mcs/save_interval);
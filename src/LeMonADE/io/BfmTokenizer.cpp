@@ -0,0 +1,153 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include <LeMonADE/io/BfmTokenizer.h>
+
+#include <cctype>
+#include <cstring>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Implementation of BfmTokenizer
+ * */
+/*****************************************************************************/
+
+/*****************************************************************************/
+//constructor
+BfmTokenizer::BfmTokenizer(std::istream& inputStream, size_t blockSize_)
+  :stream(inputStream),blockSize(blockSize_>0 ? blockSize_ : 1),begin(0),end(0),bufferOffset(0),bytesRead(0),streamEnd(false)
+{}
+/*****************************************************************************/
+
+void BfmTokenizer::reset(uint64_t offset)
+{
+  stream.clear();
+  stream.seekg(std::streampos(offset));
+  begin=0;
+  end=0;
+  bufferOffset=offset;
+  bytesRead=0;
+  streamEnd=stream.fail();
+}
+
+bool BfmTokenizer::fillBuffer()
+{
+  if(streamEnd) return false;
+
+  const size_t remaining=end-begin;
+  if(begin>0 && remaining>0)
+    std::memmove(&buffer[0],&buffer[begin],remaining);
+  bufferOffset+=begin;
+  begin=0;
+  end=remaining;
+
+  //lines longer than a block let the buffer grow
+  if(buffer.size()<remaining+blockSize)
+    buffer.resize(remaining+blockSize);
+
+  stream.read(&buffer[end],blockSize);
+  const size_t nRead=size_t(stream.gcount());
+  end+=nRead;
+  bytesRead+=nRead;
+
+  if(nRead<blockSize) streamEnd=true;
+
+  return nRead>0;
+}
+
+/*****************************************************************************/
+/**
+ * @details Lines with less than two characters are no commands, as in Parser::findRead().
+ * A last line without line end is processed as well.
+ **/
+bool BfmTokenizer::next(Command& command)
+{
+  while(true)
+  {
+    const char* lineStart=(end>begin) ? &buffer[begin] : 0;
+    const char* lineEnd=(end>begin) ? static_cast<const char*>(std::memchr(lineStart,'\n',end-begin)) : 0;
+
+    if(lineEnd==0)
+    {
+      //incomplete line: get more data, or process the last line
+      if(fillBuffer()) continue;
+      if(end==begin) return false;
+      lineStart=&buffer[begin];
+      lineEnd=lineStart+(end-begin);
+    }
+
+    const size_t length=size_t(lineEnd-lineStart);
+    const uint64_t lineOffset=bufferOffset+begin;
+    begin+=length;
+    if(begin<end) begin++; //the line end
+
+    if(length<2) continue;
+    if(!(lineStart[0]=='!' || (lineStart[0]=='#' && lineStart[1]=='!'))) continue;
+
+    //the name ends at = if present, otherwise at the first whitespace
+    const char* equal=static_cast<const char*>(std::memchr(lineStart,'=',length));
+    size_t nameLength;
+    size_t argumentStart;
+    if(equal!=0)
+    {
+      nameLength=size_t(equal-lineStart);
+      argumentStart=nameLength+1;
+    }
+    else
+    {
+      nameLength=0;
+      while(nameLength<length && !std::isspace(static_cast<unsigned char>(lineStart[nameLength]))) nameLength++;
+      argumentStart=nameLength;
+    }
+
+    command.name.assign(lineStart,nameLength);
+    command.lineOffset=lineOffset;
+    command.argumentOffset=lineOffset+argumentStart;
+    command.arguments.assign(lineStart+argumentStart,length-argumentStart);
+    return true;
+  }
+}
+
+bool BfmTokenizer::parseUnsigned(const std::string& str, uint64_t& value, size_t& consumed)
+{
+  size_t pos=0;
+  while(pos<str.size() && std::isspace(static_cast<unsigned char>(str[pos]))) pos++;
+  if(pos<str.size() && str[pos]=='+') pos++;
+
+  const size_t firstDigit=pos;
+  value=0;
+  while(pos<str.size() && str[pos]>='0' && str[pos]<='9')
+  {
+    value=10*value+uint64_t(str[pos]-'0');
+    pos++;
+  }
+
+  consumed=pos;
+  return pos>firstDigit;
+}
@@ -0,0 +1,244 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <LeMonADE/io/Checkpoint.h>
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Implementation of CheckpointWriter and CheckpointReader
+ * */
+/*****************************************************************************/
+
+namespace
+{
+	const char checkpointMagic[8]={'L','M','D','C','H','K','P','T'};
+	const uint32_t checkpointVersion=1;
+	const uint32_t flagLattice=1;
+	const uint32_t maxSectionNameLength=65536;
+}
+
+/*****************************************************************************/
+//CheckpointWriter
+/*****************************************************************************/
+CheckpointWriter::CheckpointWriter(const std::string& filename_, bool includeLattice)
+:filename(filename_)
+,file((filename_+".tmp").c_str(),std::ios::binary|std::ios::trunc)
+,withLattice(includeLattice)
+,sectionOpen(false)
+{
+	if(!file.is_open())
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointWriter: could not open file "<<filename<<".tmp for writing";
+		throw std::runtime_error(errormessage.str());
+	}
+
+	uint32_t flags=(withLattice ? flagLattice : 0);
+	file.write(checkpointMagic,sizeof(checkpointMagic));
+	file.write(reinterpret_cast<const char*>(&checkpointVersion),sizeof(checkpointVersion));
+	file.write(reinterpret_cast<const char*>(&flags),sizeof(flags));
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+	if(file.is_open())
+	{
+		file.close();
+		std::remove((filename+".tmp").c_str());
+	}
+}
+
+void CheckpointWriter::close()
+{
+	if(sectionOpen) endSection();
+	file.close();
+
+	if(file.fail() || std::rename((filename+".tmp").c_str(),filename.c_str())!=0)
+	{
+		std::remove((filename+".tmp").c_str());
+		std::stringstream errormessage;
+		errormessage<<"CheckpointWriter: could not write checkpoint "<<filename;
+		throw std::runtime_error(errormessage.str());
+	}
+}
+
+void CheckpointWriter::beginSection(const std::string& name)
+{
+	if(sectionOpen) endSection();
+
+	sectionOpen=true;
+	sectionName=name;
+	sectionData.clear();
+}
+
+void CheckpointWriter::endSection()
+{
+	if(!sectionOpen)
+		throw std::runtime_error("CheckpointWriter::endSection: no open section");
+
+	uint32_t nameLength=sectionName.size();
+	uint64_t dataLength=sectionData.size();
+	file.write(reinterpret_cast<const char*>(&nameLength),sizeof(nameLength));
+	file.write(sectionName.data(),nameLength);
+	file.write(reinterpret_cast<const char*>(&dataLength),sizeof(dataLength));
+	file.write(sectionData.data(),dataLength);
+
+	sectionOpen=false;
+	sectionData.clear();
+}
+
+void CheckpointWriter::writeString(const std::string& str)
+{
+	uint64_t n=str.size();
+	write(n);
+	sectionData.append(str);
+}
+
+/*****************************************************************************/
+//CheckpointReader
+/*****************************************************************************/
+CheckpointReader::CheckpointReader(const std::string& filename_)
+:filename(filename_)
+,file(filename_.c_str(),std::ios::binary)
+,withLattice(false)
+,sectionRemaining(0)
+{
+	if(!file.is_open())
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: could not open file "<<filename;
+		throw std::runtime_error(errormessage.str());
+	}
+
+	char magic[sizeof(checkpointMagic)];
+	uint32_t version=0, flags=0;
+	file.read(magic,sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version),sizeof(version));
+	file.read(reinterpret_cast<char*>(&flags),sizeof(flags));
+
+	if(file.fail() || std::memcmp(magic,checkpointMagic,sizeof(magic))!=0 || version!=checkpointVersion)
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: "<<filename<<" is no checkpoint of version "<<checkpointVersion;
+		throw std::runtime_error(errormessage.str());
+	}
+
+	withLattice=((flags&flagLattice)!=0);
+}
+
+void CheckpointReader::beginSection(const std::string& name)
+{
+	if(sectionRemaining!=0) endSection();
+
+	//section names are type names, longer ones indicate a corrupted file
+	uint32_t nameLength=0;
+	std::string storedName;
+	file.read(reinterpret_cast<char*>(&nameLength),sizeof(nameLength));
+	if(!file.fail() && nameLength<=maxSectionNameLength)
+	{
+		storedName.resize(nameLength);
+		if(nameLength>0) file.read(&storedName[0],nameLength);
+		file.read(reinterpret_cast<char*>(&sectionRemaining),sizeof(sectionRemaining));
+	}
+
+	if(file.fail() || nameLength>maxSectionNameLength)
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: unexpected end of file "<<filename<<" while looking for section "<<name;
+		throw std::runtime_error(errormessage.str());
+	}
+
+	if(storedName!=name)
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: expected section "<<name<<" but found "<<storedName<<" in "<<filename
+			<<". Was the checkpoint written with different features?";
+		throw std::runtime_error(errormessage.str());
+	}
+
+	sectionName=name;
+}
+
+void CheckpointReader::endSection()
+{
+	if(sectionRemaining!=0)
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: "<<sectionRemaining<<" bytes of section "<<sectionName
+			<<" in "<<filename<<" were not read";
+		throw std::runtime_error(errormessage.str());
+	}
+}
+
+void CheckpointReader::close()
+{
+	endSection();
+	if(file.peek()!=std::ifstream::traits_type::eof())
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: "<<filename<<" contains sections after "<<sectionName
+			<<". Was the checkpoint written with different features?";
+		throw std::runtime_error(errormessage.str());
+	}
+	file.close();
+}
+
+void CheckpointReader::readString(std::string& str)
+{
+	uint64_t n;
+	read(n);
+	if(n>sectionRemaining)
+		throw std::runtime_error("CheckpointReader::readString: string exceeds section "+sectionName+" in "+filename);
+	str.resize(n);
+	if(n>0) readBytes(&str[0],n);
+}
+
+void CheckpointReader::readBytes(char* destination, uint64_t nBytes)
+{
+	if(nBytes>sectionRemaining)
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: read beyond the end of section "<<sectionName<<" in "<<filename;
+		throw std::runtime_error(errormessage.str());
+	}
+
+	file.read(destination,nBytes);
+	if(file.fail())
+	{
+		std::stringstream errormessage;
+		errormessage<<"CheckpointReader: unexpected end of file "<<filename;
+		throw std::runtime_error(errormessage.str());
+	}
+	sectionRemaining-=nBytes;
+}
@@ -27,6 +27,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <LeMonADE/io/Parser.h>
 
+#include <limits>
+
 /*****************************************************************************/
 /**
  * @file
@@ -47,11 +49,25 @@ Parser::~Parser(){}
 //finds the next Read in the stream and returns the Readstring
 std::string Parser::findRead()
 {
-	std::string line, Read;
+	std::string Read;
+	findRead(Read);
+	return Read;
+}
+
+//finds the next Read in the stream and stores the Readstring in Read
+void Parser::findRead(std::string& Read)
+{
 	std::streampos linestart;
 
   while(!stream.eof() && !stream.fail()){
     //cout<<"findRead"<<endl;
+    //lines which can not be a Read are skipped without tellg, which is
+    //expensive on file streams
+    int first=stream.peek();
+    if(first!='!' && first!='#'){
+      stream.ignore(std::numeric_limits<std::streamsize>::max(),'\n');
+      continue;
+    }
     linestart=stream.tellg();
     getline(stream,line);
     if(!line.empty() && line.size()>1){
@@ -64,17 +80,17 @@ std::string Parser::findRead()
       if (length==std::string::npos){
 	stream.seekg(linestart);
 	stream>>Read;
-	return Read;
+	return;
       }
       else{
 	stream.seekg(linestart);
 	getline(stream,Read,'=');
-	return Read;
+	return;
       }
 
     }
     }
   }
   //if still here, the end of the file has been reached
-  return "endoffile";
+  Read="endoffile";
 }
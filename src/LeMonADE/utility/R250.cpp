@@ -25,6 +25,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 --------------------------------------------------------------------------------*/
 
+#include <stdexcept>
+
 #include <LeMonADE/utility/R250.h>
 
 /**
@@ -207,6 +209,31 @@ void R250::loadDefaultState()
 	refresh();
 }
 
+//the array is followed by the offsets of dice,pos,other147 and other250
+void R250::getFullState( uint32_t* fullState ) const
+{
+	for(size_t i=0;i<R250_RANDOM_PREFETCH;i++) fullState[i]=array[i];
+	fullState[R250_RANDOM_PREFETCH  ]=uint32_t(dice-array);
+	fullState[R250_RANDOM_PREFETCH+1]=uint32_t(pos-array);
+	fullState[R250_RANDOM_PREFETCH+2]=uint32_t(other147-array);
+	fullState[R250_RANDOM_PREFETCH+3]=uint32_t(other250-array);
+}
+
+void R250::setFullState( uint32_t const * fullState )
+{
+	for(size_t i=R250_RANDOM_PREFETCH;i<FULL_STATE_SIZE;i++)
+	{
+		if(fullState[i]>R250_RANDOM_PREFETCH)
+			throw std::runtime_error("R250::setFullState: invalid pointer offset in state");
+	}
+
+	for(size_t i=0;i<R250_RANDOM_PREFETCH;i++) array[i]=fullState[i];
+	dice=array+fullState[R250_RANDOM_PREFETCH];
+	pos=array+fullState[R250_RANDOM_PREFETCH+1];
+	other147=array+fullState[R250_RANDOM_PREFETCH+2];
+	other250=array+fullState[R250_RANDOM_PREFETCH+3];
+}
+
 //prints the internal state array
 void R250::printState()
 {
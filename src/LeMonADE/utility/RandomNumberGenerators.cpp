@@ -40,6 +40,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 
 R250* RandomNumberGenerators::r250Engine=0;
+thread_local R250* RandomNumberGenerators::threadR250Engine=0;
 
 #ifdef RANDOMNUMBERGENERATOR_ENABLE_CPP11
 std::mt19937* RandomNumberGenerators::mt19937Engine=0;
@@ -179,14 +180,31 @@ void RandomNumberGenerators::seedAll()
 //R250Engine handles getting a random state internally
 void RandomNumberGenerators::seedR250()
 {
-	r250Engine->loadRandomState();
+	activeR250()->loadRandomState();
 }
 
 //seed R250Engine with array of 256 values
 //state array has to contain 256 ideally random values
 void RandomNumberGenerators::seedR250( uint32_t const * stateArray )
 {
-	r250Engine->setState(stateArray);
+	activeR250()->setState(stateArray);
+}
+
+void RandomNumberGenerators::getR250State( std::vector<uint32_t>& state ) const
+{
+	state.resize(R250::FULL_STATE_SIZE);
+	activeR250()->getFullState(&state[0]);
+}
+
+void RandomNumberGenerators::setR250State( std::vector<uint32_t> const & state )
+{
+	if(state.size()!=R250::FULL_STATE_SIZE)
+	{
+		std::stringstream errormessage;
+		errormessage<<"RandomNumberGenerators::setR250State: expected "<<R250::FULL_STATE_SIZE<<" values, got "<<state.size();
+		throw std::runtime_error(errormessage.str());
+	}
+	activeR250()->setFullState(&state[0]);
 }
 
 //convenience function for randomly seeding std::rand() from /dev/urandom
@@ -218,7 +236,7 @@ void RandomNumberGenerators::seedSTDRAND( uint32_t const seed )
 
 void RandomNumberGenerators::seedDefaultValuesAll()
 {
-    r250Engine->loadDefaultState();
+    activeR250()->loadDefaultState();
 #ifdef RANDOMNUMBERGENERATOR_ENABLE_CPP11
 	seedMT(1);
 #endif /*RANDOMNUMBERGENERATOR_ENABLE_CPP11*/
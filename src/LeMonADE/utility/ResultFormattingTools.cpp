@@ -48,3 +48,28 @@ void ResultFormattingTools::addComment(std::stringstream& stream) {
 	return;
 
 }
+
+namespace {
+//! format used by analyzers which are not explicitly configured
+ResultFormattingTools::OutputFormat defaultOutputFormat=ResultFormattingTools::TextFormat;
+}
+
+ResultFormattingTools::OutputFormat ResultFormattingTools::getDefaultOutputFormat()
+{
+	return defaultOutputFormat;
+}
+
+void ResultFormattingTools::setDefaultOutputFormat(OutputFormat format)
+{
+	defaultOutputFormat=format;
+}
+
+std::string ResultFormattingTools::outputFilename(OutputFormat format, const std::string& filename)
+{
+	const std::string extension(".bin");
+	if(format!=BinaryFormat)
+		return filename;
+	if(filename.size()>=extension.size() && filename.compare(filename.size()-extension.size(),extension.size(),extension)==0)
+		return filename;
+	return filename+extension;
+}
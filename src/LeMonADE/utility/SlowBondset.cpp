@@ -271,3 +271,14 @@ bool SlowBondset::isValidStrongCheck(const VectorInt3& bondVector ) const
 {
   return isValid(bondVector);
 }
+
+/**
+ * @details The 9 bit look-up index of FastBondset cannot represent the larger
+ * bond-vectors of SlowBondset, so the check by index is not available.
+ *
+ * @throw <std::runtime_error> always.
+ */
+bool SlowBondset::isValidIndexStrongCheck(uint32_t) const
+{
+  throw std::runtime_error("SlowBondset::isValidIndexStrongCheck(uint32_t)  Bond indices are not supported, check the bond-vector instead");
+}
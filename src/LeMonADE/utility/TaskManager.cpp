@@ -64,7 +64,8 @@ TaskManager::~TaskManager()
  **/
 void TaskManager::addAnalyzer(AbstractAnalyzer* a, int period)
 {
-  analyzer.push_back(new AnalyzerObject(a,period));
+  size_t telemetryIndex=telemetry.addTask("analyzer",TaskTelemetry::typeName(typeid(*a)));
+  analyzer.push_back(new AnalyzerObject(a,period,telemetryIndex));
 }
 
 /*****************************************************************************/
@@ -75,7 +76,8 @@ void TaskManager::addAnalyzer(AbstractAnalyzer* a, int period)
  **/
 void TaskManager::addUpdater(AbstractUpdater* u, int period)
 {
-  updater.push_back(new UpdaterObject(u,period));
+  size_t telemetryIndex=telemetry.addTask("updater",TaskTelemetry::typeName(typeid(*u)));
+  updater.push_back(new UpdaterObject(u,period,telemetryIndex));
 }
 
 /*****************************************************************************/
@@ -93,9 +95,10 @@ void TaskManager::run()
   if(updater.size()==0){
     aIterator=analyzer.begin();
     while(aIterator!=analyzer.end() ){
-      if((*aIterator)->shouldExecute(nCircles)) (*aIterator)->run();
+      if((*aIterator)->shouldExecute(nCircles)) executeAnalyzer(*aIterator);
       ++aIterator;
     }
+    telemetry.endCircle(nCircles);
     return;
   }
   //else run as long as there are updates coming in from updater objects
@@ -108,21 +111,25 @@ void TaskManager::run()
       uIterator=updater.begin();
       while(uIterator!=updater.end() ){
 	if((*uIterator)->shouldExecute(nCircles)){
-		bool currentUpdaterRunning=(*uIterator)->run();
+		bool currentUpdaterRunning=executeUpdater(*uIterator);
 		running=(running ||currentUpdaterRunning);
 
 	}
 	++uIterator;
       }
       //if all updaters return false, exit the loop
-      if(!running) break;
+      if(!running){
+	telemetry.endCircle(nCircles);
+	break;
+      }
 
       //call all analyzers
       aIterator=analyzer.begin();
       while(aIterator!=analyzer.end() ){
-	if((*aIterator)->shouldExecute(nCircles)) (*aIterator)->run();
+	if((*aIterator)->shouldExecute(nCircles)) executeAnalyzer(*aIterator);
 	++aIterator;
       }
+      telemetry.endCircle(nCircles);
 
     }
   }
@@ -151,16 +158,17 @@ void TaskManager::run(int nPeriods)
     uIterator=updater.begin();
     ///@todo exception, if all updaters return false and loop keeps running??
     while(uIterator!=updater.end() ){
-      if((*uIterator)->shouldExecute(nCircles)) (*uIterator)->run();
+      if((*uIterator)->shouldExecute(nCircles)) executeUpdater(*uIterator);
       ++uIterator;
     }
 
     //call all analyzers
     aIterator=analyzer.begin();
     while(aIterator!=analyzer.end() ){
-      if((*aIterator)->shouldExecute(nCircles)) (*aIterator)->run();
+      if((*aIterator)->shouldExecute(nCircles)) executeAnalyzer(*aIterator);
       ++aIterator;
     }
+    telemetry.endCircle(nCircles);
 
   }
 
@@ -208,6 +216,54 @@ void TaskManager::cleanup()
       (*aIterator)->cleanup();
       ++aIterator;
     }
+
+    telemetry.close();
+}
+
+/*****************************************************************************/
+/**
+ * @details The updaters and analyzers added so far and later on are measured.
+ * See TaskTelemetry for the content of the log. The log is completed by cleanup().
+ *
+ * @param filename name of the log file
+ * @param period number of circles between two records
+ * @param format TaskTelemetry::JSONLines or TaskTelemetry::CSV
+ * @param hardwareCounters count cycles and instructions via perf_event_open, if available
+ **/
+void TaskManager::enableTelemetry(const std::string& filename, int period,
+				  TaskTelemetry::Format format, bool hardwareCounters)
+{
+  telemetry.open(filename,period,format,hardwareCounters);
+}
+
+/*****************************************************************************/
+/**
+ * @details The moves are the differences of the updater's counters before and after the call.
+ **/
+bool TaskManager::executeUpdater(UpdaterObject* u)
+{
+  if(!telemetry.isEnabled()) return u->run();
+
+  const uint64_t attempted=u->getNAttemptedMoves();
+  const uint64_t accepted=u->getNAcceptedMoves();
+  telemetry.startTask(u->getTelemetryIndex());
+  bool result=u->run();
+  telemetry.stopTask(u->getTelemetryIndex(),
+		     u->getNAttemptedMoves()-attempted,
+		     u->getNAcceptedMoves()-accepted);
+  return result;
+}
+
+void TaskManager::executeAnalyzer(AnalyzerObject* a)
+{
+  if(!telemetry.isEnabled()){
+    a->run();
+    return;
+  }
+
+  telemetry.startTask(a->getTelemetryIndex());
+  a->run();
+  telemetry.stopTask(a->getTelemetryIndex());
 }
 
 
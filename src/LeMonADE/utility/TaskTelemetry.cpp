@@ -0,0 +1,298 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include <LeMonADE/utility/TaskTelemetry.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Implementation TaskTelemetry members
+ * */
+/*****************************************************************************/
+
+namespace {
+
+  //! escapes quotes and backslashes for JSON strings
+  std::string escapeJSON(const std::string& s)
+  {
+    std::string result;
+    for(size_t n=0;n<s.size();n++){
+      if(s[n]=='"' || s[n]=='\\') result.push_back('\\');
+      result.push_back(s[n]);
+    }
+    return result;
+  }
+
+  //! quotes a CSV field, doubling contained quotes
+  std::string quoteCSV(const std::string& s)
+  {
+    std::string result("\"");
+    for(size_t n=0;n<s.size();n++){
+      if(s[n]=='"') result.push_back('"');
+      result.push_back(s[n]);
+    }
+    result.push_back('"');
+    return result;
+  }
+
+}
+
+TaskTelemetry::TaskTelemetry()
+:enabled(false),period(1),format(JSONLines),lastCircle(0),perfGroupFd(-1),perfInstructionsFd(-1)
+{}
+
+TaskTelemetry::~TaskTelemetry()
+{
+  close();
+}
+
+/*****************************************************************************/
+/**
+ * @param filename name of the log file, overwritten if it exists
+ * @param period_ number of circles between two records
+ * @param format_ JSONLines or CSV
+ * @param hardwareCounters if true, cycles and instructions are counted via
+ *        perf_event_open. If this is not possible (other OS, no permission),
+ *        the telemetry continues without them and writes null / empty fields.
+ *
+ * @throw std::runtime_error if the file can not be opened or the period is not positive
+ **/
+void TaskTelemetry::open(const std::string& filename, int period_, Format format_, bool hardwareCounters)
+{
+  if(period_<=0){
+    std::stringstream errormessage;
+    errormessage<<"TaskTelemetry::open(): period must be positive, got "<<period_;
+    throw std::runtime_error(errormessage.str());
+  }
+
+  close();
+
+  log.open(filename.c_str());
+  if(!log.is_open()){
+    std::stringstream errormessage;
+    errormessage<<"TaskTelemetry::open(): could not open file "<<filename;
+    throw std::runtime_error(errormessage.str());
+  }
+
+  period=period_;
+  format=format_;
+  enabled=true;
+  intervalStart=Clock::now();
+
+  if(hardwareCounters) openHardwareCounters();
+
+  if(format==CSV)
+    log<<"circle,kind,index,name,calls,wall_s,attempted_moves,accepted_moves,moves_per_s,cycles,instructions\n";
+}
+
+/*****************************************************************************/
+/**
+ * @details Pending values of an incomplete interval are written with the
+ * circle of the last endCircle() call.
+ **/
+void TaskTelemetry::close()
+{
+  if(enabled){
+    bool pending=false;
+    for(size_t n=0;n<tasks.size();n++)
+      if(tasks[n].interval.calls>0) pending=true;
+    if(pending) writeInterval(lastCircle);
+    log.close();
+    enabled=false;
+  }
+
+#ifdef __linux__
+  if(perfInstructionsFd>=0) ::close(perfInstructionsFd);
+  if(perfGroupFd>=0) ::close(perfGroupFd);
+#endif
+  perfInstructionsFd=-1;
+  perfGroupFd=-1;
+}
+
+size_t TaskTelemetry::addTask(const std::string& kind, const std::string& name)
+{
+  Task task;
+  task.kind=kind;
+  task.name=name;
+  task.startCycles=0;
+  task.startInstructions=0;
+  tasks.push_back(task);
+  return tasks.size()-1;
+}
+
+void TaskTelemetry::startTask(size_t task)
+{
+  Task& t=tasks[task];
+  if(perfGroupFd>=0) readHardwareCounters(t.startCycles,t.startInstructions);
+  t.start=Clock::now();
+}
+
+void TaskTelemetry::stopTask(size_t task, uint64_t attemptedMoves, uint64_t acceptedMoves)
+{
+  const Clock::time_point stop=Clock::now();
+  Task& t=tasks[task];
+
+  Counters c;
+  c.calls=1;
+  c.seconds=std::chrono::duration<double>(stop-t.start).count();
+  c.attempted=attemptedMoves;
+  c.accepted=acceptedMoves;
+  if(perfGroupFd>=0){
+    uint64_t cycles,instructions;
+    readHardwareCounters(cycles,instructions);
+    c.cycles=cycles-t.startCycles;
+    c.instructions=instructions-t.startInstructions;
+  }
+
+  t.interval.add(c);
+  t.total.add(c);
+}
+
+void TaskTelemetry::endCircle(int nCircles)
+{
+  if(!enabled) return;
+  lastCircle=nCircles;
+  if(nCircles%period==0) writeInterval(nCircles);
+}
+
+void TaskTelemetry::writeInterval(int nCircles)
+{
+  const Clock::time_point now=Clock::now();
+
+  Counters all;
+  for(size_t n=0;n<tasks.size();n++){
+    writeRecord(nCircles,n,tasks[n].kind,tasks[n].name,tasks[n].interval);
+    all.add(tasks[n].interval);
+    tasks[n].interval=Counters();
+  }
+
+  all.seconds=std::chrono::duration<double>(now-intervalStart).count();
+  writeRecord(nCircles,tasks.size(),"total","TaskManager",all);
+  log.flush();
+
+  intervalStart=now;
+}
+
+void TaskTelemetry::writeRecord(int nCircles, size_t index, const std::string& kind, const std::string& name, const Counters& c)
+{
+  const double movesPerSecond=(c.seconds>0.0)?double(c.attempted)/c.seconds:0.0;
+  const bool hardware=(perfGroupFd>=0);
+
+  if(format==JSONLines){
+    log<<"{\"circle\":"<<nCircles
+       <<",\"kind\":\""<<kind<<"\""
+       <<",\"index\":"<<index
+       <<",\"name\":\""<<escapeJSON(name)<<"\""
+       <<",\"calls\":"<<c.calls
+       <<",\"wall_s\":"<<c.seconds
+       <<",\"attempted_moves\":"<<c.attempted
+       <<",\"accepted_moves\":"<<c.accepted
+       <<",\"moves_per_s\":"<<movesPerSecond;
+    if(hardware) log<<",\"cycles\":"<<c.cycles<<",\"instructions\":"<<c.instructions;
+    else log<<",\"cycles\":null,\"instructions\":null";
+    log<<"}\n";
+  }
+  else{
+    log<<nCircles<<","<<kind<<","<<index<<","<<quoteCSV(name)<<","
+       <<c.calls<<","<<c.seconds<<","<<c.attempted<<","<<c.accepted<<","<<movesPerSecond<<",";
+    if(hardware) log<<c.cycles<<","<<c.instructions;
+    else log<<",";
+    log<<"\n";
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @details Counts user space cycles and instructions of the calling thread.
+ **/
+void TaskTelemetry::openHardwareCounters()
+{
+#ifdef __linux__
+  struct perf_event_attr attr;
+  std::memset(&attr,0,sizeof(attr));
+  attr.size=sizeof(attr);
+  attr.type=PERF_TYPE_HARDWARE;
+  attr.config=PERF_COUNT_HW_CPU_CYCLES;
+  attr.exclude_kernel=1;
+  attr.exclude_hv=1;
+
+  perfGroupFd=syscall(__NR_perf_event_open,&attr,0,-1,-1,0);
+  if(perfGroupFd<0) return;
+
+  attr.config=PERF_COUNT_HW_INSTRUCTIONS;
+  perfInstructionsFd=syscall(__NR_perf_event_open,&attr,0,-1,perfGroupFd,0);
+  if(perfInstructionsFd<0){
+    ::close(perfGroupFd);
+    perfGroupFd=-1;
+    return;
+  }
+
+  ioctl(perfGroupFd,PERF_EVENT_IOC_RESET,PERF_IOC_FLAG_GROUP);
+  ioctl(perfGroupFd,PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void TaskTelemetry::readHardwareCounters(uint64_t& cycles, uint64_t& instructions) const
+{
+  cycles=0;
+  instructions=0;
+#ifdef __linux__
+  if(::read(perfGroupFd,&cycles,sizeof(cycles))!=sizeof(cycles)) cycles=0;
+  if(::read(perfInstructionsFd,&instructions,sizeof(instructions))!=sizeof(instructions)) instructions=0;
+#endif
+}
+
+std::string TaskTelemetry::typeName(const std::type_info& type)
+{
+#ifdef __GNUG__
+  int status=0;
+  char* demangled=abi::__cxa_demangle(type.name(),0,0,&status);
+  if(status==0 && demangled!=0){
+    std::string result(demangled);
+    std::free(demangled);
+    return result;
+  }
+#endif
+  return type.name();
+}
@@ -386,3 +386,44 @@ TEST_F(AnalyzerPermeabilityCalculatorTest, CheckPoreUpdate)
     remove("TestDumpA.dat");
         
 }
+
+TEST_F(AnalyzerPermeabilityCalculatorTest, CheckManySolventParticles)
+{
+    setInitConfig();
+    int32_t midplane=32;
+    int32_t width=4;
+    factor2sigma=3;
+    setConfig(midplane,width);
+
+    //add solvent monomers inside the boundaries, entering from above
+    int32_t nSolvent=1000;
+    for(int32_t i=0;i<nSolvent;i++){
+        ingredients.modifyMolecules().addMonomer(i%64,(i/64)%64,midplane+width);
+        ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setAttributeTag(5);
+    }
+
+    std::vector<MonomerGroup< MyIngredients::molecules_type> > objects;
+    hasOneOfTheseTwoTypes<7,8> hastype;
+    fill_connected_groups(ingredients.getMolecules(),objects,MonomerGroup<MyIngredients::molecules_type>((ingredients.getMolecules())),hastype);
+
+    PmAnalyzerDerived pmAnalyzer(ingredients,objects,64);
+    ASSERT_EQ(2+1+nSolvent,pmAnalyzer.particlesInsideBoundariesOld.size());
+    for(int32_t i=0;i<nSolvent;i++)
+        EXPECT_EQ(1,pmAnalyzer.particlesInsideBoundariesOld[3+i]);
+
+    //every second solvent monomer leaves the boundaries below the bilayer,
+    //every fourth leaves above, the rest stays inside
+    for(int32_t i=0;i<nSolvent;i++){
+        int32_t idx=5+i;
+        if(i%2==0) ingredients.modifyMolecules()[idx].setZ(midplane-factor2sigma*width-1);
+        else if(i%4==1) ingredients.modifyMolecules()[idx].setZ(midplane+factor2sigma*width+1);
+        else ingredients.modifyMolecules()[idx].setZ(midplane-width);
+    }
+    pmAnalyzer.execute();
+
+    EXPECT_EQ(nSolvent/2,pmAnalyzer.counterSolvent);
+    for(int32_t i=0;i<nSolvent;i++){
+        if(i%4==3) EXPECT_EQ(1,pmAnalyzer.particlesInsideBoundariesOld[3+i]);
+        else EXPECT_EQ(0,pmAnalyzer.particlesInsideBoundariesOld[3+i]);
+    }
+}
@@ -519,3 +519,49 @@ TEST_F(AnalyzerPoreFinderTest, ClusterAnalysisTwoPoreandCopolymers)
     remove("PolymerCoordinates.dat");
 
 }    
+
+TEST_F(AnalyzerPoreFinderTest, ClusterAnalysisPeriodicBoundaries)
+{
+    setInitConfig();
+
+    //pore centered in the corner of the box: the cluster is split by the
+    //periodic boundaries in x and y and spans the border between the bands
+    //of rows, which are labelled independently
+    int32_t radius=4;
+    VectorInt2 center(0,0);
+    setPore(radius,center);
+
+    std::vector<MonomerGroup< MyIngredients::molecules_type> > objects;
+    PmAnalyzerDerived analPore(ingredients,objects);
+    analPore.execute();
+
+    float pi=3.142;
+    int32_t area=pi*radius*radius;
+    int32_t diff= area-analPore.coordinatesOfPore.size();
+    EXPECT_LE(abs(diff),4);
+
+    //only one pore, first site is the one with the smallest x and y
+    ASSERT_EQ(1,analPore.centriod.size());
+    EXPECT_EQ(0,analPore.coordinatesOfPore[0].getX());
+    EXPECT_EQ(0,analPore.coordinatesOfPore[0].getY());
+
+    EXPECT_LE(abs(reduceDistanceInPeriodicSpace(analPore.centriod[0].getX(),32)),1);
+    EXPECT_LE(abs(reduceDistanceInPeriodicSpace(analPore.centriod[0].getY(),32)),1);
+
+    //a stripe along y across the periodic boundary in x is also one cluster
+    ingredients.modifyMolecules().resize(0);
+    for(int32_t x=0;x<32;x++)
+        for(int32_t y=0;y<32;y++){
+            if(x==31 || x<=1) continue;
+            ingredients.modifyMolecules().addMonomer(x,y,16);
+            ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setAttributeTag(2);
+        }
+    analPore.execute();
+
+    //tails occupy x..x+1, thus only x=0 and x=1 remain free
+    EXPECT_EQ(64,analPore.coordinatesOfPore.size());
+    EXPECT_EQ(1,analPore.centriod.size());
+
+    remove("PoreSize.dat");
+    remove("PoreCoordinates.dat");
+}
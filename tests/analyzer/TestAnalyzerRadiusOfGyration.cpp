@@ -212,6 +212,16 @@ TEST_F(AnalyzerRadiusOfGyrationTest, FileName)
 	remove("outfile.dat");
 	remove("Rgoutfile.dat");
 
+	//binary output goes to a file with its own extension
+	analyzer.setOutputFormat(ResultFormattingTools::BinaryFormat);
+	analyzer.setOutputFile("Rgoutfile.dat");
+	analyzer.cleanup();
+	EXPECT_FALSE(fileExists("Rgoutfile.dat"));
+	EXPECT_TRUE(fileExists("Rgoutfile.dat.bin"));
+	std::vector<std::vector<double> > columns;
+	ResultFormattingTools::readBinaryResultFile("Rgoutfile.dat.bin",columns);
+	EXPECT_EQ(columns.size(),5);
+	remove("Rgoutfile.dat.bin");
 }
 
 /*****************************************************************************/
@@ -346,3 +356,57 @@ TEST_F(AnalyzerRadiusOfGyrationTest, CheckGroups)
 	EXPECT_EQ(value,4.0);
 
 }
+
+/*****************************************************************************/
+/**
+ * @fn TEST_F(AnalyzerRadiusOfGyrationTest, GyrationTensorsOfManyGroups)
+ * @brief Test the per group gyration tensors for more groups than threads
+ * */
+/*****************************************************************************/
+TEST_F(AnalyzerRadiusOfGyrationTest, GyrationTensorsOfManyGroups)
+{
+	//100 rods of different length along x, y or z
+	std::vector<MonomerGroup<MyIngredients::molecules_type> > groupVector;
+	for(int g=0;g<100;g++)
+	{
+		MonomerGroup<MyIngredients::molecules_type> group(ingredients.getMolecules());
+		int length=g%7+1;
+		for(int i=0;i<length;i++)
+		{
+			VectorInt3 pos(3*g,0,0);
+			if(g%3==0) pos.setX(pos.getX()+2*i);
+			else if(g%3==1) pos.setY(2*i);
+			else pos.setZ(2*i);
+			group.push_back(ingredients.modifyMolecules().addMonomer(pos.getX(),pos.getY(),pos.getZ()));
+		}
+		groupVector.push_back(group);
+	}
+
+	RgAnalyzerDerived analyzer(ingredients);
+	analyzer.setMonomerGroups(groupVector);
+	analyzer.initialize();
+	analyzer.execute();
+
+	const std::vector<GyrationTensor>& tensors=analyzer.getGyrationTensors();
+	ASSERT_EQ(tensors.size(),100);
+	double averageRg2=0.0;
+	for(int g=0;g<100;g++)
+	{
+		//Rg2 of a rod of n monomers with spacing 2: (n^2-1)/3
+		double length=g%7+1;
+		double expectedRg2=(length*length-1.0)/3.0;
+		averageRg2+=expectedRg2/100.0;
+		EXPECT_EQ(tensors[g].getNumberOfPositions(),g%7+1);
+		EXPECT_NEAR(tensors[g].getRg2(),expectedRg2,1e-10);
+		EXPECT_NEAR(tensors[g].getAsphericity(),expectedRg2,1e-10);
+		EXPECT_NEAR(tensors[g].getEigenvalues().getX(),0.0,1e-10);
+		if(g%3==0){ EXPECT_NEAR(tensors[g].getXX(),expectedRg2,1e-10); }
+		if(g%3==1){ EXPECT_NEAR(tensors[g].getYY(),expectedRg2,1e-10); }
+		if(g%3==2){ EXPECT_NEAR(tensors[g].getZZ(),expectedRg2,1e-10); }
+	}
+
+	analyzer.cleanup();
+	double value=getValueFromFile("Rg2TimeSeries.dat",0,4);
+	EXPECT_NEAR(value,averageRg2,1e-10);
+	remove("Rg2TimeSeries.dat");
+}
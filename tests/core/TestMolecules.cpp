@@ -365,3 +365,48 @@ TEST_F(MoleculesTest,Clear){
   EXPECT_EQ(0,ingredients.getMolecules().size());
 
 }
+
+TEST_F(MoleculesTest,Permute){
+
+  Molecules <VectorInt3,3,int> molecules;
+  for(int n=0;n<5;n++) molecules.addMonomer(n,10*n,100*n);
+  molecules.connect(0,1,7);
+  molecules.connect(1,2,8);
+  molecules.connect(1,4,9);
+
+  //new vertex i is old vertex order[i]
+  std::vector<uint32_t> order;
+  order.push_back(4);
+  order.push_back(2);
+  order.push_back(0);
+  order.push_back(3);
+  order.push_back(1);
+  molecules.permute(order);
+
+  EXPECT_EQ(5,molecules.size());
+  for(uint32_t i=0;i<5;i++)
+  {
+	  EXPECT_EQ(int32_t(order[i]),molecules[i].getX());
+	  EXPECT_EQ(int32_t(100*order[i]),molecules[i].getZ());
+  }
+
+  //old 1 is now 4, its links keep their order: old 0,2,4 -> 2,1,0
+  EXPECT_EQ(3,molecules.getNumLinks(4));
+  EXPECT_EQ(2,molecules.getNeighborIdx(4,0));
+  EXPECT_EQ(1,molecules.getNeighborIdx(4,1));
+  EXPECT_EQ(0,molecules.getNeighborIdx(4,2));
+  EXPECT_EQ(3,molecules.getTotalNumLinks());
+  EXPECT_EQ(7,molecules.getLinkInfo(2,4));
+  EXPECT_EQ(8,molecules.getLinkInfo(4,1));
+  EXPECT_EQ(9,molecules.getLinkInfo(0,4));
+  EXPECT_FALSE(molecules.areConnected(0,1));
+  EXPECT_EQ(0,molecules.getNumLinks(3));
+
+  //invalid permutations
+  std::vector<uint32_t> tooShort(4,0);
+  EXPECT_THROW(molecules.permute(tooShort),std::runtime_error);
+  order[1]=4;
+  EXPECT_THROW(molecules.permute(order),std::runtime_error);
+  order[1]=5;
+  EXPECT_THROW(molecules.permute(order),std::runtime_error);
+}
@@ -33,8 +33,11 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <LeMonADE/updater/AbstractUpdater.h>
 #include <LeMonADE/analyzer/AbstractAnalyzer.h>
@@ -90,6 +93,37 @@ private:
 };
 
 
+class DummyMoveUpdater:public AbstractUpdater
+{
+public:
+	DummyMoveUpdater():attempted(0),accepted(0){}
+	bool execute(){
+		attempted+=10;
+		accepted+=3;
+		return true;
+	}
+
+	void initialize(){}
+	void cleanup(){}
+
+	uint64_t getNAttemptedMoves() const {return attempted;}
+	uint64_t getNAcceptedMoves() const {return accepted;}
+private:
+	uint64_t attempted;
+	uint64_t accepted;
+};
+
+//reads all lines of a file
+static vector<string> readLines(const string& filename)
+{
+	vector<string> lines;
+	ifstream file(filename.c_str());
+	string line;
+	while(getline(file,line)) lines.push_back(line);
+	return lines;
+}
+
+
 /*
  * this test checks if new updaters and analyzers can be added correctly.
  * in particular it is checked if the execution periods are set and work.
@@ -197,5 +231,59 @@ TEST(TaskManagerTest, InitAndCleanup)
   EXPECT_TRUE(analyzer2->isCleanedUp);
 }
 
-
-
+TEST(TaskManagerTest, Telemetry)
+{
+  string textstring;
+  string filename("TestTaskManagerTelemetry.jsonl");
+
+  {
+    TaskManager taskmanager;
+    taskmanager.addUpdater(new DummyMoveUpdater);
+    taskmanager.addAnalyzer(new DummyAnalyzer(textstring),2);
+    EXPECT_THROW(taskmanager.enableTelemetry(filename,0),std::runtime_error);
+    taskmanager.enableTelemetry(filename,2);
+    taskmanager.initialize();
+    taskmanager.run(5);
+    taskmanager.cleanup();
+
+    const TaskTelemetry& telemetry=taskmanager.getTelemetry();
+    EXPECT_FALSE(telemetry.isEnabled());
+    ASSERT_EQ(telemetry.getNTasks(),2);
+    EXPECT_EQ(telemetry.getName(0),"DummyMoveUpdater");
+    EXPECT_EQ(telemetry.getName(1),"DummyAnalyzer");
+    EXPECT_EQ(telemetry.getNCalls(0),5);
+    EXPECT_EQ(telemetry.getNCalls(1),2);
+    EXPECT_EQ(telemetry.getNAttemptedMoves(0),50);
+    EXPECT_EQ(telemetry.getNAcceptedMoves(0),15);
+    EXPECT_EQ(telemetry.getNAttemptedMoves(1),0);
+    EXPECT_GE(telemetry.getWallTime(0),0.0);
+  }
+
+  //records after circles 2 and 4 and the remaining circle 5 at cleanup,
+  //each with two tasks and the total
+  vector<string> lines=readLines(filename);
+  ASSERT_EQ(lines.size(),9);
+  EXPECT_EQ(lines[0].find("{\"circle\":2,\"kind\":\"updater\",\"index\":0,\"name\":\"DummyMoveUpdater\",\"calls\":2,"),0);
+  EXPECT_NE(lines[0].find("\"attempted_moves\":20,\"accepted_moves\":6,"),string::npos);
+  EXPECT_EQ(lines[1].find("{\"circle\":2,\"kind\":\"analyzer\",\"index\":1,\"name\":\"DummyAnalyzer\",\"calls\":1,"),0);
+  EXPECT_EQ(lines[2].find("{\"circle\":2,\"kind\":\"total\",\"index\":2,\"name\":\"TaskManager\",\"calls\":3,"),0);
+  EXPECT_EQ(lines[6].find("{\"circle\":5,\"kind\":\"updater\",\"index\":0,\"name\":\"DummyMoveUpdater\",\"calls\":1,"),0);
+  EXPECT_EQ(lines[7].find("{\"circle\":5,\"kind\":\"analyzer\",\"index\":1,\"name\":\"DummyAnalyzer\",\"calls\":0,"),0);
+  EXPECT_EQ(lines[8][lines[8].size()-1],'}');
+
+  //the same as CSV
+  {
+    TaskManager taskmanager;
+    taskmanager.addUpdater(new DummyMoveUpdater);
+    taskmanager.enableTelemetry(filename,1,TaskTelemetry::CSV);
+    taskmanager.run(2);
+  }
+  lines=readLines(filename);
+  ASSERT_EQ(lines.size(),5);
+  EXPECT_EQ(lines[0],"circle,kind,index,name,calls,wall_s,attempted_moves,accepted_moves,moves_per_s,cycles,instructions");
+  EXPECT_EQ(lines[1].find("1,updater,0,\"DummyMoveUpdater\",1,"),0);
+  EXPECT_EQ(lines[3].find("2,updater,0,\"DummyMoveUpdater\",1,"),0);
+  EXPECT_EQ(lines[4].find("2,total,1,\"TaskManager\",1,"),0);
+
+  remove(filename.c_str());
+}
@@ -9,6 +9,7 @@
 #include <LeMonADE/feature/FeatureBendingPotential.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
 #include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
+#include <LeMonADE/utility/EnergyReport.h>
 
 using namespace std;
 /*****************************************************************************/
@@ -416,3 +417,65 @@ TEST_F(BendingPotentialTest, CheckReadWriteAndbondVectorToIndex)
     EXPECT_EQ(108,count1);
 
 }
+
+TEST_F(BendingPotentialTest, BendingEnergy)
+{
+    typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureBondset<>,FeatureBendingPotential) Features;
+    typedef ConfigureSystem<VectorInt3,Features> Config;
+    typedef Ingredients<Config> Ing;
+    Ing myIngredients;
+
+    myIngredients.setBoxX(64);
+    myIngredients.setBoxY(64);
+    myIngredients.setBoxZ(64);
+    myIngredients.setPeriodicX(1);
+    myIngredients.setPeriodicY(1);
+    myIngredients.setPeriodicZ(1);
+    myIngredients.modifyBondset().addBFMclassicBondset();
+
+    setMixedLinearChain(myIngredients,10);
+    myIngredients.setBendingPotential(myIngredients,1,0.5);
+    myIngredients.setBendingPotential(myIngredients,2,1.5);
+
+    //without chain ends the energy is not known
+    EXPECT_DOUBLE_EQ(0.0,myIngredients.getBendingEnergy());
+
+    //the straight chain has no bending energy
+    myIngredients.setChainEnds(myIngredients);
+    EXPECT_DOUBLE_EQ(0.0,myIngredients.getBendingEnergy());
+
+    //bend the chain at monomer 2 by 90 degrees
+    myIngredients.modifyMolecules()[3].setAllCoordinates(4,7,5);
+    for(int32_t i=4;i<10;i++)
+        myIngredients.modifyMolecules()[i].setAllCoordinates(4,7+2*(i-3),5);
+    myIngredients.synchronize();
+    double angle=acos(0.0);
+    EXPECT_NEAR(0.5*angle*angle,myIngredients.getBendingEnergy(),1e-5);
+
+    EnergyReport report(myIngredients);
+    EXPECT_DOUBLE_EQ(myIngredients.getBendingEnergy(),report.getEnergy("FeatureBendingPotential"));
+
+    //the running energy follows local moves
+    RandomNumberGenerators rng;
+    std::vector<uint32_t> rngState;
+    rng.getR250State(rngState);
+
+    MoveLocalSc move;
+    uint32_t nAccepted=0;
+    for(uint32_t n=0;n<20000;n++)
+    {
+        move.init(myIngredients);
+        if(move.check(myIngredients))
+        {
+            move.apply(myIngredients);
+            nAccepted++;
+        }
+    }
+    EXPECT_GT(nAccepted,0u);
+    double runningEnergy=myIngredients.getBendingEnergy();
+    EXPECT_NEAR(myIngredients.calculateBendingEnergy(myIngredients),runningEnergy,1e-3);
+    myIngredients.synchronize();
+    EXPECT_DOUBLE_EQ(myIngredients.calculateBendingEnergy(myIngredients),myIngredients.getBendingEnergy());
+
+    rng.setR250State(rngState);
+}
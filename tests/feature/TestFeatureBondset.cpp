@@ -247,6 +247,107 @@ TEST_F(FeatureBondsetTest,checkLocalScBfmMove)
 	}
 }
 
+/***********************************************************************/
+//checkMove and applyMove with the cache of bond-vector indices
+/***********************************************************************/
+TEST_F(FeatureBondsetTest,BondIndexCache)
+{
+	Ing cached;
+	Ing reference;
+	Ing* systems[2]={&cached,&reference};
+
+	for(int s=0;s<2;s++)
+	{
+		Ing& ingredients=*systems[s];
+		ingredients.setPeriodicX(true);
+		ingredients.setPeriodicY(true);
+		ingredients.setPeriodicZ(true);
+		ingredients.setBoxX(32);
+		ingredients.setBoxY(32);
+		ingredients.setBoxZ(32);
+		ingredients.modifyBondset().addBFMclassicBondset();
+
+		//a comb: backbone along x with a side chain at every second monomer
+		uint32_t previous=0;
+		for(int32_t m=0;m<10;m++)
+		{
+			uint32_t idx=ingredients.modifyMolecules().addMonomer(2*m,0,0);
+			if(m>0) ingredients.modifyMolecules().connect(previous,idx);
+			previous=idx;
+			if(m%2==0){
+				uint32_t side=ingredients.modifyMolecules().addMonomer(2*m,2,0);
+				ingredients.modifyMolecules().connect(idx,side);
+			}
+		}
+	}
+
+	EXPECT_FALSE(cached.getUseBondIndexCache());
+	cached.setUseBondIndexCache(true);
+	EXPECT_TRUE(cached.getUseBondIndexCache());
+	EXPECT_FALSE(cached.isBondIndexCacheActive());
+	cached.synchronize(cached);
+	reference.synchronize(reference);
+	EXPECT_TRUE(cached.isBondIndexCacheActive());
+	EXPECT_FALSE(reference.isBondIndexCacheActive());
+
+	//the same moves are accepted with and without cache
+	MoveLocalSc move;
+	uint32_t nAccepted=0;
+	for(int i=0;i<20000;i++)
+	{
+		move.init(cached);
+		bool accepted=move.check(cached);
+		EXPECT_EQ(accepted,move.check(reference));
+		if(accepted){
+			move.apply(cached);
+			move.apply(reference);
+			nAccepted++;
+		}
+
+		//a link made after synchronize is checked by its bond-vector
+		if(i==10000){
+			cached.modifyMolecules().disconnect(0,1);
+			reference.modifyMolecules().disconnect(0,1);
+			cached.modifyMolecules().connect(0,1);
+			reference.modifyMolecules().connect(0,1);
+			EXPECT_FALSE(FastBondset::isBondIndex(cached.getMolecules().getBondIndexUnchecked(0,1)));
+		}
+	}
+	EXPECT_GT(nAccepted,0u);
+
+	//the cache holds the indices of the current bond-vectors
+	const Ing::molecules_type& molecules=cached.getMolecules();
+	for(uint32_t n=0;n<molecules.size();n++)
+	{
+		EXPECT_EQ(reference.getMolecules()[n],molecules[n]);
+		for(uint32_t j=0;j<molecules.getNumLinks(n);j++)
+			EXPECT_EQ(cached.getBondset().bondVectorToIndex(molecules[molecules.getNeighborIdx(n,j)]-molecules[n]),molecules.getBondIndexUnchecked(n,j));
+	}
+
+	//switching the cache off takes effect immediately
+	cached.setUseBondIndexCache(false);
+	EXPECT_FALSE(cached.isBondIndexCacheActive());
+	EXPECT_NO_THROW(cached.synchronize(cached));
+	EXPECT_FALSE(cached.isBondIndexCacheActive());
+
+	//the look-up index does not exist for SlowBondset
+	typedef LOKI_TYPELIST_2(FeatureBondset<SlowBondset>,FeatureBox) SlowFeatures;
+	Ingredients<ConfigureSystem<VectorInt3,SlowFeatures> > slow;
+	slow.setBoxX(32);
+	slow.setBoxY(32);
+	slow.setBoxZ(32);
+	slow.setPeriodicX(true);
+	slow.setPeriodicY(true);
+	slow.setPeriodicZ(true);
+	slow.modifyBondset().addBFMclassicBondset();
+	slow.modifyMolecules().addMonomer(0,0,0);
+	slow.modifyMolecules().addMonomer(2,0,0);
+	slow.modifyMolecules().connect(0,1);
+	EXPECT_NO_THROW(slow.synchronize(slow));
+	slow.setUseBondIndexCache(true);
+	EXPECT_THROW(slow.synchronize(slow),std::runtime_error);
+}
+
 /************************************************************************/
 //test the class ReadBondset
 /************************************************************************/
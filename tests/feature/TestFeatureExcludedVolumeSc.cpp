@@ -353,6 +353,55 @@ TEST_F(TestFeatureExcludedVolumeSc,DiagonalMoves)
 }
 
 
+//the tabulated sites of the diagonal move must leave exactly the cube of the
+//monomer occupied, also across the periodic boundaries
+TEST_F(TestFeatureExcludedVolumeSc,DiagonalMoveSites)
+{
+  typedef LOKI_TYPELIST_1(FeatureExcludedVolumeSc< >) Features;
+  typedef ConfigureSystem<VectorInt3,Features> Config;
+  typedef Ingredients<Config> Ing;
+  Ing ingredients;
+
+  ingredients.setBoxX(8);
+  ingredients.setBoxY(8);
+  ingredients.setBoxZ(8);
+  ingredients.setPeriodicX(1);
+  ingredients.setPeriodicY(1);
+  ingredients.setPeriodicZ(1);
+  ingredients.modifyMolecules().resize(1);
+  ingredients.modifyMolecules()[0].setAllCoordinates(7,0,3);
+  ingredients.synchronize(ingredients);
+
+  MoveLocalScDiag move;
+  const int32_t steps[18][3]={{1,0,0},{-1,0,0},{0,1,0},{0,-1,0},{0,0,1},{0,0,-1},
+			      {0,1,1},{0,-1,1},{0,1,-1},{0,-1,-1},{1,0,1},{1,0,-1},
+			      {-1,0,1},{-1,0,-1},{1,1,0},{1,-1,0},{-1,1,0},{-1,-1,0}};
+
+  for(size_t i=0;i<18;i++)
+  {
+    //move forth and back again
+    for(int32_t sign=1;sign>=-1;sign-=2)
+    {
+      move.init(ingredients,0,VectorInt3(sign*steps[i][0],sign*steps[i][1],sign*steps[i][2]));
+      EXPECT_EQ((i<6 ? 4u : 6u),move.getNumMovedSites());
+      EXPECT_TRUE(move.check(ingredients));
+      move.apply(ingredients);
+
+      VectorInt3 pos=ingredients.getMolecules()[0].getVector3D();
+      uint32_t nOccupied=0;
+      for(int32_t x=0;x<8;x++)
+      for(int32_t y=0;y<8;y++)
+      for(int32_t z=0;z<8;z++)
+      {
+	bool inCube=((x-pos.getX()+8)%8<2) && ((y-pos.getY()+8)%8<2) && ((z-pos.getZ()+8)%8<2);
+	EXPECT_EQ(inCube,ingredients.getLatticeEntry(x,y,z)!=0);
+	if(ingredients.getLatticeEntry(x,y,z)!=0) nOccupied++;
+      }
+      EXPECT_EQ(8u,nOccupied);
+    }
+  }
+}
+
 TEST_F(TestFeatureExcludedVolumeSc,CheckInterface)
 {
 	typedef LOKI_TYPELIST_1(FeatureExcludedVolumeSc< >) Features;
@@ -0,0 +1,265 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureExternalField.h>
+#include <LeMonADE/feature/FeatureLinearForce.h>
+#include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
+#include <LeMonADE/updater/UpdaterReadBfmFile.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/updater/moves/MoveLocalScDiag.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+class TestFeatureExternalField: public ::testing::Test{
+public:
+  typedef LOKI_TYPELIST_2(FeatureMoleculesIO,FeatureExternalField) Features;
+  typedef ConfigureSystem<VectorInt3,Features,7> Config;
+  typedef Ingredients<Config> Ing;
+
+  //redirect cout output
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+  };
+
+  //restore original output
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+  };
+
+  void initIng(Ing& ingredients){
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(1);
+    ingredients.setPeriodicY(1);
+    ingredients.setPeriodicZ(1);
+    ingredients.modifyMolecules().resize(4);
+    ingredients.modifyMolecules()[0].setAllCoordinates(2,2,2);
+    ingredients.modifyMolecules()[1].setAllCoordinates(6,2,2);
+    ingredients.modifyMolecules()[2].setAllCoordinates(2,6,-3);
+    ingredients.modifyMolecules()[3].setAllCoordinates(6,6,7);
+    for(uint32_t n=0;n<4;n++) ingredients.modifyMolecules()[n].setAttributeTag(n);
+    ingredients.synchronize();
+  }
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+};
+
+TEST_F(TestFeatureExternalField,SetterGetter)
+{
+  FeatureExternalField field;
+  EXPECT_EQ(0u,field.getNTypes());
+  EXPECT_EQ(0.0,field.getForce(3).getX());
+  EXPECT_TRUE(field.getPotentialProfile(3,1).empty());
+
+  field.setForce(3,VectorDouble3(0.5,-1.0,2.0));
+  EXPECT_EQ(4u,field.getNTypes());
+  EXPECT_EQ(-1.0,field.getForce(3).getY());
+
+  field.setPeriodicModulation(1,2,0.5,8);
+  ASSERT_EQ(8u,field.getPotentialProfile(1,2).size());
+  EXPECT_DOUBLE_EQ(0.5,field.getPotentialProfile(1,2)[0]);
+  EXPECT_NEAR(0.0,field.getPotentialProfile(1,2)[2],1e-12);
+  EXPECT_DOUBLE_EQ(-0.5,field.getPotentialProfile(1,2)[4]);
+
+  //potential: -f*r plus the folded profile
+  EXPECT_DOUBLE_EQ(-(0.5*1-1.0*2+2.0*3),field.getPotential(3,VectorInt3(1,2,3)));
+  EXPECT_DOUBLE_EQ(-0.5,field.getPotential(1,VectorInt3(0,0,-4)));
+  EXPECT_DOUBLE_EQ(0.0,field.getPotential(7,VectorInt3(1,2,3)));
+
+  EXPECT_THROW(field.setForce(-1,VectorDouble3(1.0,0.0,0.0)),std::runtime_error);
+  EXPECT_THROW(field.setPotentialProfile(1,3,std::vector<double>(4,0.0)),std::runtime_error);
+
+  field.setPotentialProfile(1,2,std::vector<double>());
+  EXPECT_TRUE(field.getPotentialProfile(1,2).empty());
+
+  field.clearField();
+  EXPECT_EQ(0u,field.getNTypes());
+}
+
+//the tabulated Boltzmann factors must agree with the energy differences of
+//the moves for all directions of MoveLocalSc and MoveLocalScDiag
+TEST_F(TestFeatureExternalField,CheckMoveTables)
+{
+  Ing ingredients;
+  initIng(ingredients);
+
+  FeatureExternalField field;
+  field.setForce(1,VectorDouble3(0.3,-0.2,0.0));
+  field.setForce(2,VectorDouble3(0.0,0.0,0.1));
+  field.setPeriodicModulation(2,2,0.7,5,0.3);
+  std::vector<double> profile;
+  profile.push_back(0.0); profile.push_back(1.5); profile.push_back(-0.5);
+  field.setPotentialProfile(3,0,profile);
+  field.setPotentialProfile(3,1,profile);
+
+  for(uint32_t n=0;n<4;n++)
+  for(int dx=-1;dx<=1;dx++)
+  for(int dy=-1;dy<=1;dy++)
+  for(int dz=-1;dz<=1;dz++)
+  {
+    VectorInt3 dir(dx,dy,dz);
+    //MoveLocalScDiag has the 6 perpendicular and 12 face diagonal steps
+    const int length=std::abs(dx)+std::abs(dy)+std::abs(dz);
+    if(length==0 || length==3) continue;
+
+    const VectorInt3& pos=ingredients.getMolecules()[n];
+    const double dE=field.getPotential(n,pos+dir)-field.getPotential(n,pos);
+    EXPECT_NEAR(dE,field.getMoveEnergy(n,pos,dir),1e-12);
+
+    MoveLocalScDiag diagMove;
+    diagMove.init(ingredients,n,dir);
+    EXPECT_TRUE(field.checkMove(ingredients,diagMove));
+    EXPECT_NEAR(std::exp(-dE),diagMove.getProbability(),1e-12*std::exp(-dE));
+
+    if(length==1)
+    {
+      MoveLocalSc scMove;
+      scMove.init(ingredients,n,dir);
+      EXPECT_TRUE(field.checkMove(ingredients,scMove));
+      EXPECT_NEAR(std::exp(-dE),scMove.getProbability(),1e-12*std::exp(-dE));
+    }
+  }
+}
+
+//a force (-A,0,0) on type 4 and (A,0,0) on type 5 is FeatureLinearForce
+TEST_F(TestFeatureExternalField,LinearForceEquivalent)
+{
+  typedef LOKI_TYPELIST_2(FeatureMoleculesIO,FeatureLinearForce) LinearFeatures;
+  typedef ConfigureSystem<VectorInt3,LinearFeatures,7> LinearConfig;
+  Ingredients<LinearConfig> ingredients;
+  ingredients.setBoxX(16);
+  ingredients.setBoxY(16);
+  ingredients.setBoxZ(16);
+  ingredients.setPeriodicX(1);
+  ingredients.setPeriodicY(1);
+  ingredients.setPeriodicZ(1);
+  ingredients.modifyMolecules().resize(2);
+  ingredients.modifyMolecules()[0].setAllCoordinates(2,2,2);
+  ingredients.modifyMolecules()[1].setAllCoordinates(6,2,2);
+  ingredients.modifyMolecules()[0].setAttributeTag(4);
+  ingredients.modifyMolecules()[1].setAttributeTag(5);
+  ingredients.setAmplitudeForce(0.8);
+  ingredients.setForceOn(true);
+  ingredients.synchronize();
+
+  FeatureExternalField field;
+  field.setForce(4,VectorDouble3(-0.8,0.0,0.0));
+  field.setForce(5,VectorDouble3(0.8,0.0,0.0));
+  field.synchronize(ingredients);
+  EXPECT_NEAR(ingredients.getLinearForceEnergy(),field.getFieldEnergy(),1e-12);
+
+  for(uint32_t n=0;n<2;n++)
+  for(int dx=-1;dx<=1;dx++)
+  {
+    MoveLocalSc linearMove, fieldMove;
+    linearMove.init(ingredients,n,VectorInt3(dx,1-std::abs(dx),0));
+    fieldMove.init(ingredients,n,VectorInt3(dx,1-std::abs(dx),0));
+    ingredients.FeatureLinearForce::checkMove(ingredients,linearMove);
+    field.checkMove(ingredients,fieldMove);
+    EXPECT_NEAR(linearMove.getProbability(),fieldMove.getProbability(),1e-12*linearMove.getProbability());
+  }
+}
+
+//the energy kept up to date in applyMove must agree with the recalculated one
+TEST_F(TestFeatureExternalField,EnergyTracking)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> rngState;
+  rng.getR250State(rngState);
+  rng.seedDefaultValuesAll();
+
+  Ing ingredients;
+  ingredients.setForce(1,VectorDouble3(0.3,-0.2,0.0));
+  ingredients.setPeriodicModulation(2,2,0.7,5,0.3);
+  ingredients.setPeriodicModulation(3,0,0.4,16);
+  initIng(ingredients);
+
+  double expectedEnergy=0.0;
+  for(uint32_t n=0;n<4;n++)
+    expectedEnergy+=ingredients.getPotential(n,ingredients.getMolecules()[n]);
+  EXPECT_NEAR(expectedEnergy,ingredients.getFieldEnergy(),1e-12);
+
+  MoveLocalScDiag move;
+  uint32_t nAccepted=0;
+  for(uint32_t i=0;i<2000;i++){
+    move.init(ingredients);
+    if(move.check(ingredients)){
+      move.apply(ingredients);
+      nAccepted++;
+    }
+  }
+  EXPECT_GT(nAccepted,0u);
+
+  const double trackedEnergy=ingredients.getFieldEnergy();
+  ingredients.synchronize();
+  EXPECT_NEAR(ingredients.getFieldEnergy(),trackedEnergy,1e-9);
+
+  rng.setR250State(rngState);
+}
+
+TEST_F(TestFeatureExternalField,WriterReader)
+{
+  const std::string filename="TestFeatureExternalField.bfm";
+
+  Ing ingredients;
+  ingredients.setForce(1,VectorDouble3(0.3,-0.2,0.0));
+  ingredients.setPeriodicModulation(2,2,0.7,5,0.3);
+  initIng(ingredients);
+
+  AnalyzerWriteBfmFile<Ing> writer(filename,ingredients,AnalyzerWriteBfmFile<Ing>::NEWFILE);
+  writer.initialize();
+  writer.execute();
+  writer.closeFile();
+
+  Ing ingredients2;
+  UpdaterReadBfmFile<Ing> reader(filename,ingredients2,UpdaterReadBfmFile<Ing>::READ_LAST_CONFIG_SAVE);
+  reader.initialize();
+
+  EXPECT_EQ(ingredients.getNTypes(),ingredients2.getNTypes());
+  EXPECT_DOUBLE_EQ(0.3,ingredients2.getForce(1).getX());
+  EXPECT_DOUBLE_EQ(-0.2,ingredients2.getForce(1).getY());
+  ASSERT_EQ(5u,ingredients2.getPotentialProfile(2,2).size());
+  for(size_t c=0;c<5;c++)
+    EXPECT_DOUBLE_EQ(ingredients.getPotentialProfile(2,2)[c],ingredients2.getPotentialProfile(2,2)[c]);
+  EXPECT_NEAR(ingredients.getFieldEnergy(),ingredients2.getFieldEnergy(),1e-12);
+
+  EXPECT_EQ(0,remove(filename.c_str()));
+}
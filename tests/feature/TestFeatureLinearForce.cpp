@@ -38,6 +38,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
 #include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
+#include <LeMonADE/utility/EnergyReport.h>
 
 class TestFeatureLinearForce : public ::testing::Test{
 public:
@@ -203,5 +204,53 @@ TEST_F(TestFeatureLinearForce,checkMoveLocalSc){
     
 }
 
+TEST_F(TestFeatureLinearForce,Energy){
+    initIng();
+    ingredients.setAmplitudeForce(0.5);
+    ingredients.modifyMolecules().resize(3);
+    ingredients.modifyMolecules()[0].setAllCoordinates(6,6,6);
+    ingredients.modifyMolecules()[1].setAllCoordinates(3,6,6);
+    ingredients.modifyMolecules()[2].setAllCoordinates(8,6,6);
+    ingredients.modifyMolecules()[0].setAttributeTag(1);
+    ingredients.modifyMolecules()[1].setAttributeTag(4);
+    ingredients.modifyMolecules()[2].setAttributeTag(5);
+    ingredients.synchronize();
 
+    //no energy while the force is switched off
+    EXPECT_DOUBLE_EQ(0.0,ingredients.getLinearForceEnergy());
+    ingredients.setForceOn(true);
+    EXPECT_DOUBLE_EQ(0.5*(3-8),ingredients.getLinearForceEnergy());
 
+    RandomNumberGenerators rng;
+    std::vector<uint32_t> rngState;
+    rng.getR250State(rngState);
+
+    //the energy difference of the moves
+    MoveLocalSc move;
+    move.init(ingredients,1,VectorInt3(1,0,0));
+    move.apply(ingredients);
+    EXPECT_DOUBLE_EQ(0.5*(4-8),ingredients.getLinearForceEnergy());
+    move.init(ingredients,2,VectorInt3(1,0,0));
+    move.apply(ingredients);
+    EXPECT_DOUBLE_EQ(0.5*(4-9),ingredients.getLinearForceEnergy());
+    move.init(ingredients,0,VectorInt3(-1,0,0));
+    move.apply(ingredients);
+    EXPECT_DOUBLE_EQ(0.5*(4-9),ingredients.getLinearForceEnergy());
+
+    MoveLocalScDiag diagMove;
+    diagMove.init(ingredients,1,VectorInt3(-1,1,0));
+    diagMove.apply(ingredients);
+    EXPECT_DOUBLE_EQ(0.5*(3-9),ingredients.getLinearForceEnergy());
+
+    //the sum of the coordinates is kept when the amplitude changes
+    ingredients.setAmplitudeForce(2.0);
+    EXPECT_DOUBLE_EQ(2.0*(3-9),ingredients.getLinearForceEnergy());
+    ingredients.synchronize();
+    EXPECT_DOUBLE_EQ(2.0*(3-9),ingredients.getLinearForceEnergy());
+
+    EnergyReport report(ingredients);
+    ASSERT_EQ(1u,report.size());
+    EXPECT_DOUBLE_EQ(2.0*(3-9),report.getTotalEnergy());
+
+    rng.setR250State(rngState);
+}
@@ -11,6 +11,7 @@
 #include <LeMonADE/feature/FeatureNNInteractionBcc.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
 #include <LeMonADE/updater/moves/MoveAddMonomerBcc.h>
+#include <LeMonADE/utility/EnergyReport.h>
 
 using namespace std;
 
@@ -1190,3 +1191,79 @@ TEST_F(NNInteractionBccTest,ApplyMoveAddMonomerBcc)
     EXPECT_EQ(255,int32_t(myIngredients1.getLatticeEntry(5,6,7)));
 
 }
+
+TEST_F(NNInteractionBccTest,ContactEnergy)
+{
+    typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureBondset<>,FeatureNNInteractionBcc<FeatureLattice>) Features1;
+    typedef ConfigureSystem<VectorInt3,Features1> Config1;
+    typedef Ingredients<Config1> Ing1;
+    Ing1 myIngredients1;
+
+    myIngredients1.setBoxX(16);
+    myIngredients1.setBoxY(16);
+    myIngredients1.setBoxZ(16);
+    myIngredients1.setPeriodicX(1);
+    myIngredients1.setPeriodicY(1);
+    myIngredients1.setPeriodicZ(1);
+    myIngredients1.setNNInteraction(1,2,0.5);
+    myIngredients1.setNNInteraction(1,1,-0.3);
+
+    typename Ing1::molecules_type& molecules1=myIngredients1.modifyMolecules();
+    molecules1.resize(2);
+    molecules1[0].setAllCoordinates(4,4,4);
+    molecules1[0].setAttributeTag(1);
+    molecules1[1].setAttributeTag(2);
+
+    //contacts at distance 2, sqrt(8) and sqrt(12), also across the periodic boundary
+    molecules1[1].setAllCoordinates(6,4,4);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(0.5,myIngredients1.getNNInteractionEnergy());
+    molecules1[1].setAllCoordinates(6,-10,4);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(0.5,myIngredients1.getNNInteractionEnergy());
+    molecules1[1].setAllCoordinates(2,2,2);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(0.5,myIngredients1.getNNInteractionEnergy());
+    molecules1[1].setAllCoordinates(8,4,4);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(0.0,myIngredients1.getNNInteractionEnergy());
+
+    EnergyReport report(myIngredients1);
+    ASSERT_EQ(1u,report.size());
+    EXPECT_EQ("FeatureNNInteractionBcc",report.getName(0));
+
+    //the running energy follows local moves and added monomers
+    RandomNumberGenerators rng;
+    std::vector<uint32_t> rngState;
+    rng.getR250State(rngState);
+
+    MoveAddMonomerBcc<> addMonomer;
+    for(int32_t n=0;n<10;n++)
+    {
+      addMonomer.init(myIngredients1);
+      addMonomer.setPosition(4*(n%4)+2*(n/4),4*(n/4),10+2*(n/4));
+      addMonomer.setTag(1+n%2);
+      ASSERT_TRUE(addMonomer.check(myIngredients1));
+      addMonomer.apply(myIngredients1);
+      EXPECT_NEAR(myIngredients1.calculateNNInteractionEnergy(myIngredients1),myIngredients1.getNNInteractionEnergy(),1e-10);
+    }
+
+    MoveLocalBcc move;
+    uint32_t nAccepted=0;
+    for(uint32_t n=0;n<20000;n++)
+    {
+      move.init(myIngredients1);
+      if(move.check(myIngredients1))
+      {
+	move.apply(myIngredients1);
+	nAccepted++;
+      }
+    }
+    EXPECT_GT(nAccepted,0u);
+    double runningEnergy=myIngredients1.getNNInteractionEnergy();
+    EXPECT_NEAR(myIngredients1.calculateNNInteractionEnergy(myIngredients1),runningEnergy,1e-9);
+    myIngredients1.synchronize();
+    EXPECT_NEAR(runningEnergy,myIngredients1.getNNInteractionEnergy(),1e-9);
+
+    rng.setR250State(rngState);
+}
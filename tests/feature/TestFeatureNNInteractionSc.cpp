@@ -11,6 +11,7 @@
 #include <LeMonADE/feature/FeatureNNInteractionSc.h>
 #include <LeMonADE/updater/UpdaterReadBfmFile.h>
 #include <LeMonADE/updater/moves/MoveAddMonomerSc.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
 
 using namespace std;
 
@@ -2165,6 +2166,152 @@ TEST_F(NNInteractionScTest,getSetInteraction)
     EXPECT_DOUBLE_EQ(myIngredients.getNNInteraction(1,2),0.0);
 }
 
+TEST_F(NNInteractionScTest,SharedTables)
+{
+    typedef LOKI_TYPELIST_2(FeatureBondset<>,FeatureNNInteractionSc<FeatureLattice>) Features1;
+    typedef ConfigureSystem<VectorInt3,Features1> Config1;
+    typedef Ingredients<Config1> Ing1;
+    Ing1 original;
+    original.setBoxX(16);
+    original.setBoxY(16);
+    original.setBoxZ(16);
+    original.setPeriodicX(true);
+    original.setPeriodicY(true);
+    original.setPeriodicZ(true);
+    original.setNNInteraction(1,2,0.5);
+
+    //copies share the tables
+    Ing1 copy(original);
+    Ing1 assigned;
+    assigned.setBoxX(16);
+    assigned.setBoxY(16);
+    assigned.setBoxZ(16);
+    assigned.setPeriodicX(true);
+    assigned.setPeriodicY(true);
+    assigned.setPeriodicZ(true);
+    EXPECT_FALSE(assigned.sharesNNInteractionTables(original));
+    assigned=original;
+    EXPECT_TRUE(copy.sharesNNInteractionTables(original));
+    EXPECT_TRUE(assigned.sharesNNInteractionTables(original));
+    EXPECT_DOUBLE_EQ(copy.getNNInteraction(2,1),0.5);
+
+    //changing the copy does not change the original
+    copy.setNNInteraction(1,2,-0.3);
+    EXPECT_FALSE(copy.sharesNNInteractionTables(original));
+    EXPECT_TRUE(assigned.sharesNNInteractionTables(original));
+    EXPECT_DOUBLE_EQ(copy.getNNInteraction(1,2),-0.3);
+    EXPECT_DOUBLE_EQ(original.getNNInteraction(1,2),0.5);
+    EXPECT_DOUBLE_EQ(assigned.getNNInteraction(1,2),0.5);
+
+    //neither does changing the original
+    original.setNNInteraction(1,3,0.1);
+    EXPECT_DOUBLE_EQ(assigned.getNNInteraction(1,3),0.0);
+    EXPECT_DOUBLE_EQ(original.getNNInteraction(1,3),0.1);
+}
+
+TEST_F(NNInteractionScTest,ContactEnergy)
+{
+    typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureBondset<>,FeatureNNInteractionSc<FeatureLattice>) Features1;
+    typedef ConfigureSystem<VectorInt3,Features1> Config1;
+    typedef Ingredients<Config1> Ing1;
+    Ing1 myIngredients1;
+
+    myIngredients1.setBoxX(20);
+    myIngredients1.setBoxY(20);
+    myIngredients1.setBoxZ(20);
+    myIngredients1.setPeriodicX(1);
+    myIngredients1.setPeriodicY(1);
+    myIngredients1.setPeriodicZ(1);
+    myIngredients1.setNNInteraction(1,2,0.5);
+    myIngredients1.setNNInteraction(1,1,-0.3);
+
+    typename Ing1::molecules_type& molecules1=myIngredients1.modifyMolecules();
+    molecules1.resize(2);
+    molecules1[0].setAllCoordinates(10,10,10);
+    molecules1[0].setAttributeTag(1);
+    molecules1[1].setAttributeTag(2);
+
+    //contacts at distance 2, sqrt(5) and sqrt(6), also across the periodic boundary
+    molecules1[1].setAllCoordinates(12,10,10);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(2.0,myIngredients1.getNNInteractionEnergy());
+    molecules1[1].setAllCoordinates(10,-8,11);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(1.0,myIngredients1.getNNInteractionEnergy());
+    molecules1[1].setAllCoordinates(8,11,11);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(0.5,myIngredients1.getNNInteractionEnergy());
+    molecules1[1].setAllCoordinates(7,11,11);
+    myIngredients1.synchronize();
+    EXPECT_DOUBLE_EQ(0.0,myIngredients1.getNNInteractionEnergy());
+
+    //the running energy follows local moves and added monomers
+    RandomNumberGenerators rng;
+    std::vector<uint32_t> rngState;
+    rng.getR250State(rngState);
+
+    MoveAddMonomerSc<> addMonomer;
+    for(int32_t n=0;n<20;n++)
+    {
+      addMonomer.init(myIngredients1);
+      addMonomer.setPosition(2*(n%5),2*(n/5)+8,14);
+      addMonomer.setTag(1+n%2);
+      ASSERT_TRUE(addMonomer.check(myIngredients1));
+      addMonomer.apply(myIngredients1);
+      EXPECT_NEAR(myIngredients1.calculateNNInteractionEnergy(myIngredients1),myIngredients1.getNNInteractionEnergy(),1e-10);
+    }
+
+    MoveLocalSc move;
+    uint32_t nAccepted=0;
+    for(uint32_t n=0;n<20000;n++)
+    {
+      move.init(myIngredients1);
+      if(move.check(myIngredients1))
+      {
+	move.apply(myIngredients1);
+	nAccepted++;
+      }
+    }
+    EXPECT_GT(nAccepted,0u);
+    double runningEnergy=myIngredients1.getNNInteractionEnergy();
+    EXPECT_NEAR(myIngredients1.calculateNNInteractionEnergy(myIngredients1),runningEnergy,1e-9);
+    myIngredients1.synchronize();
+    EXPECT_NEAR(runningEnergy,myIngredients1.getNNInteractionEnergy(),1e-9);
+
+    rng.setR250State(rngState);
+}
+
+TEST_F(NNInteractionScTest,Temperature)
+{
+    typedef LOKI_TYPELIST_2(FeatureBondset<>,FeatureNNInteractionSc<FeatureLattice>) Features1;
+    typedef ConfigureSystem<VectorInt3,Features1> Config1;
+    typedef Ingredients<Config1> Ing1;
+    Ing1 cold;
+    cold.setBoxX(16);
+    cold.setBoxY(16);
+    cold.setBoxZ(16);
+    cold.setPeriodicX(true);
+    cold.setPeriodicY(true);
+    cold.setPeriodicZ(true);
+    cold.setNNInteraction(1,2,0.5);
+    EXPECT_DOUBLE_EQ(1.0,cold.getNNInteractionTemperature());
+
+    Ing1 hot(cold);
+    hot.setNNInteractionTemperature(2.5);
+    EXPECT_FALSE(hot.sharesNNInteractionTables(cold));
+    EXPECT_DOUBLE_EQ(2.5,hot.getNNInteractionTemperature());
+    EXPECT_DOUBLE_EQ(1.0,cold.getNNInteractionTemperature());
+    //the energies do not depend on the temperature
+    EXPECT_DOUBLE_EQ(0.5,hot.getNNInteraction(1,2));
+
+    hot.swapNNInteractionTables(cold);
+    EXPECT_DOUBLE_EQ(1.0,hot.getNNInteractionTemperature());
+    EXPECT_DOUBLE_EQ(2.5,cold.getNNInteractionTemperature());
+
+    EXPECT_THROW(hot.setNNInteractionTemperature(0.0),std::runtime_error);
+    EXPECT_THROW(hot.setNNInteractionTemperature(-1.0),std::runtime_error);
+}
+
 TEST_F(NNInteractionScTest,Synchronize)
 {
     typedef LOKI_TYPELIST_2(FeatureBondset<>,FeatureNNInteractionSc<FeatureLattice>) Features1;
@@ -2246,6 +2393,72 @@ TEST_F(NNInteractionScTest,Synchronize)
 
 }
 
+TEST_F(NNInteractionScTest,IncrementalSynchronize)
+{
+    typedef LOKI_TYPELIST_2(FeatureBondset<>,FeatureNNInteractionSc<FeatureLattice>) Features1;
+    typedef ConfigureSystem<VectorInt3,Features1> Config1;
+    typedef Ingredients<Config1> Ing1;
+    Ing1 incremental, reference;
+
+    incremental.setBoxX(32);
+    incremental.setBoxY(16);
+    incremental.setBoxZ(24);
+    incremental.setPeriodicX(1);
+    incremental.setPeriodicY(1);
+    incremental.setPeriodicZ(1);
+    incremental.setIncrementalSynchronization(true);
+    reference.setBoxX(32);
+    reference.setBoxY(16);
+    reference.setBoxZ(24);
+    reference.setPeriodicX(1);
+    reference.setPeriodicY(1);
+    reference.setPeriodicZ(1);
+
+    //monomers on a grid with spacing 4, including the periodic images at z=22
+    typename Ing1::molecules_type& molecules=incremental.modifyMolecules();
+    for(int32_t x=0;x<32;x+=4)
+        for(int32_t z=2;z<24;z+=4){
+            molecules.addMonomer(x,4,z);
+            molecules[molecules.size()-1].setAttributeTag(1+(x+z)%3);
+        }
+    incremental.synchronize(incremental);
+    uint64_t generation=incremental.getLatticeGeneration();
+
+    //next frame: move some monomers, onto the old position of another one,
+    //across the periodic boundary and change attributes
+    molecules[0].setAllCoordinates(0,10,2);
+    molecules[1].setAllCoordinates(0,4,2);
+    molecules[5].setAllCoordinates(0,4,23);
+    molecules[7].setAttributeTag(3);
+    incremental.synchronize(incremental);
+
+    //the lattice was kept and only the changes were applied
+    EXPECT_EQ(generation,incremental.getLatticeGeneration());
+
+    reference.modifyMolecules()=molecules;
+    reference.synchronize(reference);
+
+    int nDifferent=0;
+    for(int32_t x=0;x<32;x++)
+        for(int32_t y=0;y<16;y++)
+            for(int32_t z=0;z<24;z++)
+                if(incremental.getLatticeEntry(x,y,z)!=reference.getLatticeEntry(x,y,z)) nDifferent++;
+    EXPECT_EQ(0,nDifferent);
+    EXPECT_EQ(3,incremental.getLatticeEntry(VectorInt3(4,5,7)));
+    EXPECT_EQ(1+(0+22)%3,incremental.getLatticeEntry(VectorInt3(1,5,0)));
+
+    //overlapping monomers are detected in the incremental update as well
+    molecules[2].setAllCoordinates(1,4,3);
+    EXPECT_THROW(incremental.synchronize(incremental),std::runtime_error);
+
+    //a different box size resets the lattice
+    molecules[2].setAllCoordinates(0,4,10);
+    incremental.setBoxY(32);
+    incremental.synchronize(incremental);
+    EXPECT_NE(generation,incremental.getLatticeGeneration());
+    EXPECT_EQ(3,incremental.getLatticeEntry(VectorInt3(4,5,7)));
+}
+
 TEST_F(NNInteractionScTest,ReadWrite)
 {
     typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureBondset<>,FeatureNNInteractionSc<FeatureLattice>) Features1;
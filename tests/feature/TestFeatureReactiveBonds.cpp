@@ -39,6 +39,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/utility/Vector3D.h>
 
 #include <LeMonADE/updater/moves/MoveBreak.h>
+#include <LeMonADE/updater/moves/MoveConnectScReactive.h>
+#include <LeMonADE/updater/moves/MoveBreakReactive.h>
 
 class TestFeatureReactiveBonds : public ::testing::Test
 {
@@ -390,3 +392,65 @@ TEST_F(TestFeatureReactiveBonds, MoveBreakBad)
     EXPECT_FALSE(ingredients.getMolecules().areConnected(0,1));
   
 }
+TEST_F(TestFeatureReactiveBonds, UnreactedAndBondedBookkeeping)
+{
+  ingredients.setBoxX(32);
+  ingredients.setBoxY(32);
+  ingredients.setBoxZ(32);
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.modifyBondset().addBFMclassicBondset();
+  //a row of reactive monomers at distance 2, each can form two bonds
+  for(uint32_t n=0;n<12;n++){
+    ingredients.modifyMolecules().addMonomer(int(2*n),0,0);
+    ingredients.modifyMolecules()[n].setReactive(true);
+    ingredients.modifyMolecules()[n].setNumMaxLinks(2);
+  }
+  ingredients.synchronize();
+  EXPECT_EQ(12,ingredients.getNUnreactedMonomers());
+  EXPECT_EQ(0,ingredients.getNReactedBonds());
+
+  //random connections until no monomer is left with a free site in x direction
+  MoveConnectScReactive connectMove;
+  for(uint32_t n=0;n<2000;n++){
+    connectMove.init(ingredients);
+    if(connectMove.check(ingredients)) connectMove.apply(ingredients);
+  }
+  EXPECT_EQ(11,ingredients.getNReactedBonds());
+  //the two chain ends still have one free site
+  EXPECT_EQ(2,ingredients.getNUnreactedMonomers());
+  EXPECT_TRUE(ingredients.checkCapableFormingBonds(0));
+  EXPECT_TRUE(ingredients.checkCapableFormingBonds(11));
+  EXPECT_FALSE(ingredients.checkCapableFormingBonds(5));
+  EXPECT_FALSE(ingredients.checkCapableFormingBonds(100));
+  for(uint32_t n=0;n<11;n++){
+    EXPECT_TRUE(ingredients.checkReactiveBondExists(n+1,n));
+    EXPECT_TRUE(ingredients.getMolecules().areConnected(n,n+1));
+  }
+
+  //break all bonds again in random order
+  MoveBreakReactive breakMove;
+  for(uint32_t n=0;n<11;n++){
+    breakMove.init(ingredients);
+    EXPECT_TRUE(breakMove.check(ingredients));
+    breakMove.apply(ingredients);
+    EXPECT_EQ(10-n,ingredients.getNReactedBonds());
+    //the remaining entries are consistent with the molecules
+    for(size_t b=0;b<ingredients.getBondedMonomers().size();b++){
+      const FeatureReactiveBonds::BondPair& bond(ingredients.getBondedMonomers()[b]);
+      EXPECT_TRUE(ingredients.getMolecules().areConnected(bond.first,bond.second));
+      EXPECT_TRUE(ingredients.checkReactiveBondExists(bond.first,bond.second));
+    }
+  }
+  EXPECT_EQ(12,ingredients.getNUnreactedMonomers());
+  for(uint32_t n=0;n<12;n++){
+    EXPECT_TRUE(ingredients.checkCapableFormingBonds(n));
+    EXPECT_EQ(0,ingredients.getMolecules().getNumLinks(n));
+  }
+
+  //synchronize rebuilds the same state
+  ingredients.synchronize();
+  EXPECT_EQ(12,ingredients.getNUnreactedMonomers());
+  EXPECT_EQ(0,ingredients.getNReactedBonds());
+}
@@ -48,6 +48,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/updater/moves/MoveLocalScDiag.h>
 
 #include <LeMonADE/feature/FeatureSpringPotentialTwoGroups.h>
+#include <LeMonADE/utility/EnergyReport.h>
 
 
 class TestFeatureSpringPotentialTwoGroups: public ::testing::Test{
@@ -282,3 +283,53 @@ TEST_F(TestFeatureSpringPotentialTwoGroups,fileReadWrite){
     //remove the temporary file
   EXPECT_EQ(0,remove("tests/springPotentialTestOut.test"));
 }
+
+TEST_F(TestFeatureSpringPotentialTwoGroups,Energy){
+  ingredients.setSpringConstant(0.5);
+  ingredients.setEquilibriumLength(3);
+  ingredients.setBoxX(16);
+  ingredients.setBoxY(16);
+  ingredients.setBoxZ(16);
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.modifyBondset().addBFMclassicBondset();
+  ingredients.modifyMolecules().addMonomer(0,0,0);
+  ingredients.modifyMolecules().addMonomer(2,0,0);
+  ingredients.modifyMolecules().addMonomer(8,0,0);
+  ingredients.modifyMolecules().addMonomer(5,5,5);
+  ingredients.modifyMolecules()[0].setMonomerGroupTag(1);
+  ingredients.modifyMolecules()[1].setMonomerGroupTag(1);
+  ingredients.modifyMolecules()[2].setMonomerGroupTag(2);
+  ingredients.synchronize();
+
+  //distance of the centers of mass is 7
+  EXPECT_DOUBLE_EQ(0.25*16.0,ingredients.getSpringPotentialEnergy());
+  EnergyReport report(ingredients);
+  EXPECT_DOUBLE_EQ(4.0,report.getEnergy("FeatureSpringPotentialTwoGroups"));
+
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> rngState;
+  rng.getR250State(rngState);
+
+  //the running energy follows both kinds of local moves, including
+  //moves applied without a preceding check
+  MoveLocalSc scmove;
+  scmove.init(ingredients,2,VectorInt3(1,0,0));
+  scmove.apply(ingredients);
+  EXPECT_NEAR(0.25*25.0,ingredients.getSpringPotentialEnergy(),1e-12);
+
+  MoveLocalScDiag diagmove;
+  for(uint32_t i=0;i<2000;i++){
+    scmove.init(ingredients);
+    if(scmove.check(ingredients)) scmove.apply(ingredients);
+    diagmove.init(ingredients);
+    if(diagmove.check(ingredients)) diagmove.apply(ingredients);
+  }
+  double runningEnergy=ingredients.getSpringPotentialEnergy();
+  EXPECT_NEAR(ingredients.calculateSpringPotentialEnergy(ingredients),runningEnergy,1e-9);
+  ingredients.synchronize();
+  EXPECT_NEAR(runningEnergy,ingredients.getSpringPotentialEnergy(),1e-9);
+
+  rng.setR250State(rngState);
+}
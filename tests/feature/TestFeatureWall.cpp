@@ -298,3 +298,40 @@ TEST(TestFeatureWall,ReadWriteRoutine)
     EXPECT_NO_THROW(ingredients2.synchronize());
 
 }
+
+//the bitmasks of the walls must forbid exactly the positions found by
+//comparing with every wall
+TEST(TestFeatureWall,WallMask)
+{
+    FeatureWall feature;
+    EXPECT_FALSE(feature.isWallPosition(VectorInt3(-1,0,0)));
+
+    int baseX[]={0,5,64,200};
+    int baseZ[]={3,4};
+    for(size_t i=0;i<4;i++){
+        Wall wall;
+        wall.setBase(baseX[i],0,0);
+        wall.setNormal(1,0,0);
+        feature.addWall(wall);
+    }
+    for(size_t i=0;i<2;i++){
+        Wall wall;
+        wall.setBase(0,0,baseZ[i]);
+        wall.setNormal(0,0,1);
+        feature.addWall(wall);
+    }
+
+    for(int c=-70;c<270;c++){
+        bool expectedX=false, expectedZ=false;
+        for(size_t i=0;i<4;i++) if(c==baseX[i]-1) expectedX=true;
+        for(size_t i=0;i<2;i++) if(c==baseZ[i]-1) expectedZ=true;
+
+        EXPECT_EQ(expectedX,feature.isWallPosition(VectorInt3(c,7,7)));
+        EXPECT_FALSE(feature.isWallPosition(VectorInt3(7,c,7)));
+        EXPECT_EQ(expectedZ,feature.isWallPosition(VectorInt3(7,7,c)));
+    }
+
+    feature.clearAllWalls();
+    EXPECT_FALSE(feature.isWallPosition(VectorInt3(-1,2,3)));
+    EXPECT_FALSE(feature.isWallPosition(VectorInt3(4,2,2)));
+}
@@ -0,0 +1,124 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <LeMonADE/io/BfmTokenizer.h>
+#include <LeMonADE/io/Parser.h>
+
+TEST(BfmTokenizerTest,Commands)
+{
+  std::istringstream stream("!first=fresh\n"
+			    "!second= Lemonade\n"
+			    "thisisnocommand\n"
+			    "!\n"
+			    "#comment\n"
+			    "#!third\n"
+			    "!fourth 16 1\n"
+			    "!mcs=  1200 extra");
+  BfmTokenizer tokenizer(stream);
+  tokenizer.reset();
+  BfmTokenizer::Command command;
+
+  ASSERT_TRUE(tokenizer.next(command));
+  EXPECT_EQ(command.name,"!first");
+  EXPECT_EQ(command.lineOffset,0);
+  EXPECT_EQ(command.argumentOffset,7);
+  EXPECT_EQ(command.arguments,"fresh");
+
+  ASSERT_TRUE(tokenizer.next(command));
+  EXPECT_EQ(command.name,"!second");
+  EXPECT_EQ(command.lineOffset,13);
+  EXPECT_EQ(command.arguments," Lemonade");
+
+  ASSERT_TRUE(tokenizer.next(command));
+  EXPECT_EQ(command.name,"#!third");
+  EXPECT_EQ(command.arguments,"");
+
+  ASSERT_TRUE(tokenizer.next(command));
+  EXPECT_EQ(command.name,"!fourth");
+  EXPECT_EQ(command.arguments," 16 1");
+
+  ASSERT_TRUE(tokenizer.next(command));
+  EXPECT_EQ(command.name,"!mcs");
+  uint64_t mcs;
+  size_t consumed;
+  EXPECT_TRUE(BfmTokenizer::parseUnsigned(command.arguments,mcs,consumed));
+  EXPECT_EQ(mcs,1200);
+  EXPECT_EQ(consumed,6);
+
+  EXPECT_FALSE(tokenizer.next(command));
+  EXPECT_EQ(tokenizer.getBytesRead(),stream.str().size());
+
+  EXPECT_FALSE(BfmTokenizer::parseUnsigned(" x12",mcs,consumed));
+}
+
+//the tokenizer finds the same commands at the same positions as the Parser,
+//also if the lines are split between blocks
+TEST(BfmTokenizerTest,SameAsParser)
+{
+  const char* files[]={"tests/parserTest.test","tests/fileImportTest.test","tests/fileImportTest2.test","tests/readbfmfile.test"};
+
+  for(size_t f=0;f<4;f++)
+  {
+    std::ifstream parserFile(files[f],std::ios_base::in|std::ios_base::binary);
+    ASSERT_TRUE(parserFile.good());
+    Parser parser(parserFile);
+
+    for(size_t blockSize=3;blockSize<=BfmTokenizer::defaultBlockSize;blockSize*=64)
+    {
+      parserFile.clear();
+      parserFile.seekg(0);
+
+      std::ifstream tokenizerFile(files[f],std::ios_base::in|std::ios_base::binary);
+      BfmTokenizer tokenizer(tokenizerFile,blockSize);
+      tokenizer.reset();
+      BfmTokenizer::Command command;
+
+      uint32_t nCommands=0;
+      std::string read=parser.findRead();
+      while(read!="endoffile")
+      {
+	ASSERT_TRUE(tokenizer.next(command));
+	EXPECT_EQ(command.name,read);
+	//the position is not available if the command ends the file
+	if(parserFile.good()){
+	  EXPECT_EQ(command.argumentOffset,uint64_t(parserFile.tellg()));
+	}
+	nCommands++;
+	read=parser.findRead();
+      }
+      EXPECT_FALSE(tokenizer.next(command));
+      EXPECT_GT(nCommands,0);
+    }
+  }
+}
@@ -0,0 +1,316 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Tests for saving and loading checkpoints
+ * */
+/*****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/feature/FeatureLattice.h>
+#include <LeMonADE/feature/FeatureLatticePowerOfTwo.h>
+#include <LeMonADE/feature/FeatureNNInteractionSc.h>
+#include <LeMonADE/feature/FeatureWall.h>
+#include <LeMonADE/feature/FeatureLinearForce.h>
+#include <LeMonADE/feature/FeatureExternalField.h>
+#include <LeMonADE/feature/FeatureReactiveBonds.h>
+#include <LeMonADE/feature/FeatureConnectionSc.h>
+#include <LeMonADE/analyzer/AnalyzerWriteCheckpoint.h>
+#include <LeMonADE/io/Checkpoint.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+class TestCheckpoint: public ::testing::Test{
+public:
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureAttributes<>, FeatureExcludedVolumeSc<FeatureLattice<bool> >) Features;
+  typedef ConfigureSystem<VectorInt3,Features,4> Config;
+  typedef Ingredients<Config> IngredientsType;
+
+  typedef LOKI_TYPELIST_2(FeatureMoleculesIO, FeatureAttributes<>) OtherFeatures;
+  typedef Ingredients<ConfigureSystem<VectorInt3,OtherFeatures,4> > OtherIngredientsType;
+
+  //a stretched linear chain of 20 monomers in a box of 64x32x32
+  void setupChain(IngredientsType& ingredients){
+    ingredients.setBoxX(64);
+    ingredients.setBoxY(32);
+    ingredients.setBoxZ(32);
+    ingredients.setPeriodicX(true);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(false);
+    ingredients.modifyBondset().addBFMclassicBondset();
+    for(int n=0;n<20;n++){
+      ingredients.modifyMolecules().addMonomer(2+2*n,10,10);
+      ingredients.modifyMolecules()[n].setAttributeTag(n%3+1);
+      if(n>0) ingredients.modifyMolecules().connect(n-1,n);
+    }
+    ingredients.synchronize();
+  }
+
+  //performs nMoves local moves
+  template<class IngredientsT>
+  void simulate(IngredientsT& ingredients, int nMoves){
+    MoveLocalSc move;
+    for(int n=0;n<nMoves;n++){
+      move.init(ingredients);
+      if(move.check(ingredients)) move.apply(ingredients);
+    }
+  }
+
+  //redirect cout output and keep the random number sequence of other tests unchanged
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+    RandomNumberGenerators rng;
+    rng.getR250State(originalRngState);
+  };
+
+  //restore original output and random numbers, remove files
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+    RandomNumberGenerators rng;
+    rng.setR250State(originalRngState);
+    std::remove("tests/checkpointTest.chk");
+  };
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+  std::vector<uint32_t> originalRngState;
+};
+
+TEST_F(TestCheckpoint, ContinuesIdentically)
+{
+  for(int withLattice=0;withLattice<2;withLattice++)
+  {
+    IngredientsType original;
+    setupChain(original);
+    simulate(original,5000);
+
+    saveCheckpoint("tests/checkpointTest.chk",original,withLattice==1);
+    simulate(original,5000);
+
+    IngredientsType restored;
+    loadCheckpoint("tests/checkpointTest.chk",restored);
+
+    //box, bondset and molecules are restored
+    EXPECT_EQ(64,restored.getBoxX());
+    EXPECT_EQ(32,restored.getBoxZ());
+    EXPECT_TRUE(restored.isPeriodicY());
+    EXPECT_FALSE(restored.isPeriodicZ());
+    EXPECT_EQ(original.getBondset().size(),restored.getBondset().size());
+    EXPECT_TRUE(restored.getBondset().isValid(VectorInt3(2,0,0)));
+    ASSERT_EQ(20,restored.getMolecules().size());
+    EXPECT_EQ(1,restored.getMolecules().getNumLinks(0));
+    EXPECT_EQ(2,restored.getMolecules().getNumLinks(5));
+    EXPECT_TRUE(restored.getMolecules().areConnected(7,8));
+    EXPECT_EQ(2,restored.getMolecules()[4].getAttributeTag());
+
+    //the restored system continues with the same random numbers
+    simulate(restored,5000);
+    EXPECT_EQ(original.getMolecules().getAge(),restored.getMolecules().getAge());
+    for(size_t n=0;n<20;n++){
+      EXPECT_EQ(original.getMolecules()[n].getVector3D(),restored.getMolecules()[n].getVector3D());
+    }
+
+    //the lattice occupation is consistent with the positions
+    int nDifferent=0;
+    for(int x=0;x<64;x++)
+      for(int y=0;y<32;y++)
+        for(int z=0;z<32;z++)
+          if(original.getLatticeEntry(x,y,z)!=restored.getLatticeEntry(x,y,z)) nDifferent++;
+    EXPECT_EQ(0,nDifferent);
+  }
+}
+
+TEST_F(TestCheckpoint, BondIndexCache)
+{
+  IngredientsType original;
+  setupChain(original);
+  original.setUseBondIndexCache(true);
+  original.synchronize();
+  simulate(original,5000);
+
+  saveCheckpoint("tests/checkpointTest.chk",original);
+  simulate(original,5000);
+
+  //the cache is active without setting it by hand
+  IngredientsType restored;
+  loadCheckpoint("tests/checkpointTest.chk",restored);
+  EXPECT_TRUE(restored.getUseBondIndexCache());
+  EXPECT_TRUE(restored.isBondIndexCacheActive());
+
+  simulate(restored,5000);
+  for(size_t n=0;n<20;n++){
+    EXPECT_EQ(original.getMolecules()[n].getVector3D(),restored.getMolecules()[n].getVector3D());
+  }
+}
+
+TEST_F(TestCheckpoint, Errors)
+{
+  IngredientsType ingredients;
+  setupChain(ingredients);
+
+  EXPECT_THROW(loadCheckpoint("tests/nonexistentCheckpoint.chk",ingredients),std::runtime_error);
+  EXPECT_THROW(loadCheckpoint("tests/molecules.test",ingredients),std::runtime_error);
+
+  //a checkpoint of a system with different features can not be loaded
+  saveCheckpoint("tests/checkpointTest.chk",ingredients);
+  OtherIngredientsType other;
+  EXPECT_THROW(loadCheckpoint("tests/checkpointTest.chk",other),std::runtime_error);
+
+  //reading beyond a section
+  CheckpointWriter writer("tests/checkpointTest.chk");
+  writer.beginSection("Test");
+  writer.write(int32_t(5));
+  writer.writeString("abc");
+  writer.close();
+
+  CheckpointReader reader("tests/checkpointTest.chk");
+  EXPECT_THROW(reader.beginSection("Other"),std::runtime_error);
+
+  CheckpointReader reader2("tests/checkpointTest.chk");
+  int32_t value;
+  std::string str;
+  reader2.beginSection("Test");
+  reader2.read(value);
+  EXPECT_EQ(5,value);
+  reader2.readString(str);
+  EXPECT_EQ("abc",str);
+  EXPECT_THROW(reader2.read(value),std::runtime_error);
+}
+
+TEST_F(TestCheckpoint, RestoresFeatureParameters)
+{
+  typedef LOKI_TYPELIST_6(FeatureMoleculesIO, FeatureLinearForce, FeatureExternalField, FeatureAttributes<>,
+                          FeatureNNInteractionSc<FeatureLatticePowerOfTwo>, FeatureWall) ParameterFeatures;
+  typedef Ingredients<ConfigureSystem<VectorInt3,ParameterFeatures,4> > ParameterIngredients;
+
+  ParameterIngredients original;
+  original.setBoxX(32);
+  original.setBoxY(32);
+  original.setBoxZ(32);
+  original.setPeriodicX(true);
+  original.setPeriodicY(true);
+  original.setPeriodicZ(false);
+  original.modifyBondset().addBFMclassicBondset();
+  for(int n=0;n<20;n++){
+    original.modifyMolecules().addMonomer(2+n,10+2*(n%2),10);
+    original.modifyMolecules()[n].setAttributeTag(n%5+1);
+    if(n>0) original.modifyMolecules().connect(n-1,n);
+  }
+  original.setNNInteraction(1,2,0.4);
+  original.setNNInteraction(2,3,-0.3);
+  original.setNNInteractionTemperature(1.5);
+  Wall wall;
+  wall.setBase(0,0,1);
+  wall.setNormal(0,0,1);
+  original.addWall(wall);
+  original.setForceOn(true);
+  original.setAmplitudeForce(0.3);
+  original.setForce(1,VectorDouble3(0.1,0.0,0.0));
+  original.setPeriodicModulation(2,1,0.5,8);
+  original.synchronize();
+  simulate(original,5000);
+
+  AnalyzerWriteCheckpoint<ParameterIngredients> writer("tests/checkpointTest.chk",original);
+  EXPECT_EQ("tests/checkpointTest.chk",writer.getFilename());
+  writer.initialize();
+  writer.execute();
+  writer.cleanup();
+  simulate(original,5000);
+
+  //no parameters are set by hand
+  ParameterIngredients restored;
+  loadCheckpoint("tests/checkpointTest.chk",restored);
+  EXPECT_DOUBLE_EQ(0.4,restored.getNNInteraction(2,1));
+  EXPECT_DOUBLE_EQ(-0.3,restored.getNNInteraction(3,2));
+  EXPECT_DOUBLE_EQ(1.5,restored.getNNInteractionTemperature());
+  ASSERT_EQ(1,restored.getWalls().size());
+  EXPECT_TRUE(restored.isWallPosition(VectorInt3(5,5,0)));
+  EXPECT_TRUE(restored.isForceOn());
+  EXPECT_DOUBLE_EQ(0.3,restored.getAmplitudeForce());
+  EXPECT_EQ(VectorDouble3(0.1,0.0,0.0),restored.getForce(1));
+  EXPECT_EQ(original.getPotentialProfile(2,1),restored.getPotentialProfile(2,1));
+  EXPECT_TRUE(restored.getPotentialProfile(1,0).empty());
+
+  //the restored system continues identically
+  simulate(restored,5000);
+  for(size_t n=0;n<20;n++){
+    EXPECT_EQ(original.getMolecules()[n].getVector3D(),restored.getMolecules()[n].getVector3D());
+  }
+  EXPECT_NEAR(original.getNNInteractionEnergy(),restored.getNNInteractionEnergy(),1e-9);
+  EXPECT_NEAR(original.getFieldEnergy(),restored.getFieldEnergy(),1e-9);
+  EXPECT_DOUBLE_EQ(original.getLinearForceEnergy(),restored.getLinearForceEnergy());
+}
+
+TEST_F(TestCheckpoint, RestoresReactiveBonds)
+{
+  typedef LOKI_TYPELIST_4(FeatureMoleculesIO, FeatureReactiveBonds, FeatureConnectionSc,
+                          FeatureExcludedVolumeSc<FeatureLatticePowerOfTwo<uint8_t> >) ReactiveFeatures;
+  typedef Ingredients<ConfigureSystem<VectorInt3,ReactiveFeatures,4> > ReactiveIngredients;
+
+  ReactiveIngredients original;
+  original.setBoxX(16);
+  original.setBoxY(16);
+  original.setBoxZ(16);
+  original.setPeriodicX(true);
+  original.setPeriodicY(true);
+  original.setPeriodicZ(true);
+  original.modifyBondset().addBFMclassicBondset();
+  for(int n=0;n<6;n++){
+    original.modifyMolecules().addMonomer(2*n,4,4);
+    original.modifyMolecules()[n].setReactive(true);
+    original.modifyMolecules()[n].setNumMaxLinks(2);
+  }
+  original.modifyMolecules().connect(3,4);
+  original.modifyMolecules().connect(0,1);
+  original.synchronize();
+
+  saveCheckpoint("tests/checkpointTest.chk",original);
+  ReactiveIngredients restored;
+  loadCheckpoint("tests/checkpointTest.chk",restored);
+
+  //the lists keep their order, such that random draws from them continue identically
+  EXPECT_EQ(original.getNReactedBonds(),restored.getNReactedBonds());
+  EXPECT_EQ(original.getNReactiveSites(),restored.getNReactiveSites());
+  EXPECT_EQ(original.getBondedMonomers(),restored.getBondedMonomers());
+  EXPECT_EQ(original.getUnreactiveMonomers(),restored.getUnreactiveMonomers());
+  EXPECT_TRUE(restored.checkReactiveBondExists(4,3));
+  EXPECT_TRUE(restored.checkCapableFormingBonds(5));
+  EXPECT_DOUBLE_EQ(original.getConversion(),restored.getConversion());
+}
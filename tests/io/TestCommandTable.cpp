@@ -0,0 +1,95 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+#include <LeMonADE/io/CommandTable.h>
+
+TEST(CommandTableTest,InsertAndFind)
+{
+  CommandTable<int> table;
+  EXPECT_EQ(0u,table.size());
+  EXPECT_EQ(CommandTable<int>::notFound,table.find("!mcs"));
+
+  std::pair<int32_t,bool> inserted=table.insert("!mcs",10);
+  EXPECT_EQ(0,inserted.first);
+  EXPECT_TRUE(inserted.second);
+  inserted=table.insert("!bonds",20);
+  EXPECT_EQ(1,inserted.first);
+  EXPECT_TRUE(inserted.second);
+
+  //inserting an existing name keeps its id and value
+  inserted=table.insert("!mcs",30);
+  EXPECT_EQ(0,inserted.first);
+  EXPECT_FALSE(inserted.second);
+  EXPECT_EQ(10,table[0]);
+
+  //lookup from a character range without terminating zero
+  const char line[]="!bonds\n!mcs=100";
+  EXPECT_EQ(1,table.find(line,6));
+  EXPECT_EQ(0,table.find(line+7,4));
+  EXPECT_EQ(CommandTable<int>::notFound,table.find(line,5));
+  EXPECT_EQ(CommandTable<int>::notFound,table.find(line,7));
+
+  EXPECT_EQ("!bonds",table.getName(1));
+  table[1]=25;
+  EXPECT_EQ(25,table[table.find("!bonds")]);
+
+  table.clear();
+  EXPECT_EQ(0u,table.size());
+  EXPECT_EQ(CommandTable<int>::notFound,table.find("!mcs"));
+}
+
+//many names force several rehashes. all ids must stay dense and in
+//order of insertion
+TEST(CommandTableTest,Growth)
+{
+  CommandTable<size_t> table;
+  for(size_t n=0;n<1000;n++){
+    std::stringstream name;
+    name<<"#!command_"<<n;
+    std::pair<int32_t,bool> inserted=table.insert(name.str(),n);
+    EXPECT_EQ(int32_t(n),inserted.first);
+    EXPECT_TRUE(inserted.second);
+  }
+  EXPECT_EQ(1000u,table.size());
+
+  for(size_t n=0;n<1000;n++){
+    std::stringstream name;
+    name<<"#!command_"<<n;
+    int32_t id=table.find(name.str());
+    ASSERT_EQ(int32_t(n),id);
+    EXPECT_EQ(n,table[id]);
+    EXPECT_EQ(name.str(),table.getName(id));
+  }
+  EXPECT_EQ(CommandTable<size_t>::notFound,table.find("#!command_1000"));
+  EXPECT_EQ(CommandTable<size_t>::notFound,table.find(""));
+}
@@ -29,6 +29,8 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <cstdio>
 #include <sstream>
+#include <fstream>
+#include <vector>
 
 #include <LeMonADE/core/Molecules.h>
 #include <LeMonADE/core/Ingredients.h>
@@ -37,6 +39,7 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/feature/FeatureBondset.h>
 #include <LeMonADE/io/FileImport.h>
 #include <LeMonADE/io/AbstractRead.h>
+#include <LeMonADE/analyzer/AnalyzerWriteBfmFile.h>
 
 using namespace std;
 /************************************************************************/
@@ -491,3 +494,177 @@ TEST_F(FileImportTest, getMinMaxAge)
     EXPECT_EQ(2000000,file.getMaxAge());
     EXPECT_EQ(1000,file.getMinAge());
 }
+
+/* *****************************************************************************
+ * write a trajectory with !mcs_delta frames and check that read(), gotoMcs
+ * and gotoEnd reconstruct all conformations
+ */
+
+TEST_F(FileImportTest, DeltaFrames)
+{
+	typedef LOKI_TYPELIST_1(FeatureMoleculesIO)	Features;
+	typedef ConfigureSystem<VectorInt3,Features,4> Config;
+	typedef Ingredients < Config> MyIngredients;
+
+	const std::string deltaFilename="fileImportDeltaFrames.test";
+	const std::string fullFilename="fileImportFullFrames.test";
+	const size_t nFrames=10;
+
+	//a chain of 10 monomers and 30 unconnected monomers
+	MyIngredients ingredients;
+	ingredients.setBoxX(64); ingredients.setBoxY(64); ingredients.setBoxZ(64);
+	ingredients.setPeriodicX(true); ingredients.setPeriodicY(true); ingredients.setPeriodicZ(true);
+	ingredients.modifyBondset().addBFMclassicBondset();
+	ingredients.modifyMolecules().resize(40);
+	for(size_t n=0;n<40;n++)
+		ingredients.modifyMolecules()[n].setAllCoordinates(2*(n%10),4*(n/10),0);
+	for(size_t n=1;n<10;n++)
+		ingredients.modifyMolecules().connect(n-1,n);
+	ingredients.setMcsKeyframeInterval(4);
+	ingredients.synchronize();
+
+	MyIngredients ingredientsFull(ingredients);
+	ingredientsFull.setMcsKeyframeInterval(1);
+
+	AnalyzerWriteBfmFile<MyIngredients> writer(deltaFilename,ingredients,AnalyzerWriteBfmFile<MyIngredients>::NEWFILE);
+	AnalyzerWriteBfmFile<MyIngredients> writerFull(fullFilename,ingredientsFull,AnalyzerWriteBfmFile<MyIngredients>::NEWFILE);
+	writer.initialize();
+	writerFull.initialize();
+
+	//in every frame one unconnected monomer moves, in every third frame the chain moves
+	std::vector<MyIngredients::molecules_type> frames;
+	for(size_t frame=0;frame<nFrames;frame++)
+	{
+		MyIngredients::molecules_type& molecules=ingredients.modifyMolecules();
+		molecules.setAge(100*frame);
+		molecules[10+frame]+=VectorInt3(0,0,2);
+		if(frame%3==2)
+			for(size_t n=0;n<10;n++) molecules[n]+=VectorInt3(1,1,0);
+
+		ingredientsFull.modifyMolecules()=molecules;
+		frames.push_back(molecules);
+		writer.execute();
+		writerFull.execute();
+	}
+	writer.closeFile();
+	writerFull.closeFile();
+
+	//the file with delta frames must be smaller
+	std::ifstream deltaFile(deltaFilename.c_str(),std::ios_base::binary|std::ios_base::ate);
+	std::ifstream fullFile(fullFilename.c_str(),std::ios_base::binary|std::ios_base::ate);
+	EXPECT_LT(deltaFile.tellg(),fullFile.tellg());
+	deltaFile.close();
+	fullFile.close();
+
+	//read all frames one after another
+	MyIngredients ingredients2;
+	FileImport<MyIngredients> file(deltaFilename,ingredients2);
+	file.initialize();
+	EXPECT_EQ(nFrames,file.getNumFrames());
+	EXPECT_EQ(900,file.getMaxAge());
+	for(size_t frame=0;frame<nFrames;frame++)
+	{
+		EXPECT_TRUE(file.read());
+		EXPECT_EQ(100*frame,ingredients2.getMolecules().getAge());
+		for(size_t n=0;n<40;n++)
+			EXPECT_EQ(frames[frame][n],ingredients2.getMolecules()[n]);
+	}
+	EXPECT_FALSE(file.read());
+
+	//jump to delta frames and keyframes in arbitrary order
+	const size_t jumps[]={6,2,9,4,0,7,3};
+	for(size_t j=0;j<7;j++)
+	{
+		file.gotoMcs(100*jumps[j]);
+		EXPECT_EQ(100*jumps[j],ingredients2.getMolecules().getAge());
+		for(size_t n=0;n<40;n++)
+			EXPECT_EQ(frames[jumps[j]][n],ingredients2.getMolecules()[n]);
+	}
+
+	file.gotoEnd();
+	EXPECT_EQ(900,ingredients2.getMolecules().getAge());
+	for(size_t n=0;n<40;n++)
+		EXPECT_EQ(frames[nFrames-1][n],ingredients2.getMolecules()[n]);
+	file.close();
+
+	EXPECT_EQ(0,remove(deltaFilename.c_str()));
+	EXPECT_EQ(0,remove(fullFilename.c_str()));
+}
+
+/* *****************************************************************************
+ * a !mcs_delta frame must be based on the preceeding frame and on the same
+ * number of monomers, otherwise scanning or reading the file fails
+ */
+
+TEST_F(FileImportTest, DeltaFrameMismatch)
+{
+	typedef LOKI_TYPELIST_1(FeatureMoleculesIO)	Features;
+	typedef ConfigureSystem<VectorInt3,Features,4> Config;
+	typedef Ingredients < Config> MyIngredients;
+
+	const std::string filename="fileImportDeltaMismatch.test";
+
+	MyIngredients ingredients;
+	ingredients.setBoxX(32); ingredients.setBoxY(32); ingredients.setBoxZ(32);
+	ingredients.setPeriodicX(true); ingredients.setPeriodicY(true); ingredients.setPeriodicZ(true);
+	ingredients.modifyBondset().addBFMclassicBondset();
+	ingredients.modifyMolecules().resize(4);
+	for(size_t n=0;n<4;n++)
+		ingredients.modifyMolecules()[n].setAllCoordinates(4*n,0,0);
+	ingredients.setMcsKeyframeInterval(4);
+	ingredients.synchronize();
+
+	AnalyzerWriteBfmFile<MyIngredients> writer(filename,ingredients,AnalyzerWriteBfmFile<MyIngredients>::NEWFILE);
+	writer.initialize();
+	for(size_t frame=0;frame<3;frame++)
+	{
+		ingredients.modifyMolecules().setAge(100*frame);
+		ingredients.modifyMolecules()[frame]+=VectorInt3(0,0,2);
+		writer.execute();
+	}
+	writer.closeFile();
+
+	std::ifstream in(filename.c_str());
+	std::stringstream buffer;
+	buffer<<in.rdbuf();
+	in.close();
+	const std::string original=buffer.str();
+	ASSERT_NE(std::string::npos,original.find("!mcs_delta=100 base=0 monomers=4"));
+	ASSERT_NE(std::string::npos,original.find("!mcs_delta=200 base=100 monomers=4"));
+
+	//the written file is consistent
+	{
+		MyIngredients ingredients2;
+		FileImport<MyIngredients> file(filename,ingredients2);
+		file.initialize();
+		file.gotoEnd();
+		EXPECT_EQ(200,ingredients2.getMolecules().getAge());
+		file.close();
+	}
+
+	//the second delta frame names the wrong base frame
+	std::string modified(original);
+	modified.replace(modified.find("base=100"),8,"base=000");
+	std::ofstream(filename.c_str())<<modified;
+	{
+		MyIngredients ingredients2;
+		FileImport<MyIngredients> file(filename,ingredients2);
+		EXPECT_THROW(file.initialize(),std::runtime_error);
+		file.close();
+	}
+
+	//the delta frame is written for a different number of monomers
+	modified=original;
+	modified.replace(modified.find("base=0 monomers=4"),17,"base=0 monomers=5");
+	std::ofstream(filename.c_str())<<modified;
+	{
+		MyIngredients ingredients2;
+		FileImport<MyIngredients> file(filename,ingredients2);
+		file.initialize();
+		EXPECT_TRUE(file.read());
+		EXPECT_THROW(file.read(),std::runtime_error);
+		file.close();
+	}
+
+	EXPECT_EQ(0,remove(filename.c_str()));
+}
@@ -43,4 +43,22 @@ TEST(ParserTest,FindRead)
   EXPECT_EQ("!secondCommand",parser.findRead());
   EXPECT_EQ("#!thirdCommand",parser.findRead());
   EXPECT_EQ("endoffile",parser.findRead());
-}
\ No newline at end of file
+}
+//the overload storing the ReadString in a given string must find the same
+//commands
+TEST(ParserTest,FindReadIntoString)
+{
+  std::ifstream file;
+  file.open("tests/parserTest.test");
+  Parser parser(file);
+
+  std::string Read;
+  parser.findRead(Read);
+  EXPECT_EQ("!firstCommand",Read);
+  parser.findRead(Read);
+  EXPECT_EQ("!secondCommand",Read);
+  parser.findRead(Read);
+  EXPECT_EQ("#!thirdCommand",Read);
+  parser.findRead(Read);
+  EXPECT_EQ("endoffile",Read);
+}
@@ -0,0 +1,274 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Tests for FusedLocalScSweep and UpdaterFusedSimulator
+ * */
+/*****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureFixedMonomers.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeScIdOnLattice.h>
+#include <LeMonADE/updater/UpdaterSimpleSimulator.h>
+#include <LeMonADE/updater/UpdaterFusedSimulator.h>
+#include <LeMonADE/updater/moves/FusedLocalScSweep.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/utility/LatticePredicates.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+class TestFusedLocalScSweep: public ::testing::Test{
+public:
+
+  //feature set of the SimpleSimulator project
+  typedef LOKI_TYPELIST_4(FeatureMoleculesIO, FeatureFixedMonomers,FeatureAttributes<>,FeatureExcludedVolumeSc<>) Features;
+  typedef ConfigureSystem<VectorInt3,Features,6> Config;
+  typedef Ingredients<Config> IngredientsType;
+
+  //contains a feature without fused stage
+  typedef FeatureExcludedVolumeScIdOnLattice<FeatureLattice<uint32_t>, MonomerID > IdExcludedVolume;
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureFixedMonomers, IdExcludedVolume) GenericFeatures;
+  typedef ConfigureSystem<VectorInt3,GenericFeatures,6> GenericConfig;
+  typedef Ingredients<GenericConfig> GenericIngredientsType;
+
+  //redirect cout output and keep the random number sequence of other tests unchanged
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+    RandomNumberGenerators rng;
+    rng.getR250State(originalRngState);
+  };
+
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+    RandomNumberGenerators rng;
+    rng.setR250State(originalRngState);
+  };
+
+  //chains of 10 monomers in a box which is not a power of two, starting at negative coordinates
+  template<class IngType>
+  void setupChains(IngType& ingredients)
+  {
+    ingredients.setBoxX(30);
+    ingredients.setBoxY(30);
+    ingredients.setBoxZ(30);
+    ingredients.setPeriodicX(true);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(true);
+    ingredients.modifyBondset().addBFMclassicBondset();
+
+    for(int32_t c=0;c<40;c++)
+    {
+      for(int32_t m=0;m<10;m++)
+      {
+	uint32_t idx=ingredients.modifyMolecules().addMonomer(2*m-10,2*(c%15)-6,4*(c/15)-2);
+	ingredients.modifyMolecules()[idx].setMovableTag(idx%17!=0);
+	if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+      }
+    }
+    ingredients.synchronize();
+  }
+
+  //checks that exactly the cubes of all monomers are occupied on the lattice
+  template<class IngType>
+  void checkLattice(const IngType& ingredients)
+  {
+    uint32_t nOccupied=0;
+    for(int32_t x=0;x<30;x++)
+      for(int32_t y=0;y<30;y++)
+	for(int32_t z=0;z<30;z++)
+	  if(ingredients.getLatticeEntry(x,y,z)) nOccupied++;
+    EXPECT_EQ(8*ingredients.getMolecules().size(),nOccupied);
+
+    for(uint32_t n=0;n<ingredients.getMolecules().size();n++)
+    {
+      const VectorInt3& pos=ingredients.getMolecules()[n];
+      for(int32_t i=0;i<8;i++)
+	EXPECT_TRUE(ingredients.getLatticeEntry(pos.getX()+(i&1),pos.getY()+((i>>1)&1),pos.getZ()+((i>>2)&1)));
+    }
+  }
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+  std::vector<uint32_t> originalRngState;
+};
+
+TEST_F(TestFusedLocalScSweep,StageSelection)
+{
+  EXPECT_EQ(1,FusedLocalScSweep<IngredientsType>::IS_FUSED);
+  EXPECT_EQ(1,FusedLocalScSweep<IngredientsType>::Stages::CHECKS_MOVABLE);
+  EXPECT_EQ(1,FusedLocalScSweep<IngredientsType>::Stages::CHECKS_BOX);
+  EXPECT_EQ(1,FusedLocalScSweep<IngredientsType>::Stages::CHECKS_BONDS);
+  EXPECT_EQ(1,FusedLocalScSweep<IngredientsType>::Stages::CHECKS_VOLUME);
+  EXPECT_EQ(0,FusedLocalScSweep<GenericIngredientsType>::IS_FUSED);
+
+  typedef LOKI_TYPELIST_1(FeatureExcludedVolumeSc<FeatureLatticePowerOfTwo<> >) VolumeOnly;
+  typedef Ingredients<ConfigureSystem<VectorInt3,VolumeOnly> > VolumeOnlyIngredients;
+  EXPECT_EQ(1,FusedLocalScSweep<VolumeOnlyIngredients>::IS_FUSED);
+  EXPECT_EQ(0,FusedLocalScSweep<VolumeOnlyIngredients>::Stages::CHECKS_MOVABLE);
+}
+
+TEST_F(TestFusedLocalScSweep,SameTrajectoryAsSimpleSimulator)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> startState;
+  rng.getR250State(startState);
+
+  IngredientsType reference;
+  setupChains(reference);
+  UpdaterSimpleSimulator<IngredientsType,MoveLocalSc> simpleUpdater(reference,50);
+  simpleUpdater.execute();
+
+  rng.setR250State(startState);
+  IngredientsType fused;
+  setupChains(fused);
+  UpdaterFusedSimulator<IngredientsType> fusedUpdater(fused,50);
+  fusedUpdater.execute();
+
+  EXPECT_EQ(reference.getMolecules().getAge(),fused.getMolecules().getAge());
+  uint32_t nMoved=0;
+  for(uint32_t n=0;n<reference.getMolecules().size();n++)
+  {
+    EXPECT_EQ(reference.getMolecules()[n],fused.getMolecules()[n]);
+    if(n%17==0){ EXPECT_EQ(VectorInt3(2*(n%10)-10,2*((n/10)%15)-6,4*(n/150)-2),fused.getMolecules()[n]); }
+    if(fused.getMolecules()[n]!=VectorInt3(2*(n%10)-10,2*((n/10)%15)-6,4*(n/150)-2)) nMoved++;
+  }
+  EXPECT_GT(nMoved,0u);
+  checkLattice(fused);
+  EXPECT_NO_THROW(fused.synchronize());
+
+  //the kernel counts the accepted moves
+  FusedLocalScSweep<IngredientsType> kernel;
+  EXPECT_EQ(0u,kernel.sweep(fused,0));
+  EXPECT_LE(kernel.sweep(fused,1000),1000u);
+}
+
+TEST_F(TestFusedLocalScSweep,NonPeriodicBox)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> startState;
+  rng.getR250State(startState);
+
+  //walls in x and z, chains touching the lower and upper walls
+  IngredientsType reference, fused;
+  IngredientsType* systems[2]={&reference,&fused};
+  for(int32_t s=0;s<2;s++)
+  {
+    IngredientsType& ingredients=*systems[s];
+    ingredients.setBoxX(30);
+    ingredients.setBoxY(30);
+    ingredients.setBoxZ(30);
+    ingredients.setPeriodicX(false);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(false);
+    ingredients.modifyBondset().addBFMclassicBondset();
+    for(int32_t c=0;c<40;c++)
+    {
+      for(int32_t m=0;m<10;m++)
+      {
+	uint32_t idx=ingredients.modifyMolecules().addMonomer((c%2==0 ? 2*m : 28-2*m),2*(c%15)-6,14*(c/15));
+	if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+      }
+    }
+    ingredients.synchronize();
+  }
+
+  UpdaterSimpleSimulator<IngredientsType,MoveLocalSc> simpleUpdater(reference,50);
+  simpleUpdater.execute();
+
+  rng.setR250State(startState);
+  UpdaterFusedSimulator<IngredientsType> fusedUpdater(fused,50);
+  fusedUpdater.execute();
+
+  for(uint32_t n=0;n<reference.getMolecules().size();n++)
+  {
+    EXPECT_EQ(reference.getMolecules()[n],fused.getMolecules()[n]);
+    EXPECT_GE(fused.getMolecules()[n].getX(),0);
+    EXPECT_LT(fused.getMolecules()[n].getX(),29);
+    EXPECT_GE(fused.getMolecules()[n].getZ(),0);
+    EXPECT_LT(fused.getMolecules()[n].getZ(),29);
+  }
+  checkLattice(fused);
+}
+
+TEST_F(TestFusedLocalScSweep,BondIndexCache)
+{
+  IngredientsType fused;
+  fused.setUseBondIndexCache(true);
+  setupChains(fused);
+  ASSERT_TRUE(fused.isBondIndexCacheActive());
+  UpdaterFusedSimulator<IngredientsType> fusedUpdater(fused,20);
+  fusedUpdater.execute();
+
+  //the kernel keeps the cached bond-vector indices up to date
+  const IngredientsType::molecules_type& molecules=fused.getMolecules();
+  for(uint32_t n=0;n<molecules.size();n++)
+    for(uint32_t j=0;j<molecules.getNumLinks(n);j++)
+      EXPECT_EQ(fused.getBondset().bondVectorToIndex(molecules[molecules.getNeighborIdx(n,j)]-molecules[n]),molecules.getBondIndexUnchecked(n,j));
+}
+
+TEST_F(TestFusedLocalScSweep,GenericFallback)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> startState;
+  rng.getR250State(startState);
+
+  GenericIngredientsType reference;
+  setupChains(reference);
+  UpdaterSimpleSimulator<GenericIngredientsType,MoveLocalSc> simpleUpdater(reference,20);
+  simpleUpdater.execute();
+
+  rng.setR250State(startState);
+  GenericIngredientsType generic;
+  setupChains(generic);
+  UpdaterFusedSimulator<GenericIngredientsType> genericUpdater(generic,20);
+  genericUpdater.execute();
+
+  for(uint32_t n=0;n<reference.getMolecules().size();n++)
+    EXPECT_EQ(reference.getMolecules()[n],generic.getMolecules()[n]);
+}
+
+TEST_F(TestFusedLocalScSweep,RequiresFilledLattice)
+{
+  IngredientsType ingredients;
+  setupChains(ingredients);
+  ingredients.setLatticeFilledUp(false);
+  FusedLocalScSweep<IngredientsType> kernel;
+  EXPECT_THROW(kernel.sweep(ingredients,10),std::runtime_error);
+}
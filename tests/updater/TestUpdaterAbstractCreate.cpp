@@ -328,3 +328,99 @@ TEST_F(UpdaterAbstractCreateTest, TestUpdater)
 
 }
 
+
+//test class providing public access to the functions building up a system
+template<class IngredientsType>
+class UpdaterTestDenseCreate: public UpdaterAbstractCreate<IngredientsType>
+{
+  typedef UpdaterAbstractCreate<IngredientsType> BaseClass;
+
+public:
+  UpdaterTestDenseCreate(IngredientsType& ingredients_):BaseClass(ingredients_){}
+
+  virtual void initialize(){}
+  virtual bool execute(){return true;}
+  virtual void cleanup(){}
+
+  using BaseClass::addSingleMonomer;
+  using BaseClass::addMonomerToParent;
+};
+
+TEST_F(UpdaterAbstractCreateTest, FillBoxWithSingleMonomers)
+{
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureExcludedVolumeSc< FeatureLatticePowerOfTwo <uint8_t> >,FeatureAttributes<>) Features;
+  typedef ConfigureSystem<VectorInt3,Features> Config;
+  typedef Ingredients<Config> IngredientsType;
+
+  IngredientsType ingredients;
+  ingredients.setBoxX(8);
+  ingredients.setBoxY(8);
+  ingredients.setBoxZ(8);
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.modifyBondset().addBFMclassicBondset();
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  UpdaterTestDenseCreate<IngredientsType> creator(ingredients);
+
+  //add monomers until the box is jammed
+  uint32_t nAdded(0);
+  while(creator.addSingleMonomer(1)) nAdded++;
+
+  EXPECT_EQ(nAdded,ingredients.getMolecules().size());
+  EXPECT_GT(nAdded,0u);
+  EXPECT_LE(nAdded,64u);
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  //the function must only fail if there is no free position left
+  MoveAddMonomerSc<> addmove;
+  addmove.init(ingredients);
+  for(int32_t x=0;x<8;x++)
+    for(int32_t y=0;y<8;y++)
+      for(int32_t z=0;z<8;z++){
+	addmove.setPosition(VectorInt3(x,y,z));
+	EXPECT_FALSE(addmove.check(ingredients));
+      }
+
+  //after removing monomers there is space again
+  ingredients.modifyMolecules().resize(nAdded-1);
+  ingredients.synchronize();
+  EXPECT_TRUE(creator.addSingleMonomer(2));
+  EXPECT_EQ(2,ingredients.getMolecules()[nAdded-1].getAttributeTag());
+  EXPECT_NO_THROW(ingredients.synchronize());
+}
+
+TEST_F(UpdaterAbstractCreateTest, DenseChains)
+{
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureExcludedVolumeSc< FeatureLatticePowerOfTwo <uint8_t> >,FeatureAttributes<>) Features;
+  typedef ConfigureSystem<VectorInt3,Features> Config;
+  typedef Ingredients<Config> IngredientsType;
+
+  IngredientsType ingredients;
+  ingredients.setBoxX(16);
+  ingredients.setBoxY(16);
+  ingredients.setBoxZ(16);
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.modifyBondset().addBFMclassicBondset();
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  UpdaterTestDenseCreate<IngredientsType> creator(ingredients);
+
+  //32 chains of 8 monomers fill half of the lattice
+  for(uint32_t chain=0;chain<32;chain++){
+    ASSERT_TRUE(creator.addSingleMonomer(1));
+    for(uint32_t n=1;n<8;n++){
+      ASSERT_TRUE(creator.addMonomerToParent(ingredients.getMolecules().size()-1,1));
+    }
+  }
+
+  EXPECT_EQ(256,ingredients.getMolecules().size());
+  //checks excluded volume and bonds
+  EXPECT_NO_THROW(ingredients.synchronize());
+  for(uint32_t n=0;n<256;n++){
+    EXPECT_EQ((n%8==0 || n%8==7)?1:2,ingredients.getMolecules().getNumLinks(n));
+  }
+}
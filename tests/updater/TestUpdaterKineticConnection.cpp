@@ -0,0 +1,239 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Tests for UpdaterKineticConnection
+ * */
+/*****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/feature/FeatureConnectionSc.h>
+#include <LeMonADE/feature/FeatureReactiveBonds.h>
+#include <LeMonADE/feature/FeatureBoltzmann.h>
+#include <LeMonADE/updater/moves/MoveConnectScReactive.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/updater/UpdaterKineticConnection.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+//! halves the acceptance probability of connection moves, such that FeatureBoltzmann draws random numbers for them
+class FeatureHalfConnectionRate:public Feature
+{
+public:
+  typedef LOKI_TYPELIST_1(FeatureBoltzmann) required_features_back;
+
+  using Feature::checkMove;
+
+  template<class IngredientsType,class SpecializedMove>
+  bool checkMove(const IngredientsType&, MoveConnectBase<SpecializedMove>& move) const
+  {
+    move.multiplyProbability(0.5);
+    return true;
+  }
+};
+
+class TestUpdaterKineticConnection: public ::testing::Test{
+public:
+
+  typedef LOKI_TYPELIST_4(FeatureMoleculesIO,FeatureReactiveBonds, FeatureConnectionSc, FeatureExcludedVolumeSc< FeatureLatticePowerOfTwo <uint8_t> >) Features;
+  typedef ConfigureSystem<VectorInt3,Features> Config;
+  typedef Ingredients<Config> IngredientsType;
+  typedef UpdaterKineticConnection<IngredientsType,MoveLocalSc,MoveConnectScReactive> UpdaterType;
+
+  IngredientsType ingredients;
+
+  void setupBox(){
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(true);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(true);
+    ingredients.modifyBondset().addBFMclassicBondset();
+  }
+
+  //redirect cout output
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+  };
+
+  //restore original output
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+  };
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+
+};
+
+TEST_F(TestUpdaterKineticConnection, Catalogue)
+{
+  setupBox();
+  ingredients.modifyMolecules().addMonomer(8,8,8);
+  ingredients.modifyMolecules().addMonomer(10,8,8);
+  ingredients.modifyMolecules().addMonomer(8,10,8);
+  ingredients.modifyMolecules().addMonomer(2,2,2);
+  ingredients.modifyMolecules()[0].setReactive(true);
+  ingredients.modifyMolecules()[0].setNumMaxLinks(1);
+  ingredients.modifyMolecules()[1].setReactive(true);
+  ingredients.modifyMolecules()[1].setNumMaxLinks(1);
+  ingredients.modifyMolecules()[2].setReactive(false);
+  ingredients.modifyMolecules()[2].setNumMaxLinks(1);
+  ingredients.modifyMolecules()[3].setReactive(true);
+  ingredients.modifyMolecules()[3].setNumMaxLinks(1);
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  EXPECT_THROW(UpdaterType(ingredients,1,0.0),std::runtime_error);
+
+  UpdaterType updater(ingredients,1);
+  updater.initialize();
+
+  //0 and 1 can react with each other, 2 is not reactive, 3 has no partner
+  EXPECT_EQ(updater.getNPossibleReactions(),2);
+  EXPECT_EQ(updater.getNPossibleReactions(0),1);
+  EXPECT_EQ(updater.getNPossibleReactions(1),1);
+  EXPECT_EQ(updater.getNPossibleReactions(2),0);
+  EXPECT_EQ(updater.getNPossibleReactions(3),0);
+  EXPECT_DOUBLE_EQ(updater.getTotalRate(),2.0/6.0);
+
+  MoveConnectScReactive connect;
+  connect.init(ingredients,0,1);
+  ASSERT_TRUE(connect.check(ingredients));
+  connect.apply(ingredients);
+  updater.rebuildCatalogue();
+  EXPECT_EQ(updater.getNPossibleReactions(),0);
+}
+
+TEST_F(TestUpdaterKineticConnection, IncrementalCatalogue)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> r250State;
+  rng.getR250State(r250State);
+  rng.seedDefaultValuesAll();
+
+  setupBox();
+  //one reactive monomer per 4x4x4 cell
+  for(int32_t x=0;x<16;x+=4)
+    for(int32_t y=0;y<16;y+=4)
+      for(int32_t z=0;z<16;z+=4)
+      {
+        uint32_t n=ingredients.getMolecules().size();
+        ingredients.modifyMolecules().addMonomer(x,y,z);
+        ingredients.modifyMolecules()[n].setReactive(true);
+        ingredients.modifyMolecules()[n].setNumMaxLinks(2);
+      }
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  UpdaterType updater(ingredients,5);
+  updater.initialize();
+  EXPECT_EQ(updater.getNPossibleReactions(),0);
+
+  for(uint32_t cycle=0;cycle<20;cycle++)
+  {
+    EXPECT_NO_THROW(updater.execute());
+
+    //the incrementally tracked catalogue equals the one checked from scratch
+    std::vector<uint32_t> tracked;
+    for(uint32_t n=0;n<ingredients.getMolecules().size();n++)
+      tracked.push_back(updater.getNPossibleReactions(n));
+    uint32_t trackedTotal=updater.getNPossibleReactions();
+
+    updater.rebuildCatalogue();
+    EXPECT_EQ(updater.getNPossibleReactions(),trackedTotal);
+    for(uint32_t n=0;n<ingredients.getMolecules().size();n++)
+      EXPECT_EQ(updater.getNPossibleReactions(n),tracked[n]);
+  }
+
+  EXPECT_EQ(ingredients.getMolecules().getAge(),100);
+  EXPECT_EQ(updater.getNAttemptedMoves(),100u*ingredients.getMolecules().size());
+  EXPECT_GT(updater.getNAcceptedMoves(),0u);
+  EXPECT_LE(updater.getNAcceptedMoves(),updater.getNAttemptedMoves());
+  EXPECT_GT(updater.getNReactions(),0);
+  EXPECT_EQ(updater.getNReactions(),ingredients.getNReactedBonds());
+
+  for(uint32_t n=0;n<ingredients.getMolecules().size();n++)
+    EXPECT_LE(ingredients.getMolecules().getNumLinks(n),2);
+
+  rng.setR250State(r250State);
+}
+
+TEST_F(TestUpdaterKineticConnection, AcceptanceProbabilityAsRate)
+{
+  typedef LOKI_TYPELIST_5(FeatureMoleculesIO,FeatureReactiveBonds, FeatureConnectionSc, FeatureExcludedVolumeSc< FeatureLatticePowerOfTwo <uint8_t> >, FeatureHalfConnectionRate) BoltzmannFeatures;
+  typedef Ingredients<ConfigureSystem<VectorInt3,BoltzmannFeatures> > BoltzmannIngredients;
+  typedef UpdaterKineticConnection<BoltzmannIngredients,MoveLocalSc,MoveConnectScReactive> BoltzmannUpdater;
+
+  BoltzmannIngredients system;
+  system.setBoxX(16);
+  system.setBoxY(16);
+  system.setBoxZ(16);
+  system.setPeriodicX(true);
+  system.setPeriodicY(true);
+  system.setPeriodicZ(true);
+  system.modifyBondset().addBFMclassicBondset();
+  system.modifyMolecules().addMonomer(8,8,8);
+  system.modifyMolecules().addMonomer(10,8,8);
+  system.modifyMolecules().addMonomer(8,12,8);
+  for(uint32_t n=0;n<3;n++)
+  {
+    system.modifyMolecules()[n].setReactive(true);
+    system.modifyMolecules()[n].setNumMaxLinks(1);
+  }
+  EXPECT_NO_THROW(system.synchronize());
+
+  //building the catalogue does not draw random numbers
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> before, after;
+  rng.getR250State(before);
+  BoltzmannUpdater updater(system,1);
+  updater.initialize();
+  rng.getR250State(after);
+  EXPECT_EQ(before,after);
+
+  EXPECT_EQ(updater.getNPossibleReactions(),2);
+  EXPECT_DOUBLE_EQ(updater.getRateFactor(0),0.5);
+  EXPECT_DOUBLE_EQ(updater.getRateFactor(1),0.5);
+  EXPECT_DOUBLE_EQ(updater.getRateFactor(2),0.0);
+  EXPECT_DOUBLE_EQ(updater.getTotalRate(),0.5*2.0/6.0);
+
+  for(uint32_t n=0;n<50;n++)
+    ASSERT_NO_THROW(updater.execute());
+  EXPECT_EQ(updater.getNReactions(),system.getNReactedBonds());
+}
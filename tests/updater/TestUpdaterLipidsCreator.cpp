@@ -359,3 +359,66 @@ TEST_F(TestUpdaterLipidsCreator, TestObjectsandSolvent)
   EXPECT_EQ(num_fAC*(5-2)+num_ttNP*4,num3Links);
  
 }
+
+TEST_F(TestUpdaterLipidsCreator, TestSlotFilling)
+{
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureExcludedVolumeSc< FeatureLatticePowerOfTwo <uint8_t> >,FeatureAttributes<>) Features;
+  typedef ConfigureSystem<VectorInt3,Features> Config;
+  typedef Ingredients<Config> IngredientsType;
+
+  IngredientsType ingredients;
+  ingredients.setBoxX(32);
+  ingredients.setBoxY(32);
+  ingredients.setBoxZ(64);
+  int32_t box_volume=32*32*64;
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.modifyBondset().addBFMclassicBondset();
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  //every slot of both leaflets is used: (32/4)*(32/4) per leaflet
+  int32_t numLipids=128;
+  int32_t lipidsLength=2*5+3;
+  UpdaterLipidsCreator<IngredientsType> creator(ingredients,numLipids,0.4);
+  EXPECT_EQ(UpdaterLipidsCreator<IngredientsType>::RANDOM_INSERTION,creator.getGenerationMode());
+  creator.setGenerationMode(UpdaterLipidsCreator<IngredientsType>::SLOT_FILLING);
+  EXPECT_EQ(UpdaterLipidsCreator<IngredientsType>::SLOT_FILLING,creator.getGenerationMode());
+
+  TesterFunctions<IngredientsType> TF;
+  EXPECT_NO_THROW(creator.initialize());
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  EXPECT_EQ(numLipids*lipidsLength,TF.getTotalNonsolventMonomers(ingredients));
+  EXPECT_EQ(int32_t((0.4*box_volume-numLipids*lipidsLength*8)/8),TF.getTotalsolventMonomers(ingredients));
+  EXPECT_EQ(numLipids/2,creator.getUpperleafletLipids());
+  EXPECT_EQ(numLipids,TF.getNumMonWithLinks(ingredients,3));
+
+  //solvent is kept away from the bilayer
+  for(size_t n=0;n<ingredients.getMolecules().size();n++){
+    if(ingredients.getMolecules()[n].getAttributeTag()!=5) continue;
+    int32_t z=ingredients.getMolecules()[n].getZ();
+    EXPECT_TRUE(z<32-10 || z>=32+10);
+  }
+
+  //objects are placed in the remaining space
+  MoveAddMonomerSc<int32_t> move;
+  EXPECT_NO_THROW(creator.nanoTriangle(move,3));
+  EXPECT_EQ(3*3,TF.getNumMonWithAttribute(ingredients,7));
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  //a full leaflet is reported instead of searching forever
+  IngredientsType ingredients2;
+  ingredients2.setBoxX(32);
+  ingredients2.setBoxY(32);
+  ingredients2.setBoxZ(64);
+  ingredients2.setPeriodicX(true);
+  ingredients2.setPeriodicY(true);
+  ingredients2.setPeriodicZ(true);
+  ingredients2.modifyBondset().addBFMclassicBondset();
+  EXPECT_NO_THROW(ingredients2.synchronize());
+
+  UpdaterLipidsCreator<IngredientsType> tooMany(ingredients2,numLipids+2,0.1);
+  tooMany.setGenerationMode(UpdaterLipidsCreator<IngredientsType>::SLOT_FILLING);
+  EXPECT_THROW(tooMany.initialize(),std::runtime_error);
+}
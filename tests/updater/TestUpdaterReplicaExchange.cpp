@@ -0,0 +1,188 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Tests for the class UpdaterReplicaExchange
+ * */
+/*****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureNNInteractionSc.h>
+#include <LeMonADE/updater/UpdaterReplicaExchange.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+
+class TestUpdaterReplicaExchange: public ::testing::Test{
+public:
+
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO,FeatureAttributes<>,FeatureNNInteractionSc<FeatureLatticePowerOfTwo>) Features;
+  typedef ConfigureSystem<VectorInt3,Features,4> Config;
+  typedef Ingredients<Config> IngredientsType;
+  typedef UpdaterReplicaExchange<IngredientsType,MoveLocalSc> UpdaterType;
+
+  //redirect cout output and keep the random number sequence of other tests unchanged
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+    RandomNumberGenerators rng;
+    rng.getR250State(originalRngState);
+  };
+
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+    RandomNumberGenerators rng;
+    rng.setR250State(originalRngState);
+  };
+
+  //short chains of attractive monomers
+  void setupSystem(IngredientsType& ingredients)
+  {
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(true);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(true);
+    ingredients.modifyBondset().addBFMclassicBondset();
+    ingredients.setNNInteraction(1,1,-0.5);
+
+    for(int32_t c=0;c<8;c++)
+    {
+      for(int32_t m=0;m<6;m++)
+      {
+	uint32_t idx=ingredients.modifyMolecules().addMonomer(2*m,2*(c%4),4*(c/4));
+	ingredients.modifyMolecules()[idx].setAttributeTag(1);
+	if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+      }
+    }
+  }
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+  std::vector<uint32_t> originalRngState;
+};
+
+TEST_F(TestUpdaterReplicaExchange,SwapsTemperatures)
+{
+  IngredientsType ingredients;
+  setupSystem(ingredients);
+
+  std::vector<double> temperatures;
+  temperatures.push_back(1.0);
+  temperatures.push_back(1.2);
+  temperatures.push_back(1.5);
+  temperatures.push_back(2.0);
+
+  UpdaterType updater(ingredients,temperatures,5,20,"replicaExchangeTest.dat");
+  EXPECT_EQ(4u,updater.getNTemperatures());
+  EXPECT_DOUBLE_EQ(1.5,updater.getTemperature(2));
+
+  updater.initialize();
+  updater.execute();
+  updater.execute();
+
+  //every temperature is held by exactly one replica, which calculates its moves at this temperature
+  std::vector<bool> isUsed(4,false);
+  uint32_t nMoved=0;
+  for(size_t k=0;k<4;k++)
+  {
+    const IngredientsType& replica=updater.getIngredientsAtTemperature(k);
+    EXPECT_DOUBLE_EQ(temperatures[k],replica.getNNInteractionTemperature());
+    EXPECT_EQ(200u,replica.getMolecules().getAge());
+    EXPECT_NEAR(replica.calculateNNInteractionEnergy(replica),replica.getNNInteractionEnergy(),1e-9);
+
+    size_t r=updater.getReplicaAtTemperature(k);
+    EXPECT_FALSE(isUsed.at(r));
+    isUsed[r]=true;
+    if(r!=k) nMoved++;
+  }
+
+  //the local moves of all replicas are counted
+  const uint64_t nMonomers=ingredients.getMolecules().size();
+  EXPECT_EQ(4u*200u*nMonomers,updater.getNAttemptedMoves());
+  EXPECT_GT(updater.getNAcceptedMoves(),0u);
+  EXPECT_LE(updater.getNAcceptedMoves(),updater.getNAttemptedMoves());
+
+  //with these close temperatures, swaps are accepted
+  double sumRates=0.0;
+  for(size_t k=0;k<3;k++)
+  {
+    EXPECT_GE(updater.getAcceptanceRate(k),0.0);
+    EXPECT_LE(updater.getAcceptanceRate(k),1.0);
+    sumRates+=updater.getAcceptanceRate(k);
+  }
+  EXPECT_GT(sumRates,0.0);
+
+  //one output file per temperature with one line per round
+  updater.cleanup();
+  for(size_t k=0;k<4;k++)
+  {
+    std::stringstream filename;
+    filename<<"replicaExchangeTest_T000"<<k<<".dat";
+    std::ifstream file(filename.str().c_str());
+    ASSERT_TRUE(file.good());
+
+    std::string line;
+    uint32_t nLines=0;
+    while(std::getline(file,line))
+      if(!line.empty() && line[0]!='#') nLines++;
+    EXPECT_EQ(40u,nLines);
+    file.close();
+    std::remove(filename.str().c_str());
+  }
+}
+
+TEST_F(TestUpdaterReplicaExchange,InvalidTemperatures)
+{
+  IngredientsType ingredients;
+  setupSystem(ingredients);
+
+  std::vector<double> temperatures;
+  EXPECT_THROW(UpdaterType(ingredients,temperatures,1,1),std::runtime_error);
+  temperatures.push_back(1.0);
+  temperatures.push_back(0.5);
+  EXPECT_THROW(UpdaterType(ingredients,temperatures,1,1),std::runtime_error);
+  temperatures[1]=-1.0;
+  EXPECT_THROW(UpdaterType(ingredients,temperatures,1,1),std::runtime_error);
+  temperatures[0]=0.0;
+  temperatures[1]=1.0;
+  EXPECT_THROW(UpdaterType(ingredients,temperatures,1,1),std::runtime_error);
+}
@@ -45,8 +45,10 @@ along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
 #include <LeMonADE/feature/FeatureConnectionSc.h>
 #include <LeMonADE/feature/FeatureReactiveBonds.h>
 #include <LeMonADE/updater/moves/MoveConnectSc.h>
+#include <LeMonADE/updater/moves/MoveConnectScReactive.h>
 #include <LeMonADE/updater/moves/MoveLocalSc.h>
 #include <LeMonADE/updater/UpdaterSimpleConnection.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
 
 class TestUpdaterSimpleConnectionSc: public ::testing::Test{
 public:
@@ -115,3 +117,124 @@ TEST_F(TestUpdaterSimpleConnectionSc, Conversion)
   
   
 }
+
+//builds 64 monomers on a grid with spacing 4 which can form one bond each
+static void setupDimerSystem(TestUpdaterSimpleConnectionSc::IngredientsType& ingredients)
+{
+  ingredients.setBoxX(16);
+  ingredients.setBoxY(16);
+  ingredients.setBoxZ(16);
+  ingredients.setPeriodicX(true);
+  ingredients.setPeriodicY(true);
+  ingredients.setPeriodicZ(true);
+  ingredients.modifyBondset().addBFMclassicBondset();
+  for(int x=0;x<16;x+=4)
+  for(int y=0;y<16;y+=4)
+  for(int z=0;z<16;z+=4){
+    ingredients.modifyMolecules().addMonomer(x,y,z);
+    ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setReactive(true);
+    ingredients.modifyMolecules()[ingredients.getMolecules().size()-1].setNumMaxLinks(1);
+  }
+  ingredients.synchronize();
+}
+
+//the default schedule attempts one spatial and one connection move per monomer
+TEST_F(TestUpdaterSimpleConnectionSc, DefaultSchedule)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> rngState;
+  rng.getR250State(rngState);
+  rng.seedDefaultValuesAll();
+
+  setupDimerSystem(ingredients);
+  UpdaterSimpleConnection<IngredientsType,MoveLocalSc,MoveConnectScReactive> update(ingredients,10);
+  update.initialize();
+  update.execute();
+
+  EXPECT_EQ(10u,ingredients.getMolecules().getAge());
+  EXPECT_EQ(640u,update.getNAttemptedMoves());
+  EXPECT_EQ(640u,update.getNAttemptedConnections());
+  EXPECT_EQ(uint64_t(2*ingredients.getNReactedBonds()),2*update.getNAcceptedConnections());
+
+  rng.setR250State(rngState);
+}
+
+//sized by the reactive sites, the connection phase stops at the conversion
+//target, and the interleaved schedule makes the same number of attempts
+TEST_F(TestUpdaterSimpleConnectionSc, ReactiveSitesSchedule)
+{
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> rngState;
+  rng.getR250State(rngState);
+  rng.seedDefaultValuesAll();
+
+  setupDimerSystem(ingredients);
+  UpdaterSimpleConnection<IngredientsType,MoveLocalSc,MoveConnectScReactive> update(ingredients,1);
+  update.setConnectionSweepSize(UpdaterSimpleConnection<IngredientsType,MoveLocalSc,MoveConnectScReactive>::SWEEP_REACTIVE_SITES);
+  update.setInterleaveRatio(3);
+  update.setConversionTarget(0.5);
+  update.setReportPeriod(10);
+  update.initialize();
+
+  uint32_t mcs=0;
+  while(ingredients.getConversion()<0.5 && mcs<10000){
+    uint32_t nUnreacted=ingredients.getNUnreactedMonomers();
+    uint64_t nAttempted=update.getNAttemptedConnections();
+    update.execute();
+    mcs++;
+    EXPECT_LE(update.getNAttemptedConnections()-nAttempted,uint64_t(nUnreacted));
+  }
+  ASSERT_LT(mcs,10000u);
+  //the target is hit exactly, since every connection increases the conversion by 2/64
+  EXPECT_DOUBLE_EQ(0.5,ingredients.getConversion());
+  EXPECT_EQ(16u,update.getNAcceptedConnections());
+
+  //no further connection attempts once the target is reached
+  uint64_t nAttempted=update.getNAttemptedConnections();
+  update.execute();
+  EXPECT_EQ(nAttempted,update.getNAttemptedConnections());
+  EXPECT_EQ(uint64_t(64*(mcs+1)),update.getNAttemptedMoves());
+
+  rng.setR250State(rngState);
+}
+
+//without FeatureReactiveBonds, MoveConnectSc connects any monomers up to the connectivity of FeatureConnectionSc
+TEST_F(TestUpdaterSimpleConnectionSc, WithoutReactiveBonds)
+{
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO, FeatureConnectionSc, FeatureExcludedVolumeSc< FeatureLatticePowerOfTwo <uint8_t> >) PlainFeatures;
+  typedef Ingredients<ConfigureSystem<VectorInt3,PlainFeatures> > PlainIngredients;
+  typedef UpdaterSimpleConnection<PlainIngredients,MoveLocalSc,MoveConnectSc> PlainUpdater;
+
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> rngState;
+  rng.getR250State(rngState);
+  rng.seedDefaultValuesAll();
+
+  PlainIngredients system;
+  system.setBoxX(16);
+  system.setBoxY(16);
+  system.setBoxZ(16);
+  system.setPeriodicX(true);
+  system.setPeriodicY(true);
+  system.setPeriodicZ(true);
+  system.modifyBondset().addBFMclassicBondset();
+  for(int x=0;x<16;x+=4)
+  for(int y=0;y<16;y+=4)
+  for(int z=0;z<16;z+=4)
+    system.modifyMolecules().addMonomer(x,y,z);
+  system.synchronize();
+
+  PlainUpdater update(system,10);
+  EXPECT_THROW(update.setConversionTarget(0.5),std::runtime_error);
+  EXPECT_THROW(update.setConnectionSweepSize(PlainUpdater::SWEEP_REACTIVE_SITES),std::runtime_error);
+  update.setReportPeriod(5);
+  update.initialize();
+  update.execute();
+
+  EXPECT_EQ(10u,system.getMolecules().getAge());
+  EXPECT_EQ(640u,update.getNAttemptedConnections());
+  EXPECT_GT(update.getNAcceptedConnections(),0u);
+  EXPECT_EQ(update.getNAcceptedConnections(),uint64_t(system.getMolecules().getTotalNumLinks()));
+
+  rng.setR250State(rngState);
+}
@@ -0,0 +1,263 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Tests for UpdaterSpatialReorder and the space filling curve keys
+ * */
+/*****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureBondset.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeScIdOnLattice.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/updater/UpdaterSpatialReorder.h>
+#include <LeMonADE/utility/LatticePredicates.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/utility/SpaceFillingCurve.h>
+
+class TestUpdaterSpatialReorder: public ::testing::Test{
+public:
+
+  typedef FeatureExcludedVolumeScIdOnLattice<FeatureLatticePowerOfTwo<uint32_t>, MonomerID > ExcludedVolume;
+  typedef LOKI_TYPELIST_3(ExcludedVolume, FeatureBondset<>, FeatureAttributes<>) Features;
+  typedef ConfigureSystem<VectorInt3,Features> Config;
+  typedef Ingredients<Config> IngredientsType;
+
+  IngredientsType ingredients;
+
+  //redirect cout output and keep the random number sequence of other tests unchanged
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+    RandomNumberGenerators rng;
+    rng.getR250State(originalRngState);
+  };
+
+  //restore original output
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+    RandomNumberGenerators rng;
+    rng.setR250State(originalRngState);
+  };
+
+  //chains of 8 monomers, created in an order unrelated to their position
+  void setupChains()
+  {
+    ingredients.setBoxX(32);
+    ingredients.setBoxY(32);
+    ingredients.setBoxZ(32);
+    ingredients.setPeriodicX(true);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(true);
+    ingredients.modifyBondset().addBFMclassicBondset();
+
+    for(int32_t c=0;c<16;c++)
+    {
+      int32_t y=4*((c*5)%8);
+      int32_t z=16*(c/8);
+      for(int32_t m=0;m<8;m++)
+      {
+	uint32_t idx=ingredients.modifyMolecules().addMonomer(2*m+16*((c*3)%2),y,z);
+	ingredients.modifyMolecules()[idx].setAttributeTag(int32_t(idx));
+	if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+      }
+    }
+    ingredients.synchronize();
+  }
+
+  //checks that every monomer still has its original index
+  void checkOriginalIndices()
+  {
+    const IngredientsType::molecules_type& molecules=ingredients.getMolecules();
+    ASSERT_EQ(128,molecules.size());
+    EXPECT_EQ(112,molecules.getTotalNumLinks());
+    for(uint32_t n=0;n<molecules.size();n++)
+    {
+      EXPECT_EQ(int32_t(n),molecules[n].getAttributeTag());
+      EXPECT_EQ(n+1,ingredients.getLatticeEntry(molecules[n]));
+      if(n%8!=7){ EXPECT_TRUE(molecules.areConnected(n,n+1)); }
+      EXPECT_EQ((n%8==0||n%8==7)?1u:2u,molecules.getNumLinks(n));
+    }
+  }
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+  std::vector<uint32_t> originalRngState;
+};
+
+TEST(SpaceFillingCurveTest,HilbertKeys)
+{
+  //the keys enumerate all sites of the cube, and consecutive keys are neighbors
+  for(uint32_t bits=1;bits<=4;bits++)
+  {
+    const int32_t L=1<<bits;
+    std::vector<int32_t> site(L*L*L,-1);
+    for(int32_t x=0;x<L;x++)
+      for(int32_t y=0;y<L;y++)
+	for(int32_t z=0;z<L;z++)
+	{
+	  uint64_t key=hilbertKey3D(x,y,z,bits);
+	  ASSERT_LT(key,uint64_t(L*L*L));
+	  ASSERT_EQ(-1,site[key]);
+	  site[key]=(x*L+y)*L+z;
+	}
+
+    for(int32_t k=1;k<L*L*L;k++)
+    {
+      int32_t a=site[k-1], b=site[k];
+      int32_t distance=std::abs(a/(L*L)-b/(L*L))+std::abs((a/L)%L-(b/L)%L)+std::abs(a%L-b%L);
+      EXPECT_EQ(1,distance);
+    }
+  }
+
+  EXPECT_EQ(0u,mortonKey3D(0,0,0));
+  EXPECT_EQ(4u,mortonKey3D(1,0,0));
+  EXPECT_EQ(2u,mortonKey3D(0,1,0));
+  EXPECT_EQ(9u,mortonKey3D(0,0,3));
+  EXPECT_EQ(0x7fffffffffffffffULL,mortonKey3D(0x1fffff,0x1fffff,0x1fffff));
+}
+
+TEST_F(TestUpdaterSpatialReorder,CalculateOrder)
+{
+  setupChains();
+  UpdaterSpatialReorder<IngredientsType,MoveLocalSc> updater(ingredients,1);
+
+  std::vector<uint32_t> order;
+  updater.calculateOrder(order);
+  ASSERT_EQ(128,order.size());
+
+  //order is a permutation with non decreasing keys along the curve
+  std::vector<bool> seen(128,false);
+  uint64_t lastKey=0;
+  for(uint32_t i=0;i<order.size();i++)
+  {
+    ASSERT_LT(order[i],128u);
+    EXPECT_FALSE(seen[order[i]]);
+    seen[order[i]]=true;
+    const VectorInt3& pos=ingredients.getMolecules()[order[i]];
+    uint64_t key=hilbertKey3D(pos.getX(),pos.getY(),pos.getZ(),5);
+    EXPECT_LE(lastKey,key);
+    lastKey=key;
+  }
+
+  updater.setCurveType(UpdaterSpatialReorder<IngredientsType,MoveLocalSc>::MORTON_CURVE);
+  updater.calculateOrder(order);
+  lastKey=0;
+  for(uint32_t i=0;i<order.size();i++)
+  {
+    const VectorInt3& pos=ingredients.getMolecules()[order[i]];
+    uint64_t key=mortonKey3D(pos.getX(),pos.getY(),pos.getZ());
+    EXPECT_LE(lastKey,key);
+    lastKey=key;
+  }
+}
+
+TEST_F(TestUpdaterSpatialReorder,KeepsOriginalIndices)
+{
+  setupChains();
+  std::vector<VectorInt3> initialPositions;
+  for(uint32_t n=0;n<ingredients.getMolecules().size();n++)
+    initialPositions.push_back(ingredients.getMolecules()[n]);
+
+  //sequential sweeps, reordered several times per execute
+  UpdaterSpatialReorder<IngredientsType,MoveLocalSc> updater(ingredients,20,3);
+  updater.setSweepType(UpdaterSpatialReorder<IngredientsType,MoveLocalSc>::SEQUENTIAL_SWEEP);
+  EXPECT_TRUE(updater.execute());
+  EXPECT_EQ(20,ingredients.getMolecules().getAge());
+  EXPECT_EQ(20u*128u,updater.getNAttemptedMoves());
+  EXPECT_GT(updater.getNAcceptedMoves(),0u);
+  EXPECT_LE(updater.getNAcceptedMoves(),updater.getNAttemptedMoves());
+  checkOriginalIndices();
+  for(uint32_t n=0;n<128;n++) EXPECT_EQ(n,updater.getStorageIndex(n));
+  EXPECT_NO_THROW(ingredients.synchronize());
+
+  uint32_t nMoved=0;
+  for(uint32_t n=0;n<ingredients.getMolecules().size();n++)
+    if(ingredients.getMolecules()[n]!=initialPositions[n]) nMoved++;
+  EXPECT_GT(nMoved,0u);
+
+  //random sweeps along the Morton curve
+  updater.setSweepType(UpdaterSpatialReorder<IngredientsType,MoveLocalSc>::RANDOM_SWEEP);
+  updater.setCurveType(UpdaterSpatialReorder<IngredientsType,MoveLocalSc>::MORTON_CURVE);
+  updater.setReorderPeriod(0);
+  EXPECT_EQ(1,updater.getReorderPeriod());
+  EXPECT_TRUE(updater.execute());
+  EXPECT_EQ(40,ingredients.getMolecules().getAge());
+  checkOriginalIndices();
+  EXPECT_NO_THROW(ingredients.synchronize());
+}
+
+TEST_F(TestUpdaterSpatialReorder,KeepsOrderBetweenCalls)
+{
+  setupChains();
+  typedef UpdaterSpatialReorder<IngredientsType,MoveLocalSc> UpdaterType;
+  UpdaterType updater(ingredients,5,8);
+  EXPECT_EQ(1,updater.getOutputPeriod());
+  updater.setOutputPeriod(0);
+  updater.setSweepType(UpdaterType::SEQUENTIAL_SWEEP);
+
+  //the storage stays reordered between the calls and is consistent with the features
+  EXPECT_TRUE(updater.execute());
+  EXPECT_TRUE(updater.isReordered());
+  EXPECT_TRUE(updater.execute());
+  EXPECT_TRUE(updater.isReordered());
+  EXPECT_EQ(10,ingredients.getMolecules().getAge());
+  uint32_t nPermuted=0;
+  for(uint32_t n=0;n<128;n++)
+  {
+    EXPECT_EQ(n,updater.getStorageIndex(updater.getOriginalIndex(n)));
+    EXPECT_EQ(int32_t(updater.getOriginalIndex(n)),ingredients.getMolecules()[n].getAttributeTag());
+    EXPECT_EQ(n+1,ingredients.getLatticeEntry(ingredients.getMolecules()[n]));
+    if(updater.getOriginalIndex(n)!=n) nPermuted++;
+  }
+  EXPECT_GT(nPermuted,0u);
+
+  //cleanup restores the original order
+  updater.cleanup();
+  EXPECT_FALSE(updater.isReordered());
+  checkOriginalIndices();
+
+  //restored after every second call
+  updater.setOutputPeriod(2);
+  EXPECT_TRUE(updater.execute());
+  EXPECT_TRUE(updater.isReordered());
+  EXPECT_TRUE(updater.execute());
+  EXPECT_FALSE(updater.isReordered());
+  checkOriginalIndices();
+}
@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureNNInteractionSc.h>
+#include <LeMonADE/feature/FeatureLinearForce.h>
+#include <LeMonADE/feature/FeatureLattice.h>
+#include <LeMonADE/utility/EnergyReport.h>
+#include <LeMonADE/utility/LastCheckedMove.h>
+
+class EnergyReportTest: public ::testing::Test{
+public:
+  //redirect cout output
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+  };
+  //restore original output
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+  };
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+};
+
+TEST_F(EnergyReportTest, AddAndSum)
+{
+	EnergyReport report;
+	EXPECT_EQ(0u,report.size());
+	EXPECT_DOUBLE_EQ(0.0,report.getTotalEnergy());
+
+	report.addEnergy("A",1.5);
+	report.addEnergy("B",-0.25);
+	ASSERT_EQ(2u,report.size());
+	EXPECT_EQ("A",report.getName(0));
+	EXPECT_EQ("B",report.getName(1));
+	EXPECT_DOUBLE_EQ(1.5,report.getEnergy(0));
+	EXPECT_DOUBLE_EQ(-0.25,report.getEnergy("B"));
+	EXPECT_DOUBLE_EQ(1.25,report.getTotalEnergy());
+	EXPECT_TRUE(report.hasEnergy("A"));
+	EXPECT_FALSE(report.hasEnergy("C"));
+	EXPECT_THROW(report.getEnergy("C"),std::runtime_error);
+	EXPECT_THROW(report.getEnergy(2),std::out_of_range);
+
+	report.clear();
+	EXPECT_EQ(0u,report.size());
+}
+
+TEST_F(EnergyReportTest, Ingredients)
+{
+	//features without energy do not report anything
+	typedef LOKI_TYPELIST_1(FeatureMoleculesIO) Features0;
+	typedef ConfigureSystem<VectorInt3,Features0> Config0;
+	typedef Ingredients<Config0> Ing0;
+	Ing0 empty;
+	EXPECT_EQ(0u,EnergyReport(empty).size());
+
+	typedef LOKI_TYPELIST_3(FeatureMoleculesIO,FeatureLinearForce,FeatureNNInteractionSc<FeatureLattice>) Features;
+	typedef ConfigureSystem<VectorInt3,Features> Config;
+	typedef Ingredients<Config> Ing;
+	Ing ingredients;
+
+	ingredients.setBoxX(16);
+	ingredients.setBoxY(16);
+	ingredients.setBoxZ(16);
+	ingredients.setPeriodicX(true);
+	ingredients.setPeriodicY(true);
+	ingredients.setPeriodicZ(true);
+	ingredients.setNNInteraction(4,5,0.5);
+	ingredients.setAmplitudeForce(0.1);
+	ingredients.setForceOn(true);
+
+	ingredients.modifyMolecules().resize(2);
+	ingredients.modifyMolecules()[0].setAllCoordinates(4,4,4);
+	ingredients.modifyMolecules()[0].setAttributeTag(4);
+	ingredients.modifyMolecules()[1].setAllCoordinates(6,4,4);
+	ingredients.modifyMolecules()[1].setAttributeTag(5);
+	ingredients.synchronize();
+
+	//the energies are reported in the order of the features
+	EnergyReport report(ingredients);
+	ASSERT_EQ(2u,report.size());
+	EXPECT_EQ("FeatureLinearForce",report.getName(0));
+	EXPECT_EQ("FeatureNNInteractionSc",report.getName(1));
+	EXPECT_DOUBLE_EQ(0.1*(4-6),report.getEnergy(0));
+	EXPECT_DOUBLE_EQ(2.0,report.getEnergy(1));
+	EXPECT_DOUBLE_EQ(2.0-0.2,report.getTotalEnergy());
+}
+
+TEST_F(EnergyReportTest, LastCheckedMove)
+{
+  LastCheckedMove lastChecked;
+  EXPECT_DOUBLE_EQ(1.0,lastChecked.getFactor());
+  EXPECT_EQ(0.0,lastChecked.getEnergyDifference());
+
+  lastChecked.set(5,VectorInt3(0,1,0),std::exp(-0.5));
+  EXPECT_TRUE(lastChecked.matches(5,VectorInt3(0,1,0)));
+  EXPECT_FALSE(lastChecked.matches(5,VectorInt3(0,-1,0)));
+  EXPECT_FALSE(lastChecked.matches(4,VectorInt3(0,1,0)));
+  EXPECT_DOUBLE_EQ(0.5,lastChecked.getEnergyDifference());
+}
@@ -270,3 +270,41 @@ TEST_F(BondsetTest, LookupTable)
 
 
 }
+
+TEST_F(BondsetTest, BondIndices)
+{
+  FastBondset bondset;
+  bondset.addBFMclassicBondset();
+  bondset.addBond(4,0,0,200);
+  bondset.updateLookupTable();
+
+  EXPECT_TRUE(FastBondset::isBondIndex(0));
+  EXPECT_TRUE(FastBondset::isBondIndex(511));
+  EXPECT_FALSE(FastBondset::isBondIndex(512));
+  EXPECT_FALSE(FastBondset::isBondIndex(0xFFFF));
+
+  //components of +-4 are rejected by index as well as by vector
+  EXPECT_TRUE(bondset.isValid(VectorInt3(4,0,0)));
+  EXPECT_FALSE(bondset.isValidIndexStrongCheck(bondset.bondVectorToIndex(VectorInt3(4,0,0))));
+  EXPECT_FALSE(bondset.isValidIndexStrongCheck(bondset.bondVectorToIndex(VectorInt3(2,-4,1))));
+
+  //shifting the index by a local move agrees with the shifted vector for all bonds of the look-up range
+  for(int32_t x=-3;x<=3;x++)
+    for(int32_t y=-3;y<=3;y++)
+      for(int32_t z=-3;z<=3;z++)
+      {
+	const VectorInt3 bond(x,y,z);
+	const uint32_t bondIndex=bondset.bondVectorToIndex(bond);
+	EXPECT_EQ(bondset.bondVectorToIndex(VectorInt3(-x,-y,-z)),FastBondset::reverseBondIndex(bondIndex));
+	EXPECT_EQ(bondset.isValidStrongCheck(bond),bondset.isValidIndexStrongCheck(bondIndex));
+
+	for(int32_t s=0;s<27;s++)
+	{
+	  const VectorInt3 shift(s%3-1,(s/3)%3-1,s/9-1);
+	  const uint32_t shiftedIndex=FastBondset::shiftBondIndex(bondIndex,shift);
+	  EXPECT_EQ(bondset.bondVectorToIndex(bond+shift),shiftedIndex);
+	  EXPECT_EQ(bondset.isValidStrongCheck(bond+shift),bondset.isValidIndexStrongCheck(shiftedIndex));
+	}
+      }
+}
+
@@ -0,0 +1,160 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+#include "gtest/gtest.h"
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/utility/MonomerGroup.h>
+#include <LeMonADE/utility/FastMonomerGroup.h>
+
+typedef Molecules<VectorInt3> MyMolecules;
+
+class FastMonomerGroupTest: public ::testing::Test{
+protected:
+	MyMolecules molecules;
+	virtual void SetUp(){
+		for(int i=0;i<200;i++)
+			molecules.addMonomer(VectorInt3(i,2*i,-i));
+	}
+};
+
+TEST_F(FastMonomerGroupTest, InsertAndMembership)
+{
+	FastMonomerGroup<MyMolecules> group(molecules);
+	EXPECT_EQ(group.size(),0);
+	EXPECT_FALSE(group.contains(5));
+	EXPECT_FALSE(group.contains(100000));
+
+	EXPECT_TRUE(group.insert(10));
+	EXPECT_TRUE(group.insert(150));
+	EXPECT_TRUE(group.insert(3));
+	EXPECT_FALSE(group.insert(10));
+	group.push_back(64);
+	group.push_back(64);
+
+	ASSERT_EQ(group.size(),4);
+	//indices are kept sorted
+	EXPECT_EQ(group.trueIndex(0),3);
+	EXPECT_EQ(group.trueIndex(1),10);
+	EXPECT_EQ(group.trueIndex(2),64);
+	EXPECT_EQ(group.trueIndex(3),150);
+	EXPECT_THROW(group.trueIndex(4),std::out_of_range);
+
+	EXPECT_TRUE(group.contains(3));
+	EXPECT_TRUE(group.contains(64));
+	EXPECT_FALSE(group.contains(63));
+	EXPECT_FALSE(group.contains(65));
+
+	EXPECT_EQ(group[2].getX(),64);
+	EXPECT_EQ(group[2].getY(),128);
+	EXPECT_EQ(group[2].getZ(),-64);
+
+	//indices beyond the current molecules size can be stored
+	EXPECT_TRUE(group.insert(1000));
+	EXPECT_TRUE(group.contains(1000));
+
+	group.clear();
+	EXPECT_EQ(group.size(),0);
+	EXPECT_FALSE(group.contains(3));
+	EXPECT_FALSE(group.contains(1000));
+}
+
+TEST_F(FastMonomerGroupTest, EraseAndRemove)
+{
+	FastMonomerGroup<MyMolecules> group(molecules);
+	for(uint32_t i=0;i<10;i++) group.push_back(2*i);
+
+	EXPECT_NO_THROW(group.erase(0));
+	EXPECT_THROW(group.erase(9),std::runtime_error);
+	EXPECT_FALSE(group.contains(0));
+	EXPECT_EQ(group.size(),9);
+
+	EXPECT_NO_THROW(group.removeFromGroup(10));
+	EXPECT_THROW(group.removeFromGroup(10),std::runtime_error);
+	EXPECT_THROW(group.removeFromGroup(11),std::runtime_error);
+	EXPECT_FALSE(group.contains(10));
+	EXPECT_EQ(group.size(),8);
+
+	EXPECT_EQ(group.trueIndex(0),2);
+	EXPECT_EQ(group.trueIndex(3),8);
+	EXPECT_EQ(group.trueIndex(4),12);
+}
+
+TEST_F(FastMonomerGroupTest, SetOperations)
+{
+	FastMonomerGroup<MyMolecules> a(molecules), b(molecules);
+	for(uint32_t i=0;i<100;i+=2) a.push_back(i);
+	for(uint32_t i=0;i<150;i+=3) b.push_back(i);
+
+	FastMonomerGroup<MyMolecules> unionGroup(a);
+	unionGroup+=b;
+	FastMonomerGroup<MyMolecules> intersection(a);
+	intersection&=b;
+	FastMonomerGroup<MyMolecules> difference(a);
+	difference-=b;
+
+	for(uint32_t i=0;i<200;i++){
+		bool inA=(i<100 && i%2==0);
+		bool inB=(i<150 && i%3==0);
+		EXPECT_EQ(unionGroup.contains(i),inA||inB);
+		EXPECT_EQ(intersection.contains(i),inA&&inB);
+		EXPECT_EQ(difference.contains(i),inA&&!inB);
+	}
+	EXPECT_EQ(unionGroup.size(),50+50-17);
+	EXPECT_EQ(intersection.size(),17);
+	EXPECT_EQ(difference.size(),50-17);
+
+	//indices stay sorted and unique
+	for(size_t n=1;n<unionGroup.size();n++)
+		EXPECT_LT(unionGroup.trueIndex(n-1),unionGroup.trueIndex(n));
+}
+
+TEST_F(FastMonomerGroupTest, GatherAndConversion)
+{
+	MonomerGroup<MyMolecules> oldGroup(molecules);
+	oldGroup.push_back(7);
+	oldGroup.push_back(3);
+	oldGroup.push_back(7);
+	oldGroup.push_back(199);
+
+	FastMonomerGroup<MyMolecules> group(molecules,oldGroup);
+	ASSERT_EQ(group.size(),3);
+
+	std::vector<double> x,y,z;
+	group.gatherCoordinates(x,y,z);
+	ASSERT_EQ(x.size(),3);
+	EXPECT_DOUBLE_EQ(x[0],3.0);  EXPECT_DOUBLE_EQ(y[0],6.0);   EXPECT_DOUBLE_EQ(z[0],-3.0);
+	EXPECT_DOUBLE_EQ(x[1],7.0);  EXPECT_DOUBLE_EQ(y[1],14.0);  EXPECT_DOUBLE_EQ(z[1],-7.0);
+	EXPECT_DOUBLE_EQ(x[2],199.0);EXPECT_DOUBLE_EQ(y[2],398.0); EXPECT_DOUBLE_EQ(z[2],-199.0);
+
+	MonomerGroup<MyMolecules> backConverted=group.toMonomerGroup();
+	ASSERT_EQ(backConverted.size(),3);
+	EXPECT_EQ(backConverted.trueIndex(0),3);
+	EXPECT_EQ(backConverted.trueIndex(1),7);
+	EXPECT_EQ(backConverted.trueIndex(2),199);
+}
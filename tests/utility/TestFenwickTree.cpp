@@ -0,0 +1,103 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015,2021 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <vector>
+
+#include <LeMonADE/utility/FenwickTree.h>
+
+TEST(FenwickTreeTest, SetAndPrefixSums)
+{
+	FenwickTree<uint32_t> tree(7);
+	EXPECT_EQ(tree.size(),7);
+	EXPECT_EQ(tree.getTotal(),0);
+
+	uint32_t weights[7]={3,0,1,4,0,0,2};
+	for(size_t i=0;i<7;i++) tree.set(i,weights[i]);
+	EXPECT_EQ(tree.getTotal(),10);
+
+	uint32_t sum=0;
+	for(size_t i=0;i<=7;i++){
+		EXPECT_EQ(tree.prefixSum(i),sum);
+		if(i<7){
+			EXPECT_EQ(tree.get(i),weights[i]);
+			sum+=weights[i];
+		}
+	}
+
+	//decreasing weights wrap around in unsigned arithmetic
+	tree.set(3,1);
+	tree.set(0,0);
+	EXPECT_EQ(tree.getTotal(),4);
+	EXPECT_EQ(tree.prefixSum(4),2);
+	EXPECT_EQ(tree.prefixSum(7),4);
+
+	//building from a vector gives the same tree
+	std::vector<uint32_t> v(weights,weights+7);
+	FenwickTree<uint32_t> built;
+	built.assign(v);
+	EXPECT_EQ(built.getTotal(),10);
+	for(size_t i=0;i<=7;i++){
+		FenwickTree<uint32_t> reference(7);
+		for(size_t j=0;j<7;j++) reference.set(j,weights[j]);
+		EXPECT_EQ(built.prefixSum(i),reference.prefixSum(i));
+	}
+}
+
+TEST(FenwickTreeTest, Find)
+{
+	std::vector<uint32_t> weights;
+	for(uint32_t i=0;i<37;i++) weights.push_back((i%3==1)?0:(i%5));
+
+	FenwickTree<uint32_t> tree;
+	tree.assign(weights);
+
+	//every value in [0,total) belongs to the entry whose interval contains it
+	uint32_t start=0;
+	for(size_t i=0;i<weights.size();i++){
+		for(uint32_t x=start;x<start+weights[i];x++)
+			EXPECT_EQ(tree.find(x),i);
+		start+=weights[i];
+	}
+	EXPECT_EQ(start,tree.getTotal());
+
+	//entries set to zero are never found
+	tree.set(4,0);
+	for(uint32_t x=0;x<tree.getTotal();x++)
+		EXPECT_NE(tree.find(x),4);
+
+	FenwickTree<double> doubleTree(3);
+	doubleTree.set(0,0.5);
+	doubleTree.set(2,1.5);
+	EXPECT_DOUBLE_EQ(doubleTree.getTotal(),2.0);
+	EXPECT_EQ(doubleTree.find(0.49),0);
+	EXPECT_EQ(doubleTree.find(0.5),2);
+	EXPECT_EQ(doubleTree.find(1.99),2);
+}
@@ -0,0 +1,101 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include <LeMonADE/utility/GyrationTensor.h>
+
+TEST(GyrationTensorTest, EmptyAndSinglePosition)
+{
+	GyrationTensor tensor;
+	EXPECT_EQ(tensor.getNumberOfPositions(),0);
+	EXPECT_DOUBLE_EQ(tensor.getRg2(),0.0);
+	EXPECT_DOUBLE_EQ(tensor.getRelativeShapeAnisotropy(),0.0);
+
+	int x=3,y=-4,z=5;
+	tensor.calculate(&x,&y,&z,1);
+	EXPECT_EQ(tensor.getNumberOfPositions(),1);
+	EXPECT_DOUBLE_EQ(tensor.getCenterOfMass().getX(),3.0);
+	EXPECT_DOUBLE_EQ(tensor.getCenterOfMass().getY(),-4.0);
+	EXPECT_DOUBLE_EQ(tensor.getCenterOfMass().getZ(),5.0);
+	EXPECT_DOUBLE_EQ(tensor.getRg2(),0.0);
+}
+
+TEST(GyrationTensorTest, Rod)
+{
+	//rod along (1,1,0) far away from the origin: tests the two pass summation
+	//and the eigenvalues of a non diagonal tensor
+	std::vector<double> x,y,z;
+	for(int i=0;i<11;i++){
+		x.push_back(1.0e6+i);
+		y.push_back(-1.0e6+i);
+		z.push_back(7.0);
+	}
+	GyrationTensor tensor;
+	tensor.calculate(&x[0],&y[0],&z[0],x.size());
+
+	//variance of 0..10 is 10
+	EXPECT_DOUBLE_EQ(tensor.getXX(),10.0);
+	EXPECT_DOUBLE_EQ(tensor.getYY(),10.0);
+	EXPECT_DOUBLE_EQ(tensor.getZZ(),0.0);
+	EXPECT_DOUBLE_EQ(tensor.getXY(),10.0);
+	EXPECT_DOUBLE_EQ(tensor.getXZ(),0.0);
+	EXPECT_DOUBLE_EQ(tensor.getYZ(),0.0);
+	EXPECT_DOUBLE_EQ(tensor.getRg2(),20.0);
+
+	VectorDouble3 eigenvalues=tensor.getEigenvalues();
+	EXPECT_NEAR(eigenvalues.getX(),0.0,1e-10);
+	EXPECT_NEAR(eigenvalues.getY(),0.0,1e-10);
+	EXPECT_NEAR(eigenvalues.getZ(),20.0,1e-10);
+	EXPECT_NEAR(tensor.getAsphericity(),20.0,1e-10);
+	EXPECT_NEAR(tensor.getAcylindricity(),0.0,1e-10);
+	EXPECT_NEAR(tensor.getRelativeShapeAnisotropy(),1.0,1e-10);
+}
+
+TEST(GyrationTensorTest, EigenvaluesOfGeneralTensor)
+{
+	//points with distinct extensions along rotated axes
+	std::vector<int> x,y,z;
+	int pts[6][3]={{3,1,0},{-3,-1,0},{-1,2,1},{1,-2,-1},{0,1,-2},{0,-1,2}};
+	for(int i=0;i<6;i++){x.push_back(pts[i][0]);y.push_back(pts[i][1]);z.push_back(pts[i][2]);}
+
+	GyrationTensor tensor;
+	tensor.calculate(&x[0],&y[0],&z[0],x.size());
+
+	VectorDouble3 l=tensor.getEigenvalues();
+	EXPECT_LE(l.getX(),l.getY());
+	EXPECT_LE(l.getY(),l.getZ());
+	//invariants: trace, sum of principal minors and determinant
+	double a=tensor.getXX(),b=tensor.getYY(),c=tensor.getZZ();
+	double d=tensor.getXY(),e=tensor.getXZ(),f=tensor.getYZ();
+	EXPECT_NEAR(l.getX()+l.getY()+l.getZ(),a+b+c,1e-10);
+	EXPECT_NEAR(l.getX()*l.getY()+l.getY()*l.getZ()+l.getX()*l.getZ(),a*b+b*c+a*c-d*d-e*e-f*f,1e-10);
+	EXPECT_NEAR(l.getX()*l.getY()*l.getZ(),a*(b*c-f*f)-d*(d*c-f*e)+e*(d*f-b*e),1e-10);
+}
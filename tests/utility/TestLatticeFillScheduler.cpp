@@ -0,0 +1,120 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include <LeMonADE/core/Molecules.h>
+#include <LeMonADE/utility/Vector3D.h>
+#include <LeMonADE/utility/LatticeFillScheduler.h>
+
+typedef Molecules<VectorInt3> MyMolecules;
+
+namespace
+{
+	//counts the calls per monomer and fails for one index
+	class CountingOperation
+	{
+	public:
+		CountingOperation(std::vector<int>& calls_, uint32_t failing_):calls(calls_),failing(failing_){}
+		bool operator()(uint32_t n) const {calls[n]++; return n!=failing;}
+	private:
+		std::vector<int>& calls;
+		uint32_t failing;
+	};
+
+	struct ZeroValue
+	{
+		int operator()(const MyMolecules&, uint32_t) const {return 0;}
+	};
+}
+
+TEST(LatticeFillSchedulerTest, VisitsEveryMonomerOnce)
+{
+	MyMolecules molecules;
+	for(int i=0;i<500;i++)
+		molecules.addMonomer(VectorInt3(i%7,i%5,(i*13)%64-32));
+
+	std::vector<int> boxSizes;
+	boxSizes.push_back(64);
+	boxSizes.push_back(3);
+	boxSizes.push_back(10);
+
+	for(size_t b=0;b<boxSizes.size();b++)
+	{
+		LatticeFillScheduler<int> scheduler;
+		scheduler.sortIntoSlabs(molecules,boxSizes[b]);
+
+		std::vector<int> calls(molecules.size(),0);
+		uint32_t failedIndex;
+		EXPECT_TRUE(scheduler.forEachMonomer(CountingOperation(calls,0xFFFFFFFFu),failedIndex));
+		for(size_t n=0;n<calls.size();n++)
+			EXPECT_EQ(1,calls[n]);
+	}
+
+	//the smallest failing index is reported
+	LatticeFillScheduler<int> scheduler;
+	scheduler.sortIntoSlabs(molecules,64);
+	std::vector<int> calls(molecules.size(),0);
+	uint32_t failedIndex;
+	EXPECT_FALSE(scheduler.forEachMonomer(CountingOperation(calls,123),failedIndex));
+	EXPECT_EQ(123u,failedIndex);
+}
+
+TEST(LatticeFillSchedulerTest, Snapshot)
+{
+	MyMolecules molecules;
+	for(int i=0;i<10;i++)
+		molecules.addMonomer(VectorInt3(2*i,0,0));
+
+	LatticeFillScheduler<int> scheduler;
+	std::vector<uint32_t> changed;
+	EXPECT_FALSE(scheduler.findChangedMonomers(molecules,ZeroValue(),1,changed));
+
+	scheduler.storeSnapshot(molecules,ZeroValue(),1);
+	EXPECT_TRUE(scheduler.findChangedMonomers(molecules,ZeroValue(),1,changed));
+	EXPECT_TRUE(changed.empty());
+
+	molecules[3].setAllCoordinates(6,1,0);
+	molecules[8].setAllCoordinates(0,0,5);
+	EXPECT_TRUE(scheduler.findChangedMonomers(molecules,ZeroValue(),1,changed));
+	ASSERT_EQ(2u,changed.size());
+	EXPECT_EQ(3u,changed[0]);
+	EXPECT_EQ(8u,changed[1]);
+	EXPECT_EQ(VectorInt3(6,0,0),scheduler.getSnapshotPosition(3));
+
+	//a different lattice generation or number of monomers invalidates the snapshot
+	EXPECT_FALSE(scheduler.findChangedMonomers(molecules,ZeroValue(),2,changed));
+	molecules.addMonomer(VectorInt3(40,0,0));
+	EXPECT_FALSE(scheduler.findChangedMonomers(molecules,ZeroValue(),1,changed));
+
+	scheduler.clearSnapshot();
+	molecules.resize(10);
+	EXPECT_FALSE(scheduler.findChangedMonomers(molecules,ZeroValue(),1,changed));
+}
@@ -340,4 +340,30 @@ TEST(MonomerGroups, RemoveFromGroup)
 
 
 
-}
\ No newline at end of file
+}
+TEST(MonomerGroups, AddGroups)
+{
+	typedef Molecules<VectorInt3> MyMolecules;
+	MyMolecules molecules;
+	molecules.resize(20);
+
+	MonomerGroup<MyMolecules> groupA(molecules);
+	MonomerGroup<MyMolecules> groupB(molecules);
+	groupA.push_back(5);
+	groupA.push_back(1);
+	groupA.push_back(12);
+	groupB.push_back(12);
+	groupB.push_back(0);
+	groupB.push_back(19);
+	groupB.push_back(0);
+
+	groupA+=groupB;
+
+	//new elements are appended in order, duplicates are skipped
+	ASSERT_EQ(groupA.size(),5);
+	EXPECT_EQ(groupA.trueIndex(0),5);
+	EXPECT_EQ(groupA.trueIndex(1),1);
+	EXPECT_EQ(groupA.trueIndex(2),12);
+	EXPECT_EQ(groupA.trueIndex(3),0);
+	EXPECT_EQ(groupA.trueIndex(4),19);
+}
@@ -202,4 +202,42 @@ TEST(RandomNumberGeneratorsTest,R250RangeOfNumbers){
 	EXPECT_GE(numbersInt.size(),(10000-1));
 	EXPECT_GE(numbersDouble.size(),(10000-1));
 
-}
\ No newline at end of file
+}
+
+TEST(RandomNumberGeneratorsTest,R250ThreadBinding){
+
+	RandomNumberGenerators rng;
+	std::vector<uint32_t> sharedState;
+	rng.getR250State(sharedState);
+
+	//numbers and seeding go to the bound engine
+	R250 ownEngine;
+	RandomNumberGenerators::bindThreadR250(&ownEngine);
+	EXPECT_EQ(&ownEngine,RandomNumberGenerators::getThreadR250());
+
+	std::vector<uint32_t> boundState;
+	rng.getR250State(boundState);
+	std::vector<uint32_t> numbers;
+	for(size_t i=0;i<1000;i++) numbers.push_back(rng.r250_rand32());
+
+	RandomNumberGenerators::bindThreadR250(0);
+	EXPECT_TRUE(RandomNumberGenerators::getThreadR250()==0);
+
+	//the shared engine was not used
+	std::vector<uint32_t> state;
+	rng.getR250State(state);
+	EXPECT_EQ(sharedState,state);
+
+	//the bound engine produced its own sequence
+	R250 sameEngine;
+	for(size_t i=0;i<1000;i++) EXPECT_EQ(numbers[i],sameEngine.r250_rand());
+
+	//setting the state while bound restores the sequence of the bound engine
+	RandomNumberGenerators::bindThreadR250(&ownEngine);
+	rng.setR250State(boundState);
+	for(size_t i=0;i<1000;i++) EXPECT_EQ(numbers[i],rng.r250_rand32());
+	RandomNumberGenerators::bindThreadR250(0);
+
+	rng.getR250State(state);
+	EXPECT_EQ(sharedState,state);
+}
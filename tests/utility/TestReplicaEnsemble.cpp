@@ -0,0 +1,263 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+/*****************************************************************************/
+/**
+ * @file
+ * @brief Tests for the class ReplicaEnsemble
+ * */
+/*****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <vector>
+
+#include <LeMonADE/core/ConfigureSystem.h>
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureMoleculesIO.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/feature/FeatureExcludedVolumeSc.h>
+#include <LeMonADE/feature/FeatureNNInteractionSc.h>
+#include <LeMonADE/updater/UpdaterSimpleSimulator.h>
+#include <LeMonADE/updater/moves/MoveLocalSc.h>
+#include <LeMonADE/utility/RandomNumberGenerators.h>
+#include <LeMonADE/utility/ReplicaEnsemble.h>
+
+class TestReplicaEnsemble: public ::testing::Test{
+public:
+
+  typedef LOKI_TYPELIST_3(FeatureMoleculesIO,FeatureAttributes<>,FeatureNNInteractionSc<FeatureLatticePowerOfTwo>) Features;
+  typedef ConfigureSystem<VectorInt3,Features,4> Config;
+  typedef Ingredients<Config> IngredientsType;
+  typedef ReplicaEnsemble<IngredientsType,MoveLocalSc> EnsembleType;
+
+  //redirect cout output and keep the random number sequence of other tests unchanged
+  virtual void SetUp(){
+    originalBuffer=std::cout.rdbuf();
+    std::cout.rdbuf(tempStream.rdbuf());
+    RandomNumberGenerators rng;
+    rng.getR250State(originalRngState);
+  };
+
+  virtual void TearDown(){
+    std::cout.rdbuf(originalBuffer);
+    RandomNumberGenerators rng;
+    rng.setR250State(originalRngState);
+  };
+
+  //a few short chains with attractive interaction
+  void setupSystem(IngredientsType& ingredients)
+  {
+    ingredients.setBoxX(16);
+    ingredients.setBoxY(16);
+    ingredients.setBoxZ(16);
+    ingredients.setPeriodicX(true);
+    ingredients.setPeriodicY(true);
+    ingredients.setPeriodicZ(true);
+    ingredients.modifyBondset().addBFMclassicBondset();
+    ingredients.setNNInteraction(1,1,-0.4);
+
+    for(int32_t c=0;c<8;c++)
+    {
+      for(int32_t m=0;m<6;m++)
+      {
+	uint32_t idx=ingredients.modifyMolecules().addMonomer(2*m,2*(c%4),4*(c/4));
+	ingredients.modifyMolecules()[idx].setAttributeTag(1);
+	if(m>0) ingredients.modifyMolecules().connect(idx-1,idx);
+      }
+    }
+  }
+
+  //R250_RANDOM_PREFETCH seeds derived from value
+  std::vector<uint32_t> makeSeeds(uint32_t value)
+  {
+    std::vector<uint32_t> seeds(R250_RANDOM_PREFETCH);
+    for(size_t n=0;n<seeds.size();n++)
+      seeds[n]=value*2654435761u+uint32_t(n)*40503u+1;
+    return seeds;
+  }
+
+private:
+  std::streambuf* originalBuffer;
+  std::ostringstream tempStream;
+  std::vector<uint32_t> originalRngState;
+};
+
+//throws on execution, either a std::exception or something else
+class ThrowingAnalyzer:public AbstractAnalyzer
+{
+public:
+  ThrowingAnalyzer(bool standardException=true):throwStandardException(standardException){}
+  virtual void initialize(){}
+  virtual bool execute(){
+    if(throwStandardException) throw std::runtime_error("ThrowingAnalyzer");
+    throw 1;
+  }
+  virtual void cleanup(){}
+private:
+  bool throwStandardException;
+};
+
+TEST_F(TestReplicaEnsemble,SameTrajectoryAsSingleRun)
+{
+  IngredientsType ingredients;
+  setupSystem(ingredients);
+
+  EnsembleType ensemble(10);
+  for(uint32_t r=0;r<6;r++)
+    EXPECT_EQ(r,ensemble.addReplica(ingredients,makeSeeds(r)));
+  EXPECT_EQ(6u,ensemble.getNReplicas());
+
+  //the interaction tables are shared between the replicas
+  for(uint32_t r=0;r<6;r++)
+    EXPECT_TRUE(ensemble.getReplica(r).sharesNNInteractionTables(ingredients));
+
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> sharedState;
+  rng.getR250State(sharedState);
+
+  ensemble.initialize();
+  ensemble.run(5);
+  ensemble.cleanup();
+
+  //the shared stream is not touched by the replicas
+  std::vector<uint32_t> state;
+  rng.getR250State(state);
+  EXPECT_EQ(sharedState,state);
+
+  //every replica follows the trajectory of a single simulation with its seeds
+  for(uint32_t r=0;r<6;r++)
+  {
+    std::vector<uint32_t> seedState(makeSeeds(r));
+    seedState.push_back(R250_RANDOM_PREFETCH);
+    seedState.push_back(250);
+    seedState.push_back(250-147);
+    seedState.push_back(0);
+    rng.setR250State(seedState);
+
+    IngredientsType single(ingredients);
+    single.synchronize();
+    UpdaterSimpleSimulator<IngredientsType,MoveLocalSc> updater(single,50);
+    updater.execute();
+
+    const IngredientsType& replica=ensemble.getReplica(r);
+    EXPECT_EQ(single.getMolecules().getAge(),replica.getMolecules().getAge());
+    for(size_t n=0;n<single.getMolecules().size();n++)
+      EXPECT_EQ(single.getMolecules()[n],replica.getMolecules()[n]);
+  }
+
+  //different seeds give different trajectories
+  size_t nDifferent=0;
+  for(size_t n=0;n<ingredients.getMolecules().size();n++)
+    if(ensemble.getReplica(0).getMolecules()[n]!=ensemble.getReplica(1).getMolecules()[n]) nDifferent++;
+  EXPECT_GT(nDifferent,0u);
+}
+
+TEST_F(TestReplicaEnsemble,SeedsFromSharedStream)
+{
+  IngredientsType ingredients;
+  setupSystem(ingredients);
+
+  RandomNumberGenerators rng;
+  std::vector<uint32_t> startState;
+  rng.getR250State(startState);
+
+  EnsembleType first(5);
+  first.addReplica(ingredients);
+  first.addReplica(ingredients);
+  first.initialize();
+  first.run(2);
+
+  //same shared state gives the same ensemble
+  rng.setR250State(startState);
+  EnsembleType second(5);
+  second.addReplica(ingredients);
+  second.addReplica(ingredients);
+  second.initialize();
+  second.run(2);
+
+  for(size_t r=0;r<2;r++)
+    for(size_t n=0;n<ingredients.getMolecules().size();n++)
+      EXPECT_EQ(first.getReplica(r).getMolecules()[n],second.getReplica(r).getMolecules()[n]);
+
+  EXPECT_THROW(first.addReplica(ingredients,std::vector<uint32_t>(10,1)),std::runtime_error);
+  EXPECT_EQ(2u,first.getNReplicas());
+}
+
+TEST_F(TestReplicaEnsemble,ErrorsArePropagated)
+{
+  IngredientsType ingredients;
+  setupSystem(ingredients);
+
+  EnsembleType ensemble(1);
+  ensemble.addReplica(ingredients,makeSeeds(1));
+  ensemble.addReplica(ingredients,makeSeeds(2));
+  ensemble.addAnalyzer(1,new ThrowingAnalyzer);
+  ensemble.initialize();
+  EXPECT_THROW(ensemble.run(1),std::runtime_error);
+  EXPECT_TRUE(RandomNumberGenerators::getThreadR250()==0);
+
+  //other exceptions do not leave the parallel region either
+  EnsembleType other(1);
+  other.addReplica(ingredients,makeSeeds(1));
+  other.addAnalyzer(0,new ThrowingAnalyzer(false));
+  other.initialize();
+  try{
+    other.run(1);
+    ADD_FAILURE()<<"no exception thrown";
+  }
+  catch(std::runtime_error& e){
+    EXPECT_NE(std::string::npos,std::string(e.what()).find("replica 0 failed:\nunknown exception"));
+  }
+  EXPECT_TRUE(RandomNumberGenerators::getThreadR250()==0);
+}
+
+TEST_F(TestReplicaEnsemble,ReplicasDoNotPrintProgress)
+{
+  IngredientsType ingredients;
+  setupSystem(ingredients);
+
+  EnsembleType ensemble(1);
+  ensemble.addReplica(ingredients,makeSeeds(1));
+  ensemble.addReplica(ingredients,makeSeeds(2));
+  ensemble.initialize();
+
+  std::ostringstream output;
+  std::streambuf* buffer=std::cout.rdbuf(output.rdbuf());
+  ensemble.run(2);
+  std::cout.rdbuf(buffer);
+  EXPECT_EQ(std::string::npos,output.str().find("passed time"));
+}
+
+TEST_F(TestReplicaEnsemble,ReplicaFilename)
+{
+  EXPECT_EQ("config_r0003.bfm",EnsembleType::replicaFilename("config.bfm",3));
+  EXPECT_EQ("out/run.1/config_r0012",EnsembleType::replicaFilename("out/run.1/config",12));
+  EXPECT_EQ("a.b_r0000.dat",EnsembleType::replicaFilename("a.b.dat",0));
+}
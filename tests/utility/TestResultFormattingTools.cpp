@@ -0,0 +1,240 @@
+/*--------------------------------------------------------------------------------
+    ooo      L   attice-based  |
+  o\.|./o    e   xtensible     | LeMonADE: An Open Source Implementation of the
+ o\.\|/./o   Mon te-Carlo      |           Bond-Fluctuation-Model for Polymers
+oo---0---oo  A   lgorithm and  |
+ o/./|\.\o   D   evelopment    | Copyright (C) 2013-2015 by
+  o/.|.\o    E   nvironment    | LeMonADE Principal Developers (see AUTHORS)
+    ooo                        |
+----------------------------------------------------------------------------------
+
+This file is part of LeMonADE.
+
+LeMonADE is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LeMonADE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LeMonADE.  If not, see <http://www.gnu.org/licenses/>.
+
+--------------------------------------------------------------------------------*/
+
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <fstream>
+#include <vector>
+
+#include <LeMonADE/core/Ingredients.h>
+#include <LeMonADE/feature/FeatureAttributes.h>
+#include <LeMonADE/analyzer/AnalyzerAbstractDump.h>
+#include <LeMonADE/utility/ResultFormattingTools.h>
+
+class ResultFormattingToolsTest: public ::testing::Test{
+public:
+	typedef LOKI_TYPELIST_1(FeatureAttributes<>) Features;
+	typedef ConfigureSystem<VectorInt3,Features> Config;
+	typedef Ingredients < Config> MyIngredients;
+protected:
+	MyIngredients ingredients;
+
+	//! reference formatting with a default constructed stream
+	template<class T>
+	std::string streamFormat(T value){
+		std::stringstream stream;
+		stream.precision(std::numeric_limits<T>::max_digits10);
+		stream.setf( std::ios::fixed, std:: ios::floatfield );
+		stream<<value;
+		return stream.str();
+	}
+
+	template<class T>
+	std::string fastFormat(T value){
+		std::string buffer;
+		ResultFormattingTools::formatValue(buffer,value);
+		return buffer;
+	}
+
+	std::string readFile(std::string filename){
+		std::ifstream file(filename.c_str());
+		std::stringstream contents;
+		contents<<file.rdbuf();
+		return contents.str();
+	}
+};
+
+//! analyzer storing one column per call of execute()
+class DumpTwoColumns:public AnalyzerAbstractDump<ResultFormattingToolsTest::MyIngredients,double>
+{
+public:
+	DumpTwoColumns(const ResultFormattingToolsTest::MyIngredients& ing, std::string filename)
+	:AnalyzerAbstractDump<ResultFormattingToolsTest::MyIngredients,double>(ing,filename)
+	{
+		setNumberOfColumns(2);
+		setBufferSize(3);
+	}
+	virtual bool execute(){
+		double age=double(ingredients.getMolecules().getAge());
+		Data[0].push_back(0.5*age);
+		Data[1].push_back(-age);
+		return AnalyzerAbstractDump<ResultFormattingToolsTest::MyIngredients,double>::execute();
+	}
+};
+
+TEST_F(ResultFormattingToolsTest, FormatValueMatchesStream)
+{
+	double doubles[]={0.0,1.0,-2.5,0.1,1.0/3.0,123456789.123456789,-1e-7,1e20};
+	for(size_t n=0;n<sizeof(doubles)/sizeof(double);n++)
+		EXPECT_EQ(streamFormat(doubles[n]),fastFormat(doubles[n]));
+
+	float floats[]={0.0f,0.1f,-7.25f,3.0e8f};
+	for(size_t n=0;n<sizeof(floats)/sizeof(float);n++)
+		EXPECT_EQ(streamFormat(floats[n]),fastFormat(floats[n]));
+
+	EXPECT_EQ(fastFormat(1e300).size(),streamFormat(1e300).size());
+	EXPECT_EQ(fastFormat(int32_t(0)),"0");
+	EXPECT_EQ(fastFormat(int32_t(-45)),"-45");
+	EXPECT_EQ(fastFormat(std::numeric_limits<int32_t>::min()),streamFormat(std::numeric_limits<int32_t>::min()));
+	EXPECT_EQ(fastFormat(std::numeric_limits<int64_t>::min()),streamFormat(std::numeric_limits<int64_t>::min()));
+	EXPECT_EQ(fastFormat(std::numeric_limits<uint64_t>::max()),streamFormat(std::numeric_limits<uint64_t>::max()));
+
+	//characters are written as characters, booleans as numbers
+	EXPECT_EQ(fastFormat('a'),streamFormat('a'));
+	EXPECT_EQ(fastFormat((signed char)('B')),streamFormat((signed char)('B')));
+	EXPECT_EQ(fastFormat((unsigned char)('c')),streamFormat((unsigned char)('c')));
+	EXPECT_EQ(fastFormat(true),streamFormat(true));
+}
+
+TEST_F(ResultFormattingToolsTest, TextFileWithFirstColumn)
+{
+	std::vector<double> times(2);
+	times[0]=10; times[1]=20;
+	std::vector<std::vector<double> > data(2,std::vector<double>(2));
+	data[0][0]=1.5; data[0][1]=2.5;
+	data[1][0]=-1;  data[1][1]=0.1;
+
+	//reference: the old way with the time column copied in front of the data
+	std::vector<std::vector<double> > joined(data);
+	joined.insert(joined.begin(),times);
+
+	ResultFormattingTools::writeResultFile("tmpResultJoined.dat",ingredients,joined,"comment");
+	ResultFormattingTools::appendToResultFile("tmpResultJoined.dat",joined);
+	ResultFormattingTools::writeResultFile("tmpResultSplit.dat",ingredients,times,data,"comment");
+	ResultFormattingTools::appendToResultFile("tmpResultSplit.dat",times,data);
+
+	std::string contents=readFile("tmpResultSplit.dat");
+	EXPECT_EQ(readFile("tmpResultJoined.dat"),contents);
+	EXPECT_NE(contents.find("# comment"),std::string::npos);
+	EXPECT_NE(contents.find(streamFormat(20.0)+"\t"+streamFormat(2.5)+"\t"+streamFormat(0.1)+"\t\n"),std::string::npos);
+
+	//columns of different size
+	data[1].push_back(3.0);
+	EXPECT_THROW(ResultFormattingTools::appendToResultFile("tmpResultSplit.dat",times,data),std::runtime_error);
+
+	std::remove("tmpResultJoined.dat");
+	std::remove("tmpResultSplit.dat");
+}
+
+TEST_F(ResultFormattingToolsTest, BinaryRoundTrip)
+{
+	std::vector<int32_t> times(3);
+	times[0]=100; times[1]=200; times[2]=300;
+	std::vector<std::vector<int32_t> > data(1,std::vector<int32_t>(3));
+	data[0][0]=-1; data[0][1]=0; data[0][2]=7;
+
+	ResultFormattingTools::writeBinaryResultFile("tmpResult.bin",ingredients,&times,data,"binary comment");
+	//empty blocks are allowed
+	std::vector<int32_t> noTimes;
+	std::vector<std::vector<int32_t> > noData(1);
+	ResultFormattingTools::appendToBinaryResultFile("tmpResult.bin",&noTimes,noData);
+	times[0]=400;
+	ResultFormattingTools::appendToBinaryResultFile("tmpResult.bin",&times,data);
+
+	std::vector<std::vector<int32_t> > columns;
+	std::string header;
+	ResultFormattingTools::readBinaryResultFile("tmpResult.bin",columns,&header);
+
+	ASSERT_EQ(columns.size(),2);
+	ASSERT_EQ(columns[0].size(),6);
+	ASSERT_EQ(columns[1].size(),6);
+	EXPECT_EQ(columns[0][0],100);
+	EXPECT_EQ(columns[0][2],300);
+	EXPECT_EQ(columns[0][3],400);
+	EXPECT_EQ(columns[0][5],300);
+	EXPECT_EQ(columns[1][0],-1);
+	EXPECT_EQ(columns[1][5],7);
+	EXPECT_NE(header.find("# binary comment"),std::string::npos);
+
+	//wrong value type
+	std::vector<std::vector<double> > wrongType;
+	EXPECT_THROW(ResultFormattingTools::readBinaryResultFile("tmpResult.bin",wrongType),std::runtime_error);
+
+	std::remove("tmpResult.bin");
+}
+
+TEST_F(ResultFormattingToolsTest, AbstractDumpSelectsFormat)
+{
+	DumpTwoColumns textDump(ingredients,"tmpDump.dat");
+	EXPECT_EQ(textDump.getOutputFormat(),ResultFormattingTools::TextFormat);
+
+	ResultFormattingTools::setDefaultOutputFormat(ResultFormattingTools::BinaryFormat);
+	DumpTwoColumns binaryDump(ingredients,"tmpDump.bin");
+	ResultFormattingTools::setDefaultOutputFormat(ResultFormattingTools::TextFormat);
+	EXPECT_EQ(binaryDump.getOutputFormat(),ResultFormattingTools::BinaryFormat);
+
+	textDump.initialize();
+	binaryDump.initialize();
+	for(uint64_t age=1;age<=10;age++){
+		ingredients.modifyMolecules().setAge(age);
+		textDump.execute();
+		binaryDump.execute();
+	}
+	textDump.cleanup();
+	binaryDump.cleanup();
+
+	std::vector<std::vector<double> > columns;
+	ResultFormattingTools::readBinaryResultFile("tmpDump.bin",columns);
+	ASSERT_EQ(columns.size(),3);
+	ASSERT_EQ(columns[0].size(),10);
+	for(size_t n=0;n<10;n++){
+		EXPECT_DOUBLE_EQ(columns[0][n],double(n+1));
+		EXPECT_DOUBLE_EQ(columns[1][n],0.5*double(n+1));
+		EXPECT_DOUBLE_EQ(columns[2][n],-double(n+1));
+	}
+
+	std::string text=readFile("tmpDump.dat");
+	EXPECT_NE(text.find(streamFormat(10.0)+"\t"+streamFormat(5.0)+"\t"+streamFormat(-10.0)+"\t\n"),std::string::npos);
+
+	std::remove("tmpDump.dat");
+	std::remove("tmpDump.bin");
+}
+
+TEST_F(ResultFormattingToolsTest, BinaryFilename)
+{
+	EXPECT_EQ(ResultFormattingTools::outputFilename(ResultFormattingTools::TextFormat,"data.dat"),"data.dat");
+	EXPECT_EQ(ResultFormattingTools::outputFilename(ResultFormattingTools::BinaryFormat,"data.dat"),"data.dat.bin");
+	EXPECT_EQ(ResultFormattingTools::outputFilename(ResultFormattingTools::BinaryFormat,"data.bin"),"data.bin");
+
+	//the binary file never replaces the text file of the same name
+	DumpTwoColumns binaryDump(ingredients,"tmpDumpName.dat");
+	binaryDump.setOutputFormat(ResultFormattingTools::BinaryFormat);
+	binaryDump.initialize();
+	binaryDump.execute();
+	binaryDump.cleanup();
+
+	EXPECT_TRUE(readFile("tmpDumpName.dat").empty());
+	std::vector<std::vector<double> > columns;
+	ResultFormattingTools::readBinaryResultFile("tmpDumpName.dat.bin",columns);
+	EXPECT_EQ(columns.size(),3);
+
+	std::remove("tmpDumpName.dat.bin");
+}